@@ -371,11 +371,17 @@ public:
     // call to SuspendProcessingOfPendingEvents()
     void ResumeProcessingOfPendingEvents();
 
+    // limit the number of events processed by a single ProcessPendingEvents()
+    // call and/or the time spent in it, 0 means no limit for either of them
+    void SetPendingEventsBudget(size_t maxEvents, long maxTime = 0);
+
     // called by ~wxEvtHandler to (eventually) remove the handler from the list of
     // the handlers with pending events
     void RemovePendingEventHandler(wxEvtHandler* toRemove);
 
-    // adds an event handler to the list of the handlers with pending events
+    // adds an event handler to the list of the handlers with pending events,
+    // unless it's already there; this function doesn't lock anything and can
+    // be called from any thread
     void AppendPendingEventHandler(wxEvtHandler* toAppend);
 
     // moves the event handler from the list of the handlers with pending events
@@ -544,6 +550,12 @@ protected:
     // pending events)
     wxEvtHandlerArray m_handlersWithPendingDelayedEvents;
 
+    // the handlers added by AppendPendingEventHandler() which haven't been
+    // moved to m_handlersWithPendingEvents yet: this is a lock-free stack,
+    // linked by wxEvtHandler::m_nextWithPendingEvents, which is emptied by
+    // MoveNewPendingEventHandlers() under m_handlersWithPendingEventsLocker
+    std::atomic<wxEvtHandler*> m_handlersWithNewPendingEvents{nullptr};
+
 #if wxUSE_THREADS
     // this critical section protects both the lists above
     wxCriticalSection m_handlersWithPendingEventsLocker;
@@ -552,7 +564,15 @@ protected:
     // flag modified by Suspend/ResumeProcessingOfPendingEvents()
     bool m_bDoPendingEventProcessing = true;
 
+    // limits set by SetPendingEventsBudget(), 0 if there are none
+    size_t m_pendingEventsMaxCount = 0;
+    long m_pendingEventsMaxTime = 0;
+
 private:
+    // move the handlers from m_handlersWithNewPendingEvents to the end of
+    // m_handlersWithPendingEvents, must be called with the locker held
+    void MoveNewPendingEventHandlers();
+
     // flag set to true at the end of wxApp ctor, call WXAppConstructed() to
     // set it
     bool m_fullyConstructed = false;
@@ -98,6 +98,14 @@ public:
     // On MacOS, name must be a file with an extension "svg" placed in the
     // "Resources" subdirectory of the application bundle.
     wxNODISCARD static wxBitmapBundle FromSVGResource(const wxString& name, const wxSize& sizeDef);
+
+    // Set the maximal amount of memory, in bytes, used by the bitmaps cached
+    // by all bundles created from SVG.
+    static void SetSVGCacheLimit(size_t bytes);
+
+    // Rasterize the given bundles created from SVG in the bitmap sizes
+    // appropriate for all the currently connected displays in background.
+    static void PrerasterizeSVG(const wxVector<wxBitmapBundle>& bundles);
 #endif // wxHAS_SVG
 
     // Create from the resources: all existing versions of the bitmap of the
@@ -36,6 +36,8 @@
 #include "wx/meta/convertible.h"
 #include "wx/meta/removeref.h"
 
+#include <atomic>
+
 // This is now always defined, but keep it for backwards compatibility.
 #define wxHAS_CALL_AFTER
 
@@ -46,6 +48,7 @@
 class WXDLLIMPEXP_FWD_BASE wxList;
 class WXDLLIMPEXP_FWD_BASE wxEvent;
 class WXDLLIMPEXP_FWD_BASE wxEventFilter;
+class WXDLLIMPEXP_FWD_BASE wxStopWatch;
 #if wxUSE_GUI
     class WXDLLIMPEXP_FWD_CORE wxDC;
     class WXDLLIMPEXP_FWD_CORE wxMenu;
@@ -3769,6 +3772,11 @@ public:
     // buffer as other wxString objects in this thread.
     virtual void QueueEvent(wxEvent *event);
 
+    // Same as QueueEvent() but if an event of the same type, with the same ID
+    // and queued by this function with the same key is still pending, replace
+    // it with the new one instead of adding the new event to the queue.
+    void QueueEventCoalesced(wxEvent *event, wxIntPtr key = 0);
+
     // Add an event to be processed later: notice that this function is not
     // safe to call from threads other than main, use QueueEvent()
     virtual void AddPendingEvent(const wxEvent& event)
@@ -4099,8 +4107,28 @@ protected:
 
     struct DynamicEvents
     {
+        DynamicEvents() = default;
+        DynamicEvents(const DynamicEvents&) = delete;
+        DynamicEvents& operator=(const DynamicEvents&) = delete;
+        ~DynamicEvents();
+
+        // Must be called after adding a new entry to the end of m_entries.
+        void OnEntryAdded();
+
+        // Remove the null entries from m_entries.
+        void PruneDeleted();
+
         wxVector<wxDynamicEventTableEntry*> m_entries;
         wxRecursionGuardFlag m_flag = 0;
+
+        // Number of null entries in m_entries, i.e. the entries which were
+        // unbound but not removed from it yet.
+        size_t m_numDeleted = 0;
+
+        // Index of m_entries by event type, only created when there are
+        // sufficiently many of them.
+        struct TypeIndex;
+        TypeIndex* m_typeIndex = nullptr;
     };
     // use wxSharedPtr so that SearchDynamicEventTable() can use another
     // instance of wxSharedPtr to extend the life of the wxRecursionGuardFlag
@@ -4110,10 +4138,20 @@ protected:
     static_assert(sizeof(wxSharedPtr<DynamicEvents>) == sizeof(DynamicEvents*), "wxSharedPtr<> has wrong size");
     static_assert(alignof(wxSharedPtr<DynamicEvents>) == alignof(DynamicEvents*), "wxSharedPtr<> has wrong alignment");
 
-    wxList*             m_pendingEvents;
+    // Opaque node of the singly-linked lists of pending events below.
+    struct PendingEventNode;
+
+    // Events queued by QueueEvent() and not processed yet are first pushed,
+    // without taking any locks, to m_pendingEventsIncoming stack, i.e. in LIFO
+    // order, and are moved from there to the FIFO list starting at
+    // m_pendingEvents by the consumer, i.e. ProcessPendingEvents().
+    std::atomic<PendingEventNode*> m_pendingEventsIncoming;
+    PendingEventNode*   m_pendingEvents;
+    PendingEventNode*   m_pendingEventsLast;
 
 #if wxUSE_THREADS
-    // critical section protecting m_pendingEvents
+    // critical section protecting m_pendingEvents list (but not the incoming
+    // events stack), only used by the consumers and not by QueueEvent()
     wxCriticalSection m_pendingEventsLock;
 #endif // wxUSE_THREADS
 
@@ -4152,9 +4190,37 @@ private:
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
+    // Move all events from m_pendingEventsIncoming to the end of
+    // m_pendingEvents list, must be called with m_pendingEventsLock held.
+    void MoveIncomingPendingEvents();
+
+    // Process at most maxEvents (or all of them if it is 0) pending events,
+    // but stop, after processing at least one event, if the given stop watch
+    // shows that more than maxTime milliseconds have elapsed.
+    //
+    // Returns the number of the processed events.
+    size_t DoProcessPendingEvents(size_t maxEvents,
+                                  const wxStopWatch* stopWatch = nullptr,
+                                  long maxTime = 0);
+
+    // The events detached from m_pendingEvents by DoProcessPendingEvents()
+    // and being processed by it, or null if not inside this function.
+    struct PendingEventsBatch;
+    PendingEventsBatch* m_pendingEventsBatch;
+
     // Head of the event filter linked list.
     static wxEventFilter* ms_filterList;
 
+    // Set if this handler is in the wxApp list of handlers with pending events
+    // and used to ensure that it's only added to it once.
+    std::atomic<bool> m_isInPendingHandlersList;
+
+    // Link used by the lock-free list of handlers with pending events
+    // maintained by wxAppConsoleBase.
+    wxEvtHandler* m_nextWithPendingEvents;
+
+    friend class WXDLLIMPEXP_FWD_BASE wxAppConsoleBase;
+
     wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxEvtHandler);
 };
 
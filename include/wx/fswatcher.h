@@ -21,6 +21,7 @@
 #include "wx/dir.h"
 
 #include <unordered_map>
+#include <vector>
 
 #define wxTRACE_FSWATCHER "fswatcher"
 
@@ -218,6 +219,77 @@ typedef void (wxEvtHandler::*wxFileSystemWatcherEventFunction)
 #define EVT_FSWATCHER(winid, func) \
     wx__DECLARE_EVT1(wxEVT_FSWATCHER, winid, wxFileSystemWatcherEventHandler(func))
 
+/**
+ * Event sent when wxFileSystemWatcherBase::AddTreeAsync() finishes adding all
+ * the directories of the tree, its path is the root of the tree.
+ */
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_BASE, wxEVT_FSWATCHER_TREE_ADDED,
+                         wxFileSystemWatcherEvent);
+
+#define EVT_FSWATCHER_TREE_ADDED(winid, func) \
+    wx__DECLARE_EVT1(wxEVT_FSWATCHER_TREE_ADDED, winid, \
+                     wxFileSystemWatcherEventHandler(func))
+
+// ----------------------------------------------------------------------------
+// wxFileSystemWatcherBatchEvent
+// ----------------------------------------------------------------------------
+
+/**
+ * Event containing all the changes coalesced during the interval specified
+ * with wxFileSystemWatcherBase::SetCoalescingInterval().
+ */
+class WXDLLIMPEXP_FWD_BASE wxFileSystemWatcherBatchEvent;
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_BASE, wxEVT_FSWATCHER_BATCH,
+                         wxFileSystemWatcherBatchEvent);
+
+class WXDLLIMPEXP_BASE wxFileSystemWatcherBatchEvent : public wxEvent
+{
+public:
+    wxFileSystemWatcherBatchEvent(int watchid = wxID_ANY) :
+        wxEvent(watchid, wxEVT_FSWATCHER_BATCH)
+    {
+    }
+
+    /**
+     * Returns all the events of this batch in the order in which they
+     * occurred.
+     */
+    const std::vector<wxFileSystemWatcherEvent>& GetEvents() const
+    {
+        return m_events;
+    }
+
+    void AddEvent(const wxFileSystemWatcherEvent& event)
+    {
+        m_events.push_back(event);
+    }
+
+    wxNODISCARD virtual wxEvent* Clone() const override
+    {
+        return new wxFileSystemWatcherBatchEvent(*this);
+    }
+
+    virtual wxEventCategory GetEventCategory() const override
+    {
+        return wxEVT_CATEGORY_UNKNOWN;
+    }
+
+private:
+    std::vector<wxFileSystemWatcherEvent> m_events;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN_DEF_COPY(wxFileSystemWatcherBatchEvent);
+};
+
+typedef void (wxEvtHandler::*wxFileSystemWatcherBatchEventFunction)
+                                                (wxFileSystemWatcherBatchEvent&);
+
+#define wxFileSystemWatcherBatchEventHandler(func) \
+    wxEVENT_HANDLER_CAST(wxFileSystemWatcherBatchEventFunction, func)
+
+#define EVT_FSWATCHER_BATCH(winid, func) \
+    wx__DECLARE_EVT1(wxEVT_FSWATCHER_BATCH, winid, \
+                     wxFileSystemWatcherBatchEventHandler(func))
+
 // ----------------------------------------------------------------------------
 // wxFileSystemWatcherBase: interface for wxFileSystemWatcher
 // ----------------------------------------------------------------------------
@@ -287,6 +359,10 @@ using wxFSWatchInfoMap = std::unordered_map<wxString, wxFSWatchInfo>;
  */
 class wxFSWatcherImpl;
 
+// Private helpers used by wxFileSystemWatcherBase.
+class wxFSWEventCoalescer;
+class wxFSWTreeScanner;
+
 /**
  * Main entry point for clients interested in file system events.
  * Defines interface that can be used to receive that kind of events.
@@ -316,6 +392,14 @@ public:
     virtual bool AddTree(const wxFileName& path, int events = wxFSW_EVENT_ALL,
                          const wxString& filespec = wxEmptyString);
 
+    /**
+     * Same as AddTree(), but the tree is scanned in a background thread and
+     * its subdirectories are added to the watched paths progressively.
+     * wxEVT_FSWATCHER_TREE_ADDED is sent once all of them have been added.
+     */
+    bool AddTreeAsync(const wxFileName& path, int events = wxFSW_EVENT_ALL,
+                      const wxString& filespec = wxEmptyString);
+
     /**
      * Removes path from the list of watched paths.
      */
@@ -359,6 +443,15 @@ public:
             m_owner = handler;
     }
 
+    /**
+     * If the interval is positive, the events are accumulated during this
+     * interval and sent as a single wxEVT_FSWATCHER_BATCH event instead of
+     * being sent individually, merging the redundant events together.
+     */
+    void SetCoalescingInterval(int milliseconds);
+
+    int GetCoalescingInterval() const;
+
 
     // This is a semi-private function used by wxWidgets itself only.
     //
@@ -367,7 +460,23 @@ public:
     bool AddAny(const wxFileName& path, int events, wxFSWPathType type,
                 const wxString& filespec = wxString());
 
+    // This is a semi-private function used by wxWidgets itself only.
+    //
+    // Sends the event to the owner or adds it to the current batch if the
+    // events are being coalesced.
+    void SendEvent(wxFileSystemWatcherEvent& event);
+
+    // This is a semi-private function used by wxWidgets itself only.
+    //
+    // Called by wxFSWTreeScanner in the main thread to add the directories
+    // found during the scan with the given ID, which is finished if "done".
+    void OnTreeScanned(int scanId, const std::vector<wxString>& dirs, bool done);
+
 protected:
+    // Cancel the scan of the tree rooted at the given path, if any, and
+    // return true if there was one, or cancel all of them if path is empty.
+    bool CancelTreeScans(const wxString& path = wxString());
+
 
     static wxString GetCanonicalPath(const wxFileName& path)
     {
@@ -379,6 +488,10 @@ protected:
     wxFSWatcherImpl* m_service;     // file system events service
     wxEvtHandler* m_owner;             // handler for file system events
 
+    wxFSWEventCoalescer* m_coalescer;  // non-null if coalescing events
+    std::vector<wxFSWTreeScanner*> m_treeScanners; // running async scans
+    int m_lastScanId;                  // last ID used for a tree scan
+
     friend class wxFSWatcherImpl;
 };
 
@@ -379,6 +379,15 @@ private:
     void InvalidateColBestWidth(int idx);
     void UpdateColWidths();
 
+    // update the best width of the given column, or of all of them, after a
+    // change to the item at the given row
+    void UpdateColBestWidth(int idx, unsigned int row, const wxDataViewItem& item);
+    void UpdateColBestWidths(unsigned int row, const wxDataViewItem& item);
+
+    // measure some of the rows not taken into account when computing the
+    // best column widths
+    void RefineColBestWidths();
+
     void DoClearColumns();
 
     wxVector<wxDataViewColumn*> m_cols;
@@ -386,15 +395,23 @@ private:
     // respective columns from m_cols and the arrays have same size
     struct CachedColWidthInfo
     {
-        CachedColWidthInfo() : width(0), dirty(true) {}
+        CachedColWidthInfo()
+            : width(0), dirty(true), refineFrom(0), refineTo(0) {}
         int width;  // cached width or 0 if not computed
         bool dirty; // column was invalidated, header needs updating
+        wxDataViewItem widestItem; // item defining the width, if any
+        // range of rows which were not all measured when computing the width
+        unsigned int refineFrom,
+                     refineTo;
     };
     wxVector<CachedColWidthInfo> m_colsBestWidths;
     // This indicates that at least one entry in m_colsBestWidths has 'dirty'
     // flag set. It's cheaper to check one flag in OnInternalIdle() than to
     // iterate over m_colsBestWidths to check if anything needs to be done.
     bool                      m_colsDirty;
+    // Similar flag indicating that at least one entry in m_colsBestWidths
+    // has a non-empty range of rows to refine.
+    bool                      m_colsRefine;
 
     wxDataViewModelNotifier  *m_notifier;
     wxDataViewMainWindow     *m_clientArea;
@@ -93,6 +93,7 @@ enum wxGridRenderStyle
 
 class WXDLLIMPEXP_FWD_CORE wxGrid;
 class WXDLLIMPEXP_FWD_CORE wxGridCellAttr;
+class WXDLLIMPEXP_FWD_CORE wxGridBlockCoords;
 class WXDLLIMPEXP_FWD_CORE wxGridCellAttrProviderData;
 class WXDLLIMPEXP_FWD_CORE wxGridColLabelWindow;
 class WXDLLIMPEXP_FWD_CORE wxGridCornerLabelWindow;
@@ -120,6 +121,7 @@ class wxGridOperations;
 class wxGridRowOperations;
 class wxGridColumnOperations;
 class wxGridDirectionOperations;
+class wxGridTileCache;
 
 #if wxUSE_ACCESSIBILITY
 class WXDLLIMPEXP_FWD_CORE wxGridAccessible;
@@ -984,6 +986,14 @@ public:
     virtual void SetRowAttr(wxGridCellAttr *attr, int row);
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    // set the attribute shared by all cells of the given block
+    virtual void SetAttrRange(wxGridCellAttr *attr,
+                              const wxGridBlockCoords& block);
+
+    // return true if the cell uses the attribute set by SetAttrRange() for
+    // the block containing it
+    bool UsesAttrRange(int row, int col) const;
+
     // these functions must be called whenever some rows/cols are deleted
     // because the internal data must be updated then
     void UpdateAttrRows( size_t pos, int numRows );
@@ -1377,6 +1387,8 @@ public:
     virtual void SetAttr(wxGridCellAttr* attr, int row, int col);
     virtual void SetRowAttr(wxGridCellAttr *attr, int row);
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
+    virtual void SetAttrRange(wxGridCellAttr* attr,
+                              const wxGridBlockCoords& block);
 
 private:
     wxGrid * m_view;
@@ -1684,6 +1696,7 @@ public:
     bool IsFrozen() const;
 
     void DrawGridCellArea( wxDC& dc , const wxGridCellCoordsVector& cells );
+    void DrawCachedGridCellArea( wxDC& dc, const wxGridCellCoordsVector& cells );
     void DrawGridSpace( wxDC& dc, wxGridWindow *gridWindow );
     void DrawCellBorder( wxDC& dc, const wxGridCellCoords& );
     void DrawAllGridLines();
@@ -1790,6 +1803,11 @@ public:
     //
     void     ForceRefresh();
 
+    // Keep the drawn blocks of cells as bitmaps and reuse them instead of
+    // drawing the cells again when possible.
+    void     EnableTileCache( bool enable = true );
+    bool     IsTileCacheEnabled() const { return m_tileCache != nullptr; }
+
 
     // ------ edit control functions
     //
@@ -2089,6 +2107,9 @@ public:
     void     SetRowAttr(int row, wxGridCellAttr *attr);
     void     SetColAttr(int col, wxGridCellAttr *attr);
 
+    // this sets the attribute shared by all cells of the block
+    void     SetAttrRange(const wxGridBlockCoords& block, wxGridCellAttr *attr);
+
     // the grid can cache attributes for the recently used cells (currently it
     // only caches one attribute for the most recently used one) and might
     // notice that its value in the attribute provider has changed -- if this
@@ -2591,6 +2612,10 @@ protected:
     bool m_usesOverlaySelection = true;
 #endif
 
+    // the bitmaps of the already drawn cells, only non-null if the tile cache
+    // is enabled
+    wxGridTileCache *m_tileCache;
+
     // NB: *never* access m_row/col arrays directly because they are created
     //     on demand, *always* use accessor functions instead!
 
@@ -2899,6 +2924,9 @@ protected:
     friend class wxGridHeaderColumn;
     friend class wxGridHeaderCtrl;
 
+    // it uses our private functions to find the positions of the cells
+    friend class wxGridTileCache;
+
 #if wxUSE_ACCESSIBILITY
     friend class wxGridAccessible;
     friend class wxGridCellAccessible;
@@ -2923,6 +2951,14 @@ private:
     // redraw the grid lines, should be called after changing their attributes
     void RedrawGridLines();
 
+    // forget the cached bitmaps of the cells which may have changed: all of
+    // them, those of the given cell, those in the given rows or those shown in
+    // the given rectangle of the grid window, in its client coordinates
+    void InvalidateTiles();
+    void InvalidateTiles(const wxGridCellCoords& coords);
+    void InvalidateRowsTiles(int topRow, int bottomRow);
+    void InvalidateTiles(const wxRect& rect, const wxGridWindow *gridWindow);
+
     // draw all grid lines in the given cell region (unlike the public
     // DrawAllGridLines() which just draws all of them)
     void DrawRangeGridLines(wxDC& dc, const wxRegion& reg,
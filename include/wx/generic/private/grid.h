@@ -18,6 +18,7 @@
 #include "wx/headerctrl.h"
 
 #ifndef WX_PRECOMP
+    #include "wx/bitmap.h"
     #include "wx/dc.h"
 #endif // WX_PRECOMP
 
@@ -28,6 +29,8 @@
 #include <iterator>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 // array classes
@@ -423,6 +426,9 @@ public:
 
     virtual void ScrollWindow( int dx, int dy, const wxRect *rect ) override;
 
+    virtual void Refresh( bool eraseBackground = true,
+                          const wxRect *rect = nullptr ) override;
+
     virtual bool AcceptsFocus() const override { return true; }
 
     wxGridWindowType GetType() const { return m_type; }
@@ -442,6 +448,91 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxGridWindow);
 };
 
+// ----------------------------------------------------------------------------
+// wxGridTileCache: bitmaps with the already drawn blocks of cells
+// ----------------------------------------------------------------------------
+
+// This class is used by wxGrid when EnableTileCache() had been called to keep
+// the results of drawing the blocks of cells, called tiles, as bitmaps, so
+// that redrawing them, e.g. when scrolling back to them, only needs to draw
+// these bitmaps instead of calling the cell renderers again.
+//
+// Tiles are identified by the positions, and not indices, of their rows and
+// columns divided by TILE_ROWS and TILE_COLS and use logical coordinates, so
+// they remain valid when the grid is scrolled. The tiles whose rows or columns
+// were resized or moved since they were drawn are drawn again automatically,
+// but the grid must invalidate the tiles whose cells may have changed.
+class wxGridTileCache
+{
+public:
+    // The number of rows and columns in a tile.
+    static constexpr int TILE_ROWS = 16;
+    static constexpr int TILE_COLS = 4;
+
+    // The maximal total area of all tiles, as a multiple of the grid client
+    // area: the tiles drawn the longest time ago are removed if it's exceeded.
+    static constexpr int MAX_WINDOW_AREAS = 4;
+
+    explicit wxGridTileCache(wxGrid *grid) : m_grid(grid) { }
+
+    // Draw the tiles containing all the given cells on the given DC, which
+    // must use the same logical coordinates as the grid windows.
+    void Draw(wxDC& dc, const wxGridCellCoordsVector& cells);
+
+    // Forget all the tiles.
+    void Invalidate() { m_tiles.clear(); }
+
+    // Forget the tiles intersecting the given band of rows, in logical
+    // coordinates: notice that this includes the tiles in all columns, as the
+    // cells may overflow into the tiles to their right. The tiles which must
+    // be drawn again because their rows or columns changed are forgotten too.
+    void InvalidateBand(int top, int bottom);
+
+private:
+    struct Tile
+    {
+        // The indices and logical coordinates of the rows and columns of the
+        // tile when it was drawn, see GetLayout().
+        std::vector<int> layout;
+
+        // The logical rectangle covered by the tile.
+        wxRect rect;
+
+        wxBitmap bitmap;
+
+        // The value of m_drawCount when the tile was drawn the last time.
+        unsigned long lastDrawn = 0;
+    };
+
+    using Tiles = std::unordered_map<wxUint64, Tile>;
+
+    static wxUint64 MakeKey(int rowBlock, int colBlock)
+    {
+        return (wxUint64(wxUint32(rowBlock)) << 32) | wxUint32(colBlock);
+    }
+
+    // Return the current layout of the tile with the given key, i.e. the
+    // indices of its rows and columns and their coordinates, and also fill
+    // the provided rectangle with its current extent.
+    std::vector<int> GetLayout(wxUint64 key, wxRect& rect) const;
+
+    // Draw the cells of the tile into its bitmap.
+    void DrawTile(Tile& tile, wxUint64 key, double scale) const;
+
+    // Remove the tiles not used by the last Draw() call, starting with the
+    // least recently used ones, while their total area exceeds the limit.
+    void Shrink();
+
+    wxGrid* const m_grid;
+
+    Tiles m_tiles;
+
+    // Incremented by each Draw() call.
+    unsigned long m_drawCount = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTileCache);
+};
+
 // ----------------------------------------------------------------------------
 // the internal data representation used by wxGridCellAttrProvider
 // ----------------------------------------------------------------------------
@@ -457,6 +548,9 @@ public:
     void UpdateAttrRows( size_t pos, int numRows );
     void UpdateAttrCols( size_t pos, int numCols );
 
+    // remove the attributes of all cells inside the given block
+    void RemoveAttrs(const wxGridBlockCoords& block);
+
 private:
     // Tries to search for the attr for given cell.
     wxGridCoordsToAttrMap::iterator FindIndex(int row, int col) const;
@@ -464,6 +558,82 @@ private:
     mutable wxGridCoordsToAttrMap m_attrs;
 };
 
+// this class stores attributes set for blocks of cells as sorted and
+// non-overlapping bands of rows, each containing sorted and non-overlapping
+// intervals of columns using the same attribute, so that lookup is
+// logarithmic in the number of bands and intervals: setting the attribute of
+// a block, or removing it, splits, replaces or removes the parts of the
+// existing bands and intervals it covers and merges the identical adjacent
+// ones, so the number of them only depends on the shape of the attributed
+// area and not on the number of changes made to it
+class WXDLLIMPEXP_ADV wxGridCellAttrRangeData
+{
+public:
+    wxGridCellAttrRangeData() = default;
+    ~wxGridCellAttrRangeData();
+
+    bool IsEmpty() const { return m_bands.empty(); }
+
+    // return the number of column intervals in all bands, i.e. the number of
+    // rectangular blocks used to store all the attributes
+    size_t GetCount() const;
+
+    // set the attribute for all cells of the block, or remove their
+    // attributes if it is null, takes ownership of the pointer
+    void SetAttr(wxGridCellAttr *attr, const wxGridBlockCoords& block);
+    wxGridCellAttr *GetAttr(int row, int col) const;
+    void UpdateAttrRows( size_t pos, int numRows );
+    void UpdateAttrCols( size_t pos, int numCols );
+
+private:
+    // the columns from first to last, inclusive, use the given attribute, to
+    // which we hold a reference
+    struct Interval
+    {
+        int first;
+        int last;
+        wxGridCellAttr *attr;
+    };
+
+    using Intervals = std::vector<Interval>;
+
+    // all rows from first to last, inclusive, use the same intervals, which
+    // are never empty
+    struct Band
+    {
+        int first;
+        int last;
+        Intervals intervals;
+    };
+
+    // make a band start at the given row, splitting the band containing it if
+    // necessary, and return the index of the first band starting at or after
+    // this row
+    size_t SplitBands(int row);
+
+    // remove the empty bands and merge the adjacent identical ones in the
+    // given range of indices, also comparing the first band with the one
+    // before it
+    void NormalizeBands(size_t from, size_t to);
+
+    // set the attribute, which may be null, for the given columns in the
+    // intervals, taking ownership of it
+    static void SetIntervalsAttr(Intervals& intervals,
+                                 int first, int last,
+                                 wxGridCellAttr *attr);
+
+    // merge the adjacent intervals using the same attribute in the given
+    // range of indices, also comparing the first one with the one before it
+    static void NormalizeIntervals(Intervals& intervals, size_t from, size_t to);
+
+    static void DecRefIntervals(const Intervals& intervals);
+
+    // bands sorted by their rows
+    std::vector<Band> m_bands;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrRangeData);
+};
+
 // this class stores attributes set for rows or columns
 class WXDLLIMPEXP_ADV wxGridRowOrColAttrData
 {
@@ -477,16 +647,34 @@ public:
     void UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols );
 
 private:
+    // return the index of the first element of m_rowsOrCols which is not
+    // less than the given value
+    size_t LowerBound(int rowOrCol) const;
+
+    // these arrays are kept sorted by row or column to allow using binary
+    // search in them
     wxArrayInt m_rowsOrCols;
     wxArrayAttrs m_attrs;
 };
 
-// NB: this is just a wrapper around 3 objects: one which stores cell
-//     attributes, and 2 others for row/col ones
+// NB: this is just a wrapper around 4 objects: two which store attributes of
+//     individual cells and of blocks of them, and 2 others for row/col ones
 class WXDLLIMPEXP_ADV wxGridCellAttrProviderData
 {
 public:
+    // return the attribute set for this cell individually or as part of a
+    // block of cells
+    wxGridCellAttr *GetCellAttr(int row, int col) const
+    {
+        wxGridCellAttr *attr = m_cellAttrs.GetAttr(row, col);
+        if ( !attr && !m_cellRangeAttrs.IsEmpty() )
+            attr = m_cellRangeAttrs.GetAttr(row, col);
+
+        return attr;
+    }
+
     wxGridCellAttrData m_cellAttrs;
+    wxGridCellAttrRangeData m_cellRangeAttrs;
     wxGridRowOrColAttrData m_rowAttrs,
                            m_colAttrs;
 };
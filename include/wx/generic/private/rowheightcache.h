@@ -10,72 +10,9 @@
 #ifndef _WX_PRIVATE_ROWHEIGHTCACHE_H_
 #define _WX_PRIVATE_ROWHEIGHTCACHE_H_
 
-#include <unordered_map>
+#include <map>
 #include <vector>
 
-// struct describing a range of rows which contains rows <from> .. <to-1>
-struct RowRange
-{
-    unsigned int from;
-    unsigned int to;
-};
-
-/**
-    A helper class that manages a set of RowRange objects.
-
-    It stores the indices that are members of a group in a memory
-    efficient way.
-*/
-class WXDLLIMPEXP_CORE RowRanges
-{
-public:
-    /**
-        Adds a row index to this group by adding it to an existing RowRange
-        or by creating a new one.
-    */
-    void Add(unsigned int row);
-
-    /**
-        Removes a row index and all indices after idx from this group.
-    */
-    void Remove(unsigned int row);
-
-    /**
-        Checks whether a row index is contained in this group.
-    */
-    bool Has(unsigned int row) const;
-
-    /**
-        Returns the number of row indices that are contained in this group.
-    */
-    unsigned int CountAll() const;
-
-    /**
-        Returns the number of rows that are in this group before the given row
-        index.
-
-        Not that this doesn't include the given row.
-    */
-    unsigned int CountTo(unsigned int row) const;
-
-    /**
-        Returns the size of the range.
-
-        This is only used for testing and debugging.
-     */
-    unsigned int GetSize() const { return m_ranges.size(); }
-
-private:
-    std::vector<RowRange> m_ranges;
-
-    /**
-        If a new row index was inserted, Cleanup() checks if the neighbour
-        ranges of idx can includes the same row indices and discards
-        unnecessary RowRange objects.
-    */
-    void CleanUp(unsigned int idx);
-};
-
 /**
     HeightCache implements a cache mechanism for wxDataViewCtrl.
 
@@ -84,46 +21,41 @@ private:
     * the y-coordinate where a row starts (GetLineStart)
     * and vice versa (GetLineAt)
 
-    The layout of the cache is a hashmap where the keys are all existing row
-    heights in pixels. The values are RowRange objects that represent all rows
-    having the specified height.
+    The heights of all rows are stored in a vector, with the rows whose height
+    is not known yet using -1 as height. Additionally, a Fenwick tree (also
+    known as binary indexed tree) of the heights is maintained, in which the
+    rows with unknown height are counted as having 0 height. This allows to
+    compute the sum of heights of the first N rows in O(log N) time, while
+    still allowing to change the height of any row in O(log N) too.
 
-    An example:
-    @code
-    {
-    22: RowRange([0..10], [15..17], [20..2000]),
-    42: RowRange([11..12], [18..18]),
-    62: RowRange([13..14], [19..19])
-    }
-    @endcode
+    Only the y-coordinates of the rows in the initial part of the control in
+    which the heights of all rows are known can be found in the cache.
+
+    The heights of the rows far beyond the end of the vector are stored in a
+    separate map instead of extending the vector and the tree up to them, to
+    avoid allocating memory for all the preceding rows, whose heights may
+    never be needed, when the control is scrolled far down.
 
     Examples
     ========
 
     GetLineStart
     ------------
-    To retrieve the y-coordinate of item 1000 it is necessary to look into
-    each key of the hashmap *m_heightToRowRange*. Get the row count of
-    indices lower than 1000 (RowRange::CountTo) and multiplies it which the
-    according height.
-
-    RowRange([0..10], [15..17], [20..2000]).CountTo(1000)
-    --> 0..10 are 11 items, 15..17 are 3 items and 20..1000 are 980 items (1000-20)
-    = 11 + 3 + 980 = 994 items
-
-    GetLineStart(1000) --> (22 * 994) + (42 * 3) + (62 * 3) = 22180
+    To retrieve the y-coordinate of item 1000, compute the sum of the first
+    1000 heights using the tree: this requires adding at most log2(1000) = 10
+    tree elements, e.g. for 1000 = 0b1111101000 the elements with indices
+    0b1000000000, 0b1100000000, 0b1110000000, 0b1111000000, 0b1111100000 and
+    0b1111101000 are added.
 
     GetLineHeight
     -------------
-    To retrieve the line height look into each key and check if row is
-    contained in RowRange (RowRange::Has)
+    Simply return the stored height of the row.
 
     GetLineAt
     ---------
-    To retrieve the row that starts at a specific y-coordinate.
-    Look into each key and count all rows.
-    Use bisect algorithm in combination with GetLineStart() to
-    find the appropriate item
+    To retrieve the row that contains the given y-coordinate, descend the
+    tree starting from the largest power of 2 and keep moving right while the
+    sum of heights doesn't exceed y. This also takes O(log N) time.
 */
 class WXDLLIMPEXP_CORE HeightCache
 {
@@ -134,6 +66,12 @@ public:
     bool GetLineAt(int y, unsigned int& row);
     bool GetLineInfo(unsigned int row, int &start, int &height);
 
+    /**
+        Returns the number of rows at the beginning for which the heights are
+        all known and fills the total height of these rows.
+    */
+    unsigned int GetKnownRows(int& height) const;
+
     void Put(unsigned int row, int height);
 
     /**
@@ -145,9 +83,31 @@ public:
     void Clear();
 
 private:
-    using HeightToRowRangesMap = std::unordered_map<int, RowRanges>;
+    // Return the sum of heights of the first count rows.
+    int GetSumOfFirst(unsigned int count) const;
+
+    // Add a new row to the end of the cache.
+    void Append(int height);
+
+    // Append the rows from m_farHeights immediately following the end of the
+    // vector, if any.
+    void AppendFarRows();
+
+    // Heights of all rows or -1 for the rows with unknown height.
+    std::vector<int> m_heights;
+
+    // Fenwick tree of heights using 1-based indices: the element with index i
+    // contains the sum of heights of rows in [i - (i & -i), i) range. Its size
+    // is always one more than that of m_heights and its first element is
+    // unused.
+    std::vector<int> m_tree = std::vector<int>(1);
+
+    // Heights of the rows too far after the end of m_heights to add them
+    // there, indexed by row.
+    std::map<unsigned int, int> m_farHeights;
 
-    HeightToRowRangesMap m_heightToRowRange;
+    // Number of rows at the beginning with known heights.
+    unsigned int m_knownRows = 0;
 };
 
 
@@ -26,7 +26,9 @@ public:
     // column of which calculate the width
     explicit wxMaxWidthCalculatorBase(size_t column)
         : m_column(column),
-          m_width(0)
+          m_width(0),
+          m_skippedFrom(0),
+          m_skippedTo(0)
     {
     }
 
@@ -41,6 +43,18 @@ public:
     int GetMaxWidth() const { return m_width; }
     size_t GetColumn() const { return m_column; }
 
+    // Return true if not all rows were measured by ComputeBestColumnWidth()
+    // and fill in the range of rows only some of which were measured.
+    bool GetSkippedRows(size_t* from, size_t* to) const
+    {
+        if ( m_skippedFrom == m_skippedTo )
+            return false;
+
+        *from = m_skippedFrom;
+        *to = m_skippedTo;
+        return true;
+    }
+
     void
     ComputeBestColumnWidth(size_t count,
                            size_t first_visible,
@@ -49,17 +63,20 @@ public:
         // The code below deserves some explanation. For very large controls, we
         // simply can't afford to calculate sizes for all items, it takes too
         // long. So the best we can do is to check the first and the last N/2
-        // items in the control for some sufficiently large N and calculate best
-        // sizes from that. That can result in the calculated best width being too
-        // small for some outliers, but it's better to get slightly imperfect
-        // result than to wait several seconds after every update. To avoid highly
+        // items in the control for some sufficiently large N, as well as N/2
+        // items spread over all the other ones, and calculate best sizes from
+        // that. That can result in the calculated best width being too small
+        // for some outliers, but it's better to get slightly imperfect result
+        // than to wait several seconds after every update. To avoid highly
         // visible miscalculations, we also include all currently visible items
         // no matter what.  Finally, the value of N is determined dynamically by
         // measuring how much time we spent on the determining item widths so far.
 
 #if wxUSE_STOPWATCH
         size_t top_part_end = count;
-        static const long CALC_TIMEOUT = 20/*ms*/;
+        // this is the time for the top part only, the bottom and the middle
+        // ones take approximately the same time
+        static const long CALC_TIMEOUT = 10/*ms*/;
         // don't call wxStopWatch::Time() too often
         static const unsigned CALC_CHECK_FREQ = 100;
         wxStopWatch timer;
@@ -92,6 +109,24 @@ public:
                 UpdateWithRow(row);
             }
 
+            // then N/2 items from the middle part, taking one item from each
+            // of N/2 equal intervals, at a pseudo-random position in it to
+            // avoid being affected by any periodicity in the items:
+            const size_t middle_count = bottom_part_start - top_part_end;
+            const size_t samples = wxMin(top_part_end, middle_count);
+            if ( samples )
+            {
+                const size_t stride = middle_count / samples;
+                for ( size_t n = 0; n < samples; n++ )
+                {
+                    UpdateWithRow(top_part_end + n*stride +
+                                    (n*2654435761u) % stride);
+                }
+            }
+
+            m_skippedFrom = top_part_end;
+            m_skippedTo = bottom_part_start;
+
             // finally, include currently visible items in the calculation:
             first_visible = wxMax(first_visible, top_part_end);
             last_visible = wxMin(bottom_part_start, last_visible);
@@ -102,10 +137,12 @@ public:
             }
 
             wxLogTrace("items container",
-                       "determined best size from %zu top, %zu bottom "
-                       "plus %zu more visible items out of %zu total",
+                       "determined best size from %zu top, %zu bottom, "
+                       "%zu sampled plus %zu more visible items out of "
+                       "%zu total",
                        top_part_end,
                        count - bottom_part_start,
+                       samples,
                        last_visible - first_visible,
                        count);
         }
@@ -115,6 +152,10 @@ private:
     const size_t m_column;
     int m_width;
 
+    // Range of rows not all of which were measured.
+    size_t m_skippedFrom,
+           m_skippedTo;
+
     wxDECLARE_NO_COPY_CLASS(wxMaxWidthCalculatorBase);
 };
 
@@ -19,6 +19,8 @@
 #include "wx/animdecod.h"
 #include "wx/dynarray.h"
 
+#include <vector>
+
 // internal utility used to store a frame in 8bit-per-pixel format
 class GIFImage;
 
@@ -52,7 +54,9 @@ public:
     wxGIFDecoder();
     ~wxGIFDecoder();
 
-    // get data of current frame
+    // get data of current frame, notice that when decoding on demand, the
+    // pointer returned by GetData() is only valid until it is called for
+    // another frame
     unsigned char* GetData(unsigned int frame) const;
     unsigned char* GetPalette(unsigned int frame) const;
     unsigned int GetNcolours(unsigned int frame) const;
@@ -71,12 +75,22 @@ public:
     // load function which returns more info than just Load():
     wxGIFErrorCode LoadGIF( wxInputStream& stream );
 
+    // by default all frames are decoded by LoadGIF(), but if this is set to
+    // true before calling it, only their compressed data is kept in memory
+    // and each frame is decoded when it's accessed, with only the last
+    // accessed frame being kept in decoded form
+    void SetDecodeOnDemand(bool onDemand) { m_decodeOnDemand = onDemand; }
+
     // free all internal frames
     void Destroy();
 
-    // implementation of wxAnimationDecoder's pure virtuals
+    // implementation of wxAnimationDecoder's pure virtuals: wxAnimation only
+    // needs a single frame at a time, so frames are decoded on demand for it
     virtual bool Load( wxInputStream& stream ) override
-        { return LoadGIF(stream) == wxGIF_OK; }
+    {
+        SetDecodeOnDemand(true);
+        return LoadGIF(stream) == wxGIF_OK;
+    }
 
     bool ConvertToImage(unsigned int frame, wxImage *image) const override;
 
@@ -91,20 +105,35 @@ protected:
         // modifies current stream position (see wxAnimationDecoder::CanRead)
 
 private:
-    int getcode(wxInputStream& stream, int bits, int abfin);
+    int getcode(wxInputStream& stream, int bits, int abfin) const;
     wxGIFErrorCode dgif(wxInputStream& stream,
-                        GIFImage *img, int interl, int bits);
+                        GIFImage *img, int interl, int bits) const;
+
+    // append the data sub-blocks of the current frame to m_compressed
+    void ReadDataBlocks(wxInputStream& stream);
+
+    // decode the given frame if it's not decoded yet, freeing the previously
+    // decoded one, only used when decoding on demand
+    bool DecodeFrame(unsigned int frame) const;
 
 
     // array of all frames
     wxArrayPtrVoid m_frames;
 
+    // compressed data of all frames when decoding them on demand
+    std::vector<unsigned char> m_compressed;
+
+    // the currently decoded frame when decoding on demand or m_nFrames
+    mutable unsigned int m_decodedFrame;
+
+    bool m_decodeOnDemand;
+
     // decoder state vars
-    int           m_restbits;       // remaining valid bits
-    unsigned int  m_restbyte;       // remaining bytes in this block
-    unsigned int  m_lastbyte;       // last byte read
-    unsigned char m_buffer[256];    // buffer for reading
-    unsigned char *m_bufp;          // pointer to next byte in buffer
+    mutable int           m_restbits;       // remaining valid bits
+    mutable unsigned int  m_restbyte;       // remaining bytes in this block
+    mutable unsigned int  m_lastbyte;       // last byte read
+    mutable unsigned char m_buffer[256];    // buffer for reading
+    mutable unsigned char *m_bufp;          // pointer to next byte in buffer
 
     wxDECLARE_NO_COPY_CLASS(wxGIFDecoder);
 };
@@ -75,6 +75,7 @@ public:
     wxBitmap( const wxString &filename, wxBitmapType type = wxBITMAP_DEFAULT_TYPE );
 #if wxUSE_IMAGE
     wxBitmap(const wxImage& image, int depth = wxBITMAP_SCREEN_DEPTH, double scale = 1.0);
+    wxBitmap(wxImage&& image, int depth = wxBITMAP_SCREEN_DEPTH, double scale = 1.0);
     wxBitmap(const wxImage& image, const wxDC& dc);
 #endif // wxUSE_IMAGE
     wxBitmap(GdkPixbuf* pixbuf, int depth = 0);
@@ -148,8 +149,13 @@ public:
 
 protected:
 #if wxUSE_IMAGE
+#ifdef __WXGTK3__
+    // If canShareData is true, the image data may be used by the bitmap
+    // directly instead of being copied.
+    void InitFromImage(const wxImage& image, int depth, double scale,
+                       bool canShareData = false);
+#else
     void InitFromImage(const wxImage& image, int depth, double scale);
-#ifndef __WXGTK3__
     bool CreateFromImage(const wxImage& image, int depth);
 #endif
 #endif // wxUSE_IMAGE
@@ -20,6 +20,8 @@
 #include "wx/arrstr.h"
 #include "wx/variant.h"
 
+#include <vector>
+
 #if wxUSE_STREAMS
 #  include "wx/stream.h"
 #endif
@@ -43,6 +45,11 @@
 #define wxIMAGE_OPTION_ORIGINAL_WIDTH        wxString(wxS("OriginalWidth"))
 #define wxIMAGE_OPTION_ORIGINAL_HEIGHT       wxString(wxS("OriginalHeight"))
 
+#define wxIMAGE_OPTION_REGION_X              wxString(wxS("RegionX"))
+#define wxIMAGE_OPTION_REGION_Y              wxString(wxS("RegionY"))
+#define wxIMAGE_OPTION_REGION_WIDTH          wxString(wxS("RegionWidth"))
+#define wxIMAGE_OPTION_REGION_HEIGHT         wxString(wxS("RegionHeight"))
+
 // constants used with wxIMAGE_OPTION_RESOLUTIONUNIT
 //
 // NB: don't change these values, they correspond to libjpeg constants
@@ -464,6 +471,12 @@ public:
     void SetLoadFlags(int flags);
     int GetLoadFlags() const;
 
+    // Set the number of threads used for processing the image pixels, 0 means
+    // to use as many threads as there are CPUs and 1, which is the default,
+    // to not use any additional threads.
+    static void SetParallelism(int numThreads);
+    static int GetParallelism();
+
     static bool CanRead( const wxString& name );
     static int GetImageCount( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
@@ -655,6 +668,77 @@ extern void WXDLLIMPEXP_CORE wxInitAllImageHandlers();
 
 extern WXDLLIMPEXP_DATA_CORE(wxImage)    wxNullImage;
 
+//-----------------------------------------------------------------------------
+// wxImagePipeline: applies several operations to an image at once
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImagePipeline
+{
+public:
+    explicit wxImagePipeline(const wxImage& image);
+
+    // Geometric transformations.
+    wxImagePipeline& GetSubImage(const wxRect& rect);
+    wxImagePipeline& Mirror(bool horizontally = true);
+    wxImagePipeline& Rotate90(bool clockwise = true);
+    wxImagePipeline& Rotate180();
+    wxImagePipeline& Scale(int width, int height,
+                           wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL);
+
+    // Colour transformations.
+    wxImagePipeline& ConvertToGreyscale(double weight_r = 0.299,
+                                        double weight_g = 0.587,
+                                        double weight_b = 0.114);
+    wxImagePipeline& ConvertToDisabled(unsigned char brightness = 255);
+    wxImagePipeline& ChangeLightness(int alpha);
+    wxImagePipeline& ChangeHSV(double angleH, double factorS, double factorV);
+
+    // Return the size of the image which will be produced by Execute().
+    wxSize GetSize() const { return m_size; }
+
+    // Perform all the operations and return the resulting image.
+    wxImage Execute() const;
+
+private:
+    // All operations added to the pipeline.
+    struct Operation
+    {
+        enum Type
+        {
+            Op_SubImage,
+            Op_Mirror,
+            Op_Rotate90,
+            Op_Rotate180,
+            Op_Scale,
+            Op_Greyscale,
+            Op_Disabled,
+            Op_Lightness,
+            Op_HSV
+        };
+
+        explicit Operation(Type type_) : type(type_) { }
+
+        Type type;
+        wxRect rect;
+        int param = 0;
+        double values[3] = { 0.0, 0.0, 0.0 };
+    };
+
+    // Apply the given colour transformation to count pixels, skipping the
+    // ones of the mask colour if mask is non-null and the operation doesn't
+    // apply to them.
+    static void ApplyColourOp(const Operation& op,
+                              unsigned char* rgb,
+                              int count,
+                              const unsigned char* mask);
+
+    const wxImage m_image;
+    std::vector<Operation> m_ops;
+
+    // Size of the image after applying all operations in m_ops.
+    wxSize m_size;
+};
+
 //-----------------------------------------------------------------------------
 // wxImage handlers
 //-----------------------------------------------------------------------------
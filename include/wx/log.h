@@ -422,6 +422,10 @@ public:
         return IsEnabled() && level <= GetComponentLevel(component);
     }
 
+    // overload taking ASCII component name which avoids creating a wxString
+    // from it if no component levels were set, which is the common case
+    static bool IsLevelEnabled(wxLogLevel level, const char* component);
+
 
     // enable/disable messages at wxLOG_Verbose level (only relevant if the
     // current log level is greater or equal to it)
@@ -607,6 +611,13 @@ protected:
     // nothing otherwise; return the old value of repetition counter
     unsigned LogLastRepeatIfNeeded();
 
+    // override this to return true if DoLogRecord() can be called from any
+    // thread concurrently: in this case the messages logged by the other
+    // threads are passed to this target directly instead of being buffered
+    // until FlushActive() is called from the main thread, but repetition
+    // counting is not supported for it
+    virtual bool IsThreadSafe() const { return false; }
+
 private:
 #if wxUSE_THREADS
     // called from FlushActive() to really log any buffered messages logged
@@ -734,6 +745,53 @@ protected:
 
 #endif // wxUSE_STD_IOSTREAM
 
+#if wxUSE_THREADS
+
+class wxLogAsyncFileImpl;
+
+// log everything to a file from a background thread: logging a message only
+// queues it in a per-thread buffer without any locking and the messages are
+// formatted and written to the file in batches by the background thread
+class WXDLLIMPEXP_BASE wxLogAsyncFile : public wxLog
+{
+public:
+    // log to the file with the given name, appending to it if it exists
+    explicit wxLogAsyncFile(const wxString& filename);
+
+    // log to the given FILE, stderr by default, which is not closed by us
+    explicit wxLogAsyncFile(FILE *fp = nullptr);
+
+    virtual ~wxLogAsyncFile();
+
+    // return false if the file couldn't be opened
+    bool IsOk() const;
+
+    // wake up the background thread to write the pending messages soon, but
+    // don't wait for it: this is called during idle time and must not block
+    virtual void Flush() override;
+
+    // wait until all the messages logged before calling it are written
+    void Sync();
+
+protected:
+    virtual bool IsThreadSafe() const override { return true; }
+
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info) override;
+    virtual void DoLogTextAtLevel(wxLogLevel level,
+                                  const wxString& msg) override;
+
+private:
+    wxLogAsyncFileImpl *m_impl;
+
+    friend class wxLogAsyncFileImpl;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsyncFile);
+};
+
+#endif // wxUSE_THREADS
+
 // ----------------------------------------------------------------------------
 // /dev/null log target: suppress logging until this object goes out of scope
 // ----------------------------------------------------------------------------
@@ -941,7 +999,7 @@ public:
     {
         // remember that fatal errors can't be disabled
         if ( m_level == wxLOG_FatalError ||
-                wxLog::IsLevelEnabled(m_level, wxASCII_STR(m_info.component)) )
+                wxLog::IsLevelEnabled(m_level, m_info.component) )
             DoCallOnLog(wxString::FormatV(format, argptr));
     }
 
@@ -1054,7 +1112,7 @@ public:
     template <typename... Targs>
     void LogAtLevel(wxLogLevel level, const wxString& format, Targs... args)
     {
-        if ( !wxLog::IsLevelEnabled(level, wxASCII_STR(m_info.component)) )
+        if ( !wxLog::IsLevelEnabled(level, m_info.component) )
             return;
 
         DoCallOnLog(level, wxString::Format(format, args...));
@@ -1062,7 +1120,7 @@ public:
 
     void LogAtLevel(wxLogLevel level, const wxString& s)
     {
-        if ( !wxLog::IsLevelEnabled(level, wxASCII_STR(m_info.component)) )
+        if ( !wxLog::IsLevelEnabled(level, m_info.component) )
             return;
 
         DoCallOnLog(level, s);
@@ -1189,7 +1247,7 @@ WXDLLIMPEXP_BASE wxString wxSysErrorMsgStr(unsigned long nErrCode = 0);
 
 // Macro evaluating to true if logging at the given level is enabled.
 #define wxLOG_IS_ENABLED(level) \
-    wxLog::IsLevelEnabled(wxLOG_##level, wxASCII_STR(wxLOG_COMPONENT))
+    wxLog::IsLevelEnabled(wxLOG_##level, wxLOG_COMPONENT)
 
 // Macro used to define most of the actual wxLogXXX() macros: just calls
 // wxLogger::Log(), if logging at the specified level is enabled.
@@ -49,6 +49,8 @@ protected:
     size_t OnSysRead(void *buffer, size_t nbytes) override;
     wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) override;
     wxFileOffset OnSysTell() const override;
+    const void *OnSysPeekSpan(size_t *size) override;
+    void OnSysSkipSpan(size_t size) override;
 
 private:
     // common part of ctors taking wxInputStream
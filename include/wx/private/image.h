@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/image.h
+// Purpose:     Private helpers for wxImage implementation
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGE_H_
+#define _WX_PRIVATE_IMAGE_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE
+
+#include "wx/image.h"
+
+#include <functional>
+
+// Function called with the range [from, to) of rows to process.
+using wxImageRowsFunc = std::function<void (int from, int to)>;
+
+// Call the given function for all rows of an image of the given size.
+//
+// If the image is big enough and wxImage::GetParallelism() is greater than 1,
+// the rows are split into bands which are processed in parallel by several
+// threads, so the function must only access the rows it is given. Otherwise
+// the function is just called once for all the rows in the current thread.
+// This is also the case if the threads are already used by another call to
+// this function, e.g. when it's called from the function passed to it.
+//
+// This function doesn't return before all rows have been processed.
+WXDLLIMPEXP_CORE void
+wxImageProcessRows(int width, int height, const wxImageRowsFunc& func);
+
+// Return true if the image is the only one using its data and this data is
+// owned by it, i.e. it's safe to keep using this data after destroying the
+// image as long as a copy of the image object itself is kept alive.
+WXDLLIMPEXP_CORE bool wxImageHasExclusiveData(const wxImage& image);
+
+// Options affecting the loading of the image.
+//
+// They must be retrieved before calling wxImage::Destroy(), which resets all
+// the options, in wxImageHandler::LoadFile().
+class wxImageLoadOptions
+{
+public:
+    explicit wxImageLoadOptions(const wxImage& image)
+        : m_maxWidth(image.GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH)),
+          m_maxHeight(image.GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT)),
+          m_region(image.GetOptionInt(wxIMAGE_OPTION_REGION_X),
+                   image.GetOptionInt(wxIMAGE_OPTION_REGION_Y),
+                   image.GetOptionInt(wxIMAGE_OPTION_REGION_WIDTH),
+                   image.GetOptionInt(wxIMAGE_OPTION_REGION_HEIGHT))
+    {
+    }
+
+    bool HasMaxSize() const { return m_maxWidth > 0 || m_maxHeight > 0; }
+
+    bool HasRegion() const { return m_region.width > 0 && m_region.height > 0; }
+
+    // Return the part of the image of the given size to load: this is the
+    // entire image if no region was specified or its intersection with the
+    // region otherwise, which may be empty.
+    wxRect GetRegion(const wxSize& size) const
+    {
+        const wxRect rectAll(size);
+        return HasRegion() ? m_region.Intersect(rectAll) : rectAll;
+    }
+
+    // Return the power of 2 by which the image of the given size must be
+    // scaled down to fit into the maximal size.
+    //
+    // The image is never scaled down to nothing, even if this means that it
+    // still doesn't fit, e.g. a very wide image is only scaled down until its
+    // height becomes 1.
+    int GetScaleDenom(const wxSize& size) const
+    {
+        int scale = 1;
+        while ( (m_maxWidth > 0 && size.x / scale > m_maxWidth) ||
+                    (m_maxHeight > 0 && size.y / scale > m_maxHeight) )
+        {
+            if ( size.x / (scale * 2) == 0 || size.y / (scale * 2) == 0 )
+                break;
+
+            scale *= 2;
+        }
+
+        return scale;
+    }
+
+private:
+    const int m_maxWidth,
+              m_maxHeight;
+
+    const wxRect m_region;
+};
+
+#endif // wxUSE_IMAGE
+
+#endif // _WX_PRIVATE_IMAGE_H_
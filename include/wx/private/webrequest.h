@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 class WXDLLIMPEXP_FWD_BASE wxURI;
 
@@ -122,6 +123,10 @@ public:
 
     wxEvtHandler* GetHandler() const { return m_handler; }
 
+    // Set the batch to notify when this request terminates, this is only done
+    // right before starting it.
+    void SetBatch(const wxWebRequestBatchImplPtr& batch) { m_batch = batch; }
+
 protected:
     wxString m_method;
     wxWebRequest::Storage m_storage = wxWebRequest::Storage_Memory;
@@ -206,9 +211,65 @@ private:
     // Initially false, set to true after the first call to Cancel().
     bool m_cancelled = false;
 
+    // The batch this request belongs to, if any. It is reset as soon as the
+    // request terminates to break the reference cycle.
+    wxWebRequestBatchImplPtr m_batch;
+
     wxDECLARE_NO_COPY_CLASS(wxWebRequestImpl);
 };
 
+// ----------------------------------------------------------------------------
+// wxWebRequestBatchImpl
+// ----------------------------------------------------------------------------
+
+class wxWebRequestBatchImpl : public wxRefCounterMT
+{
+public:
+    wxWebRequestBatchImpl(wxEvtHandler* handler, int id)
+        : m_handler(handler),
+          m_id(id)
+    {
+    }
+
+    ~wxWebRequestBatchImpl();
+
+    int GetId() const { return m_id; }
+
+    const std::vector<wxWebRequestImplPtr>& GetRequests() const
+        { return m_requests; }
+
+    size_t GetFinishedCount() const { return m_numFinished; }
+
+    size_t GetFailedCount() const { return m_numFailed; }
+
+    bool IsStarted() const { return m_started; }
+
+    void Add(const wxWebRequestImplPtr& request);
+
+    void Start();
+
+    void Cancel();
+
+    // Called by wxWebRequestImpl in the main thread after processing the
+    // event about switching to one of the final states.
+    void OnRequestFinished(wxWebRequest::State state);
+
+private:
+    wxEvtHandler* const m_handler;
+    const int m_id;
+
+    std::vector<wxWebRequestImplPtr> m_requests;
+
+    // Number of requests which terminated and, among them, those which didn't
+    // complete successfully.
+    size_t m_numFinished = 0,
+           m_numFailed = 0;
+
+    bool m_started = false;
+
+    wxDECLARE_NO_COPY_CLASS(wxWebRequestBatchImpl);
+};
+
 // ----------------------------------------------------------------------------
 // wxWebResponseImpl
 // ----------------------------------------------------------------------------
@@ -342,6 +403,16 @@ public:
 
     virtual bool EnablePersistentStorage(bool WXUNUSED(enable)) { return false; }
 
+    // Connection management options are only supported by some backends.
+    virtual bool SetMaxConnectionsPerHost(int WXUNUSED(count)) { return false; }
+    virtual bool SetMaxConnections(int WXUNUSED(count)) { return false; }
+    virtual bool SetConnectionCacheSize(int WXUNUSED(count)) { return false; }
+    virtual bool EnableMultiplexing(bool WXUNUSED(enable)) { return false; }
+
+    // Start all requests of a batch, which are all idle and belong to this
+    // session. The default implementation just starts them one by one.
+    virtual void StartRequests(const std::vector<wxWebRequestImplPtr>& requests);
+
 protected:
     explicit wxWebSessionImpl(Mode mode);
 
@@ -239,12 +239,26 @@ public:
         return (wxWebSessionHandle)m_handle;
     }
 
+    bool SetMaxConnectionsPerHost(int count) override;
+
+    bool SetMaxConnections(int count) override;
+
+    bool SetConnectionCacheSize(int count) override;
+
+    bool EnableMultiplexing(bool enable) override;
+
+    void StartRequests(const std::vector<wxWebRequestImplPtr>& requests) override;
+
     bool StartRequest(wxWebRequestCURL& request);
 
     void CancelRequest(wxWebRequestCURL* request);
 
     void RequestHasTerminated(wxWebRequestCURL* request);
 
+    // Return 1 or 0 if multiplexing was explicitly enabled or disabled or -1
+    // if EnableMultiplexing() wasn't called.
+    int GetMultiplexing() const { return m_multiplexing; }
+
 private:
     static int TimerCallback(CURLM*, long, void*);
     static int SocketCallback(CURL*, curl_socket_t, int, void*, void*);
@@ -259,6 +273,10 @@ private:
     void StopActiveTransfer(CURL*);
     void RemoveActiveSocket(CURL*);
 
+    // Set the option if the multi handle was already created or just return
+    // true if it wasn't, as the option will be set when it's created then.
+    bool SetMultiOption(CURLMoption option, long value);
+
     using TransferSet = std::unordered_map<CURL*, wxWebRequestCURL*>;
     using CurlSocketMap = std::unordered_map<CURL*, curl_socket_t>;
 
@@ -269,6 +287,15 @@ private:
     wxTimer m_timeoutTimer;
     CURLM* m_handle = nullptr;
 
+    // Connection options values or -1 if they were not set.
+    long m_maxHostConnections = -1;
+    long m_maxTotalConnections = -1;
+    long m_maxConnects = -1;
+    int m_multiplexing = -1;
+
+    // True while starting all requests of a batch.
+    bool m_startingBatch = false;
+
     wxDECLARE_NO_COPY_CLASS(wxWebSessionCURL);
 };
 
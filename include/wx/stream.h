@@ -171,6 +171,23 @@ public:
     bool Ungetch(char c);
 
 
+    // direct access to the data
+    // -------------------------
+
+    // return the pointer to the data which can be read from the stream
+    // without copying it, because it is already in memory, and fill size
+    // with its length or return nullptr if the stream doesn't support this
+    // (or if there is no more data in it)
+    //
+    // the data is not consumed by this function, call SkipSpan() to do it,
+    // and the returned pointer remains valid for the lifetime of the stream
+    const void *PeekSpan(size_t *size);
+
+    // consume the given number of bytes of the data returned by PeekSpan(),
+    // which must not be greater than the size returned by it
+    void SkipSpan(size_t size);
+
+
     // position functions
     // ------------------
 
@@ -198,6 +215,14 @@ protected:
     // read
     virtual size_t OnSysRead(void *buffer, size_t size) = 0;
 
+    // return the data available in memory, see PeekSpan(): the default
+    // implementation returns nullptr, streams overriding it must also
+    // override OnSysSkipSpan()
+    virtual const void *OnSysPeekSpan(size_t *size);
+
+    // consume the data returned by OnSysPeekSpan()
+    virtual void OnSysSkipSpan(size_t size);
+
     // write-back buffer support
     // -------------------------
 
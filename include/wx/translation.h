@@ -77,6 +77,7 @@ class WXDLLIMPEXP_FWD_BASE wxTranslationsLoader;
 class WXDLLIMPEXP_FWD_BASE wxLocale;
 
 class wxPluralFormsCalculator;
+class wxMsgCatalogFile;
 using wxPluralFormsCalculatorPtr = std::unique_ptr<wxPluralFormsCalculator>;
 
 // ----------------------------------------------------------------------------
@@ -108,6 +109,9 @@ protected:
     wxMsgCatalog(const wxString& domain);
 
 private:
+    // load all the messages from m_file into m_messages and close it
+    void LoadMessages();
+
     // variable pointing to the next element in a linked list (or nullptr)
     wxMsgCatalog *m_pNext;
     friend class wxTranslations;
@@ -116,6 +120,10 @@ private:
     wxString                m_domain;   // name of the domain
 
     wxPluralFormsCalculatorPtr m_pluralFormsCalculator;
+
+    // if not null, the messages are looked up in this file on demand instead
+    // of being stored in m_messages
+    std::unique_ptr<wxMsgCatalogFile> m_file;
 };
 
 // ----------------------------------------------------------------------------
@@ -167,6 +175,12 @@ public:
     // check if the given catalog is loaded
     bool IsLoaded(const wxString& domain) const;
 
+    // enable or disable looking up the strings in the catalog files on demand
+    // instead of loading all of them at once, affects the catalogs loaded
+    // after calling it only
+    void EnableLazyLoading(bool enable = true) { m_lazyLoading = enable; }
+    bool IsLazyLoadingEnabled() const { return m_lazyLoading; }
+
     // access to translations
     const wxString *GetTranslatedString(const wxString& origString,
                                         const wxString& domain = wxEmptyString,
@@ -212,6 +226,8 @@ private:
 
     wxMsgCatalog *m_pMsgCat; // pointer to linked list of catalogs
 
+    bool m_lazyLoading;      // true if EnableLazyLoading() was called
+
     // In addition to keeping all the catalogs in the linked list, we also
     // store them in a hash map indexed by the domain name to allow finding
     // them by name efficiently.
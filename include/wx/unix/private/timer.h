@@ -14,7 +14,7 @@
 
 #include "wx/private/timer.h"
 
-#include <list>
+#include <vector>
 
 // the type used for milliseconds is large enough for microseconds too but
 // introduce a synonym for it to avoid confusion
@@ -47,6 +47,12 @@ public:
 
 private:
     bool m_isRunning;
+
+    // the index of this timer in wxTimerScheduler heap, only valid while the
+    // timer is running
+    size_t m_heapIndex = 0;
+
+    friend class wxTimerScheduler;
 };
 
 // ----------------------------------------------------------------------------
@@ -55,10 +61,24 @@ private:
 
 struct wxTimerSchedule
 {
-    wxTimerSchedule(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+    wxTimerSchedule(wxUnixTimerImpl *timer,
+                    wxUsecClock_t expiration,
+                    unsigned long seq)
         : m_timer(timer),
-          m_expiration(expiration)
+          m_expiration(expiration),
+          m_seq(seq)
+    {
+    }
+
+    // return true if this timer must be notified before the other one
+    bool IsBefore(const wxTimerSchedule& other) const
     {
+        if ( m_expiration != other.m_expiration )
+            return m_expiration < other.m_expiration;
+
+        // timers expiring at the same time are notified in the order in which
+        // they were added
+        return m_seq < other.m_seq;
     }
 
     // the timer itself (we don't own this pointer)
@@ -66,10 +86,14 @@ struct wxTimerSchedule
 
     // the time of its next expiration, in usec
     wxUsecClock_t m_expiration;
+
+    // sequence number used to order timers with the same expiration time
+    unsigned long m_seq;
 };
 
-// the linked list of all active timers, we keep it sorted by expiration time
-using wxTimerList = std::list<wxTimerSchedule>;
+// binary min-heap of all active timers ordered by expiration time, each timer
+// stores its index in it to allow removing it in logarithmic time
+using wxTimerHeap = std::vector<wxTimerSchedule>;
 
 // ----------------------------------------------------------------------------
 // wxTimerScheduler: class responsible for updating all timers
@@ -123,12 +147,26 @@ private:
     wxTimerScheduler() = default;
     ~wxTimerScheduler() = default;
 
-    // add the given timer schedule to the list in the right place
-    void DoAddTimer(const wxTimerSchedule& s);
+    // add the given timer schedule to the heap
+    void DoAddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration);
+
+    // remove the timer at the given position from the heap
+    void DoRemoveTimer(size_t index);
+
+    // put the element at the given position in the heap and update its timer
+    void PlaceAt(size_t index, const wxTimerSchedule& s);
+
+    // move the element at the given position up or down the heap until the
+    // heap property is restored
+    void SiftUp(size_t index);
+    void SiftDown(size_t index);
+
 
+    // all currently active timers
+    wxTimerHeap m_timers;
 
-    // the list of all currently active timers sorted by expiration
-    wxTimerList m_timers;
+    // the sequence number of the last added timer
+    unsigned long m_lastSeq = 0;
 
     static wxTimerScheduler *ms_instance;
 };
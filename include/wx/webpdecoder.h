@@ -19,6 +19,9 @@
 #include "wx/animdecod.h"
 #include "wx/imagwebp.h"
 
+#include <vector>
+
+struct WebPAnimDecoder;
 
 class WXDLLIMPEXP_CORE wxWebPDecoder : public wxAnimationDecoder
 {
@@ -48,7 +51,20 @@ protected:
     virtual bool DoCanRead(wxInputStream& stream) const override;
 
 private:
-    std::vector<wxWebPAnimationFrame> m_frames;
+    // Frames are decoded on demand, as libwebp only keeps the current and the
+    // previous canvas in memory, so we need to keep the entire file data.
+    std::vector<unsigned char> m_data;
+    WebPAnimDecoder* m_decoder;
+
+    std::vector<long> m_delays;
+    wxColour m_bgColour;
+
+    // the last decoded frame and the index of the next frame that will be
+    // returned by m_decoder
+    mutable wxImage m_currentImage;
+    mutable unsigned int m_nextFrame;
+
+    void Free();
 
     void InitWebPHandler() const;
 
@@ -51,11 +51,13 @@ typedef struct wxWebRequestHandleOpaque* wxWebRequestHandle;
 typedef struct wxWebSessionHandleOpaque* wxWebSessionHandle;
 
 class wxWebAuthChallengeImpl;
+class wxWebRequestBatchImpl;
 class wxWebRequestImpl;
 class wxWebResponseImpl;
 class wxWebSessionImpl;
 
 typedef wxObjectDataPtr<wxWebAuthChallengeImpl> wxWebAuthChallengeImplPtr;
+typedef wxObjectDataPtr<wxWebRequestBatchImpl> wxWebRequestBatchImplPtr;
 typedef wxObjectDataPtr<wxWebRequestImpl> wxWebRequestImplPtr;
 typedef wxObjectDataPtr<wxWebResponseImpl> wxWebResponseImplPtr;
 typedef wxObjectDataPtr<wxWebSessionImpl> wxWebSessionImplPtr;
@@ -278,6 +280,7 @@ private:
     // Ctor is used by wxWebSession and implementation classes to create
     // wxWebRequest objects from the existing implementation pointers.
     friend class wxWebSession;
+    friend class wxWebRequestBatch;
     friend class wxWebRequestImpl;
     friend class wxWebResponseImpl;
     explicit wxWebRequest(const wxWebRequestImplPtr& impl)
@@ -286,6 +289,44 @@ private:
     }
 };
 
+// Group of asynchronous requests started together and notifying about their
+// completion with a single event.
+class WXDLLIMPEXP_NET wxWebRequestBatch
+{
+public:
+    // Default ctor creates an invalid object, only IsOk() can be called on it.
+    wxWebRequestBatch();
+
+    explicit wxWebRequestBatch(wxEvtHandler* handler, int id = wxID_ANY);
+
+    wxWebRequestBatch(const wxWebRequestBatch& other);
+    wxWebRequestBatch& operator=(const wxWebRequestBatch& other);
+    ~wxWebRequestBatch();
+
+    bool IsOk() const { return m_impl.get() != nullptr; }
+
+    void Add(const wxWebRequest& request);
+
+    void Start();
+
+    void Cancel();
+
+    int GetId() const;
+
+    size_t GetCount() const;
+
+    wxWebRequest GetRequest(size_t n) const;
+
+    size_t GetFinishedCount() const;
+
+    size_t GetFailedCount() const;
+
+    bool IsFinished() const;
+
+private:
+    wxWebRequestBatchImplPtr m_impl;
+};
+
 class WXDLLIMPEXP_NET wxWebRequestSync : public wxWebRequestBase
 {
 public:
@@ -428,6 +469,12 @@ public:
     wxWebRequest
     CreateRequest(wxEvtHandler* handler, const wxString& url, int id = wxID_ANY);
 
+    // Connection management options, not supported by all backends.
+    bool SetMaxConnectionsPerHost(int count);
+    bool SetMaxConnections(int count);
+    bool SetConnectionCacheSize(int count);
+    bool EnableMultiplexing(bool enable = true);
+
 private:
     explicit wxWebSession(const wxWebSessionImplPtr& impl)
         : wxWebSessionBase(impl)
@@ -505,6 +552,7 @@ private:
 
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_NET, wxEVT_WEBREQUEST_STATE, wxWebRequestEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_NET, wxEVT_WEBREQUEST_DATA, wxWebRequestEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_NET, wxEVT_WEBREQUEST_BATCH, wxWebRequestEvent);
 
 #endif // wxUSE_WEBREQUEST
 
@@ -174,6 +174,41 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxFileStream);
 };
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream: stream reading a file mapped into memory
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFileInputStream : public wxInputStream
+{
+public:
+    wxMappedFileInputStream(const wxString& fileName);
+    virtual ~wxMappedFileInputStream();
+
+    virtual wxFileOffset GetLength() const override { return m_size; }
+    virtual bool IsSeekable() const override { return true; }
+
+    virtual char Peek() override;
+    virtual bool CanRead() const override;
+
+    // direct access to the entire file contents
+    const void *GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+protected:
+    virtual size_t OnSysRead(void *buffer, size_t size) override;
+    virtual wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) override;
+    virtual wxFileOffset OnSysTell() const override { return m_pos; }
+    virtual const void *OnSysPeekSpan(size_t *size) override;
+    virtual void OnSysSkipSpan(size_t size) override;
+
+private:
+    const char *m_data;
+    size_t m_size;
+    size_t m_pos;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFileInputStream);
+};
+
 #endif //wxUSE_FILE
 
 #if wxUSE_FFILE
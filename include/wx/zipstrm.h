@@ -17,6 +17,7 @@
 #include "wx/filename.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 // some methods from wxZipInputStream and wxZipOutputStream stream do not get
@@ -124,6 +125,7 @@ enum wxZipArchiveFormat
 // Forward decls
 //
 class WXDLLIMPEXP_FWD_BASE wxZipEntry;
+class WXDLLIMPEXP_FWD_BASE wxZipIndex;
 class WXDLLIMPEXP_FWD_BASE wxZipInputStream;
 
 
@@ -322,6 +324,9 @@ public:
     int  GetLevel() const                       { return m_level; }
     void WXZIPFIX SetLevel(int level);
 
+    int  GetParallelism() const                 { return m_parallelism; }
+    void SetParallelism(int numThreads);
+
     void SetFormat(wxZipArchiveFormat format)   { m_format = format; }
     wxZipArchiveFormat GetFormat() const        { return m_format; }
 
@@ -366,6 +371,7 @@ private:
     wxUint32 m_crcAccumulator;
     wxOutputStream *m_comp;
     int m_level;
+    int m_parallelism;
     wxFileOffset m_offsetAdjustment;
     wxString m_Comment;
     bool m_endrecWritten;
@@ -401,6 +407,8 @@ public:
 protected:
     size_t WXZIPFIX OnSysRead(void *buffer, size_t size) override;
     wxFileOffset OnSysTell() const override { return m_decomp ? m_decomp->TellI() : 0; }
+    const void *OnSysPeekSpan(size_t *size) override;
+    void OnSysSkipSpan(size_t size) override;
 
     // this protected interface isn't yet finalised
     virtual wxInputStream* WXZIPFIX OpenDecompressor(wxInputStream& stream);
@@ -430,6 +438,14 @@ private:
     bool DoOpen(wxZipEntry *entry = nullptr, bool raw = false);
     bool OpenDecompressor(bool raw = false);
 
+    // Read the data descriptor, if any, and check the length and crc of the
+    // entry after reaching its end.
+    void OnEntryEnd();
+
+    // Use the information about the central directory from the index instead
+    // of loading it from the stream.
+    void InitFromIndex(const wxZipIndex& index);
+
     class wxStoredInputStream *m_store;
     class wxZlibInputStream2 *m_inflate;
     class wxRawInputStream *m_rawin;
@@ -451,11 +467,53 @@ private:
                     wxZipEntry *entry, wxZipInputStream& inputStream);
     friend bool wxZipOutputStream::CopyArchiveMetaData(
                     wxZipInputStream& inputStream);
+    friend class wxZipIndex;
 
     wxDECLARE_NO_COPY_CLASS(wxZipInputStream);
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxZipIndex
+
+class WXDLLIMPEXP_BASE wxZipIndex
+{
+public:
+    wxZipIndex() = default;
+
+    bool Load(wxInputStream& stream, wxMBConv& conv = wxConvLocal);
+
+    bool IsOk() const                           { return m_ok; }
+    size_t GetCount() const                     { return m_entries.size(); }
+    const wxZipEntry& GetEntry(size_t n) const  { return m_entries.at(n); }
+    const wxString& GetComment() const          { return m_comment; }
+
+    const wxZipEntry *Find(const wxString& name,
+                           wxPathFormat format = wxPATH_NATIVE) const;
+
+    wxZipInputStream *OpenEntry(wxInputStream *stream,
+                                const wxZipEntry& entry,
+                                wxMBConv& conv = wxConvLocal) const;
+    wxZipInputStream *OpenEntry(wxInputStream *stream,
+                                const wxString& name,
+                                wxPathFormat format = wxPATH_NATIVE,
+                                wxMBConv& conv = wxConvLocal) const;
+
+private:
+    std::vector<wxZipEntry> m_entries;
+    std::unordered_map<wxString, size_t> m_byName;
+    wxString m_comment;
+    wxFileOffset m_centralOffset = wxInvalidOffset;
+    wxFileOffset m_offsetAdjustment = 0;
+    wxUint32 m_signature = 0;
+    bool m_ok = false;
+
+    friend class wxZipInputStream;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipIndex);
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
@@ -63,6 +63,8 @@ class WXDLLIMPEXP_BASE wxZlibInputStream: public wxFilterInputStream {
   wxDECLARE_NO_COPY_CLASS(wxZlibInputStream);
 };
 
+class wxZlibParallelDeflater;
+
 class WXDLLIMPEXP_BASE wxZlibOutputStream: public wxFilterOutputStream {
  public:
   wxZlibOutputStream(wxOutputStream& stream, int level = -1, int flags = wxZLIB_ZLIB);
@@ -78,21 +80,31 @@ class WXDLLIMPEXP_BASE wxZlibOutputStream: public wxFilterOutputStream {
   bool SetDictionary(const char *data, size_t datalen);
   bool SetDictionary(const wxMemoryBuffer &buf);
 
+  bool SetParallelism(int numThreads);
+
  protected:
   size_t OnSysWrite(const void *buffer, size_t size) override;
   wxFileOffset OnSysTell() const override { return m_pos; }
 
   virtual void DoFlush(bool final);
 
- private:
-  void Init(int level, int flags);
+  // Start a new compressed stream in parallel mode, used after DoFlush(true).
+  void ResetParallel();
 
- protected:
   size_t m_z_size;
   unsigned char *m_z_buffer;
   struct z_stream_s *m_deflate;
   wxFileOffset m_pos;
 
+  // Only non-null if SetParallelism() was called with more than one thread.
+  wxZlibParallelDeflater *m_parallel;
+
+ private:
+  void Init(int level, int flags);
+
+  int m_level;
+  int m_flags;
+
   wxDECLARE_NO_COPY_CLASS(wxZlibOutputStream);
 };
 
@@ -151,6 +151,10 @@ public:
 
         This function will immediately return and do nothing if SuspendProcessingOfPendingEvents()
         was called.
+
+        By default all pending events are processed, but the number of events
+        processed by a single call to this function and the time spent in it
+        can be limited using SetPendingEventsBudget().
     */
     virtual void ProcessPendingEvents();
 
@@ -185,6 +189,30 @@ public:
     */
     void ResumeProcessingOfPendingEvents();
 
+    /**
+        Limits the amount of work done by a single ProcessPendingEvents() call.
+
+        When a lot of events are queued at once, e.g. by a worker thread
+        posting progress notifications, processing all of them in one go may
+        make the application unresponsive. This function allows to specify
+        the maximal number of events to process and/or the maximal time to
+        spend doing it in a single call to ProcessPendingEvents(), the
+        remaining events are processed during the next event loop iterations.
+
+        Notice that at least one event is always processed and that the time
+        limit is only checked between the events, so it can be exceeded if
+        any of the event handlers takes a long time to execute.
+
+        @param maxEvents
+            Maximal number of events to process or 0 for no limit.
+        @param maxTime
+            Maximal time, in milliseconds, to spend processing the events or 0
+            for no limit.
+
+        @since 3.3.0
+    */
+    void SetPendingEventsBudget(size_t maxEvents, long maxTime = 0);
+
     ///@}
 
     /**
@@ -367,6 +367,38 @@ public:
     */
     wxBitmap(const wxImage& img, int depth = wxBITMAP_SCREEN_DEPTH);
 
+    /**
+        Creates this bitmap object from the given image, reusing its data if
+        possible.
+
+        This constructor is used for temporary images or when @c std::move()
+        is used explicitly, e.g.
+        @code
+        wxImage image(...);
+        ... modify the image ...
+        wxBitmap bitmap(std::move(image));
+        // image must not be used any more here.
+        @endcode
+
+        It works in the same way as the overload taking a const reference, but
+        allows avoiding copying the image data if the image is the sole owner
+        of it and its layout is compatible with the one used by the bitmap. In
+        this case the image is reset to be invalid after the call.
+
+        Currently the data is reused only in wxGTK 3 and only for images
+        without alpha channel, in all the other cases the data is just copied
+        as usual.
+
+        This overload is only declared in wxGTK, in the other ports passing a
+        temporary image or using @c std::move() simply selects the overload
+        taking a const reference.
+
+        @onlyfor{wxgtk}
+
+        @since 3.3.0
+    */
+    wxBitmap(wxImage&& img, int depth = wxBITMAP_SCREEN_DEPTH, double scale = 1.0);
+
     /**
         Creates a bitmap compatible with the given DC from the given image.
 
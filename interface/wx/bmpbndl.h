@@ -323,6 +323,51 @@ public:
      */
     static wxBitmapBundle FromSVGResource(const wxString& name, const wxSize& sizeDef);
 
+    /**
+        Set the maximal amount of memory used for caching SVG bitmaps.
+
+        The bitmaps rasterized by all bundles created by FromSVG() and the
+        related functions are kept in a cache shared by all of them, so that
+        requesting a bitmap of the same size again doesn't need to rasterize
+        the SVG image again. The least recently used bitmaps are removed from
+        the cache when the total size of the bitmaps in it exceeds the limit
+        set by this function, which is 16MiB by default.
+
+        Setting the limit to 0 disables caching completely, except for the
+        last used bitmap.
+
+        @param bytes The maximal total size of the cached bitmaps, computed
+            as 4 bytes per pixel.
+
+        @see PrerasterizeSVG()
+
+        @since 3.3.0
+     */
+    static void SetSVGCacheLimit(size_t bytes);
+
+    /**
+        Rasterize the given SVG bundles in background.
+
+        This function can be used, typically during the application startup,
+        to rasterize the SVG images in the sizes which will be needed for
+        displaying them on all the currently connected displays in a
+        background thread, so that they don't need to be rasterized when
+        they're used for the first time, e.g. when a menu is shown, or when
+        the window is moved to a display with a different DPI.
+
+        The sizes used are those returned by GetPreferredBitmapSizeAtScale()
+        for the scale factors of all the displays. The resulting bitmaps are
+        stored in the cache described in SetSVGCacheLimit() and only as long
+        as there is enough space left in it.
+
+        This function returns immediately. The bundles not created from SVG
+        are simply ignored. If wxWidgets is built without threads support,
+        the bundles are rasterized synchronously.
+
+        @since 3.3.0
+     */
+    static void PrerasterizeSVG(const wxVector<wxBitmapBundle>& bundles);
+
     /**
         Clear the existing bundle contents.
 
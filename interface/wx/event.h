@@ -458,6 +458,37 @@ public:
      */
     virtual void QueueEvent(wxEvent *event);
 
+    /**
+        Queue event for a later processing, replacing the previously queued
+        equivalent event, if any.
+
+        This function is similar to QueueEvent() but if an event with the same
+        type and ID queued by an earlier call to this function with the same
+        @a key is still pending, i.e. hasn't been processed yet, the old event
+        is deleted and replaced with the new one, which will be processed in
+        the position of the old one in the queue.
+
+        This is useful for the events superseding each other, e.g. progress
+        updates posted by a worker thread, as it avoids accumulating many
+        such events when the thread posts them faster than the main thread
+        processes them.
+
+        Notice that this function is thread-safe, just as QueueEvent(), but,
+        unlike it, it needs to lock the pending events queue of this handler
+        and iterate over it, so it's only worth using it for the events which
+        are expected to be coalesced.
+
+        @param event
+            A heap-allocated event to be queued, this function takes ownership
+            of it. This parameter shouldn't be @NULL.
+        @param key
+            Additional key allowing to distinguish the events of the same type
+            and with the same ID that shouldn't replace each other.
+
+        @since 3.3.0
+    */
+    void QueueEventCoalesced(wxEvent *event, wxIntPtr key = 0);
+
     /**
         Post an event to be processed later.
 
@@ -659,10 +690,11 @@ public:
     bool SafelyProcessEvent(wxEvent& event);
 
     /**
-        Processes the pending events previously queued using QueueEvent() or
-        AddPendingEvent(); you must call this function only if you are sure
-        there are pending events for this handler, otherwise a @c wxCHECK
-        will fail.
+        Processes the first pending event previously queued using
+        QueueEvent() or AddPendingEvent().
+
+        This function does nothing if there are no pending events for this
+        handler.
 
         The real processing still happens in ProcessEvent() which is called by this
         function.
@@ -40,6 +40,22 @@
     these events in any other object. See the fswatcher sample for an example
     of the latter approach.
 
+    @beginEventEmissionTable{wxFileSystemWatcherEvent}
+    @event{EVT_FSWATCHER(id, func)}
+        A file system change happened, this event is not sent if the events
+        are coalesced, see SetCoalescingInterval().
+    @event{EVT_FSWATCHER_BATCH(id, func)}
+        One or more file system changes happened during the coalescing
+        interval, see SetCoalescingInterval(). This event is of
+        wxFileSystemWatcherBatchEvent type.
+        @since 3.3.0
+    @event{EVT_FSWATCHER_TREE_ADDED(id, func)}
+        All directories of the tree added by AddTreeAsync() are now watched.
+        The path of the event is the root of the tree and its change type
+        is 0.
+        @since 3.3.0
+    @endEventTable
+
     @library{wxbase}
     @category{file}
 
@@ -89,7 +105,8 @@ public:
         should be used with care on other platforms for directories with lots
         of children (e.g. the root directory) as it calls Add() for each
         subdirectory, potentially creating a lot of watches and taking a long
-        time to execute.
+        time to execute. Consider using AddTreeAsync() to avoid
+        blocking while adding big trees.
 
         Note that on platforms that use symbolic links, you will probably want
         to have called wxFileName::DontFollowLink on @a path. This is especially
@@ -98,6 +115,29 @@ public:
     virtual bool AddTree(const wxFileName& path, int events = wxFSW_EVENT_ALL,
                          const wxString& filter = wxEmptyString);
 
+    /**
+        Same as AddTree(), but doesn't block while adding all the
+        subdirectories of the tree.
+
+        The root directory itself is watched when this function returns, but
+        under the platforms where AddTree() needs to add a watch for each
+        subdirectory, i.e. all of them except MSW and macOS, the tree is
+        scanned in a background thread and its subdirectories are watched
+        progressively, so the changes to them may be missed until this is
+        done. When all of them are watched, @c wxEVT_FSWATCHER_TREE_ADDED event
+        is sent, under all platforms.
+
+        Calling RemoveTree() or RemoveAll() before this event is received
+        stops adding the subdirectories and the event is not sent then.
+
+        @return @false if @a path is not an existing directory or couldn't be
+            watched.
+
+        @since 3.3.0
+     */
+    bool AddTreeAsync(const wxFileName& path, int events = wxFSW_EVENT_ALL,
+                      const wxString& filter = wxEmptyString);
+
     /**
         Removes @a path from the list of watched paths.
 
@@ -141,6 +181,46 @@ public:
         owner.
      */
     void SetOwner(wxEvtHandler* handler);
+
+    /**
+        Enable or disable coalescing of the file system events.
+
+        By default each change generates its own @c wxEVT_FSWATCHER event,
+        which may result in a lot of events when many changes happen at once,
+        e.g. during a build. When coalescing is enabled by specifying a
+        positive interval, the events are accumulated instead, starting with
+        the first one, and sent together as a single @c wxEVT_FSWATCHER_BATCH
+        event when the interval expires. The redundant events are merged
+        before sending them:
+            - The events modifying, accessing or changing the attributes of a
+              file created during the same interval are discarded.
+            - Repeated events of the same type for the same file are only
+              reported once.
+            - If a file is deleted, the preceding events modifying it are
+              discarded and, if it had been created during the same interval,
+              the deletion is not reported at all.
+
+        The events are never merged across a rename of the file.
+
+        @param milliseconds The interval during which the events are
+            accumulated or 0 to disable coalescing, flushing any currently
+            accumulated events immediately.
+
+        @note Coalescing is currently only implemented under Unix platforms
+            using inotify or kqueue.
+
+        @since 3.3.0
+     */
+    void SetCoalescingInterval(int milliseconds);
+
+    /**
+        Returns the interval set by SetCoalescingInterval().
+
+        Returns 0 if the events are not coalesced.
+
+        @since 3.3.0
+     */
+    int GetCoalescingInterval() const;
 };
 
 
@@ -228,6 +308,48 @@ public:
 };
 
 wxEventType wxEVT_FSWATCHER;
+wxEventType wxEVT_FSWATCHER_TREE_ADDED;
+
+/**
+    @class wxFileSystemWatcherBatchEvent
+
+    Event containing several file system changes.
+
+    This event is sent by wxFileSystemWatcher instead of the individual
+    wxFileSystemWatcherEvent events when coalescing them is enabled using
+    wxFileSystemWatcher::SetCoalescingInterval().
+
+    @library{wxbase}
+    @category{events}
+
+    @see wxFileSystemWatcher
+    @see @ref overview_events
+
+    @since 3.3.0
+*/
+class wxFileSystemWatcherBatchEvent : public wxEvent
+{
+public:
+    /**
+        Creates an empty batch.
+     */
+    wxFileSystemWatcherBatchEvent(int watchid = wxID_ANY);
+
+    /**
+        Returns the events of this batch in the order in which they occurred.
+
+        The returned vector is never empty for the events sent by
+        wxFileSystemWatcher.
+     */
+    const std::vector<wxFileSystemWatcherEvent>& GetEvents() const;
+
+    /**
+        Appends an event to the batch.
+     */
+    void AddEvent(const wxFileSystemWatcherEvent& event);
+};
+
+wxEventType wxEVT_FSWATCHER_BATCH;
 
 /**
     These are the possible types of file system change events.
@@ -1782,6 +1782,43 @@ public:
     /// Set attribute for the specified column.
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    /**
+        Set attribute shared by all cells of the specified block.
+
+        This is equivalent to calling SetAttr() for all cells of the block
+        with the same attribute, but is much faster and uses much less memory
+        for big blocks, as the default implementation stores the block only
+        once instead of storing the attribute for each cell individually.
+
+        The blocks are stored as non-overlapping rectangles, so setting the
+        attribute for a block overlapping the existing ones replaces their
+        attributes in the overlapping part, and finding the attribute of a
+        cell takes time logarithmic in the number of these rectangles.
+
+        Note that the attribute is shared by all cells, but wxGrid functions
+        modifying the attribute of a single cell, e.g.
+        wxGrid::SetCellBackgroundColour(), make a copy of it for this cell
+        first, so that the other cells are not affected.
+
+        The attribute must not be used for a cell spanning multiple rows or
+        columns.
+
+        @since 3.3.0
+     */
+    virtual void SetAttrRange(wxGridCellAttr *attr,
+                              const wxGridBlockCoords& block);
+
+    /**
+        Return @true if the cell uses the attribute set for the block
+        containing it by SetAttrRange().
+
+        This function returns @false if the cell has its own attribute, set by
+        SetAttr(), even if it is inside such block.
+
+        @since 3.3.0
+     */
+    bool UsesAttrRange(int row, int col) const;
+
     ///@}
 
     /**
@@ -2702,6 +2739,19 @@ public:
      */
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    /**
+        Set attribute shared by all cells of the specified block.
+
+        By default this function is simply forwarded to
+        wxGridCellAttrProvider::SetAttrRange().
+
+        The table takes ownership of @a attr, i.e. will call DecRef() on it.
+
+        @since 3.3.0
+     */
+    virtual void SetAttrRange(wxGridCellAttr* attr,
+                              const wxGridBlockCoords& block);
+
     ///@}
 
     /**
@@ -5745,6 +5795,33 @@ public:
     */
     bool DeleteRows(int pos = 0, int numRows = 1, bool updateLabels = true);
 
+    /**
+        Enables or disables caching the drawn cells.
+
+        When the cache is enabled, the grid keeps the bitmaps with the blocks
+        of cells drawn by the cell renderers and just draws these bitmaps when
+        the same cells need to be redrawn later, e.g. when the grid is scrolled
+        back to them, instead of calling the renderers again. This can make
+        redrawing significantly faster for big grids with many formatted
+        values or custom renderers, at the expense of using more memory.
+
+        Changing the cell values or attributes using wxGrid functions, changing
+        the table structure or calling Refresh(), RefreshBlock() or
+        ForceRefresh() discards the affected bitmaps, however the grid has no
+        way of knowing when the values in the table change or when a custom
+        renderer would draw a cell differently. If the cache is used, the grid
+        must be explicitly refreshed in these cases, even if it's currently not
+        shown. Resizing, moving or hiding rows and columns doesn't require any
+        special actions.
+
+        The cache is disabled by default.
+
+        @since 3.3.0
+
+        @see IsTileCacheEnabled()
+     */
+    void EnableTileCache(bool enable = true);
+
     /**
         Sets or resets the frozen columns and rows.
 
@@ -5846,8 +5923,11 @@ public:
         Returns the attribute for the given cell creating one if necessary.
 
         If the cell already has an attribute, it is returned. Otherwise a new
-        attribute is created, associated with the cell and returned. In any
-        case the caller must call DecRef() on the returned pointer.
+        attribute is created, associated with the cell and returned. If the
+        cell uses the attribute shared by a block of cells set with
+        SetAttrRange(), a copy of it is associated with the cell and returned,
+        so that modifying it doesn't affect the other cells. In any case the
+        caller must call DecRef() on the returned pointer.
 
         Prefer to use GetOrCreateCellAttrPtr() to avoid the need to call
         DecRef() on the returned pointer.
@@ -5919,6 +5999,15 @@ public:
     */
     bool InsertRows(int pos = 0, int numRows = 1, bool updateLabels = true);
 
+    /**
+        Returns @true if the drawn cells are cached.
+
+        @since 3.3.0
+
+        @see EnableTileCache()
+     */
+    bool IsTileCacheEnabled() const;
+
     /**
         Invalidates the cached attribute for the given cell.
 
@@ -6009,6 +6098,23 @@ public:
     */
     void SetAttr(int row, int col, wxGridCellAttr *attr);
 
+    /**
+        Sets the same cell attributes for all cells in the specified block.
+
+        This is much more efficient than calling SetAttr() for each cell of a
+        big block, both in terms of time and memory. Notice that the attribute
+        is shared by all cells, but changing it for one of them, e.g. using
+        SetCellBackgroundColour(), only changes it for this cell, as it gets
+        its own copy of the attribute, see GetOrCreateCellAttr().
+
+        The grid takes ownership of the attribute pointer.
+
+        @see wxGridCellAttrProvider::SetAttrRange()
+
+        @since 3.3.0
+    */
+    void SetAttrRange(const wxGridBlockCoords& block, wxGridCellAttr *attr);
+
     /**
         Sets the cell attributes for all cells in the specified column.
 
@@ -131,6 +131,10 @@ enum wxImagePNGType
 #define wxIMAGE_OPTION_MAX_HEIGHT                       wxString("MaxHeight")
 #define wxIMAGE_OPTION_ORIGINAL_WIDTH                   wxString("OriginalWidth")
 #define wxIMAGE_OPTION_ORIGINAL_HEIGHT                  wxString("OriginalHeight")
+#define wxIMAGE_OPTION_REGION_X                         wxString("RegionX")
+#define wxIMAGE_OPTION_REGION_Y                         wxString("RegionY")
+#define wxIMAGE_OPTION_REGION_WIDTH                     wxString("RegionWidth")
+#define wxIMAGE_OPTION_REGION_HEIGHT                    wxString("RegionHeight")
 
 #define wxIMAGE_OPTION_BMP_FORMAT                       wxString("wxBMP_FORMAT")
 #define wxIMAGE_OPTION_CUR_HOTSPOT_X                    wxString("HotSpotX")
@@ -1346,17 +1350,33 @@ public:
             max width given if it is not 0 @em and its height is less than the
             max height given if it is not 0. This is typically used for loading
             thumbnails and the advantage of using these options compared to
-            calling Rescale() after loading is that some handlers (only JPEG
-            one right now) support rescaling the image during loading which is
-            vastly more efficient than loading the entire huge image and
-            rescaling it later (if these options are not supported by the
-            handler, this is still what happens however). These options must be
-            set before calling LoadFile() to have any effect.
+            calling Rescale() after loading is that some handlers (JPEG and,
+            since wxWidgets 3.3.0, non-interlaced PNG) support rescaling the
+            image during loading which is vastly more efficient than loading
+            the entire huge image and rescaling it later (if these options are
+            not supported by the handler, this is still what happens however).
+            These options must be set before calling LoadFile() to have any
+            effect.
+
+        @li @c wxIMAGE_OPTION_REGION_X, @c wxIMAGE_OPTION_REGION_Y,
+            @c wxIMAGE_OPTION_REGION_WIDTH and @c wxIMAGE_OPTION_REGION_HEIGHT:
+            If both the width and the height options are specified and
+            positive, only the given rectangular region of the image (in the
+            coordinates of the full image and intersected with it) is loaded.
+            If the region doesn't intersect the image at all, loading fails.
+            If @c wxIMAGE_OPTION_MAX_WIDTH or @c wxIMAGE_OPTION_MAX_HEIGHT are
+            specified too, they apply to the region size. As with the max size
+            options, JPEG and non-interlaced PNG handlers support loading only
+            the region directly, without allocating memory for the entire
+            image, while for the other formats the image is cropped after
+            loading it. These options must be set before calling LoadFile() to
+            have any effect.
+            @since 3.3.0
 
         @li @c wxIMAGE_OPTION_ORIGINAL_WIDTH and @c wxIMAGE_OPTION_ORIGINAL_HEIGHT:
             These options will return the original size of the image if either
-            @c wxIMAGE_OPTION_MAX_WIDTH or @c wxIMAGE_OPTION_MAX_HEIGHT is
-            specified.
+            @c wxIMAGE_OPTION_MAX_WIDTH or @c wxIMAGE_OPTION_MAX_HEIGHT or the
+            region options are specified.
             @since 2.9.3
 
         @li @c wxIMAGE_OPTION_QUALITY: JPEG quality used when saving. This is an
@@ -1838,6 +1858,36 @@ public:
      */
     void SetLoadFlags(int flags);
 
+    /**
+        Sets the number of threads used for processing image pixels.
+
+        By default, all image operations are performed in the calling thread.
+        Calling this function with a value greater than 1 makes the functions
+        processing all image pixels, such as Rotate(), RotateHue(),
+        ChangeSaturation(), ChangeBrightness(), ChangeHSV(),
+        ConvertToGreyscale(), ConvertToDisabled() or ChangeLightness(), split
+        big images into bands of rows and process them in parallel using up
+        to the given number of threads, including the calling one. The
+        additional threads are created when they are needed for the first
+        time and reused for all subsequent operations.
+
+        Note that small images are always processed in the calling thread, as
+        the overhead of using several threads would outweigh any gains.
+
+        This setting is global and affects all image objects. It has no
+        effect if wxWidgets was built without threads support.
+
+        @param numThreads
+            Number of threads to use, 1 (default) to not use any additional
+            threads or 0 to use as many threads as there are CPUs in the
+            system, as returned by wxThread::GetCPUCount().
+
+        @see GetParallelism()
+
+        @since 3.3.0
+     */
+    static void SetParallelism(int numThreads);
+
     /**
         Specifies whether there is a mask or not.
 
@@ -2094,6 +2144,15 @@ public:
      */
     static int GetDefaultLoadFlags();
 
+    /**
+        Returns the number of threads used for processing image pixels.
+
+        See SetParallelism() for more information.
+
+        @since 3.3.0
+     */
+    static int GetParallelism();
+
     ///@{
     /**
         If the image file contains more than one image and the image handler is
@@ -2196,6 +2255,137 @@ public:
                                unsigned char startB = 0 ) const;
 };
 
+/**
+    @class wxImagePipeline
+
+    Helper class for applying several operations to an image efficiently.
+
+    Each of wxImage functions such as GetSubImage(), Rotate90() or
+    ConvertToGreyscale() returns a new image, so applying several of them in
+    a row creates a full copy of the image for each of them. This class allows
+    to specify all the operations first and then perform all of them at once
+    by calling Execute(), which avoids making these intermediate copies and
+    traverses the image data just once, e.g.:
+
+    @code
+        wxImage thumbnail = wxImagePipeline(image)
+                                .GetSubImage(wxRect(10, 10, 400, 300))
+                                .Scale(200, 150)
+                                .ConvertToGreyscale()
+                                .Rotate90()
+                                .Execute();
+    @endcode
+
+    The result is the same as the result of calling the wxImage functions
+    with the same names in the same order, except that the image options
+    (see wxImage::SetOption()) are not preserved.
+
+    Note that the operations are grouped in stages separated by Scale() calls,
+    as resampling the image can't be combined with the other operations, and
+    the image is traversed once for each of these stages. Operations are
+    performed using multiple threads if wxImage::SetParallelism() was used.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage
+
+    @since 3.3.0
+*/
+class wxImagePipeline
+{
+public:
+    /**
+        Creates a pipeline applying operations to the given image.
+
+        The image itself is never modified by the pipeline.
+    */
+    explicit wxImagePipeline(const wxImage& image);
+
+    /**
+        Adds an operation selecting the given part of the image.
+
+        The rectangle must be inside the image resulting from the
+        previous operations.
+
+        @see wxImage::GetSubImage()
+    */
+    wxImagePipeline& GetSubImage(const wxRect& rect);
+
+    /**
+        Adds an operation mirroring the image.
+
+        @see wxImage::Mirror()
+    */
+    wxImagePipeline& Mirror(bool horizontally = true);
+
+    /**
+        Adds an operation rotating the image by 90 degrees.
+
+        @see wxImage::Rotate90()
+    */
+    wxImagePipeline& Rotate90(bool clockwise = true);
+
+    /**
+        Adds an operation rotating the image by 180 degrees.
+
+        @see wxImage::Rotate180()
+    */
+    wxImagePipeline& Rotate180();
+
+    /**
+        Adds an operation scaling the image to the given size.
+
+        @see wxImage::Scale()
+    */
+    wxImagePipeline& Scale(int width, int height,
+                           wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL);
+
+    /**
+        Adds an operation converting the image to greyscale.
+
+        @see wxImage::ConvertToGreyscale()
+    */
+    wxImagePipeline& ConvertToGreyscale(double weight_r = 0.299,
+                                        double weight_g = 0.587,
+                                        double weight_b = 0.114);
+
+    /**
+        Adds an operation converting the image to its disabled appearance.
+
+        @see wxImage::ConvertToDisabled()
+    */
+    wxImagePipeline& ConvertToDisabled(unsigned char brightness = 255);
+
+    /**
+        Adds an operation changing the lightness of the image.
+
+        @see wxImage::ChangeLightness()
+    */
+    wxImagePipeline& ChangeLightness(int alpha);
+
+    /**
+        Adds an operation changing the hue, saturation and brightness of the
+        image.
+
+        @see wxImage::ChangeHSV()
+    */
+    wxImagePipeline& ChangeHSV(double angleH, double factorS, double factorV);
+
+    /**
+        Returns the size of the image which will be returned by Execute().
+    */
+    wxSize GetSize() const;
+
+    /**
+        Performs all the operations and returns the resulting image.
+
+        This function can be called more than once, e.g. to apply the same
+        operations again after adding more of them.
+    */
+    wxImage Execute() const;
+};
+
 /**
     An instance of an empty image without an alpha channel.
 */
@@ -689,6 +689,25 @@ protected:
     virtual void DoLogText(const wxString& msg);
 
     ///@}
+
+    /**
+        Return @true if this log target can be used from any thread.
+
+        The messages logged from threads other than the main one are normally
+        buffered and only passed to the active log target when FlushActive()
+        is called from the main thread. If this function is overridden to
+        return @true, the messages are passed to DoLogRecord() of this log
+        target directly from the thread which logged them instead, so it must
+        be able to handle being called from several threads concurrently.
+
+        Notice that repetition counting (see SetRepetitionCounting()) is not
+        performed for such log targets.
+
+        The base class version returns @false.
+
+        @since 3.3.0
+     */
+    virtual bool IsThreadSafe() const;
 };
 
 
@@ -906,6 +925,96 @@ public:
 
 
 
+/**
+    @class wxLogAsyncFile
+
+    This class writes the log messages to a file from a background thread.
+
+    Unlike with wxLogStderr, logging a message using this log target doesn't
+    perform any I/O nor even formatting of the message in the calling thread:
+    the message is just stored in a buffer specific to this thread, without
+    any locking, and all the accumulated messages are then formatted, sorted by
+    their time stamps and written to the file in a single operation by the
+    background thread, either periodically or when the buffer of any thread
+    becomes half full. This makes it suitable for logging many messages, from
+    both the main and any other threads, with minimal overhead.
+
+    The messages from the threads other than the main one are passed to this
+    log target immediately, without waiting for wxLog::FlushActive() to be
+    called, as it can be used from any thread (see wxLog::IsThreadSafe()).
+
+    If the buffer of a thread becomes full because it logs messages faster
+    than they can be written, logging blocks until the background thread
+    writes them out.
+
+    The messages are always written in UTF-8 encoding.
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @library{wxbase}
+    @category{logging}
+
+    @see wxLogStderr
+
+    @since 3.3.0
+*/
+class wxLogAsyncFile : public wxLog
+{
+public:
+    /**
+        Constructs a log target appending the messages to the file with the
+        given name.
+
+        The file is created if it doesn't exist. Use IsOk() to check if it
+        could be opened.
+    */
+    explicit wxLogAsyncFile(const wxString& filename);
+
+    /**
+        Constructs a log target writing messages to the given @c FILE.
+
+        If @a fp is @NULL, the messages are sent to @c stderr. The file is not
+        closed by this object.
+    */
+    explicit wxLogAsyncFile(FILE *fp = nullptr);
+
+    /**
+        Destructor writes out all the messages logged so far.
+
+        Note that no other threads may be logging messages to this object when
+        it's destroyed.
+    */
+    virtual ~wxLogAsyncFile();
+
+    /**
+        Return @true if the file was successfully opened.
+
+        If this function returns @false, all messages logged to this object
+        are simply discarded.
+    */
+    bool IsOk() const;
+
+    /**
+        Ask the background thread to write all pending messages soon.
+
+        This function doesn't wait for the messages to be actually written,
+        as it is called by wxLog::FlushActive() during idle time and so must
+        not block the main thread. Use Sync() to wait for them.
+    */
+    virtual void Flush();
+
+    /**
+        Wait until all messages logged so far are written to the file.
+
+        This function returns immediately if there are no pending messages.
+
+        @see Flush()
+    */
+    void Sync();
+};
+
+
+
 /**
     @class wxLogBuffer
 
@@ -5,6 +5,25 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+/**
+    Flags for wxQuantize::Quantize().
+*/
+#define wxQUANTIZE_INCLUDE_WINDOWS_COLOURS      0x01
+#define wxQUANTIZE_RETURN_8BIT_DATA             0x02
+#define wxQUANTIZE_FILL_DESTINATION_IMAGE       0x04
+
+/**
+    Don't use Floyd-Steinberg dithering when mapping the image colours to the
+    palette.
+
+    This is several times faster and allows to use several threads for
+    processing the image, see wxImage::SetParallelism(), but results in
+    visible colour banding in the images with smooth gradients.
+
+    @since 3.3.0
+*/
+#define wxQUANTIZE_NO_DITHERING                 0x08
+
 /**
     @class wxQuantize
 
@@ -31,10 +50,14 @@ public:
         (@a in_rows contains @a w * 3 bytes per row, @a out_rows @a w bytes per row).
         Fills @a out_rows with indexes into palette (which is also stored into @a palette
         variable).
+
+        The only flag used by this function is ::wxQUANTIZE_NO_DITHERING, the
+        @a flags parameter is available since wxWidgets 3.3.0.
     */
     static void DoQuantize(unsigned int w, unsigned int h,
                            unsigned char** in_rows, unsigned char** out_rows,
-                           unsigned char* palette, int desiredNoColours);
+                           unsigned char* palette, int desiredNoColours,
+                           int flags = 0);
 
     /**
         Reduce the colours in the source image and put the result into the destination image.
@@ -713,6 +713,40 @@ public:
     */
     bool Ungetch(char c);
 
+    /**
+        Returns the pointer to the data which can be read from the stream
+        without copying it.
+
+        Some streams, such as wxMemoryInputStream or wxMappedFileInputStream,
+        already have their data in memory and this function allows to access
+        it directly instead of copying it into a buffer using Read(). The data
+        is not consumed by this function, use SkipSpan() to do it.
+
+        The returned pointer remains valid for the lifetime of the stream.
+
+        @param size
+            Non-null pointer filled with the number of bytes available at the
+            returned address, or 0 if @NULL is returned.
+        @return
+            Pointer to the data or @NULL if the stream doesn't support direct
+            access to its data, if there is no more data in it or if some data
+            was put back into it using Ungetch(). In this case Read() must be
+            used to read the data.
+
+        @since 3.3.0
+    */
+    const void* PeekSpan(size_t* size);
+
+    /**
+        Consumes the data returned by PeekSpan().
+
+        The @a size parameter must not be greater than the size returned by
+        the last call to PeekSpan().
+
+        @since 3.3.0
+    */
+    void SkipSpan(size_t size);
+
 protected:
 
     /**
@@ -251,6 +251,38 @@ public:
      */
     bool IsLoaded(const wxString& domain) const;
 
+    /**
+        Enables or disables lazy loading of the message catalogs.
+
+        By default, all the strings of a message catalog are converted to
+        wxString and stored in memory when it is loaded. When lazy loading is
+        enabled, the catalog files are kept mapped into memory instead and the
+        strings are looked up in them using their hash table only when they
+        are requested, with the translations found being cached. This makes
+        loading big catalogs much faster and uses less memory if only a small
+        part of their strings is actually used.
+
+        Lazy loading is only used for the catalogs containing the hash table,
+        which is the case for all catalogs created by GNU msgfmt by default,
+        and which are loaded from files. Note that these files can't be
+        modified while they are in use.
+
+        This option only affects the catalogs loaded after calling this
+        function, so it should be called before adding any catalogs.
+
+        @since 3.3.0
+     */
+    void EnableLazyLoading(bool enable = true);
+
+    /**
+        Returns @true if lazy loading of the catalogs is enabled.
+
+        @see EnableLazyLoading()
+
+        @since 3.3.0
+     */
+    bool IsLazyLoadingEnabled() const;
+
     /**
         Retrieves the translation for a string in all loaded domains unless the @a domain
         parameter is specified (and then only this catalog/domain is searched).
@@ -1390,6 +1390,224 @@ public:
         @since 3.3.0
      */
     bool EnablePersistentStorage(bool enable);
+
+    /**
+        @name Connection management options.
+
+        These functions allow to control how the connections to the servers
+        are created and reused by the session, which can be important when
+        performing many requests, e.g. when using wxWebRequestBatch.
+
+        They may be called at any time and affect the requests started after
+        calling them.
+
+        All of them return @false if the option is not supported by the
+        backend being used.
+
+        @note These options are currently only implemented in the libcurl
+            backend.
+     */
+    ///@{
+
+    /**
+        Limit the number of simultaneous connections to the same host.
+
+        The requests which can't be started because of this limit are queued
+        until an existing connection becomes available.
+
+        @param count The maximal number of connections or 0 for no limit,
+            which is the default.
+
+        @since 3.3.0
+     */
+    bool SetMaxConnectionsPerHost(int count);
+
+    /**
+        Limit the total number of simultaneous connections.
+
+        @param count The maximal number of connections or 0 for no limit,
+            which is the default.
+
+        @since 3.3.0
+     */
+    bool SetMaxConnections(int count);
+
+    /**
+        Set the number of the connections kept open after the requests using
+        them terminate to be reused by the subsequent requests.
+
+        @since 3.3.0
+     */
+    bool SetConnectionCacheSize(int count);
+
+    /**
+        Enable or disable use of HTTP/2 multiplexing.
+
+        When multiplexing is enabled, HTTP/2 is used for the HTTPS requests if
+        the server supports it and several requests to the same server are
+        performed simultaneously using a single connection, which is much more
+        efficient than opening a connection for each of them.
+
+        Disabling multiplexing prevents several requests from sharing the
+        same connection, but doesn't change the HTTP version used. If this
+        function is not called, the default backend behaviour is used.
+
+        @return @false if the backend doesn't support this option or if
+            multiplexing can't be enabled because HTTP/2 is not supported.
+
+        @since 3.3.0
+     */
+    bool EnableMultiplexing(bool enable = true);
+
+    ///@}
+};
+
+/**
+    @class wxWebRequestBatch
+
+    Group of asynchronous web requests started together.
+
+    This class allows to start many requests at once and get a single
+    @c wxEVT_WEBREQUEST_BATCH event when all of them terminate. Its usage is
+    similar to this:
+
+    @code
+    wxWebSession& session = wxWebSession::GetDefault();
+    session.EnableMultiplexing();
+
+    wxWebRequestBatch batch(this);
+    for ( const auto& url : urls )
+        batch.Add(session.CreateRequest(this, url));
+
+    Bind(wxEVT_WEBREQUEST_BATCH, [batch](wxWebRequestEvent& evt) {
+        for ( size_t n = 0; n < batch.GetCount(); n++ ) {
+            wxWebRequest request = batch.GetRequest(n);
+            if ( request.GetState() == wxWebRequest::State_Completed )
+                ... use request.GetResponse() ...
+        }
+    });
+
+    batch.Start();
+    @endcode
+
+    The requests still send their usual events to their own handlers, the
+    batch event is sent after processing the last of them.
+
+    Note that a request terminating with wxWebRequest::State_Unauthorized
+    is considered to have failed and so ends its participation in the
+    batch: if wxWebAuthChallenge::SetCredentials() is called for it later,
+    the request continues as usual, but its final state is not taken into
+    account by the batch, which may have already sent its event with
+    wxWebRequest::State_Failed by then. Use the request own events to get
+    its result in this case.
+
+    Starting all requests of a batch at once may be more efficient than
+    starting them individually, e.g. libcurl backend can use a single
+    connection for all the requests to the same server when multiplexing is
+    enabled, see wxWebSession::EnableMultiplexing().
+
+    Objects of this class are reference-counted and can be copied cheaply.
+
+    @beginEventEmissionTable{wxWebRequestEvent}
+    @event{wxEVT_WEBREQUEST_BATCH(id, func)}
+        All requests of the batch have terminated. The event state is
+        wxWebRequest::State_Completed if all of them completed successfully
+        or wxWebRequest::State_Failed otherwise, including the case when
+        any of them required authentication, and it doesn't have any
+        associated request.
+    @endEventTable
+
+    @since 3.3.0
+
+    @library{wxnet}
+    @category{net}
+
+    @see wxWebRequest
+*/
+class wxWebRequestBatch
+{
+public:
+    /**
+        Default constructor creates an invalid object.
+
+        Only IsOk() can be called on such objects.
+     */
+    wxWebRequestBatch();
+
+    /**
+        Create a new empty batch.
+
+        @param handler The handler to send @c wxEVT_WEBREQUEST_BATCH event to,
+            must be non-null.
+        @param id Optional id sent with the event.
+     */
+    explicit wxWebRequestBatch(wxEvtHandler* handler, int id = wxID_ANY);
+
+    /**
+        Return @true if this is a valid batch object.
+     */
+    bool IsOk() const;
+
+    /**
+        Add a request to the batch.
+
+        The request must be valid, not started yet and use the same session
+        as the other requests in this batch, if any.
+
+        Requests can't be added to the batch after it was started.
+     */
+    void Add(const wxWebRequest& request);
+
+    /**
+        Start all requests of this batch.
+
+        The batch must contain at least one request and can only be started
+        once. Its requests must not be started individually.
+     */
+    void Start();
+
+    /**
+        Cancel all still active requests of this batch.
+     */
+    void Cancel();
+
+    /**
+        Return the id specified in the constructor.
+     */
+    int GetId() const;
+
+    /**
+        Return the number of requests in the batch.
+     */
+    size_t GetCount() const;
+
+    /**
+        Return the request with the given index.
+
+        @param n Index of the request, less than GetCount().
+     */
+    wxWebRequest GetRequest(size_t n) const;
+
+    /**
+        Return the number of requests which have already terminated.
+
+        Note that the requests terminating with wxWebRequest::State_Unauthorized
+        are considered to be finished, even if they are restarted after
+        providing the credentials later.
+     */
+    size_t GetFinishedCount() const;
+
+    /**
+        Return the number of requests which have terminated with a state other
+        than wxWebRequest::State_Completed.
+     */
+    size_t GetFailedCount() const;
+
+    /**
+        Return @true if the batch was started and all its requests have
+        terminated.
+     */
+    bool IsFinished() const;
 };
 
 /**
@@ -1646,3 +1864,4 @@ public:
 
 wxEventType wxEVT_WEBREQUEST_STATE;
 wxEventType wxEVT_WEBREQUEST_DATA;
+wxEventType wxEVT_WEBREQUEST_BATCH;
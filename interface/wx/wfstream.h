@@ -390,3 +390,55 @@ public:
     bool IsOk() const;
 };
 
+
+
+/**
+    @class wxMappedFileInputStream
+
+    This class represents data read from a file mapped into memory.
+
+    Unlike wxFileInputStream, this stream doesn't copy the file contents when
+    it is read using wxInputStream::PeekSpan() and wxInputStream::SkipSpan(),
+    which is used by wxZlibInputStream, wxZipInputStream and some image
+    handlers, making it more efficient for reading big files.
+
+    Note that the file must not be modified, and especially truncated, while
+    it is mapped, i.e. as long as this stream object exists.
+
+    @library{wxbase}
+    @category{streams}
+
+    @see wxFileInputStream
+
+    @since 3.3.0
+*/
+class wxMappedFileInputStream : public wxInputStream
+{
+public:
+    /**
+        Maps the file with the given name into memory.
+
+        @warning
+        You should use wxStreamBase::IsOk() to verify if the constructor succeeded.
+    */
+    wxMappedFileInputStream(const wxString& fileName);
+
+    /**
+        Destructor unmaps the file.
+    */
+    virtual ~wxMappedFileInputStream();
+
+    /**
+        Returns the pointer to the entire file contents.
+
+        The returned pointer is @NULL if the file is empty or couldn't be
+        mapped.
+    */
+    const void* GetData() const;
+
+    /**
+        Returns the size of the file.
+    */
+    size_t GetSize() const;
+};
+
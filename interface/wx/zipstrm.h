@@ -375,7 +375,7 @@ public:
     @library{wxbase}
     @category{archive,streams}
 
-    @see @ref overview_archive, wxZipEntry, wxZipOutputStream
+    @see @ref overview_archive, wxZipEntry, wxZipOutputStream, wxZipIndex
 */
 class wxZipInputStream : public wxArchiveInputStream
 {
@@ -438,6 +438,122 @@ public:
 
 
 
+/**
+    @class wxZipIndex
+
+    Index of all entries of a zip file allowing to access them by name.
+
+    Finding an entry by iterating over all of them using
+    wxZipInputStream::GetNextEntry() is slow for big archives, so this class
+    can be used instead when several entries need to be read from the same
+    archive: it reads the central directory of the archive once and then
+    allows to find the entries by their names in constant time and to open
+    them directly, without reading the central directory again.
+
+    As the index is not modified after loading it, its const methods can be
+    used from several threads at once, e.g. to read different entries
+    concurrently using a separate stream for each of them:
+
+    @code
+    wxZipIndex index;
+    {
+        wxFFileInputStream in(path);
+        if ( !index.Load(in) )
+            ... handle error ...
+    }
+
+    // This can be done in any thread.
+    std::unique_ptr<wxZipInputStream>
+        zip(index.OpenEntry(new wxFFileInputStream(path), "dir/file.txt"));
+    if ( zip )
+        ... read the entry data from zip ...
+    @endcode
+
+    Note that only seekable streams are supported by this class.
+
+    @since 3.3.0
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see wxZipInputStream, wxZipEntry
+*/
+class wxZipIndex
+{
+public:
+    /**
+        Default constructor creates an empty index.
+
+        Call Load() to fill it.
+    */
+    wxZipIndex();
+
+    /**
+        Read the central directory of the zip file from the given stream.
+
+        The stream must be seekable and is only used by this function, i.e.
+        it can be destroyed after it returns.
+
+        Returns @true if the index was successfully loaded.
+    */
+    bool Load(wxInputStream& stream, wxMBConv& conv = wxConvLocal);
+
+    /**
+        Returns @true if the index was successfully loaded.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the number of entries in the zip file.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns the entry with the given index, which must be less than
+        GetCount().
+
+        The entries are in the same order as in the zip file central
+        directory, i.e. the same as returned by wxZipInputStream::GetNextEntry().
+    */
+    const wxZipEntry& GetEntry(size_t n) const;
+
+    /**
+        Returns the zip file comment.
+    */
+    const wxString& GetComment() const;
+
+    /**
+        Find the entry with the given name.
+
+        Returns @NULL if there is no such entry. If the zip file contains
+        several entries with the same name, the first one is returned.
+    */
+    const wxZipEntry *Find(const wxString& name,
+                           wxPathFormat format = wxPATH_NATIVE) const;
+
+    ///@{
+    /**
+        Create a new stream reading the data of the given entry.
+
+        The @a stream must read the same zip file which was used to load the
+        index and must be seekable. The returned stream takes ownership of it,
+        and it is deleted if this function fails.
+
+        Returns @NULL if the entry couldn't be opened or if there is no entry
+        with the given name, otherwise returns a new stream which must be
+        deleted by the caller.
+    */
+    wxZipInputStream *OpenEntry(wxInputStream *stream,
+                                const wxZipEntry& entry,
+                                wxMBConv& conv = wxConvLocal) const;
+    wxZipInputStream *OpenEntry(wxInputStream *stream,
+                                const wxString& name,
+                                wxPathFormat format = wxPATH_NATIVE,
+                                wxMBConv& conv = wxConvLocal) const;
+    ///@}
+};
+
+
 /**
     @class wxZipClassFactory
 
@@ -556,6 +672,24 @@ public:
     void SetLevel(int level);
     ///@}
 
+    ///@{
+    /**
+        Set the number of threads used to compress the entries that will be
+        created after calling this function.
+
+        By default, the entries are compressed in the thread writing them. If
+        the parallelism is greater than 1, the data of each entry is compressed
+        using the given number of worker threads, which can significantly speed
+        up creating archives containing big files, see
+        wxZlibOutputStream::SetParallelism() for more details. Use 0 to use as
+        many threads as there are CPUs.
+
+        @since 3.3.0
+    */
+    int GetParallelism() const;
+    void SetParallelism(int numThreads);
+    ///@}
+
     /**
         Create a new directory entry (see wxArchiveEntry::IsDir) with the given
         name and timestamp.
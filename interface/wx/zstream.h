@@ -84,10 +84,43 @@ public:
         will inflate corrupted data.
 
         Returns @true if the dictionary was successfully set.
+
+        Note that the dictionary can't be used in parallel mode, see
+        SetParallelism().
     */
     bool SetDictionary(const char *data, size_t datalen);
     bool SetDictionary(const wxMemoryBuffer &buf);
     ///@}
+
+    /**
+        Sets the number of threads to use for compressing the data.
+
+        By default, all the data is compressed in the thread writing it to the
+        stream. Setting the parallelism to a value greater than 1 splits the
+        data in blocks of 128KiB which are compressed concurrently by the given
+        number of worker threads, using the end of the previous block as the
+        dictionary for the next one, similarly to what the @c pigz utility
+        does. The output is still a single standard zlib, gzip or raw deflate
+        stream which can be decompressed by any program, but it is slightly
+        bigger than the output produced without parallelism.
+
+        Note that calling wxOutputStream::Sync() in this mode ends the current
+        block, so doing it often prevents the data from being compressed
+        concurrently.
+
+        This function must be called before writing any data to the stream.
+
+        @param numThreads The number of threads to use, 1 to not use any
+            worker threads at all or 0 to use as many threads as there are
+            CPUs (see wxThread::GetCPUCount()).
+        @return @true if the parallelism was successfully changed, @false if
+            it is too late to change it or if worker threads couldn't be
+            created, which is always the case in the builds with
+            @c wxUSE_THREADS set to 0.
+
+        @since 3.3.0
+    */
+    bool SetParallelism(int numThreads);
 };
 
 
@@ -38,6 +38,7 @@
 #include "wx/filename.h"
 #include "wx/msgout.h"
 #include "wx/scopedptr.h"
+#include "wx/stopwatch.h"
 #include "wx/sysopt.h"
 #include "wx/tokenzr.h"
 #include "wx/thread.h"
@@ -77,6 +78,7 @@
     #include "wx/recguard.h"
 #endif // wxDEBUG_LEVEL
 
+#include <algorithm>
 #include <memory>
 
 // wxABI_VERSION can be defined when compiling applications but it should be
@@ -473,10 +475,28 @@ int wxAppConsoleBase::FilterEvent(wxEvent& WXUNUSED(event))
     return Event_Skip;
 }
 
+void wxAppConsoleBase::MoveNewPendingEventHandlers()
+{
+    wxEvtHandler* handler = m_handlersWithNewPendingEvents.exchange(nullptr);
+    if ( !handler )
+        return;
+
+    // the handlers are in the reverse order of their addition in the stack
+    // but we want to process them in the order they were added in
+    const size_t first = m_handlersWithPendingEvents.size();
+    for ( ; handler; handler = handler->m_nextWithPendingEvents )
+        m_handlersWithPendingEvents.push_back(handler);
+
+    std::reverse(m_handlersWithPendingEvents.begin() + first,
+                 m_handlersWithPendingEvents.end());
+}
+
 void wxAppConsoleBase::DelayPendingEventHandler(wxEvtHandler* toDelay)
 {
     wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
+    MoveNewPendingEventHandlers();
+
     // move the handler from the list of handlers with processable pending events
     // to the list of handlers with pending events which needs to be processed later
     m_handlersWithPendingEvents.Remove(toDelay);
@@ -489,8 +509,16 @@ void wxAppConsoleBase::DelayPendingEventHandler(wxEvtHandler* toDelay)
 
 void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
 {
+    // this is called from wxEvtHandler dtor, so avoid locking anything in the
+    // common case of the handler without any pending events
+    if ( !toRemove->m_isInPendingHandlersList )
+        return;
+
     wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
+    // the handler could be still in the stack of the new handlers
+    MoveNewPendingEventHandlers();
+
     if (m_handlersWithPendingEvents.Index(toRemove) != wxNOT_FOUND)
     {
         m_handlersWithPendingEvents.Remove(toRemove);
@@ -511,24 +539,39 @@ void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
     }
     //else: it wasn't in this list at all, it's ok
 
+    // allow AppendPendingEventHandler() to add it again
+    toRemove->m_isInPendingHandlersList = false;
+
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
 
 void wxAppConsoleBase::AppendPendingEventHandler(wxEvtHandler* toAppend)
 {
-    wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
-
-    if ( m_handlersWithPendingEvents.Index(toAppend) == wxNOT_FOUND )
-        m_handlersWithPendingEvents.Add(toAppend);
+    // don't add the handler if it's already in one of our lists
+    if ( toAppend->m_isInPendingHandlersList.exchange(true) )
+        return;
 
-    wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
+    // push it onto the stack of new handlers without taking any locks, it will
+    // be moved to m_handlersWithPendingEvents by MoveNewPendingEventHandlers()
+    toAppend->m_nextWithPendingEvents =
+        m_handlersWithNewPendingEvents.load(std::memory_order_relaxed);
+    while ( !m_handlersWithNewPendingEvents.compare_exchange_weak
+             (
+                toAppend->m_nextWithPendingEvents,
+                toAppend
+             ) )
+    {
+        // m_nextWithPendingEvents was updated to the current head by the
+        // failed call, so just try again
+    }
 }
 
 bool wxAppConsoleBase::HasPendingEvents() const
 {
     wxENTER_CRIT_SECT(const_cast<wxAppConsoleBase*>(this)->m_handlersWithPendingEventsLocker);
 
-    bool has = !m_handlersWithPendingEvents.IsEmpty();
+    bool has = !m_handlersWithPendingEvents.IsEmpty() ||
+                    m_handlersWithNewPendingEvents.load() != nullptr;
 
     wxLEAVE_CRIT_SECT(const_cast<wxAppConsoleBase*>(this)->m_handlersWithPendingEventsLocker);
 
@@ -545,15 +588,36 @@ void wxAppConsoleBase::ResumeProcessingOfPendingEvents()
     m_bDoPendingEventProcessing = true;
 }
 
+void wxAppConsoleBase::SetPendingEventsBudget(size_t maxEvents, long maxTime)
+{
+    wxASSERT_MSG( maxTime >= 0, "time limit can't be negative" );
+
+    m_pendingEventsMaxCount = maxEvents;
+    m_pendingEventsMaxTime = maxTime;
+}
+
 void wxAppConsoleBase::ProcessPendingEvents()
 {
     if ( m_bDoPendingEventProcessing )
     {
+        // don't bother measuring the time if there is no limit for it
+#if wxUSE_STOPWATCH
+        wxStopWatch sw;
+        const wxStopWatch* const stopWatch = m_pendingEventsMaxTime ? &sw
+                                                                    : nullptr;
+#else
+        const wxStopWatch* const stopWatch = nullptr;
+#endif // wxUSE_STOPWATCH
+
+        size_t processed = 0;
+
         wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
         wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                      "this helper list should be empty" );
 
+        MoveNewPendingEventHandlers();
+
         // iterate until the list becomes empty: the handlers remove themselves
         // from it when they don't have any more pending events
         while (!m_handlersWithPendingEvents.IsEmpty())
@@ -569,9 +633,36 @@ void wxAppConsoleBase::ProcessPendingEvents()
             // accessing m_handlersWithPendingEvents while we don't hold it.
             wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
-            handler->ProcessPendingEvents();
+            // process as many events of this handler as the budget allows in
+            // one go
+            processed += handler->DoProcessPendingEvents
+                                  (
+                                    m_pendingEventsMaxCount
+                                        ? m_pendingEventsMaxCount - processed
+                                        : 0,
+                                    stopWatch,
+                                    m_pendingEventsMaxTime
+                                  );
 
             wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
+
+            // take into account the handlers added while we were processing
+            MoveNewPendingEventHandlers();
+
+            const bool budgetExhausted =
+                (m_pendingEventsMaxCount && processed >= m_pendingEventsMaxCount)
+#if wxUSE_STOPWATCH
+                    || (stopWatch && stopWatch->Time() >= m_pendingEventsMaxTime)
+#endif // wxUSE_STOPWATCH
+                    ;
+
+            if ( budgetExhausted && !m_handlersWithPendingEvents.IsEmpty() )
+            {
+                // make sure we're called again soon to process the remaining
+                // events, even if nothing else happens
+                wxWakeUpIdle();
+                break;
+            }
         }
 
         // now the wxHandlersWithPendingEvents is surely empty; however some event
@@ -596,8 +687,14 @@ void wxAppConsoleBase::DeletePendingEvents()
     wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                  "this helper list should be empty" );
 
+    MoveNewPendingEventHandlers();
+
     for (unsigned int i=0; i<m_handlersWithPendingEvents.GetCount(); i++)
-        m_handlersWithPendingEvents[i]->DeletePendingEvents();
+    {
+        wxEvtHandler* const handler = m_handlersWithPendingEvents[i];
+        handler->DeletePendingEvents();
+        handler->m_isInPendingHandlersList = false;
+    }
 
     m_handlersWithPendingEvents.Clear();
 
@@ -47,6 +47,7 @@
 
 #if wxUSE_BASE
     #include <memory>
+    #include <unordered_map>
 #endif // wxUSE_BASE
 
 #if wxUSE_GUI
@@ -1187,13 +1188,109 @@ void wxEventHashTable::GrowEventTypeTable()
 // wxEvtHandler
 // ----------------------------------------------------------------------------
 
+struct wxEvtHandler::PendingEventNode
+{
+    explicit PendingEventNode(wxEvent* event_) : event(event_), next(nullptr) { }
+
+    wxEvent* event;
+    PendingEventNode* next;
+
+    // Only used for the events queued by QueueEventCoalesced().
+    wxIntPtr key = 0;
+    bool coalesce = false;
+};
+
+namespace
+{
+
+// Delete all events in the singly-linked list starting at the given node.
+template <typename T>
+void DeletePendingEventNodes(T* node)
+{
+    while ( node )
+    {
+        T* const next = node->next;
+        delete node->event;
+        delete node;
+        node = next;
+    }
+}
+
+// Find the first event which can be processed now in the given list, remove
+// it from the list and return it, or return null if there are none.
+//
+// The yielding event loop must be non-null if only the events allowed inside
+// yield should be taken from the list.
+template <typename T>
+T* TakeFirstProcessableEvent(T*& first, T*& last, wxEventLoopBase* yieldingLoop)
+{
+    T* node = first;
+    T* prev = nullptr;
+    if ( yieldingLoop )
+    {
+        while ( node &&
+                    !yieldingLoop->IsEventAllowedInsideYield(node->event->GetEventCategory()) )
+        {
+            prev = node;
+            node = node->next;
+        }
+    }
+
+    if ( !node )
+        return nullptr;
+
+    if ( prev )
+        prev->next = node->next;
+    else
+        first = node->next;
+
+    if ( last == node )
+        last = prev;
+
+    node->next = nullptr;
+
+    return node;
+}
+
+} // anonymous namespace
+
+struct wxEvtHandler::PendingEventsBatch
+{
+    explicit PendingEventsBatch(PendingEventsBatch* outer_)
+        : outer(outer_)
+    {
+    }
+
+    ~PendingEventsBatch()
+    {
+        DeletePendingEventNodes(first);
+    }
+
+    PendingEventNode* first = nullptr;
+    PendingEventNode* last = nullptr;
+
+    // The batch being processed by the outer call, if any.
+    PendingEventsBatch* const outer;
+
+    // Set by wxEvtHandler dtor if the handler is destroyed while processing
+    // the events of this batch.
+    bool handlerDestroyed = false;
+
+    wxDECLARE_NO_COPY_CLASS(PendingEventsBatch);
+};
+
 wxEvtHandler::wxEvtHandler()
+    : m_pendingEventsIncoming(nullptr),
+      m_isInPendingHandlersList(false)
 {
     m_nextHandler = nullptr;
     m_previousHandler = nullptr;
     m_enabled = true;
     m_dynamicEvents = nullptr;
     m_pendingEvents = nullptr;
+    m_pendingEventsLast = nullptr;
+    m_pendingEventsBatch = nullptr;
+    m_nextWithPendingEvents = nullptr;
 
     // no client data (yet)
     m_clientData = nullptr;
@@ -1230,6 +1327,15 @@ wxEvtHandler::~wxEvtHandler()
         }
     }
 
+    // Let DoProcessPendingEvents() know that it must not touch this object
+    // any more if we're deleted from inside it.
+    for ( PendingEventsBatch* batch = m_pendingEventsBatch;
+          batch;
+          batch = batch->outer )
+    {
+        batch->handlerDestroyed = true;
+    }
+
     // Remove us from the list of the pending events if necessary.
     if (wxTheApp)
         wxTheApp->RemovePendingEventHandler(this);
@@ -1331,111 +1437,297 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
         return;
     }
 
-    // 1) Add this event to our list of pending events
-    wxENTER_CRIT_SECT( m_pendingEventsLock );
-
-    if ( !m_pendingEvents )
-        m_pendingEvents = new wxList;
-
-    m_pendingEvents->Append(event);
+    // 1) Add this event to our stack of incoming pending events: this doesn't
+    //    take any locks, so that multiple threads can queue events for the
+    //    same handler without contending with each other or with the main
+    //    thread processing them.
+    PendingEventNode* const node = new PendingEventNode(event);
+    node->next = m_pendingEventsIncoming.load(std::memory_order_relaxed);
+    while ( !m_pendingEventsIncoming.compare_exchange_weak(node->next, node) )
+    {
+        // node->next was updated to the current head by the failed call, so
+        // just try again
+    }
 
     // 2) Add this event handler to list of event handlers that
-    //    have pending events.
-
+    //    have pending events, unless it's already there.
+    //
+    // Notice that this must be done after adding the event above: this is
+    // what guarantees that ProcessPendingEvents() either sees the new event
+    // or, if it had already removed this handler from the list, that we add
+    // it back to it here (see the end of that function).
     wxTheApp->AppendPendingEventHandler(this);
 
-    // only release m_pendingEventsLock now because otherwise there is a race
-    // condition as described in the ticket #9093: we could process the event
-    // just added to m_pendingEvents in our ProcessPendingEvents() below before
-    // we had time to append this pointer to wxHandlersWithPendingEvents list; thus
-    // breaking the invariant that a handler should be in the list iff it has
-    // any pending events to process
-    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
-
     // 3) Inform the system that new pending events are somewhere,
     //    and that these should be processed in idle time.
     wxWakeUpIdle();
 }
 
+void wxEvtHandler::QueueEventCoalesced(wxEvent *event, wxIntPtr key)
+{
+    wxCHECK_RET( event, "null event can't be posted" );
+
+    if (!wxTheApp)
+    {
+        wxLogDebug("No application object! Cannot queue this event!");
+
+        delete event;
+
+        return;
+    }
+
+    // Unlike QueueEvent(), we need to lock the list of pending events to find
+    // the event to replace in it, if any.
+    wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+    MoveIncomingPendingEvents();
+
+    for ( PendingEventNode* node = m_pendingEvents; node; node = node->next )
+    {
+        if ( node->coalesce &&
+                node->key == key &&
+                    node->event->GetEventType() == event->GetEventType() &&
+                        node->event->GetId() == event->GetId() )
+        {
+            // Replace the old event in place, so that the new one is processed
+            // at the position of the old one in the queue. Notice that we're
+            // already in the list of handlers with pending events as we have
+            // at least this event.
+            delete node->event;
+            node->event = event;
+
+            return;
+        }
+    }
+
+    PendingEventNode* const node = new PendingEventNode(event);
+    node->key = key;
+    node->coalesce = true;
+
+    if ( m_pendingEventsLast )
+        m_pendingEventsLast->next = node;
+    else
+        m_pendingEvents = node;
+
+    m_pendingEventsLast = node;
+
+    wxTheApp->AppendPendingEventHandler(this);
+
+    wxWakeUpIdle();
+}
+
+void wxEvtHandler::MoveIncomingPendingEvents()
+{
+    PendingEventNode* node = m_pendingEventsIncoming.exchange(nullptr);
+    if ( !node )
+        return;
+
+    // The incoming events are in reverse order, so reverse the list to get
+    // them in the order they were queued in.
+    PendingEventNode* const last = node;
+    PendingEventNode* first = nullptr;
+    while ( node )
+    {
+        PendingEventNode* const next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    if ( m_pendingEventsLast )
+        m_pendingEventsLast->next = first;
+    else
+        m_pendingEvents = first;
+
+    m_pendingEventsLast = last;
+}
+
 void wxEvtHandler::DeletePendingEvents()
 {
-    if (m_pendingEvents)
-        m_pendingEvents->DeleteContents(true);
-    wxDELETE(m_pendingEvents);
+    wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+    MoveIncomingPendingEvents();
+
+    DeletePendingEventNodes(m_pendingEvents);
+
+    m_pendingEvents = nullptr;
+    m_pendingEventsLast = nullptr;
 }
 
 void wxEvtHandler::ProcessPendingEvents()
+{
+    DoProcessPendingEvents(1);
+}
+
+size_t wxEvtHandler::DoProcessPendingEvents(size_t maxEvents,
+                                            const wxStopWatch* stopWatch,
+                                            long maxTime)
 {
     if (!wxTheApp)
     {
         // we need an event loop which manages the list of event handlers with
         // pending events... cannot proceed without it!
         wxLogDebug("No application object! Cannot process pending events!");
-        return;
+        return 0;
     }
 
-    // we need to process only a single pending event in this call because
-    // each call to ProcessEvent() could result in the destruction of this
-    // same event handler (see the comment at the end of this function)
+    // only the events allowed by YieldFor() can be processed if it's in
+    // progress
+    wxEventLoopBase* yieldingLoop = wxEventLoopBase::GetActive();
+    if ( yieldingLoop && !yieldingLoop->IsYielding() )
+        yieldingLoop = nullptr;
 
-    wxENTER_CRIT_SECT( m_pendingEventsLock );
+    const auto isBudgetExhausted = [=](size_t processed)
+    {
+        if ( maxEvents && processed >= maxEvents )
+            return true;
 
-    // this method is only called by wxApp if this handler does have
-    // pending events
-    wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
-                 "should have pending events if called" );
+#if wxUSE_STOPWATCH
+        if ( processed && stopWatch && stopWatch->Time() >= maxTime )
+            return true;
+#else
+        wxUnusedVar(stopWatch);
+        wxUnusedVar(maxTime);
+#endif // wxUSE_STOPWATCH
 
-    wxList::compatibility_iterator node = m_pendingEvents->GetFirst();
-    wxEvent* pEvent = static_cast<wxEvent *>(node->GetData());
+        return false;
+    };
 
-    // find the first event which can be processed now:
-    wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
-    if (evtLoop && evtLoop->IsYielding())
+    size_t processed = 0;
+
+    // If we're called from an event handler executed by an outer call to this
+    // function, process the remaining events of its batch first, as they had
+    // been queued before any events still in m_pendingEvents.
+    //
+    // Note that there is no need to lock anything here as the batch is only
+    // used by the thread processing it.
+    if ( PendingEventsBatch* const outer = m_pendingEventsBatch )
     {
-        while (node && pEvent && !evtLoop->IsEventAllowedInsideYield(pEvent->GetEventCategory()))
+        while ( !isBudgetExhausted(processed) )
         {
-            node = node->GetNext();
-            pEvent = node ? static_cast<wxEvent *>(node->GetData()) : nullptr;
+            PendingEventNode* const node =
+                TakeFirstProcessableEvent(outer->first, outer->last, yieldingLoop);
+            if ( !node )
+                break;
+
+            std::unique_ptr<wxEvent> event(node->event);
+            delete node;
+
+            SafelyProcessEvent(*event);
+            processed++;
+
+            // this object could have been deleted by the event handler, in
+            // which case the outer call will clean up its batch
+            if ( outer->handlerDestroyed )
+                return processed;
         }
 
-        if (!node)
-        {
-            // all our events are NOT processable now... signal this:
-            wxTheApp->DelayPendingEventHandler(this);
+        if ( processed )
+            return processed;
+    }
 
-            // see the comment at the beginning of evtloop.h header for the
-            // logic behind YieldFor() and behind DelayPendingEventHandler()
+    PendingEventsBatch batch(m_pendingEventsBatch);
 
-            wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+    // Detach all the events we're going to process now from m_pendingEvents
+    // while holding the lock, but process them without it.
+    wxENTER_CRIT_SECT( m_pendingEventsLock );
 
-            return;
-        }
+    MoveIncomingPendingEvents();
+
+    for ( size_t detached = 0; !maxEvents || detached < maxEvents; detached++ )
+    {
+        PendingEventNode* const
+            node = TakeFirstProcessableEvent(m_pendingEvents,
+                                             m_pendingEventsLast,
+                                             yieldingLoop);
+        if ( !node )
+            break;
+
+        if ( batch.last )
+            batch.last->next = node;
+        else
+            batch.first = node;
+
+        batch.last = node;
+    }
+
+    if ( !batch.first && m_pendingEvents )
+    {
+        // all our events are NOT processable now... signal this:
+        wxTheApp->DelayPendingEventHandler(this);
+
+        // see the comment at the beginning of evtloop.h header for the
+        // logic behind YieldFor() and behind DelayPendingEventHandler()
+
+        wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+        return processed;
     }
 
-    std::unique_ptr<wxEvent> event(pEvent);
+    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
 
-    // it's important we remove event from list before processing it, else a
-    // nested event loop, for example from a modal dialog, might process the
-    // same event again.
-    m_pendingEvents->Erase(node);
+    // Process the events of the batch one by one, removing each of them from
+    // it before processing it, as otherwise a nested event loop, for example
+    // from a modal dialog, could process the same event again.
+    m_pendingEventsBatch = &batch;
 
-    if ( m_pendingEvents->IsEmpty() )
+    while ( batch.first && !isBudgetExhausted(processed) )
+    {
+        PendingEventNode* const node = batch.first;
+        batch.first = node->next;
+        if ( !batch.first )
+            batch.last = nullptr;
+
+        std::unique_ptr<wxEvent> event(node->event);
+        delete node;
+
+        // We must not let exceptions escape from here, there is no outer exception
+        // handler to catch them and so letting them do it would just terminate the
+        // program.
+        SafelyProcessEvent(*event);
+        processed++;
+
+        // careful: this object could have been deleted by the event handler
+        // executed by the above ProcessEvent() call, so we can't access any
+        // fields of this object any more in this case and just let the batch
+        // dtor delete the remaining events
+        if ( batch.handlerDestroyed )
+            return processed;
+    }
+
+    m_pendingEventsBatch = batch.outer;
+
+    wxENTER_CRIT_SECT( m_pendingEventsLock );
+
+    // if we ran out of budget, put the remaining events back, in front of the
+    // events queued in the meanwhile
+    if ( batch.first )
+    {
+        batch.last->next = m_pendingEvents;
+        if ( !m_pendingEvents )
+            m_pendingEventsLast = batch.last;
+        m_pendingEvents = batch.first;
+
+        batch.first = nullptr;
+        batch.last = nullptr;
+    }
+
+    if ( !m_pendingEvents )
     {
         // if there are no more pending events left, we don't need to
         // stay in this list
         wxTheApp->RemovePendingEventHandler(this);
+
+        // but if another thread queued an event after our last call to
+        // MoveIncomingPendingEvents(), it could have not added us to the list
+        // because we were still in it, so do it now
+        if ( m_pendingEventsIncoming.load() )
+            wxTheApp->AppendPendingEventHandler(this);
     }
 
     wxLEAVE_CRIT_SECT( m_pendingEventsLock );
 
-    // We must not let exceptions escape from here, there is no outer exception
-    // handler to catch them and so letting them do it would just terminate the
-    // program.
-    SafelyProcessEvent(*event);
-
-    // careful: this object could have been deleted by the event handler
-    // executed by the above ProcessEvent() call, so we can't access any fields
-    // of this object any more
+    return processed;
 }
 
 /* static */
@@ -1765,6 +2057,106 @@ bool wxEvtHandler::SearchEventTable(wxEventTable& table, wxEvent& event)
     return false;
 }
 
+// ----------------------------------------------------------------------------
+// wxEvtHandler::DynamicEvents
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Minimal number of dynamically bound handlers for which we use the index by
+// event type: for fewer handlers, just iterating over all of them is faster.
+const size_t DYNAMIC_EVENTS_INDEX_THRESHOLD = 16;
+
+} // anonymous namespace
+
+struct wxEvtHandler::DynamicEvents::TypeIndex
+{
+    // Add the entry with the given index and type to the index.
+    void Add(size_t n, wxEventType eventType)
+    {
+        m_indices[eventType].push_back(n);
+    }
+
+    // Return the indices of the entries for the given event type, in the
+    // increasing order, or null if there are none.
+    //
+    // Notice that the returned pointer remains valid even if more entries are
+    // added to the index, as std::unordered_map doesn't invalidate references
+    // to its elements when inserting new ones, until Clear() is called.
+    const wxVector<size_t>* Find(wxEventType eventType) const
+    {
+        const auto it = m_indices.find(eventType);
+        return it == m_indices.end() ? nullptr : &it->second;
+    }
+
+    void Clear()
+    {
+        m_indices.clear();
+    }
+
+private:
+    std::unordered_map<wxEventType, wxVector<size_t>> m_indices;
+};
+
+wxEvtHandler::DynamicEvents::~DynamicEvents()
+{
+    delete m_typeIndex;
+}
+
+void wxEvtHandler::DynamicEvents::OnEntryAdded()
+{
+    const size_t n = m_entries.size() - 1;
+
+    if ( m_typeIndex )
+    {
+        m_typeIndex->Add(n, m_entries[n]->m_eventType);
+    }
+    else if ( m_entries.size() == DYNAMIC_EVENTS_INDEX_THRESHOLD )
+    {
+        m_typeIndex = new TypeIndex;
+        for ( size_t i = 0; i <= n; i++ )
+        {
+            if ( m_entries[i] )
+                m_typeIndex->Add(i, m_entries[i]->m_eventType);
+        }
+    }
+}
+
+void wxEvtHandler::DynamicEvents::PruneDeleted()
+{
+    size_t nNew = 0;
+    for ( size_t n = 0; n != m_entries.size(); n++ )
+    {
+        if ( m_entries[n] )
+            m_entries[nNew++] = m_entries[n];
+    }
+
+    wxASSERT( nNew != m_entries.size() );
+    m_entries.resize(nNew);
+    m_numDeleted = 0;
+
+    // The indices have changed, so rebuild the index from scratch, if we
+    // still need it.
+    if ( m_typeIndex )
+    {
+        if ( nNew < DYNAMIC_EVENTS_INDEX_THRESHOLD )
+        {
+            wxDELETE(m_typeIndex);
+        }
+        else
+        {
+            m_typeIndex->Clear();
+            for ( size_t n = 0; n != nNew; n++ )
+                m_typeIndex->Add(n, m_entries[n]->m_eventType);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// wxEvtHandler dynamic event handlers
+// ----------------------------------------------------------------------------
+
 void wxEvtHandler::DoBind(int id,
                           int lastId,
                           wxEventType eventType,
@@ -1788,6 +2180,7 @@ void wxEvtHandler::DoBind(int id,
     // in reverse direction in GetNextDynamicEntry() as it's more efficient
     // than inserting the element at the front.
     m_dynamicEvents->m_entries.push_back(entry);
+    m_dynamicEvents->OnEntryAdded();
 
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
@@ -1842,6 +2235,7 @@ wxEvtHandler::DoUnbind(int id,
             // vector, which is not guaranteed by our API, but here we can use
             // this implementation detail.
             m_dynamicEvents->m_entries[cookie] = nullptr;
+            m_dynamicEvents->m_numDeleted++;
 
             delete entry;
             return true;
@@ -1898,28 +2292,40 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
     DynamicEvents& dynamicEvents = *m_dynamicEvents;
 
     wxRecursionGuard guard(dynamicEvents.m_flag);
-    bool needToPruneDeleted = false;
+
+    const wxEventType eventType = event.GetEventType();
+
+    // If we have many handlers, only look at the ones for this event type.
+    //
+    // Notice that the entries can be bound (but not pruned, see below) while
+    // we iterate over them, so we must not keep any iterators or references
+    // into the vectors, only indices.
+    const wxVector<size_t>* candidates = nullptr;
+    size_t count = dynamicEvents.m_entries.size();
+    if ( dynamicEvents.m_typeIndex )
+    {
+        candidates = dynamicEvents.m_typeIndex->Find(eventType);
+        count = candidates ? candidates->size() : 0;
+    }
 
     // We can't use Get{First,Next}DynamicEntry() here as they hide the deleted
     // but not yet pruned entries from the caller, but here we do want to know
     // about them, so iterate directly. Remember to do it in the reverse order
     // to honour the order of handlers connection.
-    for ( size_t n = dynamicEvents.m_entries.size(); n; n-- )
+    for ( size_t k = count; k; k-- )
     {
-        wxDynamicEventTableEntry* const entry = dynamicEvents.m_entries[n - 1];
+        const size_t n = candidates ? (*candidates)[k - 1] : k - 1;
+        wxDynamicEventTableEntry* const entry = dynamicEvents.m_entries[n];
 
         if ( !entry )
         {
             // This entry must have been unbound at some time in the past, so
             // skip it now and really remove it from the vector below, once we
             // finish iterating.
-            // N.B.:  If we are in a nested call, then we can't be done
-            // iterating during this call
-            needToPruneDeleted = !guard.IsInside();
             continue;
         }
 
-        if ( event.GetEventType() == entry->m_eventType )
+        if ( eventType == entry->m_eventType )
         {
             wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
             if ( !handler )
@@ -1944,18 +2350,10 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
         }
     }
 
-    if ( needToPruneDeleted )
-    {
-        size_t nNew = 0;
-        for ( size_t n = 0; n != dynamicEvents.m_entries.size(); n++ )
-        {
-            if ( dynamicEvents.m_entries[n] )
-                dynamicEvents.m_entries[nNew++] = dynamicEvents.m_entries[n];
-        }
-
-        wxASSERT( nNew != dynamicEvents.m_entries.size() );
-        dynamicEvents.m_entries.resize(nNew);
-    }
+    // Remove the entries unbound in the past, unless we're in a nested call,
+    // in which case we can't be done iterating over them yet.
+    if ( dynamicEvents.m_numDeleted && !guard.IsInside() )
+        dynamicEvents.PruneDeleted();
 
     return false;
 }
@@ -2036,6 +2434,7 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
             // Just as in DoUnbind(), we use our knowledge of
             // GetNextDynamicEntry() implementation here.
             m_dynamicEvents->m_entries[cookie] = nullptr;
+            m_dynamicEvents->m_numDeleted++;
         }
     }
 }
@@ -16,11 +16,30 @@
 #include "wx/fswatcher.h"
 #include "wx/private/fswatcher.h"
 
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+    #include "wx/timer.h"
+#endif
+
+#include "wx/thread.h"
+
+#include <atomic>
+#include <memory>
+
+// Under MSW and macOS using FSEvents AddTree() doesn't need to add a watch for
+// each subdirectory, so there is no need to scan the tree in the background.
+#if wxUSE_THREADS && \
+    !defined(__WINDOWS__) && !defined(wxHAVE_FSEVENTS_FILE_NOTIFICATIONS)
+    #define wxHAS_FSW_TREE_SCANNER
+#endif
+
 // ============================================================================
 // helpers
 // ============================================================================
 
 wxDEFINE_EVENT(wxEVT_FSWATCHER, wxFileSystemWatcherEvent);
+wxDEFINE_EVENT(wxEVT_FSWATCHER_TREE_ADDED, wxFileSystemWatcherEvent);
+wxDEFINE_EVENT(wxEVT_FSWATCHER_BATCH, wxFileSystemWatcherBatchEvent);
 
 static wxString GetFSWEventChangeTypeName(int type)
 {
@@ -72,12 +91,291 @@ wxString wxFileSystemWatcherEvent::ToString() const
 }
 
 
+wxIMPLEMENT_DYNAMIC_CLASS(wxFileSystemWatcherBatchEvent, wxEvent);
+
 // ============================================================================
-// wxFileSystemWatcherEvent implementation
+// wxFSWEventCoalescer: accumulates the events sent as a single batch
+// ============================================================================
+
+#if wxUSE_TIMER
+
+class wxFSWEventCoalescer : public wxTimer
+{
+public:
+    wxFSWEventCoalescer(wxFileSystemWatcherBase* watcher, int interval) :
+        m_watcher(watcher),
+        m_interval(interval)
+    {
+    }
+
+    int GetInterval() const { return m_interval; }
+
+    void SetInterval(int interval) { m_interval = interval; }
+
+    void Add(const wxFileSystemWatcherEvent& event)
+    {
+        const int type = event.GetChangeType();
+        const wxString path = event.GetPath().GetFullPath();
+
+        // Indices of the still pending events for the same path.
+        std::vector<size_t>& indices = m_pathEvents[path];
+
+        switch ( type )
+        {
+            case wxFSW_EVENT_MODIFY:
+            case wxFSW_EVENT_ACCESS:
+            case wxFSW_EVENT_ATTRIB:
+                // Changes of a new file are not interesting, it's enough to
+                // report its creation, and neither are repeated changes.
+                if ( HasEvent(indices, wxFSW_EVENT_CREATE) ||
+                        HasEvent(indices, type) )
+                    return;
+                break;
+
+            case wxFSW_EVENT_DELETE:
+                for ( size_t i = indices.size(); i > 0; i-- )
+                {
+                    const size_t n = indices[i - 1];
+                    if ( !m_events[n] ||
+                            m_events[n]->GetChangeType() != wxFSW_EVENT_CREATE )
+                        continue;
+
+                    // The file didn't exist before its last creation and
+                    // doesn't exist now, so nothing happened since then from
+                    // the owner point of view.
+                    for ( size_t j = i - 1; j < indices.size(); j++ )
+                        m_events[indices[j]].reset();
+
+                    // But keep the events before it, e.g. the deletion of the
+                    // file which had existed before, as they still matter.
+                    indices.resize(i - 1);
+                    if ( indices.empty() )
+                        m_pathEvents.erase(path);
+                    return;
+                }
+
+                // Any changes to the file don't matter if it's deleted.
+                for ( size_t n : indices )
+                    m_events[n].reset();
+
+                indices.clear();
+                break;
+
+            case wxFSW_EVENT_CREATE:
+                break;
+
+            default:
+                // Don't merge the events before and after a rename or any
+                // other event.
+                m_pathEvents.erase(path);
+                if ( type == wxFSW_EVENT_RENAME )
+                    m_pathEvents.erase(event.GetNewPath().GetFullPath());
+
+                DoAdd(event);
+                return;
+        }
+
+        indices.push_back(m_events.size());
+        DoAdd(event);
+    }
+
+    void Flush()
+    {
+        Stop();
+
+        wxFileSystemWatcherBatchEvent batch;
+        for ( const auto& event : m_events )
+        {
+            if ( event )
+                batch.AddEvent(*event);
+        }
+
+        m_events.clear();
+        m_pathEvents.clear();
+
+        if ( !batch.GetEvents().empty() )
+            m_watcher->GetOwner()->ProcessEvent(batch);
+    }
+
+    virtual void Notify() override
+    {
+        Flush();
+    }
+
+private:
+    bool HasEvent(const std::vector<size_t>& indices, int type) const
+    {
+        for ( size_t n : indices )
+        {
+            if ( m_events[n] && m_events[n]->GetChangeType() == type )
+                return true;
+        }
+
+        return false;
+    }
+
+    void DoAdd(const wxFileSystemWatcherEvent& event)
+    {
+        m_events.emplace_back(new wxFileSystemWatcherEvent(event));
+
+        // Start the timer when the first event arrives and don't restart it
+        // for the subsequent ones to avoid delaying the batch indefinitely if
+        // the events keep coming.
+        if ( !IsRunning() )
+            StartOnce(m_interval);
+    }
+
+    wxFileSystemWatcherBase* const m_watcher;
+    int m_interval;
+
+    // The pending events, with the merged ones being reset.
+    std::vector<std::unique_ptr<wxFileSystemWatcherEvent>> m_events;
+
+    // Map of the paths to indices of the pending events for them in m_events.
+    std::unordered_map<wxString, std::vector<size_t>> m_pathEvents;
+
+    wxDECLARE_NO_COPY_CLASS(wxFSWEventCoalescer);
+};
+
+#endif // wxUSE_TIMER
+
+// ============================================================================
+// wxFSWTreeScanner: thread finding all subdirectories of a tree
+// ============================================================================
+
+#ifdef wxHAS_FSW_TREE_SCANNER
+
+namespace
+{
+
+// Number of directories found by wxFSWTreeScanner before passing them to the
+// main thread.
+const size_t FSW_SCAN_BATCH_SIZE = 256;
+
+} // anonymous namespace
+
+class wxFSWTreeScanner : public wxThread
+{
+public:
+    wxFSWTreeScanner(wxFileSystemWatcherBase* watcher,
+                     int id,
+                     const wxFileName& path,
+                     const wxString& root,
+                     int events,
+                     const wxString& filespec) :
+        wxThread(wxTHREAD_JOINABLE),
+        m_watcher(watcher),
+        m_id(id),
+        m_path(path),
+        m_root(root),
+        m_events(events),
+        m_filespec(filespec),
+        m_cancelled(false)
+    {
+    }
+
+    int GetId() const { return m_id; }
+    const wxString& GetRoot() const { return m_root; }
+    int GetEvents() const { return m_events; }
+    const wxString& GetFilespec() const { return m_filespec; }
+
+    // Must be called from the main thread.
+    void Cancel()
+    {
+        m_cancelled = true;
+        Wait();
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        class ScanTraverser : public wxDirTraverser
+        {
+        public:
+            explicit ScanTraverser(wxFSWTreeScanner* scanner) :
+                m_scanner(scanner)
+            {
+            }
+
+            virtual wxDirTraverseResult OnFile(const wxString& WXUNUSED(filename)) override
+            {
+                return wxDIR_CONTINUE;
+            }
+
+            virtual wxDirTraverseResult OnDir(const wxString& dirname) override
+            {
+                if ( m_scanner->m_cancelled )
+                    return wxDIR_STOP;
+
+                m_dirs.push_back(dirname);
+                if ( m_dirs.size() == FSW_SCAN_BATCH_SIZE )
+                    Post(false);
+
+                return wxDIR_CONTINUE;
+            }
+
+            void Post(bool done)
+            {
+                if ( m_scanner->m_cancelled )
+                    return;
+
+                // Note that we can't use m_scanner in the function called
+                // later as it may have been already deleted by then.
+                wxFileSystemWatcherBase* const watcher = m_scanner->m_watcher;
+                const int id = m_scanner->m_id;
+                std::vector<wxString> dirs;
+                dirs.swap(m_dirs);
+                watcher->CallAfter([watcher, id, dirs, done]()
+                    {
+                        watcher->OnTreeScanned(id, dirs, done);
+                    });
+            }
+
+        private:
+            wxFSWTreeScanner* const m_scanner;
+            std::vector<wxString> m_dirs;
+        };
+
+        // Use the same flags as AddTree() to prevent infinite loops in the
+        // trees containing symlinks.
+        int flags = wxDIR_DIRS | wxDIR_HIDDEN;
+        if ( !m_path.ShouldFollowLink() )
+        {
+            flags |= wxDIR_NO_FOLLOW;
+        }
+
+        ScanTraverser traverser(this);
+        wxDir dir(m_path.GetFullPath());
+        if ( dir.IsOpened() )
+            dir.Traverse(traverser, m_filespec, flags);
+
+        traverser.Post(true);
+
+        return nullptr;
+    }
+
+private:
+    wxFileSystemWatcherBase* const m_watcher;
+    const int m_id;
+    const wxFileName m_path;
+    const wxString m_root;
+    const int m_events;
+    const wxString m_filespec;
+
+    std::atomic<bool> m_cancelled;
+
+    wxDECLARE_NO_COPY_CLASS(wxFSWTreeScanner);
+};
+
+#endif // wxHAS_FSW_TREE_SCANNER
+
+// ============================================================================
+// wxFileSystemWatcherBase implementation
 // ============================================================================
 
 wxFileSystemWatcherBase::wxFileSystemWatcherBase() :
-    m_service(nullptr), m_owner(this)
+    m_service(nullptr), m_owner(this),
+    m_coalescer(nullptr), m_lastScanId(0)
 {
 }
 
@@ -85,6 +383,57 @@ wxFileSystemWatcherBase::~wxFileSystemWatcherBase()
 {
     RemoveAll();
     delete m_service;
+
+#if wxUSE_TIMER
+    delete m_coalescer;
+#endif // wxUSE_TIMER
+}
+
+void wxFileSystemWatcherBase::SetCoalescingInterval(int milliseconds)
+{
+#if wxUSE_TIMER
+    if ( milliseconds > 0 )
+    {
+        if ( m_coalescer )
+            m_coalescer->SetInterval(milliseconds);
+        else
+            m_coalescer = new wxFSWEventCoalescer(this, milliseconds);
+    }
+    else if ( m_coalescer )
+    {
+        // Don't lose the events accumulated so far.
+        wxFSWEventCoalescer* const coalescer = m_coalescer;
+        m_coalescer = nullptr;
+
+        coalescer->Flush();
+        delete coalescer;
+    }
+#else // !wxUSE_TIMER
+    wxUnusedVar(milliseconds);
+#endif // wxUSE_TIMER/!wxUSE_TIMER
+}
+
+int wxFileSystemWatcherBase::GetCoalescingInterval() const
+{
+#if wxUSE_TIMER
+    if ( m_coalescer )
+        return m_coalescer->GetInterval();
+#endif // wxUSE_TIMER
+
+    return 0;
+}
+
+void wxFileSystemWatcherBase::SendEvent(wxFileSystemWatcherEvent& event)
+{
+#if wxUSE_TIMER
+    if ( m_coalescer )
+    {
+        m_coalescer->Add(event);
+        return;
+    }
+#endif // wxUSE_TIMER
+
+    GetOwner()->ProcessEvent(event);
 }
 
 bool wxFileSystemWatcherBase::Add(const wxFileName& path, int events)
@@ -227,19 +576,147 @@ bool wxFileSystemWatcherBase::AddTree(const wxFileName& path, int events,
     return true;
 }
 
+bool wxFileSystemWatcherBase::AddTreeAsync(const wxFileName& path, int events,
+                                           const wxString& filespec)
+{
+    if (!path.DirExists())
+        return false;
+
+#ifdef wxHAS_FSW_TREE_SCANNER
+    // Add the root immediately, only the subdirectories are added later.
+    const wxFileName root(path.GetPathWithSep());
+    if ( !AddAny(root, events, wxFSWPath_Tree, filespec) )
+        return false;
+
+    wxFSWTreeScanner* const
+        scanner = new wxFSWTreeScanner(this, ++m_lastScanId,
+                                       path, GetCanonicalPath(root),
+                                       events, filespec);
+    if ( scanner->Run() != wxTHREAD_NO_ERROR )
+    {
+        delete scanner;
+
+        Remove(root);
+        return AddTree(path, events, filespec);
+    }
+
+    m_treeScanners.push_back(scanner);
+
+    wxLogTrace(wxTRACE_FSWATCHER,
+               "--- AddTreeAsync started scanning '%s' ---",
+               path.GetFullPath());
+#else // !wxHAS_FSW_TREE_SCANNER
+    if ( !AddTree(path, events, filespec) )
+        return false;
+
+    // Notify about the tree being added asynchronously, as promised.
+    const wxFileName root = wxFileName::DirName(GetCanonicalPath(path));
+    CallAfter([this, root]()
+        {
+            wxFileSystemWatcherEvent event(0, root, root);
+            event.SetEventType(wxEVT_FSWATCHER_TREE_ADDED);
+            GetOwner()->ProcessEvent(event);
+        });
+#endif // wxHAS_FSW_TREE_SCANNER/!wxHAS_FSW_TREE_SCANNER
+
+    return true;
+}
+
+void
+wxFileSystemWatcherBase::OnTreeScanned(int scanId,
+                                       const std::vector<wxString>& dirs,
+                                       bool done)
+{
+#ifdef wxHAS_FSW_TREE_SCANNER
+    std::vector<wxFSWTreeScanner*>::iterator it;
+    for ( it = m_treeScanners.begin(); it != m_treeScanners.end(); ++it )
+    {
+        if ( (*it)->GetId() == scanId )
+            break;
+    }
+
+    // The scan could have been cancelled since these results were posted.
+    if ( it == m_treeScanners.end() )
+        return;
+
+    wxFSWTreeScanner* const scanner = *it;
+    for ( const auto& dir : dirs )
+    {
+        if ( AddAny(wxFileName::DirName(dir), scanner->GetEvents(),
+                    wxFSWPath_Tree, scanner->GetFilespec()) )
+        {
+            wxLogTrace(wxTRACE_FSWATCHER,
+               "--- AddTreeAsync adding directory '%s' ---", dir);
+        }
+    }
+
+    if ( done )
+    {
+        m_treeScanners.erase(it);
+
+        const wxFileName root = wxFileName::DirName(scanner->GetRoot());
+
+        scanner->Wait();
+        delete scanner;
+
+        wxFileSystemWatcherEvent event(0, root, root);
+        event.SetEventType(wxEVT_FSWATCHER_TREE_ADDED);
+        GetOwner()->ProcessEvent(event);
+    }
+#else // !wxHAS_FSW_TREE_SCANNER
+    wxUnusedVar(scanId);
+    wxUnusedVar(dirs);
+    wxUnusedVar(done);
+#endif // wxHAS_FSW_TREE_SCANNER/!wxHAS_FSW_TREE_SCANNER
+}
+
+bool wxFileSystemWatcherBase::CancelTreeScans(const wxString& path)
+{
+    bool cancelled = false;
+
+#ifdef wxHAS_FSW_TREE_SCANNER
+    for ( size_t n = 0; n < m_treeScanners.size(); )
+    {
+        wxFSWTreeScanner* const scanner = m_treeScanners[n];
+        if ( path.empty() || scanner->GetRoot() == path )
+        {
+            scanner->Cancel();
+            delete scanner;
+
+            m_treeScanners.erase(m_treeScanners.begin() + n);
+            cancelled = true;
+        }
+        else
+        {
+            n++;
+        }
+    }
+#else // !wxHAS_FSW_TREE_SCANNER
+    wxUnusedVar(path);
+#endif // wxHAS_FSW_TREE_SCANNER/!wxHAS_FSW_TREE_SCANNER
+
+    return cancelled;
+}
+
 bool wxFileSystemWatcherBase::RemoveTree(const wxFileName& path)
 {
     if (!path.DirExists())
         return false;
 
+    // If the tree is still being added by AddTreeAsync(), only some of its
+    // directories are watched, so don't complain about the other ones.
+    const bool
+        partial = CancelTreeScans(GetCanonicalPath(path.GetPathWithSep()));
+
     // OPT could be optimised if we stored information about relationships
     // between paths
     class RemoveTraverser : public wxDirTraverser
     {
     public:
         RemoveTraverser(wxFileSystemWatcherBase* watcher,
-                        const wxString& filespec) :
-            m_watcher(watcher), m_filespec(filespec)
+                        const wxString& filespec,
+                        bool partial) :
+            m_watcher(watcher), m_filespec(filespec), m_partial(partial)
         {
         }
 
@@ -252,13 +729,19 @@ bool wxFileSystemWatcherBase::RemoveTree(const wxFileName& path)
 
         virtual wxDirTraverseResult OnDir(const wxString& dirname) override
         {
-            m_watcher->Remove(wxFileName::DirName(dirname));
+            const wxFileName dir = wxFileName::DirName(dirname);
+            if ( !m_partial ||
+                    m_watcher->m_watches.count(GetCanonicalPath(dir)) )
+            {
+                m_watcher->Remove(dir);
+            }
             return wxDIR_CONTINUE;
         }
 
     private:
         wxFileSystemWatcherBase* m_watcher;
         wxString m_filespec;
+        bool m_partial;
     };
 
     // If AddTree() used a filespec, we must use the same one
@@ -289,7 +772,7 @@ bool wxFileSystemWatcherBase::RemoveTree(const wxFileName& path)
     {
         flags |= wxDIR_NO_FOLLOW;
     }
-    RemoveTraverser traverser(this, filespec);
+    RemoveTraverser traverser(this, filespec, partial);
     dir.Traverse(traverser, filespec, flags);
 
     // As in AddTree() above, handle the path itself explicitly.
@@ -300,6 +783,8 @@ bool wxFileSystemWatcherBase::RemoveTree(const wxFileName& path)
 
 bool wxFileSystemWatcherBase::RemoveAll()
 {
+    CancelTreeScans();
+
     const bool ret = m_service->RemoveAll();
     m_watches.clear();
     return ret;
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "wx/gifdecod.h"
+#include "wx/mstream.h"
 #include "wx/scopedarray.h"
 #include "wx/scopeguard.h"
 
@@ -63,6 +64,12 @@ public:
     unsigned int ncolours;          // number of colours
     wxString comment;
 
+    // only used when decoding on demand
+    int interl;                     // interlaced flag
+    int bits;                       // initial code size
+    size_t offset;                  // offset of the compressed data
+    size_t length;                  // and its length
+
     wxDECLARE_NO_COPY_CLASS(GIFImage);
 };
 
@@ -81,6 +88,10 @@ GIFImage::GIFImage()
     p = (unsigned char *) nullptr;
     pal = (unsigned char *) nullptr;
     ncolours = 0;
+    interl = 0;
+    bits = 0;
+    offset = 0;
+    length = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -89,6 +100,8 @@ GIFImage::GIFImage()
 
 wxGIFDecoder::wxGIFDecoder()
 {
+    m_decodedFrame = 0;
+    m_decodeOnDemand = false;
 }
 
 wxGIFDecoder::~wxGIFDecoder()
@@ -109,6 +122,9 @@ void wxGIFDecoder::Destroy()
 
     m_frames.Clear();
     m_nFrames = 0;
+
+    m_compressed.clear();
+    m_decodedFrame = 0;
 }
 
 
@@ -137,8 +153,14 @@ bool wxGIFDecoder::ConvertToImage(unsigned int frame, wxImage *image) const
     if (!image->IsOk())
         return false;
 
-    pal = GetPalette(frame);
     src = GetData(frame);
+    if (!src)
+    {
+        image->Destroy();
+        return false;
+    }
+
+    pal = GetPalette(frame);
     dst = image->GetData();
     transparent = GetTransparentColourIndex(frame);
 
@@ -270,7 +292,14 @@ wxColour wxGIFDecoder::GetTransparentColour(unsigned int frame) const
                     pal[n*3 + 2]);
 }
 
-unsigned char* wxGIFDecoder::GetData(unsigned int frame) const    { return (GetFrame(frame)->p); }
+unsigned char* wxGIFDecoder::GetData(unsigned int frame) const
+{
+    if (m_decodeOnDemand && !DecodeFrame(frame))
+        return nullptr;
+
+    return (GetFrame(frame)->p);
+}
+
 unsigned char* wxGIFDecoder::GetPalette(unsigned int frame) const { return (GetFrame(frame)->pal); }
 unsigned int wxGIFDecoder::GetNcolours(unsigned int frame) const  { return (GetFrame(frame)->ncolours); }
 int wxGIFDecoder::GetTransparentColourIndex(unsigned int frame) const  { return (GetFrame(frame)->transparent); }
@@ -284,7 +313,7 @@ int wxGIFDecoder::GetTransparentColourIndex(unsigned int frame) const  { return
 // getcode:
 //  Reads the next code from the file stream, with size 'bits'
 //
-int wxGIFDecoder::getcode(wxInputStream& stream, int bits, int ab_fin)
+int wxGIFDecoder::getcode(wxInputStream& stream, int bits, int ab_fin) const
 {
     unsigned int mask;          // bit mask
     unsigned int code;          // code (result)
@@ -346,7 +375,7 @@ int wxGIFDecoder::getcode(wxInputStream& stream, int bits, int ab_fin)
 //  Returns wxGIF_OK (== 0) on success, or an error code if something
 // fails (see header file for details)
 wxGIFErrorCode
-wxGIFDecoder::dgif(wxInputStream& stream, GIFImage *img, int interl, int bits)
+wxGIFDecoder::dgif(wxInputStream& stream, GIFImage *img, int interl, int bits) const
 {
     static const int allocSize = 4096 + 1;
 
@@ -590,6 +619,71 @@ as an End of Information itself)
 }
 
 
+// ReadDataBlocks:
+//  Copies the data sub-blocks of the current image, including their size
+//  bytes and the terminating empty block, to m_compressed without decoding
+//  them. If the stream is truncated, copies as much as can be read, exactly
+//  as much data as dgif() would have used then.
+void wxGIFDecoder::ReadDataBlocks(wxInputStream& stream)
+{
+    for ( ;; )
+    {
+        const int len = stream.GetC();
+        if (stream.Eof() || len == wxEOF)
+            break;
+
+        const size_t start = m_compressed.size();
+        m_compressed.resize(start + 1 + len);
+        m_compressed[start] = static_cast<unsigned char>(len);
+        if (len == 0)
+            break;
+
+        stream.Read(&m_compressed[start + 1], len);
+        if (stream.LastRead() != static_cast<size_t>(len))
+        {
+            m_compressed.resize(start + 1 + stream.LastRead());
+            break;
+        }
+    }
+}
+
+// DecodeFrame:
+//  Decodes the given frame from the data saved by ReadDataBlocks(), after
+//  freeing the data of the previously decoded frame to keep memory usage
+//  independent of the number of frames.
+bool wxGIFDecoder::DecodeFrame(unsigned int frame) const
+{
+    GIFImage* const img = GetFrame(frame);
+    if (img->p)
+        return true;
+
+    if (m_decodedFrame < m_nFrames)
+    {
+        GIFImage* const prev = GetFrame(m_decodedFrame);
+        free(prev->p);
+        prev->p = nullptr;
+    }
+
+    m_decodedFrame = m_nFrames;
+
+    img->p = (unsigned char *) malloc((size_t)img->w * img->h);
+    if (!img->p)
+        return false;
+
+    wxMemoryInputStream stream(m_compressed.data() + img->offset, img->length);
+    if (dgif(stream, img, img->interl, img->bits) != wxGIF_OK)
+    {
+        free(img->p);
+        img->p = nullptr;
+        return false;
+    }
+
+    m_decodedFrame = frame;
+
+    return true;
+}
+
+
 // CanRead:
 //  Returns true if the file looks like a valid GIF, false otherwise.
 //
@@ -834,11 +928,10 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
                 pimg->disposal = disposal;
                 pimg->delay = delay;
 
-                // allocate memory for image and palette
-                pimg->p   = (unsigned char *) malloc((unsigned int)size);
+                // allocate memory for palette
                 pimg->pal = (unsigned char *) malloc(768);
 
-                if ((!pimg->p) || (!pimg->pal))
+                if (!pimg->pal)
                     return wxGIF_MEMERR;
 
                 // load local color map if available, else use global map
@@ -862,10 +955,27 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
                 if (stream.Eof() || bits <= 0)
                     return wxGIF_INVFORMAT;
 
-                // decode image
-                wxGIFErrorCode result = dgif(stream, pimg.get(), interl, bits);
-                if (result != wxGIF_OK)
-                    return result;
+                if (m_decodeOnDemand)
+                {
+                    // just remember where the image data is, it will be
+                    // decoded by DecodeFrame() when it's needed
+                    pimg->interl = interl;
+                    pimg->bits = bits;
+                    pimg->offset = m_compressed.size();
+                    ReadDataBlocks(stream);
+                    pimg->length = m_compressed.size() - pimg->offset;
+                }
+                else
+                {
+                    // allocate memory for image and decode it
+                    pimg->p = (unsigned char *) malloc((unsigned int)size);
+                    if (!pimg->p)
+                        return wxGIF_MEMERR;
+
+                    wxGIFErrorCode result = dgif(stream, pimg.get(), interl, bits);
+                    if (result != wxGIF_OK)
+                        return result;
+                }
 
                 guardDestroy.Dismiss();
 
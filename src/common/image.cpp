@@ -26,11 +26,19 @@
 
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
+#include "wx/private/image.h"
+
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+#endif
 
 // For memcpy
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
 #include <unordered_set>
+#include <vector>
 
 // make the code compile with either wxFile*Stream or wxFFile*Stream:
 #define HAS_FILE_STREAMS (wxUSE_STREAMS && (wxUSE_FILE || wxUSE_FFILE))
@@ -657,84 +665,86 @@ void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
     }
 }
 
-} // anonymous namespace
-
-wxImage wxImage::ResampleBox(int width, int height) const
+// Compute the box averages for ResampleBox() using the given type for the
+// sums of the pixel values over a single source image column.
+template <typename T>
+void DoResampleBox(const unsigned char* src_data,
+                   const unsigned char* src_alpha,
+                   int old_width,
+                   const wxVector<BoxPrecalc>& vPrecalcs,
+                   const wxVector<BoxPrecalc>& hPrecalcs,
+                   unsigned char* dst_data,
+                   unsigned char* dst_alpha)
 {
-    wxCHECK_MSG( IsOk(), {}, "invalid image" );
-
-    // This function implements a simple pre-blur/box averaging method for
-    // downsampling that gives reasonably smooth results To scale the image
-    // down we will need to gather a grid of pixels of the size of the scale
-    // factor in each direction and then do an averaging of the pixels.
-
-    wxImage ret_image(width, height, false);
-
-    wxVector<BoxPrecalc> vPrecalcs(height);
-    wxVector<BoxPrecalc> hPrecalcs(width);
+    const int width = hPrecalcs.size();
+    const int height = vPrecalcs.size();
 
-    ResampleBoxPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    // We sum the values of the pixels in the vertical box for all source
+    // columns first, which can be done with a simple loop over contiguous
+    // memory that the compiler can vectorize, and then sum these sums over
+    // the horizontal box for each destination pixel. All computations use
+    // integers and so give exactly the same result as averaging all the
+    // pixels of the box directly.
+    const int channels = src_alpha ? 4 : 3;
+    wxVector<T> colSums(old_width*channels);
 
+    for ( int y = 0; y < height; y++ )
+    {
+        const BoxPrecalc& vPrecalc = vPrecalcs[y];
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = nullptr;
-
-    wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
+        std::fill(colSums.begin(), colSums.end(), T(0));
+        T* const sums = &colSums[0];
 
-    if ( src_alpha )
-    {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
+        for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+        {
+            const unsigned char* const src = src_data + j*old_width*3;
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+            if ( src_alpha )
+            {
+                const unsigned char* const alpha = src_alpha + j*old_width;
+                for ( int i = 0; i < old_width; i++ )
+                {
+                    const T a = alpha[i];
+                    sums[4*i + 0] += src[3*i + 0] * a;
+                    sums[4*i + 1] += src[3*i + 1] * a;
+                    sums[4*i + 2] += src[3*i + 2] * a;
+                    sums[4*i + 3] += a;
+                }
+            }
+            else
+            {
+                for ( int i = 0; i < old_width*3; i++ )
+                    sums[i] += src[i];
+            }
+        }
 
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
-    {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+        const int boxHeight = vPrecalc.boxEnd - vPrecalc.boxStart + 1;
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
+        for ( int x = 0; x < width; x++ )
         {
-            // Source pixel in the X direction
             const BoxPrecalc& hPrecalc = hPrecalcs[x];
 
-            // Box of pixels to average
-            averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
-                                * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+            const wxUint64 averaged_pixels =
+                wxUint64(hPrecalc.boxEnd - hPrecalc.boxStart + 1) * boxHeight;
+
+            wxUint64 sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            const T* s = sums + hPrecalc.boxStart*channels;
+            for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+                sum_r += s[0];
+                sum_g += s[1];
+                sum_b += s[2];
+                if ( src_alpha )
+                    sum_a += s[3];
 
-                    if (src_alpha)
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
-                    }
-                }
+                s += channels;
             }
 
             // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
+            if ( src_alpha )
             {
-                if (sum_a != 0)
+                if ( sum_a != 0 )
                 {
                     dst_data[0] = (unsigned char)(sum_r / sum_a);
                     dst_data[1] = (unsigned char)(sum_g / sum_a);
@@ -757,6 +767,61 @@ wxImage wxImage::ResampleBox(int width, int height) const
             dst_data += 3;
         }
     }
+}
+
+} // anonymous namespace
+
+wxImage wxImage::ResampleBox(int width, int height) const
+{
+    wxCHECK_MSG( IsOk(), {}, "invalid image" );
+
+    // This function implements a simple pre-blur/box averaging method for
+    // downsampling that gives reasonably smooth results To scale the image
+    // down we will need to gather a grid of pixels of the size of the scale
+    // factor in each direction and then do an averaging of the pixels.
+
+    wxImage ret_image(width, height, false);
+
+    wxVector<BoxPrecalc> vPrecalcs(height);
+    wxVector<BoxPrecalc> hPrecalcs(width);
+
+    ResampleBoxPrecalc(vPrecalcs, M_IMGDATA->m_height);
+    ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
+
+
+    const unsigned char* src_data = M_IMGDATA->m_data;
+    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
+    unsigned char* dst_data = ret_image.GetData();
+    unsigned char* dst_alpha = nullptr;
+
+    wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
+
+    if ( src_alpha )
+    {
+        ret_image.SetAlpha();
+        dst_alpha = ret_image.GetAlpha();
+    }
+
+    // Use 32 bit sums for the columns unless the vertical box is so big that
+    // they could overflow, which only happens when shrinking by huge factors.
+    int maxBoxHeight = 0;
+    for ( const BoxPrecalc& vPrecalc : vPrecalcs )
+    {
+        const int boxHeight = vPrecalc.boxEnd - vPrecalc.boxStart + 1;
+        if ( boxHeight > maxBoxHeight )
+            maxBoxHeight = boxHeight;
+    }
+
+    if ( wxUint64(maxBoxHeight)*255*255 <= 0xffffffffu )
+    {
+        DoResampleBox<wxUint32>(src_data, src_alpha, M_IMGDATA->m_width,
+                                vPrecalcs, hPrecalcs, dst_data, dst_alpha);
+    }
+    else
+    {
+        DoResampleBox<wxUint64>(src_data, src_alpha, M_IMGDATA->m_width,
+                                vPrecalcs, hPrecalcs, dst_data, dst_alpha);
+    }
 
     return ret_image;
 }
@@ -819,6 +884,43 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
+// Interpolate the given source image row horizontally, storing the RGB values
+// of all destination pixels in the first output array and their alpha values
+// in the second one (only used if the source has alpha channel).
+void ResampleBilinearRow(const unsigned char* src_data,
+                         const unsigned char* src_alpha,
+                         const wxVector<BilinearPrecalc>& hPrecalcs,
+                         double* out_data,
+                         double* out_alpha)
+{
+    const int width = hPrecalcs.size();
+    for ( int dstx = 0; dstx < width; dstx++ )
+    {
+        const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+
+        const unsigned char* const src1 = src_data + hPrecalc.offset1 * 3;
+        const unsigned char* const src2 = src_data + hPrecalc.offset2 * 3;
+        const double dx = hPrecalc.dd;
+        const double dx1 = hPrecalc.dd1;
+
+        out_data[0] = src1[0] * dx1 + src2[0] * dx;
+        out_data[1] = src1[1] * dx1 + src2[1] * dx;
+        out_data[2] = src1[2] * dx1 + src2[2] * dx;
+        out_data += 3;
+    }
+
+    if ( src_alpha )
+    {
+        for ( int dstx = 0; dstx < width; dstx++ )
+        {
+            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+
+            out_alpha[dstx] = src_alpha[hPrecalc.offset1] * hPrecalc.dd1 +
+                                src_alpha[hPrecalc.offset2] * hPrecalc.dd;
+        }
+    }
+}
+
 } // anonymous namespace
 
 wxImage wxImage::ResampleBilinear(int width, int height) const
@@ -845,59 +947,77 @@ wxImage wxImage::ResampleBilinear(int width, int height) const
     ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
+    const int old_width = M_IMGDATA->m_width;
+
+    // As the interpolation is separable, we first interpolate the two source
+    // rows used for each destination row horizontally and then combine them.
+    // The horizontally interpolated rows are kept between iterations, as the
+    // consecutive destination rows often use the same source rows, and both
+    // loops operate on contiguous arrays, allowing them to be vectorized.
+    // Note that the computations are done in the same order as when doing
+    // everything in a single loop, so the results are exactly the same.
+    wxVector<double> rowsData(2*width*3);
+    wxVector<double> rowsAlpha(src_alpha ? 2*width : 0);
+
+    double* row_data[2] = { &rowsData[0], &rowsData[width*3] };
+    double* row_alpha[2] = { nullptr, nullptr };
+    if ( src_alpha )
+    {
+        row_alpha[0] = &rowsAlpha[0];
+        row_alpha[1] = &rowsAlpha[width];
+    }
+
+    // Source rows currently stored in row_data and row_alpha.
+    int row_src[2] = { -1, -1 };
 
     for ( int dsty = 0; dsty < height; dsty++ )
     {
         // We need to calculate the source pixel to interpolate from - Y-axis
         const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
         const double dy = vPrecalc.dd;
         const double dy1 = vPrecalc.dd1;
 
-
-        for ( int dstx = 0; dstx < width; dstx++ )
+        // Reuse the previously interpolated rows if possible: typically the
+        // first row of this destination row is the second one of the
+        // previous destination row.
+        const int offsets[2] = { vPrecalc.offset1, vPrecalc.offset2 };
+        if ( row_src[0] != offsets[0] && row_src[1] == offsets[0] )
         {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+            std::swap(row_data[0], row_data[1]);
+            std::swap(row_alpha[0], row_alpha[1]);
+            std::swap(row_src[0], row_src[1]);
+        }
 
-            // result lines
+        for ( int n = 0; n < 2; n++ )
+        {
+            if ( row_src[n] == offsets[n] )
+                continue;
+
+            ResampleBilinearRow(src_data + offsets[n] * old_width * 3,
+                                src_alpha ? src_alpha + offsets[n] * old_width
+                                          : nullptr,
+                                hPrecalcs, row_data[n], row_alpha[n]);
+            row_src[n] = offsets[n];
+        }
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
+        // result lines
+        const double* const data1 = row_data[0];
+        const double* const data2 = row_data[1];
+        for ( int i = 0; i < width*3; i++ )
+        {
+            dst_data[i] = static_cast<unsigned char>(data1[i] * dy1 + data2[i] * dy + .5);
+        }
+        dst_data += width*3;
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+        if ( src_alpha )
+        {
+            const double* const alpha1 = row_alpha[0];
+            const double* const alpha2 = row_alpha[1];
+            for ( int i = 0; i < width; i++ )
+            {
+                dst_alpha[i] = static_cast<unsigned char>(alpha1[i] * dy1 + alpha2[i] * dy +.5);
+            }
+            dst_alpha += width;
         }
     }
 
@@ -1030,11 +1150,23 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
+    const int old_width = M_IMGDATA->m_width;
+
     for ( int dsty = 0; dsty < height; dsty++ )
     {
         // We need to calculate the source pixel to interpolate from - Y-axis
         const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
 
+        // Source rows used for this destination row.
+        const unsigned char* src_rows[4];
+        const unsigned char* alpha_rows[4] = { nullptr };
+        for ( int k = 0; k < 4; k++ )
+        {
+            src_rows[k] = src_data + vPrecalc.offset[k] * old_width * 3;
+            if ( src_alpha )
+                alpha_rows[k] = src_alpha + vPrecalc.offset[k] * old_width;
+        }
+
         for ( int dstx = 0; dstx < width; dstx++ )
         {
             // X-axis of pixel to interpolate from
@@ -1043,43 +1175,52 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
             // Sums for each color channel
             double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+            // Here we actually determine the RGBA values for the destination
+            // pixel: the weight for each pixel is computed according to the
+            // bicubic b-spline kernel we're using for interpolation and
+            // the sum of all values for each color channel adjusted for the
+            // pixel's weight is computed. Note that the alpha check is done
+            // outside of the loops to avoid doing it for every pixel.
+            if ( src_alpha )
             {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
-
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
+                for ( int k = 0; k < 4; k++ )
                 {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
+                    const unsigned char* const src_row = src_rows[k];
+                    const unsigned char* const alpha_row = alpha_rows[k];
+
+                    for ( int i = 0; i < 4; i++ )
                     {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
+                        const int x_offset = hPrecalc.offset[i];
+                        const unsigned char* const src = src_row + x_offset * 3;
+
+                        const double
+                            pixel_weight = vPrecalc.weight[k] * hPrecalc.weight[i];
+
+                        const unsigned char a = alpha_row[x_offset];
+                        sum_r += src[0] * pixel_weight * a;
+                        sum_g += src[1] * pixel_weight * a;
+                        sum_b += src[2] * pixel_weight * a;
                         sum_a += a * pixel_weight;
                     }
-                    else
+                }
+            }
+            else
+            {
+                for ( int k = 0; k < 4; k++ )
+                {
+                    const unsigned char* const src_row = src_rows[k];
+
+                    for ( int i = 0; i < 4; i++ )
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
+                        const unsigned char* const
+                            src = src_row + hPrecalc.offset[i] * 3;
+
+                        const double
+                            pixel_weight = vPrecalc.weight[k] * hPrecalc.weight[i];
+
+                        sum_r += src[0] * pixel_weight;
+                        sum_g += src[1] * pixel_weight;
+                        sum_b += src[2] * pixel_weight;
                     }
                 }
             }
@@ -1115,6 +1256,40 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     return ret_image;
 }
 
+namespace
+{
+
+// Helper computing the average of blurArea pixel values from their sum.
+//
+// Integer division is relatively slow and, as it has to be done for every
+// pixel component, dominates the blur time, so we use multiplication by the
+// precomputed inverse instead. This is exact as long as sum*blurArea < 2^48,
+// which is always the case for sum <= 255*blurArea with the limit on
+// blurArea below, and we fall back on the division for the bigger values.
+class BlurAverager
+{
+public:
+    explicit BlurAverager(int blurArea)
+        : m_blurArea(blurArea),
+          m_mult(blurArea < (1 << 20) ? (wxUint64(1) << 48) / blurArea + 1 : 0)
+    {
+    }
+
+    unsigned char operator()(long sum) const
+    {
+        if ( m_mult )
+            return (unsigned char)((wxUint64(sum) * m_mult) >> 48);
+
+        return (unsigned char)(sum / m_blurArea);
+    }
+
+private:
+    const int m_blurArea;
+    const wxUint64 m_mult;
+};
+
+} // anonymous namespace
+
 // Blur in the horizontal direction
 wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
@@ -1127,91 +1302,78 @@ wxImage wxImage::BlurHorizontal(int blurRadius) const
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_alpha = ret_image.GetAlpha();
 
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
+
     // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+    const BlurAverager average(blurRadius*2 + 1);
 
     // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
+    // radius in the X or horizontal direction, using the edge pixels for the
+    // pixels outside of the image.
+    //
+    // The alpha channel, if any, is blurred separately in the same way to
+    // avoid checking for it for every pixel.
+    for ( int y = 0; y < height; y++ )
     {
+        const unsigned char* const src = src_data + y*width*3;
+        unsigned char* const dst = dst_data + y*width*3;
+
         // Variables used in the blurring algorithm
         long sum_r = 0,
              sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
+             sum_b = 0;
 
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
+        // Calculate the sum of all pixels in the blur radius for the first
         // pixel of the row
         for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
         {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            const int x = wxMin(wxMax(kernel_x, 0), width - 1);
+            sum_r += src[x*3 + 0];
+            sum_g += src[x*3 + 1];
+            sum_b += src[x*3 + 2];
         }
 
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+        dst[0] = average(sum_r);
+        dst[1] = average(sum_g);
+        dst[2] = average(sum_b);
 
         // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
+        // blur radius box along the row, subtracting the value of the pixel
+        // at the left side of the box and adding the one at its right side.
+        for ( int x = 1; x < width; x++ )
         {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+            const int left = wxMax(x - blurRadius - 1, 0);
+            const int right = wxMin(x + blurRadius, width - 1);
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            sum_r += src[right*3 + 0] - src[left*3 + 0];
+            sum_g += src[right*3 + 1] - src[left*3 + 1];
+            sum_b += src[right*3 + 2] - src[left*3 + 2];
 
             // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+            dst[x*3 + 0] = average(sum_r);
+            dst[x*3 + 1] = average(sum_g);
+            dst[x*3 + 2] = average(sum_b);
+        }
+
+        if ( !src_alpha )
+            continue;
+
+        const unsigned char* const alpha = src_alpha + y*width;
+        unsigned char* const dstAlpha = dst_alpha + y*width;
+
+        long sum_a = 0;
+        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
+            sum_a += alpha[wxMin(wxMax(kernel_x, 0), width - 1)];
+
+        dstAlpha[0] = average(sum_a);
+
+        for ( int x = 1; x < width; x++ )
+        {
+            sum_a += alpha[wxMin(x + blurRadius, width - 1)] -
+                        alpha[wxMax(x - blurRadius - 1, 0)];
+
+            dstAlpha[x] = average(sum_a);
         }
     }
 
@@ -1230,91 +1392,76 @@ wxImage wxImage::BlurVertical(int blurRadius) const
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_alpha = ret_image.GetAlpha();
 
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
+
     // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+    const BlurAverager average(blurRadius*2 + 1);
+
+    // Vertical blurring algorithm - same as horizontal but in the opposite
+    // direction. Instead of going along each column, which would access the
+    // memory with a big stride, we keep the sums for all the columns and
+    // move the blur radius box down for all of them at once, which allows
+    // processing entire rows in simple loops.
+    const int rowLen = width*3;
 
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
+    wxVector<long> sumsData(rowLen);
+    wxVector<long> sumsAlpha(src_alpha ? width : 0);
+    long* const sums = &sumsData[0];
+    long* const sums_a = src_alpha ? &sumsAlpha[0] : nullptr;
+
+    // Calculate the sum of all pixels in our blur radius box for the first
+    // pixel of each column, using the edge pixels for the pixels outside of
+    // the image.
+    for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
     {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
+        const int y = wxMin(wxMax(kernel_y, 0), height - 1);
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
+        const unsigned char* const src = src_data + y*rowLen;
+        for ( int i = 0; i < rowLen; i++ )
+            sums[i] += src[i];
 
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
         if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
         {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
+            const unsigned char* const alpha = src_alpha + y*width;
+            for ( int x = 0; x < width; x++ )
+                sums_a[x] += alpha[x];
+        }
+    }
 
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+    for ( int y = 0; y < height; y++ )
+    {
+        if ( y > 0 )
+        {
+            // Subtract the values of the row at the top of our blur radius
+            // box and add the values of the row being added to its bottom.
+            const int top = wxMax(y - blurRadius - 1, 0);
+            const int bottom = wxMin(y + blurRadius, height - 1);
 
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+            const unsigned char* const srcTop = src_data + top*rowLen;
+            const unsigned char* const srcBottom = src_data + bottom*rowLen;
+            for ( int i = 0; i < rowLen; i++ )
+                sums[i] += srcBottom[i] - srcTop[i];
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
             if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            {
+                const unsigned char* const alphaTop = src_alpha + top*width;
+                const unsigned char* const alphaBottom = src_alpha + bottom*width;
+                for ( int x = 0; x < width; x++ )
+                    sums_a[x] += alphaBottom[x] - alphaTop[x];
+            }
+        }
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+        // Save off the averaged data
+        unsigned char* const dst = dst_data + y*rowLen;
+        for ( int i = 0; i < rowLen; i++ )
+            dst[i] = average(sums[i]);
+
+        if ( src_alpha )
+        {
+            unsigned char* const dstAlpha = dst_alpha + y*width;
+            for ( int x = 0; x < width; x++ )
+                dstAlpha[x] = average(sums_a[x]);
         }
     }
 
@@ -2893,8 +3040,17 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
 {
     // save the options values which can be clobbered by the handler (e.g. many
     // of them call Destroy() before trying to load the file)
-    const unsigned maxWidth = GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
-                   maxHeight = GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+    const wxImageLoadOptions options(*this);
+
+    // the handlers supporting loading only the given region set the original
+    // image size options, so reset them to be able to check if it was done
+    if ( options.HasRegion() && HasOption(wxIMAGE_OPTION_ORIGINAL_WIDTH) )
+    {
+        SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, 0);
+        SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, 0);
+    }
+
+    const bool verbose = (M_IMGDATA->m_loadFlags & Load_Verbose) != 0;
 
     // Preserve the original stream position if possible to rewind back to it
     // if we failed to load the file -- maybe the next handler that we try can
@@ -2903,8 +3059,7 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
     if ( stream.IsSeekable() )
         posOld = stream.TellI();
 
-    if ( !handler.LoadFile(this, stream,
-                           (M_IMGDATA->m_loadFlags & Load_Verbose) != 0, index) )
+    if ( !handler.LoadFile(this, stream, verbose, index) )
     {
         if ( posOld != wxInvalidOffset )
             stream.SeekI(posOld);
@@ -2912,30 +3067,59 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
         return false;
     }
 
-    // rescale the image to the specified size if needed
-    if ( maxWidth || maxHeight )
+    // extract the specified region if the handler didn't do it already
+    if ( options.HasRegion() && !GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) )
     {
-        const unsigned widthOrig = GetWidth(),
-                       heightOrig = GetHeight();
+        const wxSize sizeOrig = GetSize();
+        const wxRect rect = options.GetRegion(sizeOrig);
+        if ( rect.IsEmpty() )
+        {
+            if ( verbose )
+            {
+                wxLogError(_("The requested region is outside of the image."));
+            }
 
-        // this uses the same (trivial) algorithm as the JPEG handler
-        unsigned width = widthOrig,
-                 height = heightOrig;
-        while ( (maxWidth && width > maxWidth) ||
-                    (maxHeight && height > maxHeight) )
+            Destroy();
+
+            if ( posOld != wxInvalidOffset )
+                stream.SeekI(posOld);
+
+            return false;
+        }
+
+        if ( rect.GetSize() != sizeOrig )
         {
-            width /= 2;
-            height /= 2;
+            wxImage sub = GetSubImage(rect);
+
+            // preserve the options set by the handler
+            wxImageRefData* const subData =
+                static_cast<wxImageRefData*>(sub.m_refData);
+            subData->m_optionNames = M_IMGDATA->m_optionNames;
+            subData->m_optionValues = M_IMGDATA->m_optionValues;
+
+            *this = sub;
         }
 
-        if ( width != widthOrig || height != heightOrig )
+        SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, sizeOrig.x);
+        SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, sizeOrig.y);
+    }
+
+    // rescale the image to the specified size if needed
+    if ( options.HasMaxSize() )
+    {
+        const int widthOrig = GetWidth(),
+                  heightOrig = GetHeight();
+
+        // this uses the same (trivial) algorithm as the JPEG handler
+        const int scale = options.GetScaleDenom(GetSize());
+        if ( scale != 1 )
         {
             // get the original size if it was set by the image handler
             // but also in order to restore it after Rescale
             int widthOrigOption = GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH),
                 heightOrigOption = GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT);
 
-            Rescale(width, height, wxIMAGE_QUALITY_HIGH);
+            Rescale(widthOrig / scale, heightOrig / scale, wxIMAGE_QUALITY_HIGH);
 
             SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, widthOrigOption ? widthOrigOption : widthOrig);
             SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, heightOrigOption ? heightOrigOption : heightOrig);
@@ -3730,11 +3914,11 @@ wxImage wxImage::Rotate(double angle,
         *offset_after_rotation = wxPoint (x1a, y1a);
     }
 
-    // the rotated (destination) image is always accessed sequentially via this
-    // pointer, there is no need for pointer-based arrays here
-    unsigned char *dst = rotated.GetData();
+    // the rotated (destination) image is always accessed sequentially, so
+    // there is no need for pointer-based arrays here
+    unsigned char * const dst_data = rotated.GetData();
 
-    unsigned char *alpha_dst = has_alpha ? rotated.GetAlpha() : nullptr;
+    unsigned char * const dst_alpha = has_alpha ? rotated.GetAlpha() : nullptr;
 
     // if the original image has a mask, use its RGB values as the blank pixel,
     // else, fall back to default (black).
@@ -3761,189 +3945,488 @@ wxImage wxImage::Rotate(double angle,
     // only once, instead of repeating it for each pixel.
     if (interpolating)
     {
-        for (int y = 0; y < rH; y++)
+        wxImageProcessRows(rW, rH, [&](int yFrom, int yTo)
         {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+            unsigned char *dst = dst_data + static_cast<size_t>(yFrom) * rW * 3;
+            unsigned char *alpha_dst = has_alpha ? dst_alpha + static_cast<size_t>(yFrom) * rW
+                                                 : nullptr;
 
-                if (-0.25 < src.x && src.x < w - 0.75 &&
-                    -0.25 < src.y && src.y < h - 0.75)
+            for (int y = yFrom; y < yTo; y++)
+            {
+                for (int x = 0; x < rW; x++)
                 {
-                    // interpolate using the 4 enclosing grid-points.  Those
-                    // points can be obtained using floor and ceiling of the
-                    // exact coordinates of the point
-                    int x1, y1, x2, y2;
+                    wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
 
-                    if (0 < src.x && src.x < w - 1)
-                    {
-                        x1 = (int) floor(src.x);
-                        x2 = (int) ceil(src.x);
-                    }
-                    else    // else means that x is near one of the borders (0 or width-1)
+                    if (-0.25 < src.x && src.x < w - 0.75 &&
+                        -0.25 < src.y && src.y < h - 0.75)
                     {
-                        x1 = x2 = wxRound (src.x);
-                    }
+                        // interpolate using the 4 enclosing grid-points.  Those
+                        // points can be obtained using floor and ceiling of the
+                        // exact coordinates of the point
+                        int x1, y1, x2, y2;
 
-                    if (0 < src.y && src.y < h - 1)
-                    {
-                        y1 = (int) floor(src.y);
-                        y2 = (int) ceil(src.y);
-                    }
-                    else
-                    {
-                        y1 = y2 = wxRound (src.y);
-                    }
+                        if (0 < src.x && src.x < w - 1)
+                        {
+                            x1 = (int) floor(src.x);
+                            x2 = (int) ceil(src.x);
+                        }
+                        else    // else means that x is near one of the borders (0 or width-1)
+                        {
+                            x1 = x2 = wxRound (src.x);
+                        }
 
-                    // get four points and the distances (square of the distance,
-                    // for efficiency reasons) for the interpolation formula
+                        if (0 < src.y && src.y < h - 1)
+                        {
+                            y1 = (int) floor(src.y);
+                            y2 = (int) ceil(src.y);
+                        }
+                        else
+                        {
+                            y1 = y2 = wxRound (src.y);
+                        }
 
-                    // GRG: Do not calculate the points until they are
-                    //      really needed -- this way we can calculate
-                    //      just one, instead of four, if d1, d2, d3
-                    //      or d4 are < wxROTATE_EPSILON
+                        // get four points and the distances (square of the distance,
+                        // for efficiency reasons) for the interpolation formula
 
-                    const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
-                    const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
-                    const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
-                    const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
+                        // GRG: Do not calculate the points until they are
+                        //      really needed -- this way we can calculate
+                        //      just one, instead of four, if d1, d2, d3
+                        //      or d4 are < wxROTATE_EPSILON
 
-                    // Now interpolate as a weighted average of the four surrounding
-                    // points, where the weights are the distances to each of those points
+                        const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
+                        const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
+                        const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
+                        const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
 
-                    // If the point is exactly at one point of the grid of the source
-                    // image, then don't interpolate -- just assign the pixel
+                        // Now interpolate as a weighted average of the four surrounding
+                        // points, where the weights are the distances to each of those points
 
-                    // d1,d2,d3,d4 are positive -- no need for abs()
-                    if (d1 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        // If the point is exactly at one point of the grid of the source
+                        // image, then don't interpolate -- just assign the pixel
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x1);
-                    }
-                    else if (d2 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        // d1,d2,d3,d4 are positive -- no need for abs()
+                        if (d1 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y1] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x2);
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y1] + x1);
+                        }
+                        else if (d2 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y1] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y1] + x2);
+                        }
+                        else if (d3 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y2] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y2] + x2);
+                        }
+                        else if (d4 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y2] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y2] + x1);
+                        }
+                        else
+                        {
+                            // weights for the weighted average are proportional to the inverse of the distance
+                            unsigned char *v1 = data[y1] + (3 * x1);
+                            unsigned char *v2 = data[y1] + (3 * x2);
+                            unsigned char *v3 = data[y2] + (3 * x2);
+                            unsigned char *v4 = data[y2] + (3 * x1);
+
+                            const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
+
+                            // GRG: Unrolled.
+
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *v1 + w2 * *v2 +
+                                   w3 * *v3 + w4 * *v4) /
+                                  (w1 + w2 + w3 + w4) );
+
+                            if (has_alpha)
+                            {
+                                v1 = alpha[y1] + (x1);
+                                v2 = alpha[y1] + (x2);
+                                v3 = alpha[y2] + (x2);
+                                v4 = alpha[y2] + (x1);
+
+                                *(alpha_dst++) = (unsigned char)
+                                    ( (w1 * *v1 + w2 * *v2 +
+                                       w3 * *v3 + w4 * *v4) /
+                                      (w1 + w2 + w3 + w4) );
+                            }
+                        }
                     }
-                    else if (d3 < wxROTATE_EPSILON)
+                    else
                     {
-                        unsigned char *p = data[y2] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        *(dst++) = blank_r;
+                        *(dst++) = blank_g;
+                        *(dst++) = blank_b;
 
                         if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x2);
+                            *(alpha_dst++) = 0;
                     }
-                    else if (d4 < wxROTATE_EPSILON)
+                }
+            }
+        });
+    }
+    else // not interpolating
+    {
+        wxImageProcessRows(rW, rH, [&](int yFrom, int yTo)
+        {
+            unsigned char *dst = dst_data + static_cast<size_t>(yFrom) * rW * 3;
+            unsigned char *alpha_dst = has_alpha ? dst_alpha + static_cast<size_t>(yFrom) * rW
+                                                 : nullptr;
+
+            for (int y = yFrom; y < yTo; y++)
+            {
+                for (int x = 0; x < rW; x++)
+                {
+                    wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+
+                    const int xs = wxRound (src.x);      // wxRound rounds to the
+                    const int ys = wxRound (src.y);      // closest integer
+
+                    if (0 <= xs && xs < w && 0 <= ys && ys < h)
                     {
-                        unsigned char *p = data[y2] + (3 * x1);
+                        unsigned char *p = data[ys] + (3 * xs);
                         *(dst++) = *(p++);
                         *(dst++) = *(p++);
                         *(dst++) = *p;
 
                         if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x1);
+                            *(alpha_dst++) = *(alpha[ys] + (xs));
                     }
                     else
                     {
-                        // weights for the weighted average are proportional to the inverse of the distance
-                        unsigned char *v1 = data[y1] + (3 * x1);
-                        unsigned char *v2 = data[y1] + (3 * x2);
-                        unsigned char *v3 = data[y2] + (3 * x2);
-                        unsigned char *v4 = data[y2] + (3 * x1);
-
-                        const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
-
-                        // GRG: Unrolled.
-
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *v1 + w2 * *v2 +
-                               w3 * *v3 + w4 * *v4) /
-                              (w1 + w2 + w3 + w4) );
+                        *(dst++) = blank_r;
+                        *(dst++) = blank_g;
+                        *(dst++) = blank_b;
 
                         if (has_alpha)
-                        {
-                            v1 = alpha[y1] + (x1);
-                            v2 = alpha[y1] + (x2);
-                            v3 = alpha[y2] + (x2);
-                            v4 = alpha[y2] + (x1);
-
-                            *(alpha_dst++) = (unsigned char)
-                                ( (w1 * *v1 + w2 * *v2 +
-                                   w3 * *v3 + w4 * *v4) /
-                                  (w1 + w2 + w3 + w4) );
-                        }
+                            *(alpha_dst++) = 255;
                     }
                 }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = 0;
-                }
             }
+        });
+    }
+
+    delete [] data;
+    delete [] alpha;
+
+    return rotated;
+}
+
+// ----------------------------------------------------------------------------
+// parallel processing of image rows
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// The value set by wxImage::SetParallelism(), which may be called from any
+// thread.
+std::atomic<int> gs_imageParallelism{1};
+
+// Minimal number of pixels in a band of rows processed by a single thread:
+// it's not worth using threads for smaller images.
+const int MIN_PIXELS_PER_BAND = 64*1024;
+
+// Number of bands to use per thread: using more than one band per thread
+// allows to balance the load between them when some bands take longer to
+// process than others.
+const int BANDS_PER_THREAD = 4;
+
+#if wxUSE_THREADS
+
+// Pool of threads used by wxImageProcessRows().
+//
+// The threads are created on demand and are kept alive until the library
+// shutdown, as creating them for every operation would be too slow.
+class wxImageThreadPool
+{
+public:
+    wxImageThreadPool()
+        : m_condWork(m_mutex),
+          m_condDone(m_mutex)
+    {
+    }
+
+    ~wxImageThreadPool()
+    {
+        {
+            wxMutexLocker lock(m_mutex);
+            m_exit = true;
+            m_condWork.Broadcast();
+        }
+
+        for ( Worker* worker : m_workers )
+        {
+            worker->Wait();
+            delete worker;
         }
     }
-    else // not interpolating
+
+    // Call the function for all bands of the given height, using up to the
+    // given number of threads, including the current one.
+    //
+    // Returns false without doing anything if the pool is already used by
+    // another operation, which may be the one calling this function from its
+    // callback, either in this thread or in one of the pool threads, and so
+    // can't be waited for without deadlocking.
+    bool Run(const wxImageRowsFunc& func,
+             int height,
+             int bandHeight,
+             int numThreads)
+    {
+        // Only one operation can use the pool at any given moment.
+        if ( m_runMutex.TryLock() != wxMUTEX_NO_ERROR )
+            return false;
+
+        DoRun(func, height, bandHeight, numThreads);
+
+        m_runMutex.Unlock();
+
+        return true;
+    }
+
+private:
+    void DoRun(const wxImageRowsFunc& func,
+               int height,
+               int bandHeight,
+               int numThreads)
     {
-        for (int y = 0; y < rH; y++)
+        wxMutexLocker lock(m_mutex);
+
+        while ( static_cast<int>(m_workers.size()) < numThreads - 1 )
         {
-            for (int x = 0; x < rW; x++)
+            Worker* const worker = new Worker(*this);
+            if ( worker->Run() != wxTHREAD_NO_ERROR )
             {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+                // Just use the threads we already have.
+                delete worker;
+                break;
+            }
 
-                const int xs = wxRound (src.x);      // wxRound rounds to the
-                const int ys = wxRound (src.y);      // closest integer
+            m_workers.push_back(worker);
+        }
 
-                if (0 <= xs && xs < w && 0 <= ys && ys < h)
-                {
-                    unsigned char *p = data[ys] + (3 * xs);
-                    *(dst++) = *(p++);
-                    *(dst++) = *(p++);
-                    *(dst++) = *p;
+        m_func = &func;
+        m_height = height;
+        m_bandHeight = bandHeight;
+        m_numBands = (height + bandHeight - 1) / bandHeight;
+        m_nextBand = 0;
+        m_bandsDone = 0;
+        m_helpers = 0;
+        m_maxHelpers = numThreads - 1;
+        m_generation++;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = *(alpha[ys] + (xs));
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+        m_condWork.Broadcast();
 
-                    if (has_alpha)
-                        *(alpha_dst++) = 255;
-                }
+        ProcessBands();
+
+        while ( m_bandsDone < m_numBands )
+            m_condDone.Wait();
+
+        m_func = nullptr;
+    }
+
+    class Worker : public wxThread
+    {
+    public:
+        explicit Worker(wxImageThreadPool& pool)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_pool(pool)
+        {
+        }
+
+    protected:
+        virtual void* Entry() override
+        {
+            m_pool.WorkerLoop();
+
+            return nullptr;
+        }
+
+    private:
+        wxImageThreadPool& m_pool;
+    };
+
+    void WorkerLoop()
+    {
+        wxMutexLocker lock(m_mutex);
+
+        // Note that this is different from any valid generation, so that a
+        // newly created thread participates in the current operation.
+        unsigned generation = 0;
+        for ( ;; )
+        {
+            while ( !m_exit && m_generation == generation )
+                m_condWork.Wait();
+
+            if ( m_exit )
+                break;
+
+            generation = m_generation;
+
+            if ( m_helpers < m_maxHelpers )
+            {
+                m_helpers++;
+                ProcessBands();
             }
         }
     }
 
-    delete [] data;
-    delete [] alpha;
+    // Process the bands of the current operation until there are none left.
+    //
+    // Must be called with m_mutex locked, which is released while calling
+    // the function.
+    void ProcessBands()
+    {
+        while ( m_nextBand < m_numBands )
+        {
+            const int from = m_nextBand++*m_bandHeight;
+            const int to = wxMin(from + m_bandHeight, m_height);
 
-    return rotated;
+            m_mutex.Unlock();
+            (*m_func)(from, to);
+            m_mutex.Lock();
+
+            if ( ++m_bandsDone == m_numBands )
+                m_condDone.Signal();
+        }
+    }
+
+
+    // Locked by Run() while the pool is used by an operation.
+    wxMutex m_runMutex;
+
+    // Protects all the fields below.
+    wxMutex m_mutex;
+
+    // Signalled when a new operation starts or the pool is being destroyed.
+    wxCondition m_condWork;
+
+    // Signalled when the last band of the current operation was processed.
+    wxCondition m_condDone;
+
+    std::vector<Worker*> m_workers;
+
+    // The current operation parameters.
+    const wxImageRowsFunc* m_func = nullptr;
+    int m_height = 0;
+    int m_bandHeight = 0;
+    int m_numBands = 0;
+
+    // The state of the current operation.
+    int m_nextBand = 0;
+    int m_bandsDone = 0;
+    int m_helpers = 0;
+    int m_maxHelpers = 0;
+
+    // Incremented whenever a new operation starts.
+    unsigned m_generation = 0;
+
+    bool m_exit = false;
+};
+
+wxImageThreadPool* gs_imageThreadPool = nullptr;
+
+// Return the pool, creating it if necessary. As this can be called from
+// different threads simultaneously, the pool creation must be protected.
+wxImageThreadPool& GetImageThreadPool()
+{
+    static wxCriticalSection s_cs;
+    wxCriticalSectionLocker lock(s_cs);
+
+    if ( !gs_imageThreadPool )
+        gs_imageThreadPool = new wxImageThreadPool();
+
+    return *gs_imageThreadPool;
+}
+
+#endif // wxUSE_THREADS
+
+} // anonymous namespace
+
+/* static */
+void wxImage::SetParallelism(int numThreads)
+{
+    wxCHECK_RET( numThreads >= 0, "invalid number of threads" );
+
+    gs_imageParallelism = numThreads;
+}
+
+/* static */
+int wxImage::GetParallelism()
+{
+    return gs_imageParallelism;
+}
+
+bool wxImageHasExclusiveData(const wxImage& image)
+{
+    const wxImageRefData* const
+        data = static_cast<wxImageRefData*>(image.GetRefData());
+
+    return data && data->GetRefCount() == 1 && !data->m_static;
+}
+
+void wxImageProcessRows(int width, int height, const wxImageRowsFunc& func)
+{
+#if wxUSE_THREADS
+    int numThreads = gs_imageParallelism;
+    if ( numThreads == 0 )
+        numThreads = wxThread::GetCPUCount();
+
+    if ( numThreads > 1 && width > 0 )
+    {
+        int bandHeight = wxMax((MIN_PIXELS_PER_BAND + width - 1) / width, 1);
+
+        // Don't use more bands than we need for balancing the load.
+        const int maxBands = numThreads*BANDS_PER_THREAD;
+        if ( height / bandHeight > maxBands )
+            bandHeight = (height + maxBands - 1) / maxBands;
+
+        const int numBands = (height + bandHeight - 1) / bandHeight;
+        if ( numBands > 1 &&
+                GetImageThreadPool().Run(func, height, bandHeight,
+                                         wxMin(numThreads, numBands)) )
+        {
+            return;
+        }
+    }
+#else // !wxUSE_THREADS
+    wxUnusedVar(width);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    func(0, height);
 }
 
 // Helper function used internally by wxImage class only.
@@ -3952,13 +4435,423 @@ void wxImage::ApplyToAllPixels(const F& func)
 {
     AllocExclusive();
 
-    const size_t size = GetWidth() * GetHeight();
-    unsigned char *data = GetData();
+    const int width = GetWidth();
+    unsigned char* const data = GetData();
+
+    wxImageProcessRows(width, GetHeight(), [&func, width, data](int from, int to)
+    {
+        const size_t size = static_cast<size_t>(to - from) * width;
+        unsigned char* p = data + static_cast<size_t>(from) * width * 3;
+
+        for ( size_t i = 0; i < size; i++, p += 3 )
+        {
+            func(p);
+        }
+    });
+}
+
+// ----------------------------------------------------------------------------
+// wxImagePipeline
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Mapping of the pixel coordinates in the output of a sequence of geometric
+// operations to the coordinates in their input image: any composition of
+// these operations is of the form
+//
+//      srcX = x0 + xx*x + xy*y
+//      srcY = y0 + yx*x + yy*y
+//
+// where all the coefficients other than x0 and y0 are -1, 0 or 1.
+struct wxImageCoordsMap
+{
+    bool IsIdentity() const
+    {
+        return x0 == 0 && y0 == 0 && xx == 1 && xy == 0 && yx == 0 && yy == 1;
+    }
+
+    // Apply the given mapping, mapping the new output coordinates to the
+    // current output ones, before this one.
+    void Compose(const wxImageCoordsMap& m)
+    {
+        wxImageCoordsMap r;
+        r.x0 = x0 + xx*m.x0 + xy*m.y0;
+        r.y0 = y0 + yx*m.x0 + yy*m.y0;
+        r.xx = xx*m.xx + xy*m.yx;
+        r.xy = xx*m.xy + xy*m.yy;
+        r.yx = yx*m.xx + yy*m.yx;
+        r.yy = yx*m.xy + yy*m.yy;
+
+        *this = r;
+    }
+
+    int x0 = 0,
+        y0 = 0;
+    int xx = 1,
+        xy = 0,
+        yx = 0,
+        yy = 1;
+};
+
+} // anonymous namespace
+
+wxImagePipeline::wxImagePipeline(const wxImage& image)
+    : m_image(image),
+      m_size(image.IsOk() ? image.GetSize() : wxSize())
+{
+}
+
+wxImagePipeline& wxImagePipeline::GetSubImage(const wxRect& rect)
+{
+    wxCHECK_MSG( !rect.IsEmpty() &&
+                 rect.GetLeft() >= 0 && rect.GetTop() >= 0 &&
+                 rect.GetRight() < m_size.x && rect.GetBottom() < m_size.y,
+                 *this, "invalid subimage size" );
+
+    Operation op(Operation::Op_SubImage);
+    op.rect = rect;
+    m_ops.push_back(op);
+
+    m_size = rect.GetSize();
+
+    return *this;
+}
+
+wxImagePipeline& wxImagePipeline::Mirror(bool horizontally)
+{
+    Operation op(Operation::Op_Mirror);
+    op.param = horizontally;
+    m_ops.push_back(op);
+
+    return *this;
+}
+
+wxImagePipeline& wxImagePipeline::Rotate90(bool clockwise)
+{
+    Operation op(Operation::Op_Rotate90);
+    op.param = clockwise;
+    m_ops.push_back(op);
+
+    m_size = wxSize(m_size.y, m_size.x);
+
+    return *this;
+}
+
+wxImagePipeline& wxImagePipeline::Rotate180()
+{
+    m_ops.push_back(Operation(Operation::Op_Rotate180));
+
+    return *this;
+}
+
+wxImagePipeline&
+wxImagePipeline::Scale(int width, int height, wxImageResizeQuality quality)
+{
+    wxCHECK_MSG( width > 0 && height > 0, *this, "invalid new image size" );
+
+    // Scaling to the same size doesn't do anything, just as wxImage::Scale().
+    if ( wxSize(width, height) == m_size )
+        return *this;
+
+    Operation op(Operation::Op_Scale);
+    op.rect = wxRect(0, 0, width, height);
+    op.param = quality;
+    m_ops.push_back(op);
+
+    m_size = op.rect.GetSize();
+
+    return *this;
+}
+
+wxImagePipeline&
+wxImagePipeline::ConvertToGreyscale(double weight_r,
+                                    double weight_g,
+                                    double weight_b)
+{
+    Operation op(Operation::Op_Greyscale);
+    op.values[0] = weight_r;
+    op.values[1] = weight_g;
+    op.values[2] = weight_b;
+    m_ops.push_back(op);
+
+    return *this;
+}
+
+wxImagePipeline& wxImagePipeline::ConvertToDisabled(unsigned char brightness)
+{
+    Operation op(Operation::Op_Disabled);
+    op.param = brightness;
+    m_ops.push_back(op);
+
+    return *this;
+}
+
+wxImagePipeline& wxImagePipeline::ChangeLightness(int alpha)
+{
+    wxASSERT(alpha >= 0 && alpha <= 200);
+
+    Operation op(Operation::Op_Lightness);
+    op.param = alpha;
+    m_ops.push_back(op);
+
+    return *this;
+}
+
+wxImagePipeline&
+wxImagePipeline::ChangeHSV(double angleH, double factorS, double factorV)
+{
+    wxASSERT(angleH >= -1.0 && angleH <= 1.0 && factorS >= -1.0 &&
+             factorS <= 1.0 && factorV >= -1.0 && factorV <= 1.0);
+
+    Operation op(Operation::Op_HSV);
+    op.values[0] = angleH;
+    op.values[1] = factorS;
+    op.values[2] = factorV;
+    m_ops.push_back(op);
+
+    return *this;
+}
+
+/* static */
+void wxImagePipeline::ApplyColourOp(const Operation& op,
+                                    unsigned char* rgb,
+                                    int count,
+                                    const unsigned char* mask)
+{
+    // Check if the pixel should be left unchanged because it's transparent.
+    const auto isMasked = [mask](const unsigned char* p)
+    {
+        return mask && p[0] == mask[0] && p[1] == mask[1] && p[2] == mask[2];
+    };
+
+    switch ( op.type )
+    {
+        case Operation::Op_Greyscale:
+            for ( int n = 0; n < count; n++, rgb += 3 )
+            {
+                if ( !isMasked(rgb) )
+                    wxColour::MakeGrey(rgb, rgb + 1, rgb + 2,
+                                       op.values[0], op.values[1], op.values[2]);
+            }
+            break;
+
+        case Operation::Op_Disabled:
+            for ( int n = 0; n < count; n++, rgb += 3 )
+            {
+                if ( !isMasked(rgb) )
+                    wxColour::MakeDisabled(rgb, rgb + 1, rgb + 2,
+                                           static_cast<unsigned char>(op.param));
+            }
+            break;
+
+        case Operation::Op_Lightness:
+            for ( int n = 0; n < count; n++, rgb += 3 )
+            {
+                if ( !isMasked(rgb) )
+                    wxColour::ChangeLightness(rgb, rgb + 1, rgb + 2, op.param);
+            }
+            break;
+
+        case Operation::Op_HSV:
+            for ( int n = 0; n < count; n++, rgb += 3 )
+            {
+                if ( !wxIsNullDouble(op.values[0]) )
+                    DoRotateHue(rgb, op.values[0]);
+
+                if ( !wxIsNullDouble(op.values[1]) )
+                    DoChangeSaturation(rgb, op.values[1]);
+
+                if ( !wxIsNullDouble(op.values[2]) )
+                    DoChangeBrightness(rgb, op.values[2]);
+            }
+            break;
+
+        case Operation::Op_SubImage:
+        case Operation::Op_Mirror:
+        case Operation::Op_Rotate90:
+        case Operation::Op_Rotate180:
+        case Operation::Op_Scale:
+            wxFAIL_MSG( "not a colour operation" );
+            break;
+    }
+}
+
+wxImage wxImagePipeline::Execute() const
+{
+    wxCHECK_MSG( m_image.IsOk(), wxImage(), "invalid image" );
+
+    // The operations are split into stages separated by Scale() calls, as
+    // resampling can't be combined with the other operations. Each stage is
+    // performed in a single pass over the image which copies each pixel from
+    // the source image to its final position, as determined by all the
+    // geometric operations of this stage, and applies all colour operations
+    // to it. Note that colour operations affect each pixel independently, so
+    // the order of geometric and colour operations doesn't matter.
+    wxImage source = m_image;
+    wxImageCoordsMap map;
+    wxSize size = source.GetSize();
+    std::vector<const Operation*> colourOps;
+
+    const auto executeStage = [&]() -> wxImage
+    {
+        if ( map.IsIdentity() && colourOps.empty() && size == source.GetSize() )
+            return source;
+
+        wxImage image(size, false);
+        wxCHECK_MSG( image.IsOk(), image, "unable to create image" );
+
+        const unsigned char* const srcData = source.GetData();
+        const unsigned char* const srcAlpha = source.GetAlpha();
+        unsigned char* const dstData = image.GetData();
+        unsigned char* dstAlpha = nullptr;
+        if ( srcAlpha )
+        {
+            image.SetAlpha();
+            dstAlpha = image.GetAlpha();
+        }
+
+        const bool hasMask = source.HasMask();
+        unsigned char mask[3] = { 0, 0, 0 };
+        if ( hasMask )
+        {
+            mask[0] = source.GetMaskRed();
+            mask[1] = source.GetMaskGreen();
+            mask[2] = source.GetMaskBlue();
+            image.SetMaskColour(mask[0], mask[1], mask[2]);
+        }
+
+        const int width = size.x;
+        const long srcWidth = source.GetWidth();
+
+        // Offset between the source pixels corresponding to the two
+        // horizontally adjacent output pixels.
+        const long step = map.yx*srcWidth + map.xx;
+
+        wxImageProcessRows(size.x, size.y, [&](int from, int to)
+        {
+            for ( int y = from; y < to; y++ )
+            {
+                const long start = (map.y0 + map.yy*y)*srcWidth + map.x0 + map.xy*y;
+                unsigned char* const dst = dstData + static_cast<size_t>(y)*width*3;
+
+                if ( step == 1 )
+                {
+                    memcpy(dst, srcData + start*3, width*3);
+                }
+                else
+                {
+                    unsigned char* p = dst;
+                    for ( int x = 0; x < width; x++, p += 3 )
+                    {
+                        const unsigned char* const src = srcData + (start + x*step)*3;
+                        p[0] = src[0];
+                        p[1] = src[1];
+                        p[2] = src[2];
+                    }
+                }
+
+                if ( dstAlpha )
+                {
+                    unsigned char* const
+                        dstA = dstAlpha + static_cast<size_t>(y)*width;
 
-    for ( size_t i = 0; i < size; i++, data += 3 )
+                    if ( step == 1 )
+                    {
+                        memcpy(dstA, srcAlpha + start, width);
+                    }
+                    else
+                    {
+                        for ( int x = 0; x < width; x++ )
+                            dstA[x] = srcAlpha[start + x*step];
+                    }
+                }
+
+                // Apply the colour operations to this row while it's still
+                // in the cache.
+                for ( const Operation* op : colourOps )
+                    ApplyColourOp(*op, dst, width, hasMask ? mask : nullptr);
+            }
+        });
+
+        return image;
+    };
+
+    for ( const Operation& op : m_ops )
     {
-        func(data);
+        // Mapping of the coordinates of the output of this operation to its
+        // input coordinates.
+        wxImageCoordsMap opMap;
+
+        switch ( op.type )
+        {
+            case Operation::Op_SubImage:
+                opMap.x0 = op.rect.x;
+                opMap.y0 = op.rect.y;
+                size = op.rect.GetSize();
+                break;
+
+            case Operation::Op_Mirror:
+                if ( op.param )
+                {
+                    opMap.x0 = size.x - 1;
+                    opMap.xx = -1;
+                }
+                else
+                {
+                    opMap.y0 = size.y - 1;
+                    opMap.yy = -1;
+                }
+                break;
+
+            case Operation::Op_Rotate90:
+                opMap.xx = 0;
+                opMap.yy = 0;
+                if ( op.param )
+                {
+                    opMap.xy = 1;
+                    opMap.y0 = size.y - 1;
+                    opMap.yx = -1;
+                }
+                else
+                {
+                    opMap.x0 = size.x - 1;
+                    opMap.xy = -1;
+                    opMap.yx = 1;
+                }
+                size = wxSize(size.y, size.x);
+                break;
+
+            case Operation::Op_Rotate180:
+                opMap.x0 = size.x - 1;
+                opMap.xx = -1;
+                opMap.y0 = size.y - 1;
+                opMap.yy = -1;
+                break;
+
+            case Operation::Op_Scale:
+                source = executeStage().Scale(op.rect.width, op.rect.height,
+                                              static_cast<wxImageResizeQuality>(op.param));
+                wxCHECK_MSG( source.IsOk(), source, "failed to scale image" );
+
+                map = wxImageCoordsMap();
+                size = source.GetSize();
+                colourOps.clear();
+                continue;
+
+            case Operation::Op_Greyscale:
+            case Operation::Op_Disabled:
+            case Operation::Op_Lightness:
+            case Operation::Op_HSV:
+                colourOps.push_back(&op);
+                continue;
+        }
+
+        map.Compose(opMap);
     }
+
+    return executeStage();
 }
 
 // A module to allow wxImage initialization/cleanup
@@ -3969,9 +4862,26 @@ class wxImageModule: public wxModule
 {
     wxDECLARE_DYNAMIC_CLASS(wxImageModule);
 public:
-    wxImageModule() {}
+    wxImageModule()
+    {
+#if wxUSE_THREADS
+        // Make sure our thread pool is destroyed before wxThreadModule tries
+        // to delete all the remaining threads, as the pool threads would
+        // never terminate on their own.
+        AddDependency("wxThreadModule");
+#endif // wxUSE_THREADS
+    }
+
     bool OnInit() override { wxImage::InitStandardHandlers(); return true; }
-    void OnExit() override { wxImage::CleanUpHandlers(); }
+    void OnExit() override
+    {
+        wxImage::CleanUpHandlers();
+
+#if wxUSE_THREADS
+        delete gs_imageThreadPool;
+        gs_imageThreadPool = nullptr;
+#endif // wxUSE_THREADS
+    }
 };
 
 wxIMPLEMENT_DYNAMIC_CLASS(wxImageModule, wxModule);
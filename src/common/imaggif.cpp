@@ -113,7 +113,9 @@ static bool wxGIFHandler_BufferedOutput(wxOutputStream *, wxUint8 *buf, int c);
 bool wxGIFHandler::LoadFile(wxImage *image, wxInputStream& stream,
     bool verbose, int index)
 {
+    // only decode the frame we need
     wxGIFDecoder decod;
+    decod.SetDecodeOnDemand(true);
     switch ( decod.LoadGIF(stream) )
     {
         case wxGIF_OK:
@@ -137,7 +139,14 @@ bool wxGIFHandler::LoadFile(wxImage *image, wxInputStream& stream,
             break;
     }
 
-    return decod.ConvertToImage(index != -1 ? (size_t)index : 0, image);
+    if ( !decod.ConvertToImage(index != -1 ? (size_t)index : 0, image) )
+    {
+        if ( verbose )
+            wxLogError(_("GIF: error in GIF image format."));
+        return false;
+    }
+
+    return true;
 }
 
 bool wxGIFHandler::SaveFile(wxImage *image,
@@ -170,6 +179,7 @@ bool wxGIFHandler::DoCanRead( wxInputStream& stream )
 int wxGIFHandler::DoGetImageCount( wxInputStream& stream )
 {
     wxGIFDecoder decod;
+    decod.SetDecodeOnDemand(true);
     wxGIFErrorCode error = decod.LoadGIF(stream);
     if ( (error != wxGIF_OK) && (error != wxGIF_TRUNCATED) )
         return -1;
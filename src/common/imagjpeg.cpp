@@ -38,6 +38,7 @@
 
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
+#include "wx/private/image.h"
 
 // For memcpy
 #include <string.h>
@@ -79,6 +80,7 @@ typedef struct {
 
     JOCTET* buffer;               /* start of buffer */
     wxInputStream *stream;
+    size_t span;                  /* size of the stream data used directly */
 } wx_source_mgr;
 
 typedef wx_source_mgr * wx_src_ptr;
@@ -94,6 +96,24 @@ CPP_METHODDEF(boolean) wx_fill_input_buffer ( j_decompress_ptr cinfo )
 {
     wx_src_ptr src = (wx_src_ptr) cinfo->src;
 
+    // Consume the data used directly the last time, as it was all used now.
+    if ( src->span )
+    {
+        src->stream->SkipSpan(src->span);
+        src->span = 0;
+    }
+
+    // Use the data directly without copying it if the stream allows it.
+    size_t len;
+    const void* const data = src->stream->PeekSpan(&len);
+    if ( data )
+    {
+        src->pub.next_input_byte = static_cast<const JOCTET*>(data);
+        src->pub.bytes_in_buffer = len;
+        src->span = len;
+        return TRUE;
+    }
+
     src->pub.next_input_byte = src->buffer;
     src->pub.bytes_in_buffer = src->stream->Read(src->buffer, JPEG_IO_BUFFER_SIZE).LastRead();
 
@@ -127,7 +147,9 @@ CPP_METHODDEF(void) wx_term_source ( j_decompress_ptr cinfo )
 {
     wx_src_ptr src = (wx_src_ptr) cinfo->src;
 
-    if (src->pub.bytes_in_buffer > 0)
+    if (src->span)
+        src->stream->SkipSpan(src->span - src->pub.bytes_in_buffer);
+    else if (src->pub.bytes_in_buffer > 0)
         src->stream->SeekI(-(long)src->pub.bytes_in_buffer, wxFromCurrent);
     delete[] src->buffer;
 }
@@ -199,6 +221,7 @@ void wx_jpeg_io_src( j_decompress_ptr cinfo, wxInputStream& infile )
     src->buffer = new JOCTET[JPEG_IO_BUFFER_SIZE];
     src->pub.next_input_byte = nullptr; /* until buffer loaded */
     src->stream = &infile;
+    src->span = 0;
 
     src->pub.init_source = wx_init_source;
     src->pub.fill_input_buffer = wx_fill_input_buffer;
@@ -238,8 +261,7 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     unsigned char *ptr;
 
     // save this before calling Destroy()
-    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
-                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+    const wxImageLoadOptions options(*image);
     image->Destroy();
 
     cinfo.err = jpeg_std_error( &jerr );
@@ -279,44 +301,87 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         bytesPerPixel = 3;
     }
 
-    // scale the picture to fit in the specified max size if necessary
-    if ( maxWidth > 0 || maxHeight > 0 )
+    // determine the part of the image to load, there is no need to load
+    // anything at all if the region doesn't intersect the image
+    const wxSize sizeOrig(cinfo.image_width, cinfo.image_height);
+    wxRect region = options.GetRegion(sizeOrig);
+    const bool loadRegion = options.HasRegion();
+    if ( loadRegion && region.IsEmpty() )
     {
-        unsigned& scale = cinfo.scale_denom;
-        while ( (maxWidth && (cinfo.image_width / scale > maxWidth)) ||
-                    (maxHeight && (cinfo.image_height / scale > maxHeight)) )
+        if (verbose)
         {
-            scale *= 2;
+            wxLogError(_("The requested region is outside of the image."));
         }
+        (cinfo.src->term_source)(&cinfo);
+        jpeg_destroy_decompress(&cinfo);
+        return false;
     }
 
+    // scale the picture to fit in the specified max size if necessary
+    if ( options.HasMaxSize() )
+        cinfo.scale_denom = options.GetScaleDenom(region.GetSize());
+
     jpeg_start_decompress( &cinfo );
 
-    image->Create( cinfo.output_width, cinfo.output_height );
+    // convert the region to the output, i.e. possibly scaled, coordinates
+    const JDIMENSION xStart = static_cast<wxUint64>(region.GetLeft()) * cinfo.output_width
+                                / cinfo.image_width;
+    const JDIMENSION yStart = static_cast<wxUint64>(region.GetTop()) * cinfo.output_height
+                                / cinfo.image_height;
+    const JDIMENSION xEnd = (static_cast<wxUint64>(region.GetRight() + 1) * cinfo.output_width
+                                + cinfo.image_width - 1) / cinfo.image_width;
+    const JDIMENSION yEnd = (static_cast<wxUint64>(region.GetBottom() + 1) * cinfo.output_height
+                                + cinfo.image_height - 1) / cinfo.image_height;
+    const JDIMENSION widthOut = xEnd - xStart;
+
+    // the first column in the decoded scanlines
+    JDIMENSION xFirst = 0;
+
+#ifdef LIBJPEG_TURBO_VERSION_NUMBER
+    // libjpeg-turbo can avoid decoding the columns and the rows we don't need
+    if ( widthOut != cinfo.output_width )
+    {
+        JDIMENSION widthCrop = widthOut;
+        xFirst = xStart;
+        jpeg_crop_scanline( &cinfo, &xFirst, &widthCrop );
+    }
+
+    if ( yStart )
+        jpeg_skip_scanlines( &cinfo, yStart );
+#endif // LIBJPEG_TURBO_VERSION_NUMBER
+
+    image->Create( widthOut, yEnd - yStart );
     if (!image->IsOk()) {
-        jpeg_finish_decompress( &cinfo );
+        (cinfo.src->term_source)(&cinfo);
+        jpeg_abort_decompress( &cinfo );
         jpeg_destroy_decompress( &cinfo );
         return false;
     }
     image->SetMask( false );
     ptr = image->GetData();
 
-    unsigned stride = cinfo.output_width * bytesPerPixel;
     JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
-                            ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
+                            ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                             cinfo.output_width * bytesPerPixel, 1 );
 
-    while ( cinfo.output_scanline < cinfo.output_height )
+    while ( cinfo.output_scanline < yEnd )
     {
         jpeg_read_scanlines( &cinfo, tempbuf, 1 );
+
+        // skip the rows above the region, if we couldn't do it above
+        if ( cinfo.output_scanline <= yStart )
+            continue;
+
+        const unsigned char* inptr = (const unsigned char*) tempbuf[0]
+                                        + (xStart - xFirst) * bytesPerPixel;
         if (cinfo.out_color_space == JCS_RGB)
         {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
+            memcpy( ptr, inptr, widthOut * 3 );
+            ptr += widthOut * 3;
         }
         else // CMYK
         {
-            const unsigned char* inptr = (const unsigned char*) tempbuf[0];
-            for (size_t i = 0; i < cinfo.output_width; i++)
+            for (size_t i = 0; i < widthOut; i++)
             {
                 wx_cmyk_to_rgb(ptr, inptr);
                 ptr += 3;
@@ -336,14 +401,25 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, cinfo.density_unit);
     }
 
-    if ( cinfo.image_width != cinfo.output_width || cinfo.image_height != cinfo.output_height )
+    if ( loadRegion ||
+            cinfo.image_width != cinfo.output_width ||
+                cinfo.image_height != cinfo.output_height )
     {
         // save the original image size
         image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, cinfo.image_width);
         image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, cinfo.image_height);
     }
 
-    jpeg_finish_decompress( &cinfo );
+    // we may have stopped before reading all the rows if we only needed some
+    // of them, and jpeg_finish_decompress() would complain about it, so abort
+    // decompression, which doesn't call term_source, in this case instead
+    if ( cinfo.output_scanline < cinfo.output_height )
+    {
+        (cinfo.src->term_source)(&cinfo);
+        jpeg_abort_decompress( &cinfo );
+    }
+    else
+        jpeg_finish_decompress( &cinfo );
     jpeg_destroy_decompress( &cinfo );
     return true;
 }
@@ -32,6 +32,8 @@
 
 #include "png.h"
 
+#include "wx/private/image.h"
+
 // For memcpy
 #include <string.h>
 
@@ -107,9 +109,12 @@ struct wxPNGImageData
     {
         lines = nullptr;
         m_buf = nullptr;
+        m_row = nullptr;
+        m_sums = nullptr;
         info_ptr = (png_infop) nullptr;
         png_ptr = (png_structp) nullptr;
         ok = false;
+        outsideRegion = false;
     }
 
     bool Alloc(png_uint_32 width, png_uint_32 height, unsigned char* buf)
@@ -141,6 +146,8 @@ struct wxPNGImageData
 
     ~wxPNGImageData()
     {
+        free(m_sums);
+        free(m_row);
         free(m_buf);
         free( lines );
 
@@ -153,13 +160,30 @@ struct wxPNGImageData
         }
     }
 
-    void DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo);
+    void DoLoadPNGFile(wxImage* image,
+                       wxPNGInfoStruct& wxinfo,
+                       const wxImageLoadOptions& options);
+
+    bool ReadRows(wxImage* image,
+                  png_uint_32 width,
+                  const wxRect& region,
+                  int scale,
+                  int channels);
 
     unsigned char** lines;
     unsigned char* m_buf;
+
+    // used by ReadRows() only: buffer for a single row and the sums of the
+    // pixel values when scaling the image down
+    unsigned char* m_row;
+    wxUint32* m_sums;
+
     png_infop info_ptr;
     png_structp png_ptr;
     bool ok;
+
+    // set if loading failed because the region is outside of the image
+    bool outsideRegion;
 };
 
 } // anonymous namespace
@@ -243,6 +267,36 @@ bool wxPNGHandler::DoCanRead( wxInputStream& stream )
     return memcmp(hdr, "\211PNG", WXSIZEOF(hdr)) == 0;
 }
 
+// convert a row of RGBA data to wxImage format
+static
+void CopyRowFromPNG(wxImage *image,
+                    const unsigned char *ptrSrc,
+                    png_uint_32 y,
+                    png_uint_32 width,
+                    unsigned char *&alpha)
+{
+    unsigned char *ptrDst = image->GetData() + 3 * size_t(y) * width;
+    for ( png_uint_32 x = 0; x < width; x++ )
+    {
+        unsigned char r = *ptrSrc++;
+        unsigned char g = *ptrSrc++;
+        unsigned char b = *ptrSrc++;
+        unsigned char a = *ptrSrc++;
+
+        // the first time we encounter a transparent pixel we must
+        // allocate alpha channel for the image
+        if ( !IsOpaque(a) && !alpha )
+            alpha = InitAlpha(image, x, y);
+
+        if ( alpha )
+            *alpha++ = a;
+
+        *ptrDst++ = r;
+        *ptrDst++ = g;
+        *ptrDst++ = b;
+    }
+}
+
 // convert data from RGB to wxImage format
 static
 void CopyDataFromPNG(wxImage *image,
@@ -253,32 +307,8 @@ void CopyDataFromPNG(wxImage *image,
     // allocated on demand if we have any non-opaque pixels
     unsigned char *alpha = nullptr;
 
-    unsigned char *ptrDst = image->GetData();
-    {
-        for ( png_uint_32 y = 0; y < height; y++ )
-        {
-            const unsigned char *ptrSrc = lines[y];
-            for ( png_uint_32 x = 0; x < width; x++ )
-            {
-                unsigned char r = *ptrSrc++;
-                unsigned char g = *ptrSrc++;
-                unsigned char b = *ptrSrc++;
-                unsigned char a = *ptrSrc++;
-
-                // the first time we encounter a transparent pixel we must
-                // allocate alpha channel for the image
-                if ( !IsOpaque(a) && !alpha )
-                    alpha = InitAlpha(image, x, y);
-
-                if ( alpha )
-                    *alpha++ = a;
-
-                *ptrDst++ = r;
-                *ptrDst++ = g;
-                *ptrDst++ = b;
-            }
-        }
-    }
+    for ( png_uint_32 y = 0; y < height; y++ )
+        CopyRowFromPNG(image, lines[y], y, width, alpha);
 }
 
 // temporarily disable the warning C4611 (interaction between '_setjmp' and
@@ -292,8 +322,101 @@ void CopyDataFromPNG(wxImage *image,
 // the stack frame of the caller prevents this from happening. It also
 // "returns" its result via wxPNGImageData: use its "ok" field to check
 // whether loading succeeded or failed.
+//
+// ReadRows() must be called from DoLoadPNGFile() only, as it relies on the
+// latter to handle errors, and is used to read the image row by row, which is
+// only possible for non-interlaced images, but allows to avoid allocating an
+// intermediate buffer for the entire image and to load only its part and/or
+// scale it down while reading it.
+bool
+wxPNGImageData::ReadRows(wxImage* image,
+                         png_uint_32 width,
+                         const wxRect& region,
+                         int scale,
+                         int channels)
+{
+    const int widthOut = region.width / scale;
+    const int heightOut = region.height / scale;
+
+    image->Create(widthOut, heightOut, false /* no need to init pixels */);
+    if ( !image->IsOk() )
+        return false;
+
+    m_row = static_cast<unsigned char*>(malloc(size_t(width) * channels));
+    if ( !m_row )
+        return false;
+
+    const size_t lenOut = size_t(widthOut) * channels;
+    if ( scale != 1 )
+    {
+        m_sums = static_cast<wxUint32*>(malloc(lenOut * sizeof(wxUint32)));
+        if ( !m_sums )
+            return false;
+    }
+
+    // skip the rows above the region
+    for ( int y = 0; y < region.y; y++ )
+        png_read_row(png_ptr, m_row, nullptr);
+
+    // allocated on demand if we have any non-opaque pixels
+    unsigned char* alpha = nullptr;
+
+    unsigned char* dst = image->GetData();
+    const unsigned char* const regionStart = m_row + size_t(region.x) * channels;
+    for ( int y = 0; y < heightOut; y++ )
+    {
+        const unsigned char* src = regionStart;
+        if ( scale == 1 )
+        {
+            png_read_row(png_ptr, m_row, nullptr);
+        }
+        else
+        {
+            // compute the average of each scale*scale block of pixels
+            memset(m_sums, 0, lenOut * sizeof(wxUint32));
+            for ( int n = 0; n < scale; n++ )
+            {
+                png_read_row(png_ptr, m_row, nullptr);
+
+                const unsigned char* p = regionStart;
+                wxUint32* sum = m_sums;
+                for ( int x = 0; x < widthOut; x++, sum += channels )
+                {
+                    for ( int k = 0; k < scale; k++ )
+                    {
+                        for ( int c = 0; c < channels; c++ )
+                            sum[c] += *p++;
+                    }
+                }
+            }
+
+            // the region start is not needed any more, so we can reuse the
+            // row buffer for the result
+            const wxUint32 count = wxUint32(scale) * scale;
+            for ( size_t i = 0; i < lenOut; i++ )
+                m_row[i] = static_cast<unsigned char>((m_sums[i] + count / 2) / count);
+
+            src = m_row;
+        }
+
+        if ( channels == 3 )
+        {
+            memcpy(dst, src, lenOut);
+            dst += lenOut;
+        }
+        else
+        {
+            CopyRowFromPNG(image, src, y, widthOut, alpha);
+        }
+    }
+
+    return true;
+}
+
 void
-wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
+wxPNGImageData::DoLoadPNGFile(wxImage* image,
+                              wxPNGInfoStruct& wxinfo,
+                              const wxImageLoadOptions& options)
 {
     png_uint_32 width, height = 0;
     int bit_depth, color_type;
@@ -329,20 +452,74 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     png_set_strip_16( png_ptr );
     png_set_packing( png_ptr );
 
-    image->Create((int)width, (int)height, (bool) false /* no need to init pixels */);
-
-    if (!image->IsOk())
-        return;
-
     const bool needCopy =
         (color_type & PNG_COLOR_MASK_ALPHA) ||
         png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
-    if (!Alloc(width, height, needCopy ? nullptr : image->GetData()))
+    // determine the part of the image to load and the scale to use, there is
+    // no need to load anything at all if the region doesn't intersect it
+    const wxSize sizeOrig((int)width, (int)height);
+    wxRect region = options.GetRegion(sizeOrig);
+    if ( options.HasRegion() && region.IsEmpty() )
+    {
+        outsideRegion = true;
         return;
+    }
 
-    png_read_image( png_ptr, lines );
-    png_read_end( png_ptr, info_ptr );
+    bool loadRegion = options.HasRegion();
+    int scale = 1;
+
+    // interlaced images can't be read row by row, so always read all of them
+    // and let wxImage extract the region and scale them
+    const bool canReadRows =
+        png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE;
+    if ( canReadRows )
+    {
+        if ( !loadRegion )
+            region = wxRect(sizeOrig);
+
+        if ( options.HasMaxSize() )
+            scale = options.GetScaleDenom(region.GetSize());
+    }
+    else
+    {
+        loadRegion = false;
+    }
+
+    if ( loadRegion || scale != 1 || (needCopy && canReadRows) )
+    {
+        if ( !ReadRows(image, width, region, scale, needCopy ? 4 : 3) )
+            return;
+
+        // we don't need to read the rest of the image data if we didn't use
+        // all the rows
+        if ( region.GetBottom() + 1 == (int)height &&
+                region.height % scale == 0 )
+            png_read_end( png_ptr, info_ptr );
+
+        if ( loadRegion || scale != 1 )
+        {
+            image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, (int)width);
+            image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, (int)height);
+        }
+    }
+    else
+    {
+        image->Create((int)width, (int)height, (bool) false /* no need to init pixels */);
+
+        if (!image->IsOk())
+            return;
+
+        if (!Alloc(width, height, needCopy ? nullptr : image->GetData()))
+            return;
+
+        png_read_image( png_ptr, lines );
+        png_read_end( png_ptr, info_ptr );
+
+        // loaded successfully, now init wxImage with this data
+        if (needCopy)
+            CopyDataFromPNG(image, lines, width, height);
+    }
 
 #if wxUSE_PALETTE
     if (color_type == PNG_COLOR_TYPE_PALETTE)
@@ -411,10 +588,6 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     }
 
 
-    // loaded successfully, now init wxImage with this data
-    if (needCopy)
-        CopyDataFromPNG(image, lines, width, height);
-
     // This will indicate to the caller that loading succeeded.
     ok = true;
 }
@@ -429,14 +602,20 @@ wxPNGHandler::LoadFile(wxImage *image,
     wxinfo.verbose = verbose;
     wxinfo.stream.in = &stream;
 
+    // save this before DoLoadPNGFile() calls Destroy()
+    const wxImageLoadOptions options(*image);
+
     wxPNGImageData data;
-    data.DoLoadPNGFile(image, wxinfo);
+    data.DoLoadPNGFile(image, wxinfo, options);
 
     if ( !data.ok )
     {
         if (verbose)
         {
-           wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
+            if ( data.outsideRegion )
+                wxLogError(_("The requested region is outside of the image."));
+            else
+                wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
         }
 
         if ( image->IsOk() )
@@ -172,14 +172,53 @@ bool wxWEBPHandler::LoadFile(wxImage* image, wxInputStream& stream, bool verbose
     }
     else if (index >= 0)
     {
-        // Use animation decoder, always RGBA
-        std::vector<wxWebPAnimationFrame> frames;
-        LoadAnimation(frames, stream, verbose);
-        size_t idx = static_cast<size_t>(index);
-        if (idx < frames.size())
+        // Use animation decoder, always RGBA, but stop as soon as we get the
+        // frame we need instead of decoding all of them.
+        wxMemoryOutputStream mos;
+        stream.Read(mos);
+        wxStreamBuffer* mosb = mos.GetOutputStreamBuffer();
+        if (mosb == nullptr)
+            return false;
+
+        WebPData webp_data{};
+        webp_data.bytes = reinterpret_cast<uint8_t*>(mosb->GetBufferStart());
+        webp_data.size = mosb->GetBufferSize();
+
+        WebPAnimDecoderOptions dec_options;
+        WebPAnimDecoderOptionsInit(&dec_options);
+
+        WebPAnimDecoderPtr decoder(
+            WebPAnimDecoderNew(&webp_data, &dec_options),
+            WebPAnimDecoderDelete
+        );
+
+        WebPAnimInfo anim_info;
+        if (decoder != nullptr &&
+                WebPAnimDecoderGetInfo(decoder.get(), &anim_info) &&
+                static_cast<uint32_t>(index) < anim_info.frame_count)
         {
-            *image = frames.at(idx).image.Copy();
-            ok = true;
+            uint8_t* buf = nullptr;
+            int timestamp;
+            for (int n = 0; n <= index; n++)
+            {
+                if (!WebPAnimDecoderGetNext(decoder.get(), &buf, &timestamp))
+                {
+                    buf = nullptr;
+                    break;
+                }
+            }
+
+            if (buf != nullptr)
+            {
+                image->Create(anim_info.canvas_width, anim_info.canvas_height, false);
+                image->SetDataRGBA(buf);
+                ok = true;
+            }
+        }
+
+        if (!ok && verbose)
+        {
+            wxLogError(_("WebP: Error decoding animation."));
         }
     }
 
@@ -43,6 +43,11 @@
 #include "wx/private/log.h"
 
 // other standard headers
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <errno.h>
 
 #include <string.h>
@@ -162,6 +167,10 @@ inline ComponentLevelsMap& GetComponentLevels()
     return s_componentLevels;
 }
 
+// set to true as soon as any component level is set, this allows to avoid
+// locking and looking up the map in the very common case when it's not used
+std::atomic<bool> gs_hasComponentLevels{false};
+
 } // anonymous namespace
 
 // ============================================================================
@@ -371,7 +380,12 @@ wxLog::OnLog(wxLogLevel level,
         logger = wxPerThreadLogger;
         if ( !logger )
         {
-            if ( ms_pLogger )
+            // thread-safe loggers can be used directly from any thread
+            if ( ms_pLogger && ms_pLogger->IsThreadSafe() )
+            {
+                ms_pLogger->CallDoLogNow(level, msg, info);
+            }
+            else if ( ms_pLogger )
             {
                 // buffer the messages until they can be shown from the main
                 // thread
@@ -406,7 +420,9 @@ wxLog::CallDoLogNow(wxLogLevel level,
                     const wxString& msg,
                     const wxLogRecordInfo& info)
 {
-    if ( GetRepetitionCounting() )
+    // repetition counting uses global state and so can't be used with the
+    // loggers which may be called from several threads at once
+    if ( GetRepetitionCounting() && !IsThreadSafe() )
     {
         if ( msg == gs_prevLog.msg )
         {
@@ -589,12 +605,17 @@ void wxLog::SetComponentLevel(const wxString& component, wxLogLevel level)
         wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
 
         GetComponentLevels()[component] = level;
+
+        gs_hasComponentLevels = true;
     }
 }
 
 /* static */
 wxLogLevel wxLog::GetComponentLevel(const wxString& componentOrig)
 {
+    if ( componentOrig.empty() || !gs_hasComponentLevels )
+        return GetLogLevel();
+
     wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
 
     // Make a copy before modifying it in the loop.
@@ -613,6 +634,19 @@ wxLogLevel wxLog::GetComponentLevel(const wxString& componentOrig)
     return GetLogLevel();
 }
 
+/* static */
+bool wxLog::IsLevelEnabled(wxLogLevel level, const char* component)
+{
+    if ( !IsEnabled() )
+        return false;
+
+    // don't create wxString from the component name unless we really need it
+    if ( !component || !*component || !gs_hasComponentLevels )
+        return level <= GetLogLevel();
+
+    return level <= GetComponentLevel(wxString::FromAscii(component));
+}
+
 // ----------------------------------------------------------------------------
 // wxLog trace masks
 // ----------------------------------------------------------------------------
@@ -892,6 +926,487 @@ void wxLogStream::DoLogText(const wxString& msg)
 }
 #endif // wxUSE_STD_IOSTREAM
 
+// ----------------------------------------------------------------------------
+// wxLogAsyncFile implementation
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Queue of log records logged by a single thread and consumed by the
+// wxLogAsyncFile background thread: as there is only a single producer and a
+// single consumer, it can be implemented without any locking.
+class wxLogRecordsRing
+{
+public:
+    // The number of records in the ring, must be a power of 2.
+    static constexpr size_t SIZE = 1024;
+
+    struct Slot
+    {
+        wxLogLevel level = wxLOG_Info;
+        wxString msg;
+        wxLogRecordInfo info;
+
+        // True if msg is already formatted and just needs to be output.
+        bool isText = false;
+
+        // Global sequence number of this record, used to output the records
+        // from all threads in the order in which they were logged.
+        wxUint64 seq = 0;
+    };
+
+    wxLogRecordsRing() : m_slots(SIZE) { }
+
+    // Called by the producer thread only, returns false if the ring is full.
+    //
+    // Notice that the slots are reused, so that their strings don't need to
+    // be reallocated once they become big enough.
+    bool Push(wxLogLevel level,
+              const wxString& msg,
+              const wxLogRecordInfo& info,
+              bool isText,
+              wxUint64 seq)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if ( head - m_tail.load(std::memory_order_acquire) == SIZE )
+            return false;
+
+        Slot& slot = m_slots[head & (SIZE - 1)];
+        slot.level = level;
+        slot.msg = msg;
+        slot.info = info;
+        slot.isText = isText;
+        slot.seq = seq;
+
+        m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Return the approximate number of records in the ring.
+    size_t GetCount() const
+    {
+        return m_head.load(std::memory_order_acquire) -
+                    m_tail.load(std::memory_order_acquire);
+    }
+
+
+    // The functions below are only called by the consumer thread.
+
+    // Return the index one past the last record available for reading.
+    size_t GetHead() const { return m_head.load(std::memory_order_acquire); }
+
+    // Return the index of the first record available for reading.
+    size_t GetTail() const { return m_tail.load(std::memory_order_relaxed); }
+
+    const Slot& GetSlot(size_t n) const { return m_slots[n & (SIZE - 1)]; }
+
+    // Free the slots up to the given index for reuse by the producer.
+    void Release(size_t tail) { m_tail.store(tail, std::memory_order_release); }
+
+
+    // Set by the producer when it won't use this ring any more.
+    std::atomic<bool> m_abandoned{false};
+
+private:
+    std::vector<Slot> m_slots;
+
+    std::atomic<size_t> m_head{0},
+                        m_tail{0};
+
+    wxDECLARE_NO_COPY_CLASS(wxLogRecordsRing);
+};
+
+using wxLogRecordsRingPtr = std::shared_ptr<wxLogRecordsRing>;
+
+// Source of unique identifiers for wxLogAsyncFile objects: we can't use their
+// addresses as a new object could be allocated at the same address as an
+// already deleted one.
+std::atomic<unsigned> gs_lastAsyncLogId{0};
+
+// The ring used by the current thread for logging to wxLogAsyncFile with the
+// given identifier: we only remember the last used one as there is normally
+// only one such logger at any time.
+struct wxLogRecordsRingHolder
+{
+    ~wxLogRecordsRingHolder()
+    {
+        if ( ring )
+            ring->m_abandoned = true;
+    }
+
+    unsigned id = 0;
+    wxLogRecordsRingPtr ring;
+};
+
+thread_local wxLogRecordsRingHolder wxPerThreadLogRing;
+
+} // anonymous namespace
+
+class wxLogAsyncFileImpl : public wxThread
+{
+public:
+    wxLogAsyncFileImpl(wxLogAsyncFile* log, FILE* fp, bool ownsFile)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_log(log),
+          m_fp(fp),
+          m_ownsFile(ownsFile),
+          m_condWork(m_mutex),
+          m_condDone(m_mutex),
+          m_id(++gs_lastAsyncLogId)
+    {
+        m_ok = m_fp && Run() == wxTHREAD_NO_ERROR;
+    }
+
+    ~wxLogAsyncFileImpl()
+    {
+        if ( m_ok )
+        {
+            {
+                wxMutexLocker lock(m_mutex);
+                m_stop = true;
+                m_condWork.Signal();
+            }
+
+            Wait();
+        }
+
+        if ( m_ownsFile && m_fp )
+            fclose(m_fp);
+    }
+
+    bool IsOk() const { return m_ok; }
+
+    bool IsWriterThread() const { return wxThread::This() == this; }
+
+    // Called from any thread to queue the record for the writer thread.
+    void Push(wxLogLevel level,
+              const wxString& msg,
+              const wxLogRecordInfo& info,
+              bool isText = false)
+    {
+        wxLogRecordsRing& ring = GetRingForThisThread();
+
+        // Stamp the record with its sequence number now, when it's logged,
+        // and not when it's actually pushed, which may happen later if we
+        // need to wait for the ring to have space for it.
+        const wxUint64 seq = m_lastSeq++;
+        while ( !ring.Push(level, msg, info, isText, seq) )
+        {
+            // The ring is full, we have no choice but to wait until the
+            // writer thread catches up.
+            WaitUntilWritten();
+        }
+
+        // Don't wait for the timeout if the ring is getting full.
+        if ( ring.GetCount() == wxLogRecordsRing::SIZE / 2 )
+            WakeUp();
+    }
+
+    // Called from any thread other than the writer one: this only wakes up
+    // the writer thread and doesn't wait for it, as this is called from
+    // wxLog::FlushActive() during idle time and must not block the UI.
+    void Flush()
+    {
+        if ( HasPendingRecords() )
+            WakeUp();
+    }
+
+    // Called from any thread other than the writer one.
+    void Sync()
+    {
+        if ( HasPendingRecords() )
+            WaitUntilWritten();
+    }
+
+    // Called from the writer thread only.
+    void Append(const wxString& text)
+    {
+        m_batch << text << wxS('\n');
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        for ( ;; )
+        {
+            unsigned request;
+            bool stop;
+            {
+                wxMutexLocker lock(m_mutex);
+                if ( !m_wakeUp && !m_stop )
+                    m_condWork.WaitTimeout(100);
+
+                m_wakeUp = false;
+                request = m_lastRequest;
+                stop = m_stop;
+            }
+
+            // All records pushed before the request was made are written now.
+            Drain();
+
+            {
+                wxMutexLocker lock(m_mutex);
+                m_lastDone = request;
+                m_condDone.Broadcast();
+            }
+
+            if ( stop )
+                break;
+        }
+
+        return nullptr;
+    }
+
+private:
+    wxLogRecordsRing& GetRingForThisThread()
+    {
+        wxLogRecordsRingHolder& holder = wxPerThreadLogRing;
+        if ( holder.id != m_id )
+        {
+            if ( holder.ring )
+                holder.ring->m_abandoned = true;
+
+            holder.ring = std::make_shared<wxLogRecordsRing>();
+            holder.id = m_id;
+
+            wxCriticalSectionLocker lock(m_ringsCS);
+            m_rings.push_back(holder.ring);
+        }
+
+        return *holder.ring;
+    }
+
+    bool HasPendingRecords()
+    {
+        wxCriticalSectionLocker lock(m_ringsCS);
+        for ( const auto& ring : m_rings )
+        {
+            if ( ring->GetCount() )
+                return true;
+        }
+
+        return false;
+    }
+
+    // Wake up the writer thread without waiting for it.
+    void WakeUp()
+    {
+        wxMutexLocker lock(m_mutex);
+        m_wakeUp = true;
+        m_condWork.Signal();
+    }
+
+    // Wake up the writer thread and wait until it writes all the records
+    // queued until now.
+    void WaitUntilWritten()
+    {
+        wxMutexLocker lock(m_mutex);
+
+        const unsigned request = ++m_lastRequest;
+        m_wakeUp = true;
+        m_condWork.Signal();
+
+        // Use signed difference to handle the counter wrap around.
+        while ( static_cast<int>(request - m_lastDone) > 0 )
+            m_condDone.Wait();
+    }
+
+    // Write out all the records currently in the rings.
+    void Drain()
+    {
+        std::vector<wxLogRecordsRingPtr> rings;
+        {
+            wxCriticalSectionLocker lock(m_ringsCS);
+            rings = m_rings;
+        }
+
+        std::vector<size_t> heads(rings.size());
+        std::vector<const wxLogRecordsRing::Slot*> records;
+        bool hasAbandoned = false;
+        for ( size_t n = 0; n < rings.size(); n++ )
+        {
+            const wxLogRecordsRing& ring = *rings[n];
+
+            // Check this before reading the head to be sure that no more
+            // records are added after it if it's abandoned.
+            if ( ring.m_abandoned )
+                hasAbandoned = true;
+
+            heads[n] = ring.GetHead();
+            for ( size_t i = ring.GetTail(); i != heads[n]; i++ )
+                records.push_back(&ring.GetSlot(i));
+        }
+
+        if ( !records.empty() )
+        {
+            // Records from different threads are interleaved in the order in
+            // which they were logged: unlike the time stamps, the sequence
+            // numbers are unique and never go backwards.
+            std::sort(records.begin(), records.end(),
+                      [](const wxLogRecordsRing::Slot* s1,
+                         const wxLogRecordsRing::Slot* s2)
+                      {
+                          return s1->seq < s2->seq;
+                      });
+
+            // Formatting the records results in calls to Append().
+            for ( const auto slot : records )
+            {
+                if ( slot->isText )
+                    Append(slot->msg);
+                else
+                    m_log->wxLog::DoLogRecord(slot->level, slot->msg, slot->info);
+            }
+        }
+
+        // Messages could have been logged from this thread too.
+        if ( !m_batch.empty() )
+        {
+            const wxScopedCharBuffer buf = m_batch.utf8_str();
+            fwrite(buf.data(), 1, buf.length(), m_fp);
+            fflush(m_fp);
+
+            m_batch.clear();
+        }
+
+        for ( size_t n = 0; n < rings.size(); n++ )
+            rings[n]->Release(heads[n]);
+
+        if ( hasAbandoned )
+        {
+            wxCriticalSectionLocker lock(m_ringsCS);
+            m_rings.erase
+            (
+                std::remove_if
+                (
+                    m_rings.begin(), m_rings.end(),
+                    [](const wxLogRecordsRingPtr& ring)
+                    {
+                        return ring->m_abandoned && !ring->GetCount();
+                    }
+                ),
+                m_rings.end()
+            );
+        }
+    }
+
+
+    wxLogAsyncFile* const m_log;
+    FILE* const m_fp;
+    const bool m_ownsFile;
+    bool m_ok = false;
+
+    // The text of the formatted messages accumulated during Drain().
+    wxString m_batch;
+
+    // All rings used for logging to this object, protected by m_ringsCS.
+    std::vector<wxLogRecordsRingPtr> m_rings;
+    wxCriticalSection m_ringsCS;
+
+    // The variables below are protected by this mutex.
+    wxMutex m_mutex;
+
+    // Signalled to wake up the writer thread.
+    wxCondition m_condWork;
+
+    // Signalled by the writer thread after each pass.
+    wxCondition m_condDone;
+
+    // Set to make the writer thread do a pass immediately.
+    bool m_wakeUp = false;
+
+    // Set to make the writer thread exit after the next pass.
+    bool m_stop = false;
+
+    // The last request to write all queued records and the last request
+    // already fulfilled by the writer thread.
+    unsigned m_lastRequest = 0,
+             m_lastDone = 0;
+
+    // Unique identifier of this object.
+    const unsigned m_id;
+
+    // Sequence number of the next record to be logged.
+    std::atomic<wxUint64> m_lastSeq{0};
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsyncFileImpl);
+};
+
+wxLogAsyncFile::wxLogAsyncFile(const wxString& filename)
+{
+    m_impl = new wxLogAsyncFileImpl(this, wxFopen(filename, wxS("a")), true);
+}
+
+wxLogAsyncFile::wxLogAsyncFile(FILE* fp)
+{
+    m_impl = new wxLogAsyncFileImpl(this, fp ? fp : stderr, false);
+}
+
+wxLogAsyncFile::~wxLogAsyncFile()
+{
+    // This writes out all the remaining messages.
+    delete m_impl;
+}
+
+bool wxLogAsyncFile::IsOk() const
+{
+    return m_impl->IsOk();
+}
+
+void wxLogAsyncFile::Flush()
+{
+    // Don't call the base class version: repetition counting is not used for
+    // thread-safe loggers.
+
+    if ( m_impl->IsOk() && !m_impl->IsWriterThread() )
+        m_impl->Flush();
+}
+
+void wxLogAsyncFile::Sync()
+{
+    if ( m_impl->IsOk() && !m_impl->IsWriterThread() )
+        m_impl->Sync();
+}
+
+void wxLogAsyncFile::DoLogRecord(wxLogLevel level,
+                                 const wxString& msg,
+                                 const wxLogRecordInfo& info)
+{
+    if ( !m_impl->IsOk() )
+        return;
+
+    // Format the messages logged by the writer thread itself immediately, it
+    // can't wait for itself.
+    if ( m_impl->IsWriterThread() )
+        wxLog::DoLogRecord(level, msg, info);
+    else
+        m_impl->Push(level, msg, info);
+}
+
+void wxLogAsyncFile::DoLogTextAtLevel(wxLogLevel level, const wxString& msg)
+{
+    if ( !m_impl->IsOk() )
+        return;
+
+    // This is called from the writer thread when formatting the records
+    // queued by DoLogRecord(), but may also be called directly by
+    // LogTextAtLevel() from any thread.
+    if ( m_impl->IsWriterThread() )
+    {
+        m_impl->Append(msg);
+    }
+    else
+    {
+        m_impl->Push(level, msg, wxLogRecordInfo(), true /* already formatted */);
+    }
+}
+
+#endif // wxUSE_THREADS
+
 // ----------------------------------------------------------------------------
 // wxLogChain
 // ----------------------------------------------------------------------------
@@ -147,6 +147,22 @@ wxFileOffset wxMemoryInputStream::OnSysTell() const
     return m_i_streambuf->Tell();
 }
 
+const void *wxMemoryInputStream::OnSysPeekSpan(size_t *size)
+{
+    *size = m_length - m_i_streambuf->GetIntPosition();
+
+    return *size ? m_i_streambuf->GetBufferPos() : nullptr;
+}
+
+void wxMemoryInputStream::OnSysSkipSpan(size_t size)
+{
+    const size_t pos = m_i_streambuf->GetIntPosition();
+
+    wxCHECK_RET( size <= m_length - pos, wxT("skipping past the end") );
+
+    m_i_streambuf->SetIntPosition(pos + size);
+}
+
 // ----------------------------------------------------------------------------
 // wxMemoryOutputStream
 // ----------------------------------------------------------------------------
@@ -40,6 +40,10 @@
     #include "wx/image.h"
 #endif
 
+#include "wx/thread.h"
+
+#include "wx/private/image.h"
+
 #ifdef __WXMSW__
     #include "wx/msw/private.h"
 #endif
@@ -47,6 +51,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <vector>
+
 namespace
 {
 
@@ -72,6 +78,7 @@ typedef struct {
         JSAMPARRAY colormap;
         int actual_number_of_colors;
         int desired_number_of_colors;
+        bool dither;
         JSAMPLE *sample_range_limit, *srl_orig;
 } j_decompress;
 
@@ -298,16 +305,13 @@ typedef my_cquantizer * my_cquantize_ptr;
  */
 
 void
-prescan_quantize (j_decompress_ptr cinfo, JSAMPARRAY input_buf,
-          JSAMPARRAY WXUNUSED(output_buf), int num_rows)
+accumulate_histogram (hist3d histogram, JSAMPARRAY input_buf, int num_rows,
+                      JDIMENSION width)
 {
-  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
   JSAMPROW ptr;
   histptr histp;
-  hist3d histogram = cquantize->histogram;
   int row;
   JDIMENSION col;
-  JDIMENSION width = cinfo->output_width;
 
   for (row = 0; row < num_rows; row++) {
     ptr = input_buf[row];
@@ -328,6 +332,63 @@ prescan_quantize (j_decompress_ptr cinfo, JSAMPARRAY input_buf,
   }
 }
 
+void
+prescan_quantize (j_decompress_ptr cinfo, JSAMPARRAY input_buf,
+          JSAMPARRAY WXUNUSED(output_buf), int num_rows)
+{
+  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
+
+  accumulate_histogram(cquantize->histogram, input_buf, num_rows,
+                       cinfo->output_width);
+}
+
+
+/*
+ * Prescan all rows of the image, possibly using several threads, each of
+ * which accumulates its own histogram which are then merged together.
+ * The result is exactly the same as with prescan_quantize(), as the
+ * saturating addition of the counts doesn't depend on their order.
+ */
+
+void
+prescan_quantize_parallel (j_decompress_ptr cinfo, JSAMPARRAY input_buf,
+                           int num_rows)
+{
+  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
+  hist3d histogram = cquantize->histogram;
+  JDIMENSION width = cinfo->output_width;
+  wxCriticalSection cs;
+
+  wxImageProcessRows(width, num_rows, [=, &cs](int from, int to)
+  {
+    if (from == 0 && to == num_rows) {
+      /* No need for a separate histogram if we do everything at once. */
+      accumulate_histogram(histogram, input_buf, num_rows, width);
+      return;
+    }
+
+    const size_t cells_per_c0 = HIST_C1_ELEMS*HIST_C2_ELEMS;
+    std::vector<histcell> cells(HIST_C0_ELEMS*cells_per_c0);
+    hist2d local[HIST_C0_ELEMS];
+    for (int i = 0; i < HIST_C0_ELEMS; i++)
+      local[i] = reinterpret_cast<hist2d>(&cells[i*cells_per_c0]);
+
+    accumulate_histogram(local, input_buf + from, to - from, width);
+
+    wxCriticalSectionLocker lock(cs);
+    for (int i = 0; i < HIST_C0_ELEMS; i++) {
+      histptr src = &cells[i*cells_per_c0];
+      histptr dst = &histogram[i][0][0];
+      for (size_t n = 0; n < cells_per_c0; n++, src++, dst++) {
+        if (*src) {
+          const unsigned count = unsigned(*dst) + *src;
+          *dst = (histcell) (count <= 0xffff ? count : 0xffff);
+        }
+      }
+    }
+  });
+}
+
 
 /*
  * Next we have the really interesting routines: selection of a colormap
@@ -992,7 +1053,6 @@ fill_inverse_cmap (j_decompress_ptr cinfo, int c0, int c1, int c2)
  * Map some rows of pixels to the output colormapped representation.
  */
 
-#if 0
 void
 pass2_no_dither (j_decompress_ptr cinfo,
          JSAMPARRAY input_buf, JSAMPARRAY output_buf, int num_rows)
@@ -1025,7 +1085,71 @@ pass2_no_dither (j_decompress_ptr cinfo,
     }
   }
 }
-#endif
+
+
+/*
+ * Return the indices of the first cells of all update boxes containing any
+ * non-empty histogram cells, i.e. colors actually used in the image.
+ */
+
+std::vector<int>
+find_used_boxes (j_decompress_ptr cinfo)
+{
+  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
+  hist3d histogram = cquantize->histogram;
+  std::vector<int> boxes;
+
+  for (int c0 = 0; c0 < HIST_C0_ELEMS; c0 += BOX_C0_ELEMS) {
+    for (int c1 = 0; c1 < HIST_C1_ELEMS; c1 += BOX_C1_ELEMS) {
+      for (int c2 = 0; c2 < HIST_C2_ELEMS; c2 += BOX_C2_ELEMS) {
+        bool used = false;
+        for (int ic0 = 0; ic0 < BOX_C0_ELEMS && !used; ic0++) {
+          for (int ic1 = 0; ic1 < BOX_C1_ELEMS && !used; ic1++) {
+            histptr histp = & histogram[c0+ic0][c1+ic1][c2];
+            for (int ic2 = 0; ic2 < BOX_C2_ELEMS; ic2++) {
+              if (*histp++) {
+                used = true;
+                break;
+              }
+            }
+          }
+        }
+
+        if (used)
+          boxes.push_back((c0*HIST_C1_ELEMS + c1)*HIST_C2_ELEMS + c2);
+      }
+    }
+  }
+
+  return boxes;
+}
+
+
+/*
+ * Fill the inverse colormap for all the update boxes containing the given
+ * cells in advance, possibly using several threads, as each update box is
+ * filled independently of all the others. Once this is done, pass2_no_dither
+ * only reads the inverse colormap and so can be used from several threads too.
+ */
+
+void
+fill_inverse_cmap_boxes (j_decompress_ptr cinfo, const std::vector<int>& boxes)
+{
+  /* Use the number of distances computed for each box as its "width". */
+  const int cost = BOX_C0_ELEMS*BOX_C1_ELEMS*BOX_C2_ELEMS *
+                   cinfo->actual_number_of_colors;
+
+  wxImageProcessRows(cost, (int) boxes.size(), [=, &boxes](int from, int to)
+  {
+    for (int n = from; n < to; n++) {
+      const int cell = boxes[n];
+      fill_inverse_cmap(cinfo,
+                        cell / (HIST_C1_ELEMS*HIST_C2_ELEMS),
+                        cell / HIST_C2_ELEMS % HIST_C1_ELEMS,
+                        cell % HIST_C2_ELEMS);
+    }
+  });
+}
 
 void
 pass2_fs_dither (j_decompress_ptr cinfo,
@@ -1269,12 +1393,23 @@ start_pass_2_quant (j_decompress_ptr cinfo, bool is_pre_scan)
 {
   my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
   hist3d histogram = cquantize->histogram;
+  std::vector<int> used_boxes;
 
   if (is_pre_scan) {
     /* Set up method pointers */
     cquantize->pub.color_quantize = prescan_quantize;
     cquantize->pub.finish_pass = finish_pass1;
     cquantize->needs_zeroed = true; /* Always zero histogram */
+  } else if (!cinfo->dither) {
+    /* Set up method pointers */
+    cquantize->pub.color_quantize = pass2_no_dither;
+    cquantize->pub.finish_pass = finish_pass2;
+
+    /* Fill the inverse color map for all colors used by the image in
+     * advance, this must be done before zeroing the histogram below.
+     */
+    if (cquantize->needs_zeroed)
+      used_boxes = find_used_boxes(cinfo);
   } else {
     /* Set up method pointers */
     cquantize->pub.color_quantize = pass2_fs_dither;
@@ -1303,6 +1438,9 @@ start_pass_2_quant (j_decompress_ptr cinfo, bool is_pre_scan)
     }
     cquantize->needs_zeroed = false;
   }
+
+  if (!used_boxes.empty())
+    fill_inverse_cmap_boxes(cinfo, used_boxes);
 }
 
 
@@ -1420,7 +1558,7 @@ prepare_range_limit_table (j_decompress_ptr cinfo)
 wxIMPLEMENT_DYNAMIC_CLASS(wxQuantize, wxObject);
 
 void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows,
-    unsigned char *palette, int desiredNoColours)
+    unsigned char *palette, int desiredNoColours, int flags)
 {
     j_decompress dec;
     my_cquantize_ptr cquantize;
@@ -1428,17 +1566,29 @@ void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, uns
     dec.colormap = nullptr;
     dec.output_width = w;
     dec.desired_number_of_colors = desiredNoColours;
+    dec.dither = !(flags & wxQUANTIZE_NO_DITHERING);
     prepare_range_limit_table(&dec);
     jinit_2pass_quantizer(&dec);
     cquantize = (my_cquantize_ptr) dec.cquantize;
 
 
     cquantize->pub.start_pass(&dec, true);
-    cquantize->pub.color_quantize(&dec, in_rows, out_rows, h);
+    prescan_quantize_parallel(&dec, in_rows, h);
     cquantize->pub.finish_pass(&dec);
 
     cquantize->pub.start_pass(&dec, false);
-    cquantize->pub.color_quantize(&dec, in_rows, out_rows, h);
+    if ( dec.dither )
+    {
+        // Error diffusion makes each row depend on the previous one.
+        cquantize->pub.color_quantize(&dec, in_rows, out_rows, h);
+    }
+    else
+    {
+        wxImageProcessRows(w, h, [&dec, in_rows, out_rows](int from, int to)
+        {
+            pass2_no_dither(&dec, in_rows + from, out_rows + from, to - from);
+        });
+    }
     cquantize->pub.finish_pass(&dec);
 
 
@@ -1507,7 +1657,7 @@ bool wxQuantize::Quantize(const wxImage& src, wxImage& dest,
         outrows[i] = data8bit + w * i;
 
     //RGB->palette
-    DoQuantize(w, h, rows, outrows, palette, desiredNoColours);
+    DoQuantize(w, h, rows, outrows, palette, desiredNoColours, flags);
 
     delete[] rows;
     delete[] outrows;
@@ -835,6 +835,43 @@ bool wxInputStream::Ungetch(char c)
     return Ungetch(&c, sizeof(c)) != 0;
 }
 
+const void *wxInputStream::PeekSpan(size_t *size)
+{
+    wxCHECK_MSG( size, nullptr, wxT("null size pointer") );
+
+    *size = 0;
+
+    // the data in the write back buffer is not contiguous with the rest of
+    // the stream data, so just don't provide direct access to it, the callers
+    // must be prepared to fall back to Read() anyhow
+    if ( m_wback || !IsOk() )
+        return nullptr;
+
+    const void * const data = OnSysPeekSpan(size);
+    if ( !data )
+        *size = 0;
+
+    return data;
+}
+
+void wxInputStream::SkipSpan(size_t size)
+{
+    wxCHECK_RET( !m_wback, wxT("no data returned by PeekSpan() to skip") );
+
+    if ( size )
+        OnSysSkipSpan(size);
+}
+
+const void *wxInputStream::OnSysPeekSpan(size_t * WXUNUSED(size))
+{
+    return nullptr;
+}
+
+void wxInputStream::OnSysSkipSpan(size_t WXUNUSED(size))
+{
+    wxFAIL_MSG( wxT("must be overridden if OnSysPeekSpan() is") );
+}
+
 int wxInputStream::GetC()
 {
     unsigned char c;
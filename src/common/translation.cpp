@@ -30,6 +30,7 @@
     #include "wx/log.h"
     #include "wx/utils.h"
     #include "wx/module.h"
+    #include "wx/thread.h"
 #endif // WX_PRECOMP
 
 // standard headers
@@ -45,6 +46,7 @@
 #include "wx/stdpaths.h"
 #include "wx/version.h"
 #include "wx/uilocale.h"
+#include "wx/wfstream.h"
 
 #ifdef __WINDOWS__
     #include "wx/dynlib.h"
@@ -818,6 +820,16 @@ public:
     // fills the hash with string-translation pairs
     bool FillHash(wxTranslationsHashMap& hash, const wxString& domain) const;
 
+    // prepare for looking up the strings on demand using GetString(), which
+    // is only possible if the catalog has a hash table; returns false if it
+    // doesn't or if the catalog is invalid
+    bool PrepareLookup();
+
+    // return the translation of the given string, in the given plural form,
+    // looking it up in the catalog hash table and caching it; returns nullptr
+    // if there is no translation
+    const wxString *GetString(const wxString& msgid, int index);
+
     // return the charset of the strings in this catalog or empty string if
     // none/unknown
     wxString GetCharset() const { return m_charset; }
@@ -847,14 +859,34 @@ private:
     // all data is stored here
     DataBuffer m_data;
 
+#if wxUSE_STREAMS && wxUSE_FILE
+    // if not null, m_data points to the contents of this mapped file
+    std::unique_ptr<wxMappedFileInputStream> m_mappedFile;
+#endif // wxUSE_STREAMS && wxUSE_FILE
+
     // data description
     size_t32          m_numStrings;   // number of strings in this domain
     const
     wxMsgTableEntry  *m_pOrigTable,   // pointer to original   strings
                      *m_pTransTable;  //            translated
 
+    size_t32          m_nHashSize;    // number of entries in the hash table
+    const size_t32   *m_pHashTable;   // hash table or null if none
+
     wxString m_charset;               // from the message catalog header
 
+    // data used by GetString() only
+    std::unique_ptr<wxMBConv> m_conv; // conversion for catalog strings
+
+    wxTranslationsHashMap m_cache;    // strings already looked up, with
+                                      // empty value for missing ones
+    wxCRIT_SECT_DECLARE_MEMBER(m_cacheCS);
+
+    // return the index of the original string in the catalog or m_numStrings
+    // if not found, the hash is computed by the caller as the hash function
+    // used depends on the platform where the catalog was created
+    size_t32 FindString(const char* msgid, size_t len, size_t32 hash) const;
+
 
     // swap the 2 halves of 32 bit integer if needed
     size_t32 Swap(size_t32 ui) const
@@ -888,6 +920,12 @@ private:
 // ----------------------------------------------------------------------------
 
 wxMsgCatalogFile::wxMsgCatalogFile()
+    : m_numStrings(0),
+      m_pOrigTable(nullptr),
+      m_pTransTable(nullptr),
+      m_nHashSize(0),
+      m_pHashTable(nullptr),
+      m_bSwapped(false)
 {
 }
 
@@ -899,6 +937,36 @@ wxMsgCatalogFile::~wxMsgCatalogFile()
 bool wxMsgCatalogFile::LoadFile(const wxString& filename,
                                 wxPluralFormsCalculatorPtr& rPluralFormsCalculator)
 {
+#if wxUSE_STREAMS && wxUSE_FILE
+    // map the file into memory if possible to avoid copying its contents,
+    // any errors will be reported when reading it below if this fails
+    std::unique_ptr<wxMappedFileInputStream> mappedFile;
+    {
+        wxLogNull noLog;
+        mappedFile.reset(new wxMappedFileInputStream(filename));
+    }
+
+    size_t sizeMapped;
+    const void* const dataMapped = mappedFile->PeekSpan(&sizeMapped);
+    if ( dataMapped )
+    {
+        m_mappedFile = std::move(mappedFile);
+
+        if ( !LoadData
+              (
+                DataBuffer::CreateNonOwned(static_cast<const char*>(dataMapped),
+                                           sizeMapped),
+                rPluralFormsCalculator
+              ) )
+        {
+            wxLogWarning(_("'%s' is not a valid message catalog."), filename);
+            return false;
+        }
+
+        return true;
+    }
+#endif // wxUSE_STREAMS && wxUSE_FILE
+
     wxFile fileMsg(filename);
     if ( !fileMsg.IsOpened() )
         return false;
@@ -964,6 +1032,19 @@ bool wxMsgCatalogFile::LoadData(const DataBuffer& data,
     m_pTransTable = reinterpret_cast<const wxMsgTableEntry*>(data.data() +
                     Swap(pHeader->ofsTransTable));
 
+    // the hash table is optional and GNU gettext doesn't use it if its size
+    // is less than 3, so don't do it either
+    const size_t32 nHashSize = Swap(pHeader->nHashSize);
+    const size_t32 ofsHashTable = Swap(pHeader->ofsHashTable);
+    if ( nHashSize > 2 &&
+            ofsHashTable < data.length() &&
+                (data.length() - ofsHashTable) / sizeof(size_t32) >= nHashSize )
+    {
+        m_nHashSize = nHashSize;
+        m_pHashTable = reinterpret_cast<const size_t32*>(data.data() +
+                       ofsHashTable);
+    }
+
     // now parse catalog's header and try to extract catalog charset and
     // plural forms formula from it:
 
@@ -1089,6 +1170,141 @@ bool wxMsgCatalogFile::FillHash(wxTranslationsHashMap& hash,
     return true;
 }
 
+bool wxMsgCatalogFile::PrepareLookup()
+{
+    if ( !m_pHashTable )
+        return false;
+
+    // check that all strings are valid as FillHash() would do, this doesn't
+    // require accessing the strings themselves and so is relatively cheap
+    for ( size_t32 i = 0; i < m_numStrings; i++ )
+    {
+        if ( !StringAtOfs(m_pOrigTable, i) || !StringAtOfs(m_pTransTable, i) )
+            return false; // may happen for invalid MO files
+    }
+
+    if ( !m_charset.empty() )
+        m_conv.reset(new wxCSConv(m_charset));
+    else // use the default conversion if we have no charset, as FillHash()
+        m_conv.reset(wxConvCurrent->Clone());
+
+    return true;
+}
+
+namespace
+{
+
+// This is the hash function used by GNU gettext for the hash table in .mo
+// files, see hash_string() in its sources.
+size_t32 GetMsgIdHash(const char* str)
+{
+    size_t32 hval = 0;
+    for ( ; *str; ++str )
+    {
+        hval = (hval << 4) + static_cast<unsigned char>(*str);
+
+        const size_t32 g = hval & 0xf0000000u;
+        if ( g )
+            hval ^= (g >> 24) ^ g;
+    }
+
+    return hval;
+}
+
+} // anonymous namespace
+
+size_t32
+wxMsgCatalogFile::FindString(const char* msgid, size_t len, size_t32 hash) const
+{
+    // this is the same double hashing as used by GNU gettext itself
+    size_t32 idx = hash % m_nHashSize;
+    const size_t32 incr = 1 + hash % (m_nHashSize - 2);
+
+    // limit the number of iterations to avoid looping forever on corrupted
+    // catalogs without any free slots in the hash table
+    for ( size_t32 n = 0; n < m_nHashSize; n++ )
+    {
+        const size_t32 nstr = Swap(m_pHashTable[idx]);
+        if ( !nstr )
+            break;
+
+        // entries greater than the number of strings correspond to system
+        // dependent strings which are not supported by FillHash() either
+        if ( nstr <= m_numStrings )
+        {
+            // the original string may contain the plural form after the NUL
+            const size_t32 i = nstr - 1;
+            const size_t32 lenOrig = Swap(m_pOrigTable[i].nLen);
+            if ( lenOrig >= len )
+            {
+                const char * const orig = StringAtOfs(m_pOrigTable, i);
+                if ( orig && memcmp(orig, msgid, len) == 0 &&
+                        (lenOrig == len || orig[len] == '\0') )
+                    return i;
+            }
+        }
+
+        if ( idx >= m_nHashSize - incr )
+            idx -= m_nHashSize - incr;
+        else
+            idx += incr;
+    }
+
+    return m_numStrings;
+}
+
+const wxString *wxMsgCatalogFile::GetString(const wxString& msgid, int index)
+{
+    wxCHECK_MSG( m_conv, nullptr, "PrepareLookup() must be called first" );
+
+    // use the same keys as FillHash()
+    const wxString key = index == 0 ? msgid : msgid + wxChar(index);
+
+    wxCRIT_SECT_LOCKER(lock, m_cacheCS);
+
+    wxTranslationsHashMap::iterator it = m_cache.find(key);
+    if ( it == m_cache.end() )
+    {
+        wxString msgstr;
+
+        // there is no translation if the string can't be represented in the
+        // catalog encoding at all
+        const wxScopedCharBuffer buf(msgid.mb_str(*m_conv));
+        if ( buf.length() || msgid.empty() )
+        {
+            const char * const str = msgid.empty() ? "" : buf.data();
+            const size_t len = msgid.empty() ? 0 : buf.length();
+
+            const size_t32 i = FindString(str, len, GetMsgIdHash(str));
+
+            if ( i != m_numStrings )
+            {
+                // find the requested plural form in the same way as FillHash()
+                const char * const data = StringAtOfs(m_pTransTable, i);
+                const size_t length = Swap(m_pTransTable[i].nLen);
+                size_t offset = 0;
+                for ( int n = 0; offset < length; n++ )
+                {
+                    const char * const trans = data + offset;
+                    if ( n == index )
+                    {
+                        msgstr = wxString(trans, *m_conv);
+                        break;
+                    }
+
+                    offset += wxStrnlen(trans, length - offset) + 1;
+                }
+            }
+        }
+
+        it = m_cache.emplace(key, msgstr).first;
+    }
+
+    // empty translations are not used, see FillHash(), so we can use empty
+    // strings for the missing ones
+    return it->second.empty() ? nullptr : &it->second;
+}
+
 
 // ----------------------------------------------------------------------------
 // wxMsgCatalog class
@@ -1107,13 +1323,23 @@ wxMsgCatalog *wxMsgCatalog::CreateFromFile(const wxString& filename,
 {
     std::unique_ptr<wxMsgCatalog> cat(new wxMsgCatalog(domain));
 
-    wxMsgCatalogFile file;
+    std::unique_ptr<wxMsgCatalogFile> file(new wxMsgCatalogFile);
 
-    if ( !file.LoadFile(filename, cat->m_pluralFormsCalculator) )
+    if ( !file->LoadFile(filename, cat->m_pluralFormsCalculator) )
         return nullptr;
 
-    if ( !file.FillHash(cat->m_messages, domain) )
-        return nullptr;
+    // keep the file, which is normally mapped into memory, and look up the
+    // strings in it on demand if possible, wxTranslations calls LoadMessages()
+    // to load all of them at once unless lazy loading is enabled
+    if ( file->PrepareLookup() )
+    {
+        cat->m_file = std::move(file);
+    }
+    else
+    {
+        if ( !file->FillHash(cat->m_messages, domain) )
+            return nullptr;
+    }
 
     return cat.release();
 }
@@ -1135,6 +1361,16 @@ wxMsgCatalog *wxMsgCatalog::CreateFromData(const wxScopedCharBuffer& data,
     return cat.release();
 }
 
+void wxMsgCatalog::LoadMessages()
+{
+    if ( m_file )
+    {
+        // this can't fail as the file was already checked by PrepareLookup()
+        m_file->FillHash(m_messages, m_domain);
+        m_file.reset();
+    }
+}
+
 const wxString *wxMsgCatalog::GetString(const wxString& str, unsigned n, const wxString& context) const
 {
     int index = 0;
@@ -1142,6 +1378,15 @@ const wxString *wxMsgCatalog::GetString(const wxString& str, unsigned n, const w
     {
         index = m_pluralFormsCalculator->evaluate(n);
     }
+
+    if ( m_file )
+    {
+        if ( context.empty() )
+            return m_file->GetString(str, index);
+        else
+            return m_file->GetString(context + wxString('\x04') + str, index);
+    }
+
     wxTranslationsHashMap::const_iterator i;
     if (index != 0)
     {
@@ -1209,6 +1454,7 @@ wxTranslations::wxTranslations()
 {
     m_pMsgCat = nullptr;
     m_loader = new wxFileTranslationsLoader;
+    m_lazyLoading = false;
 }
 
 
@@ -1350,6 +1596,9 @@ bool wxTranslations::LoadCatalog(const wxString& domain, const wxString& lang)
 
     if ( cat )
     {
+        if ( !m_lazyLoading )
+            cat->LoadMessages();
+
         // add it to the head of the list so that in GetString it will
         // be searched before the catalogs added earlier
 
@@ -13,13 +13,34 @@
 #if wxUSE_STREAMS && wxUSE_LIBWEBP
 
 #include "wx/webpdecoder.h"
+#include "wx/mstream.h"
+
+#include "webp/demux.h"
 
 wxWebPDecoder::wxWebPDecoder()
 {
+    m_decoder = nullptr;
+    m_nextFrame = 0;
 }
 
 wxWebPDecoder::~wxWebPDecoder()
 {
+    Free();
+}
+
+void wxWebPDecoder::Free()
+{
+    if ( m_decoder )
+    {
+        WebPAnimDecoderDelete(m_decoder);
+        m_decoder = nullptr;
+    }
+
+    m_data.clear();
+    m_delays.clear();
+    m_currentImage.Destroy();
+    m_nextFrame = 0;
+    m_nFrames = 0;
 }
 
 void wxWebPDecoder::InitWebPHandler() const
@@ -46,22 +67,60 @@ wxAnimationDisposal wxWebPDecoder::GetDisposalMethod(unsigned int WXUNUSED(frame
 long wxWebPDecoder::GetDelay(unsigned int frame) const
 {
     if (frame < m_nFrames)
-        return m_frames[frame].duration;
+        return m_delays[frame];
     else
         return 0;
 }
 
 bool wxWebPDecoder::ConvertToImage(unsigned int frame, wxImage* image) const
 {
-    if (image && frame < m_nFrames)
-        *image = m_frames[frame].image;
-    return image && image->IsOk();
+    if (!image || frame >= m_nFrames)
+        return false;
+
+    // Frames are composited by libwebp on top of the previous ones, so they
+    // can only be decoded in order: restart from the beginning if we need a
+    // frame before the current one, e.g. when the animation loops.
+    if (frame + 1 < m_nextFrame || !m_currentImage.IsOk())
+    {
+        WebPAnimDecoderReset(m_decoder);
+        m_nextFrame = 0;
+    }
+
+    uint8_t* buf = nullptr;
+    while (m_nextFrame <= frame)
+    {
+        int timestamp;
+        if (!WebPAnimDecoderGetNext(m_decoder, &buf, &timestamp))
+        {
+            // Don't leave the decoder in an inconsistent state.
+            WebPAnimDecoderReset(m_decoder);
+            m_nextFrame = 0;
+            m_currentImage.Destroy();
+            return false;
+        }
+
+        m_nextFrame++;
+    }
+
+    // Only convert the frame we need, if any: it may be the current one.
+    if (buf)
+    {
+        const wxSize& size = m_szAnimation;
+
+        // Don't reuse the existing image as it could be shared with the
+        // images returned from the previous calls.
+        m_currentImage = wxImage(size, false);
+        m_currentImage.SetDataRGBA(buf);
+    }
+
+    *image = m_currentImage;
+    return image->IsOk();
 }
 
 wxColour wxWebPDecoder::GetTransparentColour(unsigned int frame) const
 {
     if (frame < m_nFrames)
-        return m_frames[frame].bgColour;
+        return m_bgColour;
     else
         return wxNullColour;
 }
@@ -76,21 +135,63 @@ bool wxWebPDecoder::DoCanRead(wxInputStream& stream) const
 
 bool wxWebPDecoder::Load(wxInputStream& stream)
 {
-    m_frames.clear();
-
-    InitWebPHandler();
-    wxWEBPHandler* handler =
-        wxDynamicCast(wxImage::FindHandler(wxBITMAP_TYPE_WEBP), wxWEBPHandler);
-    if (handler)
-        handler->LoadAnimation(m_frames, stream);
-
-    m_nFrames = m_frames.size();
-    if (m_nFrames > 0)
-        m_szAnimation = m_frames.front().image.GetSize();
-    else
-        m_szAnimation = wxDefaultSize;
-
-    return m_szAnimation != wxDefaultSize;
+    Free();
+
+    m_szAnimation = wxDefaultSize;
+
+    // Only the compressed data is kept in memory, frames are decoded when
+    // ConvertToImage() is called for them.
+    wxMemoryOutputStream mos;
+    stream.Read(mos);
+    m_data.resize(mos.GetLength());
+    if (m_data.empty() || mos.CopyTo(m_data.data(), m_data.size()) != m_data.size())
+        return false;
+
+    WebPData webp_data{};
+    webp_data.bytes = m_data.data();
+    webp_data.size = m_data.size();
+
+    WebPAnimDecoderOptions dec_options;
+    WebPAnimDecoderOptionsInit(&dec_options);
+
+    m_decoder = WebPAnimDecoderNew(&webp_data, &dec_options);
+    if (!m_decoder)
+    {
+        Free();
+        return false;
+    }
+
+    WebPAnimInfo anim_info;
+    if (!WebPAnimDecoderGetInfo(m_decoder, &anim_info) ||
+            !anim_info.frame_count)
+    {
+        Free();
+        return false;
+    }
+
+    // Frame durations are available without decoding the frames.
+    const WebPDemuxer* const demux = WebPAnimDecoderGetDemuxer(m_decoder);
+    for (int n = 1; n <= static_cast<int>(anim_info.frame_count); n++)
+    {
+        WebPIterator iter;
+        if (!WebPDemuxGetFrame(demux, n, &iter))
+            break;
+
+        m_delays.push_back(iter.duration);
+        WebPDemuxReleaseIterator(&iter);
+    }
+
+    m_nFrames = m_delays.size();
+    if (!m_nFrames)
+    {
+        Free();
+        return false;
+    }
+
+    m_bgColour.SetRGBA(anim_info.bgcolor);
+    m_szAnimation = wxSize(anim_info.canvas_width, anim_info.canvas_height);
+
+    return true;
 }
 
 #endif // wxUSE_STREAMS && wxUSE_LIBWEBP
@@ -48,6 +48,7 @@ extern WXDLLIMPEXP_DATA_NET(const char) wxWebSessionBackendCURL[] = "CURL";
 
 wxDEFINE_EVENT(wxEVT_WEBREQUEST_STATE, wxWebRequestEvent);
 wxDEFINE_EVENT(wxEVT_WEBREQUEST_DATA, wxWebRequestEvent);
+wxDEFINE_EVENT(wxEVT_WEBREQUEST_BATCH, wxWebRequestEvent);
 
 #ifdef __WXDEBUG__
 static const wxStringCharType* wxNO_IMPL_MSG
@@ -406,6 +407,18 @@ void wxWebRequestImpl::ProcessStateEvent(wxWebRequest::State state, const wxStri
     if ( !dataFile.empty() && wxFileExists(dataFile) )
         wxRemoveFile(dataFile);
 
+    // Notify the batch, if any, only after the request own handler, and only
+    // once, even if the request becomes active again after authenticating:
+    // as explained above, we can't know if this is going to happen, so the
+    // batch considers State_Unauthorized as a failure, as documented.
+    if ( m_batch && state != wxWebRequest::State_Active )
+    {
+        const wxWebRequestBatchImplPtr batch = m_batch;
+        m_batch.reset(nullptr);
+
+        batch->OnRequestFinished(state);
+    }
+
     // This may destroy this object if it's not used from elsewhere any longer.
     if ( release )
         DecRef();
@@ -582,6 +595,165 @@ int wxWebRequestBase::GetSecurityFlags() const
     return m_impl->GetSecurityFlags();
 }
 
+//
+// wxWebRequestBatchImpl
+//
+
+wxWebRequestBatchImpl::~wxWebRequestBatchImpl() = default;
+
+void wxWebRequestBatchImpl::Add(const wxWebRequestImplPtr& request)
+{
+    wxCHECK_RET( !m_started, "Can't add requests to an already started batch" );
+
+    wxCHECK_RET( request->GetState() == wxWebRequest::State_Idle,
+                 "Only not yet started requests can be added to a batch" );
+
+    wxCHECK_RET( m_requests.empty() ||
+                    &m_requests[0]->GetSessionImpl() == &request->GetSessionImpl(),
+                 "All requests in a batch must use the same session" );
+
+    m_requests.push_back(request);
+}
+
+void wxWebRequestBatchImpl::Start()
+{
+    wxCHECK_RET( !m_started, "Batch can't be restarted" );
+
+    wxCHECK_RET( !m_requests.empty(), "Can't start an empty batch" );
+
+    for ( const auto& request : m_requests )
+    {
+        wxCHECK_RET( request->GetState() == wxWebRequest::State_Idle,
+                     "Requests in a batch must not be started individually" );
+    }
+
+    m_started = true;
+
+    // This creates a reference cycle which is broken when the request
+    // notifies us about its termination.
+    IncRef();
+    const wxWebRequestBatchImplPtr self(this);
+    for ( const auto& request : m_requests )
+        request->SetBatch(self);
+
+    m_requests[0]->GetSessionImpl().StartRequests(m_requests);
+}
+
+void wxWebRequestBatchImpl::Cancel()
+{
+    for ( const auto& request : m_requests )
+    {
+        if ( request->GetState() == wxWebRequest::State_Active )
+            request->Cancel();
+    }
+}
+
+void wxWebRequestBatchImpl::OnRequestFinished(wxWebRequest::State state)
+{
+    m_numFinished++;
+    if ( state != wxWebRequest::State_Completed )
+        m_numFailed++;
+
+    wxLogTrace(wxTRACE_WEBREQUEST, "Batch %p: %zu of %zu requests finished",
+               this, m_numFinished, m_requests.size());
+
+    if ( m_numFinished == m_requests.size() )
+    {
+        wxWebRequestEvent evt(wxEVT_WEBREQUEST_BATCH, m_id,
+                              m_numFailed ? wxWebRequest::State_Failed
+                                          : wxWebRequest::State_Completed);
+        m_handler->ProcessEvent(evt);
+    }
+}
+
+//
+// wxWebRequestBatch
+//
+
+wxWebRequestBatch::wxWebRequestBatch() = default;
+
+wxWebRequestBatch::wxWebRequestBatch(wxEvtHandler* handler, int id)
+    : m_impl(new wxWebRequestBatchImpl(handler, id))
+{
+    wxASSERT_MSG( handler, "Batch event handler must be specified" );
+}
+
+wxWebRequestBatch::wxWebRequestBatch(const wxWebRequestBatch&) = default;
+
+wxWebRequestBatch&
+wxWebRequestBatch::operator=(const wxWebRequestBatch&) = default;
+
+wxWebRequestBatch::~wxWebRequestBatch() = default;
+
+void wxWebRequestBatch::Add(const wxWebRequest& request)
+{
+    wxCHECK_IMPL_VOID();
+
+    wxCHECK_RET( request.IsOk(), "Can't add an invalid request to a batch" );
+
+    m_impl->Add(request.m_impl);
+}
+
+void wxWebRequestBatch::Start()
+{
+    wxCHECK_IMPL_VOID();
+
+    m_impl->Start();
+}
+
+void wxWebRequestBatch::Cancel()
+{
+    wxCHECK_IMPL_VOID();
+
+    m_impl->Cancel();
+}
+
+int wxWebRequestBatch::GetId() const
+{
+    wxCHECK_IMPL( wxID_ANY );
+
+    return m_impl->GetId();
+}
+
+size_t wxWebRequestBatch::GetCount() const
+{
+    wxCHECK_IMPL( 0 );
+
+    return m_impl->GetRequests().size();
+}
+
+wxWebRequest wxWebRequestBatch::GetRequest(size_t n) const
+{
+    wxCHECK_IMPL( wxWebRequest() );
+
+    wxCHECK_MSG( n < m_impl->GetRequests().size(), wxWebRequest(),
+                 "Invalid request index" );
+
+    return wxWebRequest(m_impl->GetRequests()[n]);
+}
+
+size_t wxWebRequestBatch::GetFinishedCount() const
+{
+    wxCHECK_IMPL( 0 );
+
+    return m_impl->GetFinishedCount();
+}
+
+size_t wxWebRequestBatch::GetFailedCount() const
+{
+    wxCHECK_IMPL( 0 );
+
+    return m_impl->GetFailedCount();
+}
+
+bool wxWebRequestBatch::IsFinished() const
+{
+    wxCHECK_IMPL( false );
+
+    return m_impl->IsStarted() &&
+            m_impl->GetFinishedCount() == m_impl->GetRequests().size();
+}
+
 
 
 
@@ -948,6 +1120,13 @@ wxWebSessionImpl::wxWebSessionImpl(Mode mode)
 
 wxWebSessionImpl::~wxWebSessionImpl() = default;
 
+void
+wxWebSessionImpl::StartRequests(const std::vector<wxWebRequestImplPtr>& requests)
+{
+    for ( const auto& request : requests )
+        request->Start();
+}
+
 bool wxWebSessionImpl::SetBaseURL(const wxString& url)
 {
     // For things to work as expected, i.e. append relative URLs to the base
@@ -1132,6 +1311,34 @@ wxWebSession::CreateRequest(wxEvtHandler* handler, const wxString& url, int id)
     return wxWebRequest(m_impl->CreateRequest(*this, handler, GetFullURL(url), id));
 }
 
+bool wxWebSession::SetMaxConnectionsPerHost(int count)
+{
+    wxCHECK_IMPL( false );
+
+    return m_impl->SetMaxConnectionsPerHost(count);
+}
+
+bool wxWebSession::SetMaxConnections(int count)
+{
+    wxCHECK_IMPL( false );
+
+    return m_impl->SetMaxConnections(count);
+}
+
+bool wxWebSession::SetConnectionCacheSize(int count)
+{
+    wxCHECK_IMPL( false );
+
+    return m_impl->SetConnectionCacheSize(count);
+}
+
+bool wxWebSession::EnableMultiplexing(bool enable)
+{
+    wxCHECK_IMPL( false );
+
+    return m_impl->EnableMultiplexing(enable);
+}
+
 wxWebRequestSync
 wxWebSessionSync::CreateRequest(const wxString& url)
 {
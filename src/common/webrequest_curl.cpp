@@ -420,6 +420,20 @@ void wxWebRequestCURL::DoStartPrepare(const wxString& url)
     wxCURLSetOpt(m_handle, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
     if ( usingProxy )
         wxCURLSetOpt(m_handle, CURLOPT_PROXYAUTH, CURLAUTH_ANY);
+
+#if CURL_AT_LEAST_VERSION(7, 47, 0)
+    // Use HTTP/2 if multiplexing was explicitly enabled for the session.
+    // Notice that we don't do anything if it was disabled: this is done by
+    // the session for its multi handle and the HTTP version stays default.
+    if ( m_sessionCURL && m_sessionCURL->GetMultiplexing() == 1 )
+    {
+        wxCURLSetOpt(m_handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+
+        // Prefer waiting for an existing connection allowing multiplexing
+        // to opening a new one.
+        wxCURLSetOpt(m_handle, CURLOPT_PIPEWAIT, 1L);
+    }
+#endif // curl >= 7.47
 }
 
 wxWebRequestCURL::~wxWebRequestCURL()
@@ -1203,6 +1217,22 @@ wxWebSessionCURL::CreateRequest(wxWebSession& session,
             curl_multi_setopt(m_handle, CURLMOPT_SOCKETFUNCTION, SocketCallback);
             curl_multi_setopt(m_handle, CURLMOPT_TIMERDATA, this);
             curl_multi_setopt(m_handle, CURLMOPT_TIMERFUNCTION, TimerCallback);
+
+            // Apply the options which could have been set before.
+            if ( m_maxConnects != -1 )
+                SetMultiOption(CURLMOPT_MAXCONNECTS, m_maxConnects);
+#if CURL_AT_LEAST_VERSION(7, 30, 0)
+            if ( m_maxHostConnections != -1 )
+                SetMultiOption(CURLMOPT_MAX_HOST_CONNECTIONS, m_maxHostConnections);
+            if ( m_maxTotalConnections != -1 )
+                SetMultiOption(CURLMOPT_MAX_TOTAL_CONNECTIONS, m_maxTotalConnections);
+#endif // curl >= 7.30
+#if CURL_AT_LEAST_VERSION(7, 47, 0)
+            if ( m_multiplexing != -1 )
+                SetMultiOption(CURLMOPT_PIPELINING,
+                               m_multiplexing ? CURLPIPE_MULTIPLEX
+                                              : CURLPIPE_NOTHING);
+#endif // curl >= 7.47
         }
     }
 
@@ -1220,17 +1250,106 @@ bool wxWebSessionCURL::StartRequest(wxWebRequestCURL & request)
         request.SetState(wxWebRequest::State_Active);
         m_activeTransfers[curl] = &request;
 
-        // Report a timeout to curl to initiate this transfer.
+        // Report a timeout to curl to initiate this transfer, unless we're
+        // starting a batch, in which case StartRequests() does it only once
+        // for all of them.
+        if ( !m_startingBatch )
+        {
+            int runningHandles;
+            curl_multi_socket_action(m_handle, CURL_SOCKET_TIMEOUT, 0,
+                                     &runningHandles);
+        }
+
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+void
+wxWebSessionCURL::StartRequests(const std::vector<wxWebRequestImplPtr>& requests)
+{
+    m_startingBatch = true;
+    wxWebSessionImpl::StartRequests(requests);
+    m_startingBatch = false;
+
+    // Initiate all the transfers at once, this allows libcurl to use the same
+    // connection for all of them if multiplexing is enabled.
+    if ( m_handle && !m_activeTransfers.empty() )
+    {
         int runningHandles;
         curl_multi_socket_action(m_handle, CURL_SOCKET_TIMEOUT, 0,
                                  &runningHandles);
+    }
+}
 
+bool wxWebSessionCURL::SetMultiOption(CURLMoption option, long value)
+{
+    if ( !m_handle )
         return true;
+
+    return curl_multi_setopt(m_handle, option, value) == CURLM_OK;
+}
+
+bool wxWebSessionCURL::SetMaxConnectionsPerHost(int count)
+{
+    wxCHECK_MSG( count >= 0, false, "Invalid number of connections" );
+
+#if CURL_AT_LEAST_VERSION(7, 30, 0)
+    if ( CurlRuntimeAtLeastVersion(7, 30, 0) )
+    {
+        m_maxHostConnections = count;
+        return SetMultiOption(CURLMOPT_MAX_HOST_CONNECTIONS, count);
     }
-    else
+#endif // curl >= 7.30
+
+    return false;
+}
+
+bool wxWebSessionCURL::SetMaxConnections(int count)
+{
+    wxCHECK_MSG( count >= 0, false, "Invalid number of connections" );
+
+#if CURL_AT_LEAST_VERSION(7, 30, 0)
+    if ( CurlRuntimeAtLeastVersion(7, 30, 0) )
     {
-        return false;
+        m_maxTotalConnections = count;
+        return SetMultiOption(CURLMOPT_MAX_TOTAL_CONNECTIONS, count);
+    }
+#endif // curl >= 7.30
+
+    return false;
+}
+
+bool wxWebSessionCURL::SetConnectionCacheSize(int count)
+{
+    wxCHECK_MSG( count >= 0, false, "Invalid number of connections" );
+
+    m_maxConnects = count;
+    return SetMultiOption(CURLMOPT_MAXCONNECTS, count);
+}
+
+bool wxWebSessionCURL::EnableMultiplexing(bool enable)
+{
+#if CURL_AT_LEAST_VERSION(7, 47, 0)
+    if ( CurlRuntimeAtLeastVersion(7, 47, 0) )
+    {
+        // Multiplexing requires HTTP/2 support in libcurl.
+        if ( enable &&
+                !(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2) )
+            return false;
+
+        m_multiplexing = enable;
+        return SetMultiOption(CURLMOPT_PIPELINING,
+                              enable ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
     }
+#else
+    wxUnusedVar(enable);
+#endif // curl >= 7.47
+
+    return false;
 }
 
 void wxWebSessionCURL::CancelRequest(wxWebRequestCURL* request)
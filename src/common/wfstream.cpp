@@ -16,11 +16,21 @@
 #include "wx/wfstream.h"
 
 #ifndef WX_PRECOMP
+    #include "wx/intl.h"
+    #include "wx/log.h"
     #include "wx/stream.h"
 #endif
 
 #include <stdio.h>
 
+#if wxUSE_FILE
+    #ifdef __WINDOWS__
+        #include "wx/msw/wrapwin.h"
+    #else
+        #include <sys/mman.h>
+    #endif
+#endif // wxUSE_FILE
+
 #if wxUSE_FILE
 
 // ----------------------------------------------------------------------------
@@ -259,6 +269,184 @@ bool wxFileStream::IsOk() const
     return wxFileOutputStream::IsOk() && wxFileInputStream::IsOk();
 }
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+wxMappedFileInputStream::wxMappedFileInputStream(const wxString& fileName)
+    : m_data(nullptr),
+      m_size(0),
+      m_pos(0)
+{
+    m_lasterror = wxSTREAM_READ_ERROR;
+
+#ifdef __WINDOWS__
+    const HANDLE hFile = ::CreateFile(fileName.t_str(), GENERIC_READ,
+                                      FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+    if ( hFile == INVALID_HANDLE_VALUE )
+    {
+        wxLogSysError(_("can't open file '%s'"), fileName);
+        return;
+    }
+
+    // Check that the file size fits into size_t too.
+    LARGE_INTEGER size;
+    if ( !::GetFileSizeEx(hFile, &size) ||
+            static_cast<LONGLONG>(static_cast<size_t>(size.QuadPart))
+                != size.QuadPart )
+    {
+        wxLogSysError(_("can't get size of file '%s'"), fileName);
+        ::CloseHandle(hFile);
+        return;
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // Mapping empty files is not allowed, but we don't need to do it anyhow.
+    if ( m_size )
+    {
+        const HANDLE hMapping = ::CreateFileMapping(hFile, nullptr,
+                                                    PAGE_READONLY, 0, 0,
+                                                    nullptr);
+        if ( hMapping )
+        {
+            // The view keeps the mapping alive, so we can close it right now.
+            m_data = static_cast<const char*>(
+                        ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+            ::CloseHandle(hMapping);
+        }
+
+        if ( !m_data )
+        {
+            wxLogSysError(_("can't map file '%s' into memory"), fileName);
+            m_size = 0;
+        }
+    }
+
+    ::CloseHandle(hFile);
+#else // !__WINDOWS__
+    wxFile file(fileName);
+    if ( !file.IsOpened() )
+        return;
+
+    // Check that the file size fits into size_t too.
+    const wxFileOffset size = file.Length();
+    if ( size == wxInvalidOffset ||
+            static_cast<wxFileOffset>(static_cast<size_t>(size)) != size )
+        return;
+
+    m_size = static_cast<size_t>(size);
+
+    // Mapping empty files is not allowed, but we don't need to do it anyhow.
+    if ( m_size )
+    {
+        // The mapping remains valid after closing the file.
+        void* const data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE,
+                                file.fd(), 0);
+        if ( data == MAP_FAILED )
+        {
+            wxLogSysError(_("can't map file '%s' into memory"), fileName);
+            m_size = 0;
+        }
+        else
+        {
+            m_data = static_cast<const char*>(data);
+        }
+    }
+#endif // __WINDOWS__/!__WINDOWS__
+
+    if ( m_data || !m_size )
+        m_lasterror = wxSTREAM_NO_ERROR;
+}
+
+wxMappedFileInputStream::~wxMappedFileInputStream()
+{
+    if ( m_data )
+    {
+#ifdef __WINDOWS__
+        ::UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+}
+
+bool wxMappedFileInputStream::CanRead() const
+{
+    return m_pos != m_size;
+}
+
+char wxMappedFileInputStream::Peek()
+{
+    if ( m_pos == m_size )
+    {
+        m_lasterror = wxSTREAM_READ_ERROR;
+        m_lastcount = 0;
+
+        return 0;
+    }
+
+    m_lastcount = 1;
+    return m_data[m_pos];
+}
+
+size_t wxMappedFileInputStream::OnSysRead(void *buffer, size_t size)
+{
+    if ( m_pos == m_size )
+    {
+        m_lasterror = wxSTREAM_EOF;
+
+        return 0;
+    }
+
+    if ( size > m_size - m_pos )
+        size = m_size - m_pos;
+
+    memcpy(buffer, m_data + m_pos, size);
+    m_pos += size;
+
+    return size;
+}
+
+wxFileOffset wxMappedFileInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
+{
+    switch ( mode )
+    {
+        case wxFromStart:
+            break;
+
+        case wxFromCurrent:
+            pos += m_pos;
+            break;
+
+        case wxFromEnd:
+            pos += m_size;
+            break;
+    }
+
+    if ( pos < 0 || pos > static_cast<wxFileOffset>(m_size) )
+        return wxInvalidOffset;
+
+    m_pos = static_cast<size_t>(pos);
+
+    return pos;
+}
+
+const void *wxMappedFileInputStream::OnSysPeekSpan(size_t *size)
+{
+    *size = m_size - m_pos;
+
+    return *size ? m_data + m_pos : nullptr;
+}
+
+void wxMappedFileInputStream::OnSysSkipSpan(size_t size)
+{
+    wxCHECK_RET( size <= m_size - m_pos, wxT("skipping past the end") );
+
+    m_pos += size;
+}
+
 #endif // wxUSE_FILE
 
 #if wxUSE_FFILE
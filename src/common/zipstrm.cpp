@@ -26,6 +26,8 @@
 #include "wx/wfstream.h"
 #include "zlib.h"
 
+#include <atomic>
+
 #include <memory>
 #include <unordered_map>
 
@@ -277,6 +279,8 @@ public:
 protected:
     virtual size_t OnSysRead(void *buffer, size_t size) override;
     virtual wxFileOffset OnSysTell() const override { return m_pos; }
+    virtual const void *OnSysPeekSpan(size_t *size) override;
+    virtual void OnSysSkipSpan(size_t size) override;
 
 private:
     wxFileOffset m_pos;
@@ -305,6 +309,21 @@ size_t wxStoredInputStream::OnSysRead(void *buffer, size_t size)
     return count;
 }
 
+const void *wxStoredInputStream::OnSysPeekSpan(size_t *size)
+{
+    const void *data = m_parent_i_stream->PeekSpan(size);
+    if (data && wxFileOffset(*size) > m_len - m_pos)
+        *size = wx_truncate_cast(size_t, m_len - m_pos);
+
+    return *size ? data : nullptr;
+}
+
+void wxStoredInputStream::OnSysSkipSpan(size_t size)
+{
+    m_parent_i_stream->SkipSpan(size);
+    m_pos += size;
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 // Stored output stream
@@ -555,6 +574,8 @@ bool wxZlibOutputStream2::Open(wxOutputStream& stream)
     m_lasterror = wxSTREAM_NO_ERROR;
     m_parent_o_stream = &stream;
 
+    ResetParallel();
+
     if (deflateReset(m_deflate) != Z_OK) {
         wxLogError(_("can't re-initialize zlib deflate stream"));
         m_lasterror = wxSTREAM_WRITE_ERROR;
@@ -613,7 +634,10 @@ private:
     char *m_data;
     size_t m_size;
     size_t m_capacity;
-    int m_ref;
+
+    // Atomic because copies of the same entry may be made by several threads,
+    // see wxZipIndex::OpenEntry().
+    std::atomic<int> m_ref;
 
     wxSUPPRESS_GCC_PRIVATE_DTOR_WARNING(wxZipMemory)
 };
@@ -1785,6 +1809,16 @@ bool wxZipInputStream::FindEndRecord()
     return false;
 }
 
+void wxZipInputStream::InitFromIndex(const wxZipIndex& index)
+{
+    m_parentSeekable = true;
+    m_position = index.m_centralOffset;
+    m_offsetAdjustment = index.m_offsetAdjustment;
+    m_signature = index.m_signature;
+    m_TotalEntries = index.m_entries.size();
+    m_Comment = index.m_comment;
+}
+
 wxZipEntry *wxZipInputStream::GetNextEntry()
 {
     if (m_position == wxInvalidOffset)
@@ -2105,42 +2139,170 @@ size_t wxZipInputStream::OnSysRead(void *buffer, size_t size)
     if (count < size)
         m_lasterror = m_decomp->GetLastError();
 
-    if (Eof()) {
-        if ((m_entry.GetFlags() & wxZIP_SUMS_FOLLOW) != 0) {
-            m_headerSize += m_entry.ReadDescriptor(*m_parent_i_stream);
-            wxZipEntry *entry = m_weaklinks->GetEntry(m_entry.GetKey());
+    if (Eof())
+        OnEntryEnd();
 
-            if (entry) {
-                entry->SetCrc(m_entry.GetCrc());
-                entry->SetCompressedSize(m_entry.GetCompressedSize());
-                entry->SetSize(m_entry.GetSize());
-                entry->Notify();
-            }
+    return count;
+}
+
+void wxZipInputStream::OnEntryEnd()
+{
+    if ((m_entry.GetFlags() & wxZIP_SUMS_FOLLOW) != 0) {
+        m_headerSize += m_entry.ReadDescriptor(*m_parent_i_stream);
+        wxZipEntry *entry = m_weaklinks->GetEntry(m_entry.GetKey());
+
+        if (entry) {
+            entry->SetCrc(m_entry.GetCrc());
+            entry->SetCompressedSize(m_entry.GetCompressedSize());
+            entry->SetSize(m_entry.GetSize());
+            entry->Notify();
         }
+    }
 
-        if (!m_raw) {
+    if (!m_raw) {
+        m_lasterror = wxSTREAM_READ_ERROR;
+
+        if (m_entry.GetSize() != TellI())
+        {
+            wxLogError(_("reading zip stream (entry %s): bad length"),
+                       m_entry.GetName().c_str());
+        }
+        else if (m_crcAccumulator != m_entry.GetCrc())
+        {
+            wxLogError(_("reading zip stream (entry %s): bad crc"),
+                       m_entry.GetName().c_str());
+        }
+        else
+        {
+            m_lasterror = wxSTREAM_EOF;
+        }
+    }
+}
+
+const void *wxZipInputStream::OnSysPeekSpan(size_t *size)
+{
+    if (!IsOpened())
+        if ((AtHeader() && !DoOpen()) || !OpenDecompressor()) {
             m_lasterror = wxSTREAM_READ_ERROR;
+            return nullptr;
+        }
 
-            if (m_entry.GetSize() != TellI())
-            {
-                wxLogError(_("reading zip stream (entry %s): bad length"),
-                           m_entry.GetName().c_str());
-            }
-            else if (m_crcAccumulator != m_entry.GetCrc())
-            {
-                wxLogError(_("reading zip stream (entry %s): bad crc"),
-                           m_entry.GetName().c_str());
-            }
-            else
-            {
-                m_lasterror = wxSTREAM_EOF;
-            }
+    // only the data of the stored entries can be accessed directly
+    if (m_decomp != m_store)
+        return nullptr;
+
+    return m_decomp->PeekSpan(size);
+}
+
+void wxZipInputStream::OnSysSkipSpan(size_t size)
+{
+    if (!m_raw) {
+        size_t len;
+        const void *data = m_decomp->PeekSpan(&len);
+        wxCHECK_RET(data && size <= len, wxT("skipping past the end"));
+
+        m_crcAccumulator = crc32(m_crcAccumulator, (const Byte*)data, size);
+    }
+
+    m_decomp->SkipSpan(size);
+
+    // if all the data was accessed directly, OnSysRead() is never called at
+    // the end of the entry, so check its length and crc here instead
+    if (m_decomp->TellI() == m_decomp->GetLength())
+        OnEntryEnd();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Index of the central directory
+
+bool wxZipIndex::Load(wxInputStream& stream, wxMBConv& conv /*=wxConvLocal*/)
+{
+    m_entries.clear();
+    m_byName.clear();
+    m_comment.clear();
+    m_ok = false;
+
+    wxCHECK_MSG(stream.IsSeekable(), false,
+                wxT("zip index can only be loaded from a seekable stream"));
+
+    wxZipInputStream zip(stream, conv);
+    if (!zip.LoadEndRecord() || !zip.m_parentSeekable)
+        return false;
+
+    m_centralOffset = zip.m_position;
+    m_offsetAdjustment = zip.m_offsetAdjustment;
+    m_signature = zip.m_signature;
+    m_comment = zip.m_Comment;
+
+    m_entries.reserve(zip.m_TotalEntries);
+    m_byName.reserve(zip.m_TotalEntries);
+
+    // Read the central directory directly instead of using GetNextEntry() to
+    // avoid allocating and registering all the entries with the stream.
+    for (;;) {
+        wxStreamError err = zip.ReadCentral();
+        if (err == wxSTREAM_EOF)
+            break;
+
+        if (err != wxSTREAM_NO_ERROR) {
+            m_entries.clear();
+            m_byName.clear();
+            return false;
         }
+
+        // If there are several entries with the same name, use the first one.
+        m_byName.emplace(zip.m_entry.GetInternalName(), m_entries.size());
+        m_entries.push_back(zip.m_entry);
     }
 
-    return count;
+    m_ok = true;
+    return true;
 }
 
+const wxZipEntry *wxZipIndex::Find(const wxString& name,
+                                   wxPathFormat format /*=wxPATH_NATIVE*/) const
+{
+    const auto it = m_byName.find(wxZipEntry::GetInternalName(name, format));
+    return it != m_byName.end() ? &m_entries[it->second] : nullptr;
+}
+
+wxZipInputStream *wxZipIndex::OpenEntry(wxInputStream *stream,
+                                        const wxZipEntry& entry,
+                                        wxMBConv& conv /*=wxConvLocal*/) const
+{
+    std::unique_ptr<wxInputStream> owner(stream);
+    wxCHECK_MSG(m_ok, nullptr, wxT("zip index not loaded"));
+    wxCHECK_MSG(stream && stream->IsSeekable(), nullptr,
+                wxT("zip entries can only be opened from a seekable stream"));
+
+    std::unique_ptr<wxZipInputStream> zip(
+        new wxZipInputStream(owner.release(), conv));
+    zip->InitFromIndex(*this);
+
+    // Opening the entry updates it with the data from its local header, so
+    // use a copy to allow opening the same entry from several threads.
+    wxZipEntry copy(entry);
+    if (!zip->OpenEntry(copy))
+        return nullptr;
+
+    return zip.release();
+}
+
+wxZipInputStream *wxZipIndex::OpenEntry(wxInputStream *stream,
+                                        const wxString& name,
+                                        wxPathFormat format /*=wxPATH_NATIVE*/,
+                                        wxMBConv& conv /*=wxConvLocal*/) const
+{
+    const wxZipEntry *entry = Find(name, format);
+    if (!entry) {
+        delete stream;
+        return nullptr;
+    }
+
+    return OpenEntry(stream, *entry, conv);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Output stream
 
@@ -2174,6 +2336,7 @@ void wxZipOutputStream::Init(int level)
     m_entrySize = 0;
     m_comp = nullptr;
     m_level = level;
+    m_parallelism = 1;
     m_offsetAdjustment = wxInvalidOffset;
     m_endrecWritten = false;
     m_format = wxZIP_FORMAT_DEFAULT;
@@ -2263,6 +2426,16 @@ void wxZipOutputStream::SetLevel(int level)
     }
 }
 
+void wxZipOutputStream::SetParallelism(int numThreads)
+{
+    if (numThreads != m_parallelism) {
+        if (m_comp != m_deflate)
+            delete m_deflate;
+        m_deflate = nullptr;
+        m_parallelism = numThreads;
+    }
+}
+
 bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
 {
     CloseEntry();
@@ -2350,8 +2523,11 @@ wxOutputStream *wxZipOutputStream::OpenCompressor(
             entry.SetFlags((entry.GetFlags() & ~wxZIP_DEFLATE_MASK) |
                             defbits | wxZIP_SUMS_FOLLOW);
 
-            if (!m_deflate)
+            if (!m_deflate) {
                 m_deflate = new wxZlibOutputStream2(stream, GetLevel());
+                if (m_parallelism != 1)
+                    m_deflate->SetParallelism(m_parallelism);
+            }
             else
                 m_deflate->Open(stream);
 
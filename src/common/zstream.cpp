@@ -16,6 +16,7 @@
 
 #include "wx/zstream.h"
 #include "wx/versioninfo.h"
+#include "wx/thread.h"
 
 #ifndef WX_PRECOMP
     #include "wx/intl.h"
@@ -34,6 +35,12 @@
     #include "zlib.h"
 #endif
 
+#if wxUSE_THREADS
+    #include <deque>
+    #include <memory>
+    #include <vector>
+#endif
+
 enum {
     ZSTREAM_BUFFER_SIZE = 16384,
     ZSTREAM_GZIP        = 0x10,     // gzip header
@@ -206,9 +213,22 @@ size_t wxZlibInputStream::OnSysRead(void *buffer, size_t size)
 
   while (err == Z_OK && m_inflate->avail_out > 0) {
     if (m_inflate->avail_in == 0 && m_parent_i_stream->IsOk()) {
-      m_parent_i_stream->Read(m_z_buffer, m_z_size);
-      m_inflate->next_in = m_z_buffer;
-      m_inflate->avail_in = m_parent_i_stream->LastRead();
+      // avoid copying the data if the parent stream has it in memory, but
+      // still take at most the buffer size to not have to put back too much
+      // of it after the end of the deflate stream
+      size_t len;
+      const void *data = m_parent_i_stream->PeekSpan(&len);
+      if (data) {
+        len = wxMin(len, m_z_size);
+        m_parent_i_stream->SkipSpan(len);
+        m_inflate->next_in = static_cast<Bytef*>(const_cast<void*>(data));
+        m_inflate->avail_in = len;
+      }
+      else {
+        m_parent_i_stream->Read(m_z_buffer, m_z_size);
+        m_inflate->next_in = m_z_buffer;
+        m_inflate->avail_in = m_parent_i_stream->LastRead();
+      }
     }
     err = inflate(m_inflate, Z_SYNC_FLUSH);
   }
@@ -278,6 +298,512 @@ bool wxZlibInputStream::SetDictionary(const wxMemoryBuffer &buf)
 // wxZlibOutputStream
 //////////////////////
 
+#if wxUSE_THREADS
+
+// ----------------------------------------------------------------------------
+// wxZlibParallelDeflater: compresses blocks of data using several threads
+// ----------------------------------------------------------------------------
+
+// This works in the same way as pigz: the input is split into blocks which are
+// compressed independently as raw deflate streams, using the end of the
+// previous block as dictionary to avoid losing too much compression, and
+// terminated with an empty stored block (i.e. Z_SYNC_FLUSH), so that their
+// concatenation is a single valid deflate stream. The header and trailer of
+// zlib and gzip formats, if any, are generated here too.
+class wxZlibParallelDeflater
+{
+public:
+    wxZlibParallelDeflater(int level, int flags, int numThreads);
+    ~wxZlibParallelDeflater();
+
+    bool IsOk() const { return !m_workers.empty(); }
+
+    // Compress the data, writing the blocks compressed so far to the stream.
+    bool Write(wxOutputStream& out, const void* buffer, size_t size);
+
+    // Compress all the pending data and write it out, finishing the stream if
+    // final is true, in which case nothing is done until Reset() is called.
+    bool Flush(wxOutputStream& out, bool final);
+
+    // Start a new stream.
+    void Reset();
+
+private:
+    // Size of the blocks the input is split into.
+    static const size_t BLOCK_SIZE = 128*1024;
+
+    // Size of the dictionary used for each block, i.e. deflate window size.
+    static const size_t DICT_SIZE = 32*1024;
+
+    struct Block
+    {
+        std::vector<unsigned char> in;
+        std::vector<unsigned char> dict;
+        std::vector<unsigned char> out;
+        int flush = Z_SYNC_FLUSH;
+        bool done = false;
+        bool ok = false;
+    };
+
+    class Worker : public wxThread
+    {
+    public:
+        explicit Worker(wxZlibParallelDeflater& deflater)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_deflater(deflater)
+        {
+        }
+
+    protected:
+        virtual void* Entry() override;
+
+    private:
+        wxZlibParallelDeflater& m_deflater;
+    };
+
+    // Compress the given block using the given (raw) deflate stream.
+    static bool Compress(z_stream& z, Block& block);
+
+    // Queue the current block for compression.
+    void Submit(int flush);
+
+    // Write out the blocks which have already been compressed, waiting until
+    // there are not too many blocks in progress or, if all is true, until all
+    // of them are done.
+    bool WriteCompleted(wxOutputStream& out, bool all);
+
+    bool WriteBytes(wxOutputStream& out, const void* data, size_t size);
+
+    bool WriteHeader(wxOutputStream& out);
+    bool WriteTrailer(wxOutputStream& out);
+
+
+    const int m_level;
+    const int m_flags;
+
+    // These fields are used only by the thread using the stream.
+    std::vector<wxThread*> m_workers;
+    std::unique_ptr<Block> m_current;
+    std::vector<unsigned char> m_dict;
+    std::deque<std::unique_ptr<Block>> m_blocks;
+    uLong m_check;
+    uLong m_total;
+    bool m_headerWritten;
+    bool m_finished;
+
+    // These fields are shared with the worker threads and protected by mutex.
+    wxMutex m_mutex;
+    wxCondition m_condWork;
+    wxCondition m_condDone;
+    std::deque<Block*> m_queue;
+    bool m_exit = false;
+
+    wxDECLARE_NO_COPY_CLASS(wxZlibParallelDeflater);
+};
+
+wxZlibParallelDeflater::wxZlibParallelDeflater(int level, int flags, int numThreads)
+    : m_level(level == -1 ? Z_DEFAULT_COMPRESSION : level),
+      m_flags(flags),
+      m_condWork(m_mutex),
+      m_condDone(m_mutex)
+{
+    Reset();
+
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        wxThread* const worker = new Worker(*this);
+        if ( worker->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete worker;
+            break;
+        }
+
+        m_workers.push_back(worker);
+    }
+}
+
+wxZlibParallelDeflater::~wxZlibParallelDeflater()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+        m_exit = true;
+        m_condWork.Broadcast();
+    }
+
+    for ( auto worker : m_workers )
+    {
+        worker->Wait();
+        delete worker;
+    }
+}
+
+void wxZlibParallelDeflater::Reset()
+{
+    // Blocks still being compressed after an error can't be destroyed yet.
+    {
+        wxMutexLocker lock(m_mutex);
+        for ( const auto& block : m_blocks )
+        {
+            while ( !block->done )
+                m_condDone.Wait();
+        }
+    }
+
+    m_current.reset();
+    m_dict.clear();
+    m_blocks.clear();
+    m_check = m_flags == wxZLIB_GZIP ? crc32(0, Z_NULL, 0)
+                                     : adler32(0, Z_NULL, 0);
+    m_total = 0;
+    m_headerWritten = false;
+    m_finished = false;
+}
+
+void* wxZlibParallelDeflater::Worker::Entry()
+{
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    const bool initOk = deflateInit2(&z, m_deflater.m_level, Z_DEFLATED,
+                                     -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+
+    wxMutexLocker lock(m_deflater.m_mutex);
+    for ( ;; )
+    {
+        while ( m_deflater.m_queue.empty() && !m_deflater.m_exit )
+            m_deflater.m_condWork.Wait();
+
+        if ( m_deflater.m_queue.empty() )
+            break;
+
+        Block* const block = m_deflater.m_queue.front();
+        m_deflater.m_queue.pop_front();
+
+        m_deflater.m_mutex.Unlock();
+        const bool ok = initOk && Compress(z, *block);
+        m_deflater.m_mutex.Lock();
+
+        block->ok = ok;
+        block->done = true;
+        m_deflater.m_condDone.Broadcast();
+    }
+
+    if ( initOk )
+        deflateEnd(&z);
+
+    return nullptr;
+}
+
+/* static */
+bool wxZlibParallelDeflater::Compress(z_stream& z, Block& block)
+{
+    if ( deflateReset(&z) != Z_OK )
+        return false;
+
+    if ( !block.dict.empty() &&
+            deflateSetDictionary(&z, block.dict.data(),
+                                 static_cast<uInt>(block.dict.size())) != Z_OK )
+        return false;
+
+    // The flush adds a few bytes to the bound in the worst case.
+    block.out.resize(deflateBound(&z, static_cast<uLong>(block.in.size())) + 16);
+
+    z.next_in = block.in.data();
+    z.avail_in = static_cast<uInt>(block.in.size());
+
+    size_t used = 0;
+    for ( ;; )
+    {
+        if ( used == block.out.size() )
+            block.out.resize(2*used);
+
+        z.next_out = block.out.data() + used;
+        z.avail_out = static_cast<uInt>(block.out.size() - used);
+
+        const int err = deflate(&z, block.flush);
+
+        used = block.out.size() - z.avail_out;
+
+        if ( err == Z_STREAM_END )
+            break;
+
+        if ( err != Z_OK )
+            return false;
+
+        if ( block.flush != Z_FINISH && z.avail_out != 0 )
+            break;
+    }
+
+    block.out.resize(used);
+    block.in.clear();
+    block.in.shrink_to_fit();
+    block.dict.clear();
+    block.dict.shrink_to_fit();
+
+    return true;
+}
+
+void wxZlibParallelDeflater::Submit(int flush)
+{
+    if ( !m_current )
+        m_current.reset(new Block);
+
+    Block* const block = m_current.get();
+    block->flush = flush;
+
+    // Note that the dictionary is not used after a full flush, so that the
+    // data after it can be decompressed independently.
+    block->dict = m_dict;
+
+    if ( flush == Z_SYNC_FLUSH )
+    {
+        const std::vector<unsigned char>& in = block->in;
+        if ( in.size() >= DICT_SIZE )
+        {
+            m_dict.assign(in.end() - DICT_SIZE, in.end());
+        }
+        else
+        {
+            m_dict.insert(m_dict.end(), in.begin(), in.end());
+            if ( m_dict.size() > DICT_SIZE )
+                m_dict.erase(m_dict.begin(), m_dict.end() - DICT_SIZE);
+        }
+    }
+    else
+    {
+        m_dict.clear();
+    }
+
+    m_blocks.push_back(std::move(m_current));
+
+    wxMutexLocker lock(m_mutex);
+    m_queue.push_back(block);
+    m_condWork.Signal();
+}
+
+bool
+wxZlibParallelDeflater::WriteBytes(wxOutputStream& out,
+                                   const void* data,
+                                   size_t size)
+{
+    if ( out.Write(data, size).LastWrite() != size )
+    {
+        wxLogDebug(wxT("wxZlibOutputStream: Error writing to underlying stream"));
+        return false;
+    }
+
+    return true;
+}
+
+bool wxZlibParallelDeflater::WriteHeader(wxOutputStream& out)
+{
+    m_headerWritten = true;
+
+    switch ( m_flags )
+    {
+        case wxZLIB_ZLIB:
+            {
+                // See RFC 1950: use deflate with 32KiB window and indicate
+                // the compression level in the same way as zlib does.
+                int levelFlags;
+                if ( m_level == Z_DEFAULT_COMPRESSION || m_level == 6 )
+                    levelFlags = 2;
+                else if ( m_level < 2 )
+                    levelFlags = 0;
+                else if ( m_level < 6 )
+                    levelFlags = 1;
+                else
+                    levelFlags = 3;
+
+                unsigned header = (0x78 << 8) | (levelFlags << 6);
+                header += 31 - header % 31;
+
+                const unsigned char bytes[] =
+                {
+                    static_cast<unsigned char>(header >> 8),
+                    static_cast<unsigned char>(header & 0xff),
+                };
+                return WriteBytes(out, bytes, sizeof(bytes));
+            }
+
+        case wxZLIB_GZIP:
+            {
+                // See RFC 1952: no file name nor time stamp, just like zlib.
+                const unsigned char bytes[] =
+                {
+                    0x1f, 0x8b,         // magic
+                    Z_DEFLATED,         // compression method
+                    0,                  // flags
+                    0, 0, 0, 0,         // modification time
+                    static_cast<unsigned char>(m_level == 9 ? 2
+                                                : m_level == 1 ? 4 : 0),
+                    0xff                // OS: unknown
+                };
+                return WriteBytes(out, bytes, sizeof(bytes));
+            }
+    }
+
+    return true;
+}
+
+bool wxZlibParallelDeflater::WriteTrailer(wxOutputStream& out)
+{
+    switch ( m_flags )
+    {
+        case wxZLIB_ZLIB:
+            {
+                // Adler-32 checksum in big endian order.
+                const unsigned char bytes[] =
+                {
+                    static_cast<unsigned char>((m_check >> 24) & 0xff),
+                    static_cast<unsigned char>((m_check >> 16) & 0xff),
+                    static_cast<unsigned char>((m_check >> 8) & 0xff),
+                    static_cast<unsigned char>(m_check & 0xff),
+                };
+                return WriteBytes(out, bytes, sizeof(bytes));
+            }
+
+        case wxZLIB_GZIP:
+            {
+                // CRC-32 and size modulo 2^32 in little endian order.
+                const unsigned char bytes[] =
+                {
+                    static_cast<unsigned char>(m_check & 0xff),
+                    static_cast<unsigned char>((m_check >> 8) & 0xff),
+                    static_cast<unsigned char>((m_check >> 16) & 0xff),
+                    static_cast<unsigned char>((m_check >> 24) & 0xff),
+                    static_cast<unsigned char>(m_total & 0xff),
+                    static_cast<unsigned char>((m_total >> 8) & 0xff),
+                    static_cast<unsigned char>((m_total >> 16) & 0xff),
+                    static_cast<unsigned char>((m_total >> 24) & 0xff),
+                };
+                return WriteBytes(out, bytes, sizeof(bytes));
+            }
+    }
+
+    return true;
+}
+
+bool wxZlibParallelDeflater::WriteCompleted(wxOutputStream& out, bool all)
+{
+    // Limit the number of blocks in progress to avoid using too much memory
+    // when the data is written faster than it can be compressed.
+    const size_t maxBlocks = all ? 0 : 2*m_workers.size();
+
+    bool ok = true;
+    while ( !m_blocks.empty() )
+    {
+        Block* const block = m_blocks.front().get();
+
+        {
+            wxMutexLocker lock(m_mutex);
+            if ( !block->done )
+            {
+                if ( m_blocks.size() <= maxBlocks )
+                    break;
+
+                while ( !block->done )
+                    m_condDone.Wait();
+            }
+        }
+
+        if ( ok )
+        {
+            if ( !block->ok )
+            {
+                wxLogError(_("Can't write to deflate stream: %s"),
+                           _("compression failed"));
+                ok = false;
+            }
+            else if ( !WriteBytes(out, block->out.data(), block->out.size()) )
+            {
+                ok = false;
+            }
+        }
+
+        m_blocks.pop_front();
+    }
+
+    return ok;
+}
+
+bool
+wxZlibParallelDeflater::Write(wxOutputStream& out,
+                              const void* buffer,
+                              size_t size)
+{
+    wxCHECK_MSG( !m_finished, false, wxT("Deflate stream already finished") );
+
+    if ( !m_headerWritten && !WriteHeader(out) )
+        return false;
+
+    const unsigned char* data = static_cast<const unsigned char*>(buffer);
+    m_total += static_cast<uLong>(size);
+
+    while ( size )
+    {
+        if ( !m_current )
+        {
+            m_current.reset(new Block);
+            m_current->in.reserve(BLOCK_SIZE);
+        }
+
+        std::vector<unsigned char>& in = m_current->in;
+        const size_t len = wxMin(size, BLOCK_SIZE - in.size());
+
+        // Checksum is computed sequentially here, which is much faster than
+        // compressing, so it doesn't need to be parallelized.
+        m_check = m_flags == wxZLIB_GZIP ? crc32(m_check, data, len)
+                                         : adler32(m_check, data, len);
+
+        in.insert(in.end(), data, data + len);
+        data += len;
+        size -= len;
+
+        if ( in.size() == BLOCK_SIZE )
+        {
+            Submit(Z_SYNC_FLUSH);
+
+            if ( !WriteCompleted(out, false) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool wxZlibParallelDeflater::Flush(wxOutputStream& out, bool final)
+{
+    if ( m_finished )
+        return true;
+
+    if ( !m_headerWritten && !WriteHeader(out) )
+        return false;
+
+    if ( final )
+    {
+        // Note that the last block must be submitted even if it's empty, as
+        // the stream must be terminated by the final deflate block.
+        Submit(Z_FINISH);
+        m_finished = true;
+    }
+    else if ( m_current )
+    {
+        Submit(Z_FULL_FLUSH);
+    }
+    else
+    {
+        // Still don't use the dictionary for the next block.
+        m_dict.clear();
+    }
+
+    if ( !WriteCompleted(out, true) )
+        return false;
+
+    return !final || WriteTrailer(out);
+}
+
+#endif // wxUSE_THREADS
+
 wxZlibOutputStream::wxZlibOutputStream(wxOutputStream& stream,
                                        int level,
                                        int flags)
@@ -300,6 +826,9 @@ void wxZlibOutputStream::Init(int level, int flags)
   m_z_buffer = new unsigned char[ZSTREAM_BUFFER_SIZE];
   m_z_size = ZSTREAM_BUFFER_SIZE;
   m_pos = 0;
+  m_parallel = nullptr;
+  m_level = level;
+  m_flags = flags;
 
   if ( level == -1 )
   {
@@ -350,6 +879,9 @@ bool wxZlibOutputStream::Close()
    deflateEnd(m_deflate);
    wxDELETE(m_deflate);
    wxDELETEA(m_z_buffer);
+#if wxUSE_THREADS
+  wxDELETE(m_parallel);
+#endif
 
   return wxFilterOutputStream::Close() && IsOk();
  }
@@ -361,6 +893,14 @@ void wxZlibOutputStream::DoFlush(bool final)
   if (!IsOk())
     return;
 
+#if wxUSE_THREADS
+  if (m_parallel) {
+    if (!m_parallel->Flush(*m_parent_o_stream, final))
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+    return;
+  }
+#endif
+
   int err = Z_OK;
   bool done = false;
 
@@ -396,6 +936,18 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
   if (!IsOk() || !size)
     return 0;
 
+#if wxUSE_THREADS
+  if (m_parallel) {
+    if (!m_parallel->Write(*m_parent_o_stream, buffer, size)) {
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+      return 0;
+    }
+
+    m_pos += size;
+    return size;
+  }
+#endif
+
   int err = Z_OK;
   m_deflate->next_in = const_cast<unsigned char*>(static_cast<const unsigned char*>(buffer));
   m_deflate->avail_in = size;
@@ -436,6 +988,9 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
 
 bool wxZlibOutputStream::SetDictionary(const char *data, size_t datalen)
 {
+    wxCHECK_MSG( !m_parallel, false,
+                 wxT("Dictionary can't be used in parallel mode") );
+
     return deflateSetDictionary(m_deflate, reinterpret_cast<const Bytef*>(data), datalen) == Z_OK;
 }
 
@@ -444,5 +999,44 @@ bool wxZlibOutputStream::SetDictionary(const wxMemoryBuffer &buf)
     return SetDictionary((char*)buf.GetData(), buf.GetDataLen());
 }
 
+bool wxZlibOutputStream::SetParallelism(int numThreads)
+{
+#if wxUSE_THREADS
+    wxCHECK_MSG( numThreads >= 0, false, wxT("Invalid number of threads") );
+    wxCHECK_MSG( m_pos == 0 || m_pos == wxInvalidOffset, false,
+                 wxT("Parallelism must be set before writing any data") );
+
+    if ( !m_deflate || !IsOk() )
+        return false;
+
+    if ( numThreads == 0 )
+        numThreads = wxThread::GetCPUCount();
+
+    wxDELETE(m_parallel);
+
+    if ( numThreads > 1 )
+    {
+        m_parallel = new wxZlibParallelDeflater(m_level, m_flags, numThreads);
+        if ( !m_parallel->IsOk() )
+        {
+            wxDELETE(m_parallel);
+            return false;
+        }
+    }
+
+    return true;
+#else // !wxUSE_THREADS
+    return numThreads == 1;
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+void wxZlibOutputStream::ResetParallel()
+{
+#if wxUSE_THREADS
+    if ( m_parallel )
+        m_parallel->Reset();
+#endif // wxUSE_THREADS
+}
+
 #endif
   // wxUSE_ZLIB && wxUSE_STREAMS
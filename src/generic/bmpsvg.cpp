@@ -81,10 +81,21 @@
 #else
     #define wxNO_SVG_FILE
 #endif
+
+#include "wx/module.h"
 #include "wx/rawbmp.h"
+#include "wx/thread.h"
+
+#if wxUSE_DISPLAY
+    #include "wx/display.h"
+#endif
 
 #include "wx/private/bmpbndl.h"
 
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
 // ----------------------------------------------------------------------------
 // private helpers
 // ----------------------------------------------------------------------------
@@ -103,42 +114,363 @@ public:
     {
     }
 
-    ~wxBitmapBundleImplSVG()
-    {
-        nsvgDeleteRasterizer(m_svgRasterizer);
-        nsvgDelete(m_svgImage);
-    }
+    ~wxBitmapBundleImplSVG();
 
     virtual wxSize GetDefaultSize() const override;
     virtual wxSize GetPreferredBitmapSizeAtScale(double scale) const override;
     virtual wxBitmap GetBitmap(const wxSize& size) override;
 
-private:
-    wxBitmap DoRasterize(const wxSize& size);
+    // Rasterize the image into the provided buffer using the given rasterizer.
+    //
+    // This function can be called from any thread, as long as the rasterizer
+    // is not used by any other thread at the same time.
+    void Rasterize(NSVGrasterizer* rasterizer,
+                   const wxSize& size,
+                   wxVector<unsigned char>& buffer) const;
+
+    // Create the bitmap from the data returned by Rasterize().
+    static wxBitmap
+    CreateBitmap(const wxSize& size, const wxVector<unsigned char>& buffer);
 
+private:
     NSVGimage* const m_svgImage;
     NSVGrasterizer* const m_svgRasterizer;
 
     const wxSize m_sizeDef;
 
-    // Cache the last used bitmap (may be invalid if not used yet).
+    wxDECLARE_NO_COPY_CLASS(wxBitmapBundleImplSVG);
+};
+
+// Cache of the bitmaps rasterized by all wxBitmapBundleImplSVG objects.
+//
+// The cache size is limited by the total number of bytes used by the bitmaps
+// in it and the least recently used bitmaps are removed from it when this
+// limit is exceeded.
+//
+// The cache can contain either bitmaps or, for the entries added by the
+// background thread which can't create wxBitmap objects, raw rasterized data
+// which is converted to bitmap when it's used for the first time. Only the
+// latter kind of entries may be added from non-main thread and these entries
+// are never removed from the cache from such threads, as this could destroy
+// wxBitmap objects which must be only done in the main thread.
+class wxSVGBitmapCache
+{
+public:
+    // Default value of the cache size limit.
+    static const size_t DEFAULT_LIMIT = 16*1024*1024;
+
+    // Return the cached bitmap or an invalid bitmap if there is none.
     //
-    // Note that we cache only the last bitmap and not all the bitmaps ever
-    // requested from GetBitmap() for the different sizes because there would
-    // be no way to clear such cache and its growth could be unbounded,
-    // resulting in too many bitmap objects being used in an application using
-    // SVG for all of its icons.
-    wxBitmap m_cachedBitmap;
+    // Must be called from the main thread only.
+    wxBitmap Get(const wxBitmapBundleImplSVG* impl, const wxSize& size)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
 
-    wxDECLARE_NO_COPY_CLASS(wxBitmapBundleImplSVG);
+        const auto it = m_index.find(Key(impl, size));
+        if ( it == m_index.end() )
+            return wxBitmap();
+
+        // Move the entry to the front of the list as it's the most recently
+        // used one now.
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+        Entry& entry = *it->second;
+        if ( !entry.bitmap.IsOk() )
+        {
+            entry.bitmap = wxBitmapBundleImplSVG::CreateBitmap(size, entry.raster);
+            wxVector<unsigned char>().swap(entry.raster);
+        }
+
+        return entry.bitmap;
+    }
+
+    // Check if we already have an entry for the given size.
+    bool Has(const wxBitmapBundleImplSVG* impl, const wxSize& size)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        return m_index.count(Key(impl, size)) != 0;
+    }
+
+    // Add a newly rasterized bitmap to the cache.
+    //
+    // Must be called from the main thread only.
+    void Add(const wxBitmapBundleImplSVG* impl,
+             const wxSize& size,
+             const wxBitmap& bitmap)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        const Key key(impl, size);
+        if ( m_index.count(key) )
+            return;
+
+        m_entries.push_front(Entry(key));
+        m_entries.front().bitmap = bitmap;
+        m_index[key] = m_entries.begin();
+        m_bytes += GetBytes(size);
+
+        Trim();
+    }
+
+    // Add the raw rasterized data to the cache if there is enough space
+    // remaining in it.
+    //
+    // This function may be called from any thread.
+    void AddRaster(const wxBitmapBundleImplSVG* impl,
+                   const wxSize& size,
+                   wxVector<unsigned char>& raster)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        const Key key(impl, size);
+        if ( m_index.count(key) )
+            return;
+
+        const size_t bytes = GetBytes(size);
+        if ( m_bytes + bytes > m_limit )
+            return;
+
+        m_entries.push_front(Entry(key));
+        m_entries.front().raster.swap(raster);
+        m_index[key] = m_entries.begin();
+        m_bytes += bytes;
+    }
+
+    // Remove all entries for the bundle which is being destroyed.
+    void Remove(const wxBitmapBundleImplSVG* impl)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        for ( auto it = m_entries.begin(); it != m_entries.end(); )
+        {
+            if ( it->key.impl == impl )
+            {
+                m_bytes -= GetBytes(it->key.size);
+                m_index.erase(it->key);
+                it = m_entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void SetLimit(size_t limit)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        m_limit = limit;
+
+        Trim();
+    }
+
+private:
+    struct Key
+    {
+        Key(const wxBitmapBundleImplSVG* impl_, const wxSize& size_)
+            : impl(impl_), size(size_)
+        {
+        }
+
+        bool operator==(const Key& other) const
+        {
+            return impl == other.impl && size == other.size;
+        }
+
+        const wxBitmapBundleImplSVG* impl;
+        wxSize size;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return std::hash<const void*>()(key.impl) ^
+                    (static_cast<size_t>(key.size.x) << 16) ^
+                    static_cast<size_t>(key.size.y);
+        }
+    };
+
+    struct Entry
+    {
+        explicit Entry(const Key& key_) : key(key_) { }
+
+        Key key;
+
+        // Either the bitmap or the raw data is valid.
+        wxBitmap bitmap;
+        wxVector<unsigned char> raster;
+    };
+
+    using Entries = std::list<Entry>;
+
+    static size_t GetBytes(const wxSize& size)
+    {
+        return static_cast<size_t>(size.x)*size.y*4;
+    }
+
+    // Remove the least recently used entries until the total size is under
+    // the limit, but always keep at least the most recently used one.
+    void Trim()
+    {
+        while ( m_bytes > m_limit && m_entries.size() > 1 )
+        {
+            const Entry& entry = m_entries.back();
+
+            m_bytes -= GetBytes(entry.key.size);
+            m_index.erase(entry.key);
+            m_entries.pop_back();
+        }
+    }
+
+    // The entries in the order of their last use, most recent first.
+    Entries m_entries;
+
+    // Index of the entries by their key.
+    std::unordered_map<Key, Entries::iterator, KeyHash> m_index;
+
+    // Total size of all entries.
+    size_t m_bytes = 0;
+
+    size_t m_limit = DEFAULT_LIMIT;
+
+    wxCRIT_SECT_DECLARE_MEMBER(m_cs);
+};
+
+// The global cache, created on demand and destroyed by wxSVGBitmapCacheModule.
+wxSVGBitmapCache* gs_svgBitmapCache = nullptr;
+
+wxSVGBitmapCache& GetSVGBitmapCache()
+{
+    if ( !gs_svgBitmapCache )
+        gs_svgBitmapCache = new wxSVGBitmapCache();
+
+    return *gs_svgBitmapCache;
+}
+
+// A request to rasterize the given bundle in the given size.
+struct wxSVGRasterizeRequest
+{
+    const wxBitmapBundleImplSVG* impl;
+    wxSize size;
 };
 
+// Rasterize all the requested bitmaps and store them in the given cache.
+//
+// The provided function is called to check if we should stop before
+// processing the next request.
+template <typename F>
+void
+DoPrerasterize(wxSVGBitmapCache& cache,
+               const wxVector<wxSVGRasterizeRequest>& requests,
+               const F& shouldStop)
+{
+    NSVGrasterizer* const rasterizer = nsvgCreateRasterizer();
+
+    wxVector<unsigned char> buffer;
+    for ( const wxSVGRasterizeRequest& req : requests )
+    {
+        if ( shouldStop() )
+            break;
+
+        if ( cache.Has(req.impl, req.size) )
+            continue;
+
+        req.impl->Rasterize(rasterizer, req.size, buffer);
+        cache.AddRaster(req.impl, req.size, buffer);
+    }
+
+    nsvgDeleteRasterizer(rasterizer);
+}
+
+#if wxUSE_THREADS
+
+// Thread rasterizing the bundles passed to wxBitmapBundle::PrerasterizeSVG().
+class wxSVGPrerasterizeThread : public wxThread
+{
+public:
+    // The cache must be created in the main thread before creating this
+    // thread, it is destroyed only after all the threads are.
+    wxSVGPrerasterizeThread(wxSVGBitmapCache& cache,
+                            const wxVector<wxBitmapBundle>& bundles,
+                            const wxVector<wxSVGRasterizeRequest>& requests)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_cache(cache),
+          m_bundles(bundles),
+          m_requests(requests)
+    {
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        DoPrerasterize(m_cache, m_requests,
+                       [this]() { return TestDestroy(); });
+
+        return nullptr;
+    }
+
+private:
+    wxSVGBitmapCache& m_cache;
+
+    // We keep references to the bundles to ensure that the pointers in the
+    // requests remain valid while this thread is running. Note that this
+    // object is only created and destroyed in the main thread, so the
+    // reference counts are never modified by the thread itself.
+    const wxVector<wxBitmapBundle> m_bundles;
+
+    const wxVector<wxSVGRasterizeRequest> m_requests;
+};
+
+// All the threads started by PrerasterizeSVG() and not yet deleted.
+wxVector<wxSVGPrerasterizeThread*> gs_svgPrerasterizeThreads;
+
+#endif // wxUSE_THREADS
+
+// Module cleaning up the global data used by SVG bundles.
+class wxSVGBitmapCacheModule : public wxModule
+{
+public:
+    wxSVGBitmapCacheModule() { }
+
+    virtual bool OnInit() override { return true; }
+    virtual void OnExit() override
+    {
+#if wxUSE_THREADS
+        for ( wxSVGPrerasterizeThread* thread : gs_svgPrerasterizeThreads )
+        {
+            thread->Delete();
+            delete thread;
+        }
+        gs_svgPrerasterizeThreads.clear();
+#endif // wxUSE_THREADS
+
+        wxDELETE(gs_svgBitmapCache);
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxSVGBitmapCacheModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxSVGBitmapCacheModule, wxModule);
+
 } // anonymous namespace
 
 // ============================================================================
 // wxBitmapBundleImplSVG implementation
 // ============================================================================
 
+wxBitmapBundleImplSVG::~wxBitmapBundleImplSVG()
+{
+    if ( gs_svgBitmapCache )
+        gs_svgBitmapCache->Remove(this);
+
+    nsvgDeleteRasterizer(m_svgRasterizer);
+    nsvgDelete(m_svgImage);
+}
+
 wxSize wxBitmapBundleImplSVG::GetDefaultSize() const
 {
     return m_sizeDef;
@@ -152,20 +484,29 @@ wxSize wxBitmapBundleImplSVG::GetPreferredBitmapSizeAtScale(double scale) const
 
 wxBitmap wxBitmapBundleImplSVG::GetBitmap(const wxSize& size)
 {
-    if ( !m_cachedBitmap.IsOk() || m_cachedBitmap.GetSize() != size )
+    wxSVGBitmapCache& cache = GetSVGBitmapCache();
+
+    wxBitmap bitmap = cache.Get(this, size);
+    if ( !bitmap.IsOk() )
     {
-        m_cachedBitmap = DoRasterize(size);
+        wxVector<unsigned char> buffer;
+        Rasterize(m_svgRasterizer, size, buffer);
+
+        bitmap = CreateBitmap(size, buffer);
+        cache.Add(this, size, bitmap);
     }
 
-    return m_cachedBitmap;
+    return bitmap;
 }
 
-wxBitmap wxBitmapBundleImplSVG::DoRasterize(const wxSize& size)
+void wxBitmapBundleImplSVG::Rasterize(NSVGrasterizer* rasterizer,
+                                      const wxSize& size,
+                                      wxVector<unsigned char>& buffer) const
 {
-    wxVector<unsigned char> buffer(size.x*size.y*4);
+    buffer.assign(size.x*size.y*4, 0);
     nsvgRasterize
     (
-        m_svgRasterizer,
+        rasterizer,
         m_svgImage,
         0.0, 0.0,           // no offset
         wxMin
@@ -177,7 +518,13 @@ wxBitmap wxBitmapBundleImplSVG::DoRasterize(const wxSize& size)
         size.x, size.y,
         size.x*4            // stride -- we have no gaps between lines
     );
+}
 
+/* static */
+wxBitmap
+wxBitmapBundleImplSVG::CreateBitmap(const wxSize& size,
+                                    const wxVector<unsigned char>& buffer)
+{
     wxBitmap bitmap(size, 32);
     wxAlphaPixelData bmpdata(bitmap);
     wxAlphaPixelData::Iterator dst(bmpdata);
@@ -282,4 +629,86 @@ wxBitmapBundle wxBitmapBundle::FromSVGFile(const wxString& path, const wxSize& s
     return wxBitmapBundle();
 }
 
+/* static */
+void wxBitmapBundle::SetSVGCacheLimit(size_t bytes)
+{
+    GetSVGBitmapCache().SetLimit(bytes);
+}
+
+/* static */
+void wxBitmapBundle::PrerasterizeSVG(const wxVector<wxBitmapBundle>& bundles)
+{
+    // Rasterize the bitmaps for all scale factors currently in use.
+    wxVector<double> scales;
+#if wxUSE_DISPLAY
+    const unsigned numDisplays = wxDisplay::GetCount();
+    for ( unsigned n = 0; n < numDisplays; ++n )
+    {
+        const double scale = wxDisplay(n).GetScaleFactor();
+        if ( std::find(scales.begin(), scales.end(), scale) == scales.end() )
+            scales.push_back(scale);
+    }
+#endif // wxUSE_DISPLAY
+    if ( scales.empty() )
+        scales.push_back(1.0);
+
+    wxVector<wxBitmapBundle> bundlesSVG;
+    wxVector<wxSVGRasterizeRequest> requests;
+    for ( const wxBitmapBundle& bundle : bundles )
+    {
+        const wxBitmapBundleImplSVG* const
+            impl = dynamic_cast<wxBitmapBundleImplSVG*>(bundle.GetImpl());
+        if ( !impl )
+            continue;
+
+        bundlesSVG.push_back(bundle);
+
+        for ( double scale : scales )
+        {
+            const wxSVGRasterizeRequest
+                req = { impl, impl->GetPreferredBitmapSizeAtScale(scale) };
+            requests.push_back(req);
+        }
+    }
+
+    if ( requests.empty() )
+        return;
+
+    // Note that the cache must be created here, in the main thread, and not
+    // on demand by the worker thread.
+    wxSVGBitmapCache& cache = GetSVGBitmapCache();
+
+#if wxUSE_THREADS
+    // Clean up the threads which have already finished.
+    for ( auto it = gs_svgPrerasterizeThreads.begin();
+          it != gs_svgPrerasterizeThreads.end(); )
+    {
+        wxSVGPrerasterizeThread* const thread = *it;
+        if ( thread->IsRunning() )
+        {
+            ++it;
+            continue;
+        }
+
+        thread->Wait();
+        delete thread;
+        it = gs_svgPrerasterizeThreads.erase(it);
+    }
+
+    wxSVGPrerasterizeThread* const
+        thread = new wxSVGPrerasterizeThread(cache, bundlesSVG, requests);
+    if ( thread->Run() == wxTHREAD_NO_ERROR )
+    {
+        gs_svgPrerasterizeThreads.push_back(thread);
+        return;
+    }
+
+    delete thread;
+
+    // Fall back to doing it synchronously if we couldn't start the thread.
+#endif // wxUSE_THREADS
+
+    DoPrerasterize(cache, requests, []() { return false; });
+}
+
 #endif // wxHAS_SVG
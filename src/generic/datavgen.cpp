@@ -18,8 +18,8 @@
 #ifdef wxHAS_GENERIC_DATAVIEWCTRL
 
 #ifndef WX_PRECOMP
+    #include "wx/app.h"
     #ifdef __WXMSW__
-        #include "wx/app.h"          // GetRegisteredClassName()
         #include "wx/msw/private.h"
         #include "wx/msw/wrapwin.h"
         #include "wx/msw/wrapcctl.h" // include <commctrl.h> "properly"
@@ -533,6 +533,33 @@ public:
     void InsertChild(wxDataViewMainWindow* window,
                      wxDataViewTreeNode *node, unsigned index);
 
+    // Set all children of a node which doesn't have any yet at once. This is
+    // much faster than inserting them one by one if there are many of them,
+    // as they're only sorted once, if necessary. The contents of the provided
+    // vector is taken by this function.
+    void RealizeChildren(wxDataViewMainWindow* window,
+                         wxDataViewTreeNodes& nodes);
+
+    // Delete all child nodes of a closed node if none of them is open: they
+    // will be recreated from the model if this node is opened again, so there
+    // is no need to keep them in memory meanwhile.
+    void ReleaseChildrenIfUnused()
+    {
+        if ( !m_branchData || m_branchData->open || HasOpenDescendants() )
+            return;
+
+        wxDataViewTreeNodes& nodes = m_branchData->children;
+        for ( wxDataViewTreeNodes::iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            delete *i;
+        }
+
+        wxDataViewTreeNodes().swap(nodes);
+        m_branchData->sortOrder = SortOrder();
+    }
+
     void RemoveChild(unsigned index)
     {
         wxCHECK_RET( m_branchData != nullptr, "leaf node doesn't have children" );
@@ -634,6 +661,25 @@ public:
         return m_branchData ? m_branchData->subTreeCount : 0;
     }
 
+    // Return true if any of the already created nodes in this subtree, not
+    // counting this node itself, is open.
+    bool HasOpenDescendants() const
+    {
+        if ( !m_branchData )
+            return false;
+
+        const wxDataViewTreeNodes& nodes = m_branchData->children;
+        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            if ( (*i)->IsOpen() || (*i)->HasOpenDescendants() )
+                return true;
+        }
+
+        return false;
+    }
+
     void ChangeSubTreeCount( int num )
     {
         wxASSERT( m_branchData != nullptr );
@@ -1936,6 +1982,32 @@ void wxDataViewTreeNode::InsertChild(wxDataViewMainWindow* window,
     }
 }
 
+void wxDataViewTreeNode::RealizeChildren(wxDataViewMainWindow* window,
+                                         wxDataViewTreeNodes& nodes)
+{
+    if (!m_branchData)
+        m_branchData = new BranchNodeData;
+
+    wxCHECK_RET( m_branchData->children.empty(), "children already realized" );
+
+    m_branchData->children.swap(nodes);
+
+    // As in InsertChild(), postpone sorting the children of a closed node
+    // until it is opened, which may never happen.
+    const SortOrder sortOrder = window->GetSortOrder();
+    if ( m_branchData->open && !sortOrder.IsNone() )
+    {
+        std::sort(m_branchData->children.begin(),
+                  m_branchData->children.end(),
+                  wxGenericTreeModelNodeCmp(window, sortOrder));
+
+        m_branchData->sortOrder = sortOrder;
+    }
+    else
+    {
+        m_branchData->sortOrder = SortOrder();
+    }
+}
 
 void wxDataViewTreeNode::Resort(wxDataViewMainWindow* window)
 {
@@ -3370,20 +3442,30 @@ bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_c
         node->PutInSortOrder(this);
     }
 
+    // Only the changed item needs to be measured to update the best column
+    // widths, unless it was the widest one.
+    const int row = GetRowByItem(item);
+
     wxDataViewColumn* column;
     if ( view_column == wxNOT_FOUND )
     {
         column = nullptr;
-        GetOwner()->InvalidateColBestWidths();
+        if ( row >= 0 )
+            GetOwner()->UpdateColBestWidths(row, item);
+        else
+            GetOwner()->InvalidateColBestWidths();
     }
     else
     {
         column = m_owner->GetColumn(view_column);
-        GetOwner()->InvalidateColBestWidth(view_column);
+        if ( row >= 0 )
+            GetOwner()->UpdateColBestWidth(view_column, row, item);
+        else
+            GetOwner()->InvalidateColBestWidth(view_column);
     }
 
     // Update the displayed value(s).
-    RefreshRow(GetRowByItem(item));
+    RefreshRow(row);
 
     // Send event
     wxDataViewEvent le(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED, m_owner, column, item);
@@ -3754,8 +3836,9 @@ int wxDataViewMainWindow::GetLineStart( unsigned int row ) const
     if ( m_rowHeightCache->GetLineStart(row, start) )
         return start;
 
+    // continue after the rows whose heights are already known
     unsigned int r;
-    for (r = 0; r < row; r++)
+    for (r = m_rowHeightCache->GetKnownRows(start); r < row; r++)
     {
         int height = 0;
         if ( !m_rowHeightCache->GetLineHeight(r, height) )
@@ -3799,8 +3882,11 @@ int wxDataViewMainWindow::GetLineAt( unsigned int y ) const
         return rowCount;
     }
 
-    // sum all item heights until y is reached
-    unsigned int yy = 0;
+    // sum all item heights until y is reached, starting after the rows whose
+    // heights are already known as y can't be inside them
+    int known = 0;
+    row = m_rowHeightCache->GetKnownRows(known);
+    unsigned int yy = known;
     for (;;)
     {
         height = 0;
@@ -4124,6 +4210,10 @@ void wxDataViewMainWindow::Collapse(unsigned int row)
 
         node->ToggleOpen(this);
 
+        // Don't keep the nodes which are not shown any longer, unless we need
+        // them to remember which of them were expanded.
+        node->ReleaseChildrenIfUnused();
+
         // Adjust the current row if necessary.
         if ( HasCurrentRow() && m_currentRow > row )
         {
@@ -4434,6 +4524,10 @@ static void BuildTreeHelper( wxDataViewMainWindow *window, const wxDataViewModel
     wxDataViewItemArray children;
     unsigned int num = model->GetChildren( item, children);
 
+    // Don't insert the nodes one by one, this would be quadratic in their
+    // number when the control is sorted.
+    wxDataViewTreeNodes nodes;
+    nodes.reserve(num);
     for ( unsigned int index = 0; index < num; index++ )
     {
         wxDataViewTreeNode *n = new wxDataViewTreeNode(node, children[index]);
@@ -4441,9 +4535,11 @@ static void BuildTreeHelper( wxDataViewMainWindow *window, const wxDataViewModel
         if( model->IsContainer(children[index]) )
             n->SetHasChildren( true );
 
-        node->InsertChild(window, n, index);
+        nodes.push_back(n);
     }
 
+    node->RealizeChildren(window, nodes);
+
     if ( node->IsOpen() )
         node->ChangeSubTreeCount(+num);
 }
@@ -5628,6 +5724,7 @@ void wxDataViewCtrl::Init()
     m_clientArea = nullptr;
 
     m_colsDirty = false;
+    m_colsRefine = false;
 
     m_allowMultiColumnSort = false;
 }
@@ -6072,23 +6169,17 @@ class wxDataViewMaxWidthCalculator : public wxMaxWidthCalculatorBase
 public:
     wxDataViewMaxWidthCalculator(const wxDataViewCtrl *dvc,
                                  wxDataViewMainWindow *clientArea,
-                                 wxDataViewRenderer *renderer,
-                                 const wxDataViewModel *model,
-                                 size_t model_column,
-                                 int expanderSize)
-        : wxMaxWidthCalculatorBase(model_column),
+                                 wxDataViewColumn *column)
+        : wxMaxWidthCalculatorBase(column->GetModelColumn()),
           m_dvc(dvc),
           m_clientArea(clientArea),
-          m_renderer(renderer),
-          m_model(model),
-          m_expanderSize(expanderSize)
+          m_renderer(const_cast<wxDataViewRenderer*>(column->GetRenderer())),
+          m_model(dvc->GetModel()),
+          m_expanderSize(clientArea->GetRowHeight())
     {
-        int index = dvc->GetModelColumnIndex( model_column );
-        wxDataViewColumn* column = index == wxNOT_FOUND ? nullptr : dvc->GetColumn(index);
         m_isExpanderCol =
             !clientArea->IsList() &&
-            (column == nullptr ||
-             GetExpanderColumnOrFirstOne(const_cast<wxDataViewCtrl*>(dvc)) == column );
+            GetExpanderColumnOrFirstOne(const_cast<wxDataViewCtrl*>(dvc)) == column;
     }
 
     virtual void UpdateWithRow(int row) override
@@ -6113,9 +6204,16 @@ public:
                 width += m_renderer->GetSize().x;
         }
 
+        if ( width > GetMaxWidth() )
+            m_widestItem = item;
+
         UpdateWithWidth(width);
     }
 
+    // Return the item with the biggest width or an invalid item if the max
+    // width doesn't come from any item.
+    const wxDataViewItem& GetWidestItem() const { return m_widestItem; }
+
 private:
     const wxDataViewCtrl *m_dvc;
     wxDataViewMainWindow *m_clientArea;
@@ -6123,6 +6221,7 @@ private:
     const wxDataViewModel *m_model;
     bool m_isExpanderCol;
     int m_expanderSize;
+    wxDataViewItem m_widestItem;
 };
 
 
@@ -6133,12 +6232,8 @@ unsigned int wxDataViewCtrl::GetBestColumnWidth(int idx) const
 
     const int count = m_clientArea->GetRowCount();
     wxDataViewColumn *column = GetColumn(idx);
-    wxDataViewRenderer *renderer =
-        const_cast<wxDataViewRenderer*>(column->GetRenderer());
 
-    wxDataViewMaxWidthCalculator calculator(this, m_clientArea, renderer,
-                                            GetModel(), column->GetModelColumn(),
-                                            m_clientArea->GetRowHeight());
+    wxDataViewMaxWidthCalculator calculator(this, m_clientArea, column);
 
     calculator.UpdateWithWidth(column->GetMinWidth());
 
@@ -6154,7 +6249,26 @@ unsigned int wxDataViewCtrl::GetBestColumnWidth(int idx) const
     if ( max_width > 0 )
         max_width += 2 * PADDING_RIGHTLEFT;
 
-    const_cast<wxDataViewCtrl*>(this)->m_colsBestWidths[idx].width = max_width;
+    wxDataViewCtrl* const self = const_cast<wxDataViewCtrl*>(this);
+    CachedColWidthInfo& info = self->m_colsBestWidths[idx];
+    info.width = max_width;
+    info.widestItem = calculator.GetWidestItem();
+
+    // If we didn't measure all rows, do it later, in small chunks, from idle
+    // time handler to make the width converge to its real value.
+    size_t from, to;
+    if ( calculator.GetSkippedRows(&from, &to) )
+    {
+        info.refineFrom = from;
+        info.refineTo = to;
+        self->m_colsRefine = true;
+    }
+    else
+    {
+        info.refineFrom =
+        info.refineTo = 0;
+    }
+
     return max_width;
 }
 
@@ -6226,6 +6340,110 @@ void wxDataViewCtrl::InvalidateColBestWidths()
     m_colsDirty = true;
 }
 
+void wxDataViewCtrl::UpdateColBestWidth(int idx,
+                                        unsigned int row,
+                                        const wxDataViewItem& item)
+{
+    CachedColWidthInfo& info = m_colsBestWidths[idx];
+
+    // If the item was the widest one, the column may need to become narrower
+    // now, so we have no choice but to recompute the width completely.
+    if ( !info.width || !item.IsOk() || item == info.widestItem )
+    {
+        InvalidateColBestWidth(idx);
+        return;
+    }
+
+    // Otherwise the column can only become wider, if this item is wider now.
+    wxDataViewMaxWidthCalculator calculator(this, m_clientArea, GetColumn(idx));
+    calculator.UpdateWithRow(row);
+
+    const int width = calculator.GetMaxWidth() + 2 * PADDING_RIGHTLEFT;
+    if ( width > info.width )
+    {
+        info.width = width;
+        info.widestItem = item;
+        info.dirty = true;
+        m_colsDirty = true;
+    }
+}
+
+void wxDataViewCtrl::UpdateColBestWidths(unsigned int row,
+                                         const wxDataViewItem& item)
+{
+    const unsigned len = m_colsBestWidths.size();
+    for ( unsigned i = 0; i < len; i++ )
+        UpdateColBestWidth(i, row, item);
+}
+
+void wxDataViewCtrl::RefineColBestWidths()
+{
+    m_colsRefine = false;
+
+#if wxUSE_STOPWATCH
+    // Don't block the UI for longer than this.
+    static const long REFINE_TIMEOUT = 5/*ms*/;
+    static const unsigned REFINE_CHECK_FREQ = 50;
+    wxStopWatch timer;
+#else
+    static const unsigned REFINE_MAX_ROWS = 100;
+#endif // wxUSE_STOPWATCH/!wxUSE_STOPWATCH
+
+    const unsigned count = m_clientArea->GetRowCount();
+    unsigned measured = 0;
+    bool done = false;
+
+    const unsigned len = m_colsBestWidths.size();
+    for ( unsigned i = 0; i < len; i++ )
+    {
+        CachedColWidthInfo& info = m_colsBestWidths[i];
+        if ( !info.width )
+            continue;
+
+        const unsigned end = wxMin(info.refineTo, count);
+        if ( info.refineFrom >= end )
+            continue;
+
+        if ( done )
+        {
+            // We'll continue with this column during the next idle time.
+            m_colsRefine = true;
+            continue;
+        }
+
+        wxDataViewMaxWidthCalculator calculator(this, m_clientArea, GetColumn(i));
+        for ( ; info.refineFrom < end; info.refineFrom++ )
+        {
+#if wxUSE_STOPWATCH
+            if ( ++measured % REFINE_CHECK_FREQ == 0 &&
+                    timer.Time() > REFINE_TIMEOUT )
+#else
+            if ( ++measured > REFINE_MAX_ROWS )
+#endif // wxUSE_STOPWATCH/!wxUSE_STOPWATCH
+            {
+                done = true;
+                m_colsRefine = true;
+                break;
+            }
+
+            calculator.UpdateWithRow(info.refineFrom);
+        }
+
+        const int width = calculator.GetMaxWidth() + 2 * PADDING_RIGHTLEFT;
+        if ( width > info.width )
+        {
+            info.width = width;
+            info.widestItem = calculator.GetWidestItem();
+            info.dirty = true;
+            m_colsDirty = true;
+        }
+    }
+
+    // Don't wait for another event to continue.
+    if ( m_colsRefine )
+        wxWakeUpIdle();
+}
+
 void wxDataViewCtrl::UpdateColWidths()
 {
     m_colsDirty = false;
@@ -6256,6 +6474,9 @@ void wxDataViewCtrl::OnInternalIdle()
 {
     wxDataViewCtrlBase::OnInternalIdle();
 
+    if ( m_colsRefine )
+        RefineColBestWidths();
+
     if ( m_colsDirty )
         UpdateColWidths();
 }
@@ -61,6 +61,9 @@ const char wxGridNameStr[] = "grid";
 // Required for wxIs... functions
 #include <ctype.h>
 
+#include <unordered_map>
+#include <unordered_set>
+
 // ----------------------------------------------------------------------------
 // globals
 // ----------------------------------------------------------------------------
@@ -1205,12 +1208,412 @@ void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
     UpdateCellAttrRowsOrCols(m_attrs, static_cast<int>(pos), 0, numCols);
 }
 
+void wxGridCellAttrData::RemoveAttrs(const wxGridBlockCoords& block)
+{
+    const wxULongLong_t numCells =
+        static_cast<wxULongLong_t>(block.GetBottomRow() - block.GetTopRow() + 1)
+            * (block.GetRightCol() - block.GetLeftCol() + 1);
+
+    // Either check all the existing attributes or all cells of the block,
+    // depending on which of them is less.
+    if ( m_attrs.size() < numCells )
+    {
+        for ( wxGridCoordsToAttrMap::iterator it = m_attrs.begin();
+              it != m_attrs.end(); )
+        {
+            int row, col;
+            KeyToCoords(it->first, &row, &col);
+
+            if ( block.Contains(wxGridCellCoords(row, col)) )
+            {
+                it->second->DecRef();
+                m_attrs.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    else
+    {
+        for ( int row = block.GetTopRow(); row <= block.GetBottomRow(); row++ )
+        {
+            for ( int col = block.GetLeftCol(); col <= block.GetRightCol(); col++ )
+                SetAttr(nullptr, row, col);
+        }
+    }
+}
+
 wxGridCoordsToAttrMap::iterator
 wxGridCellAttrData::FindIndex(int row, int col) const
 {
     return m_attrs.find(CoordsToKey(row, col));
 }
 
+// ----------------------------------------------------------------------------
+// wxGridCellAttrRangeData
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Update the sorted spans, i.e. bands or intervals, after inserting or
+// deleting rows or columns: the spans are shifted, shrunk or removed, and
+// split if the new rows or columns are inserted inside them, as they don't
+// have any attributes.
+//
+// The copy function must return a copy of the span for which it takes a new
+// reference to the attributes and the release function must release them.
+template <typename T, typename CopyFunc, typename ReleaseFunc>
+void
+UpdateSpansRowsOrCols(std::vector<T>& spans, int pos, int numRowsOrCols,
+                      CopyFunc copy, ReleaseFunc release)
+{
+    std::vector<T> spansNew;
+    spansNew.reserve(spans.size() + 1);
+    for ( auto& span : spans )
+    {
+        if ( numRowsOrCols > 0 )
+        {
+            if ( span.last < pos )
+            {
+                // Nothing to do, this span is before the inserted cells.
+            }
+            else if ( span.first < pos )
+            {
+                T before = copy(span);
+                before.last = pos - 1;
+                spansNew.push_back(std::move(before));
+
+                span.first = pos + numRowsOrCols;
+                span.last += numRowsOrCols;
+            }
+            else
+            {
+                span.first += numRowsOrCols;
+                span.last += numRowsOrCols;
+            }
+        }
+        else // Deleting [pos, pos - numRowsOrCols) rows or columns.
+        {
+            const int end = pos - numRowsOrCols;
+
+            if ( span.first >= end )
+                span.first += numRowsOrCols;
+            else if ( span.first > pos )
+                span.first = pos;
+
+            if ( span.last >= end )
+                span.last += numRowsOrCols;
+            else if ( span.last >= pos )
+                span.last = pos - 1;
+
+            if ( span.first > span.last )
+            {
+                // This span was entirely deleted.
+                release(span);
+                continue;
+            }
+        }
+
+        spansNew.push_back(std::move(span));
+    }
+
+    spans.swap(spansNew);
+}
+
+// Return the iterator to the span containing the given row or column or end.
+template <typename T>
+typename std::vector<T>::const_iterator
+FindSpan(const std::vector<T>& spans, int rowOrCol)
+{
+    // Find the first span ending at or after this position.
+    auto it = std::lower_bound(spans.begin(), spans.end(), rowOrCol,
+                               [](const T& span, int n)
+                               {
+                                   return span.last < n;
+                               });
+    if ( it != spans.end() && it->first > rowOrCol )
+        it = spans.end();
+
+    return it;
+}
+
+} // anonymous namespace
+
+wxGridCellAttrRangeData::~wxGridCellAttrRangeData()
+{
+    for ( const auto& band : m_bands )
+        DecRefIntervals(band.intervals);
+}
+
+/* static */
+void wxGridCellAttrRangeData::DecRefIntervals(const Intervals& intervals)
+{
+    for ( const auto& interval : intervals )
+        interval.attr->DecRef();
+}
+
+size_t wxGridCellAttrRangeData::GetCount() const
+{
+    size_t count = 0;
+    for ( const auto& band : m_bands )
+        count += band.intervals.size();
+
+    return count;
+}
+
+void wxGridCellAttrRangeData::SetAttr(wxGridCellAttr *attr,
+                                      const wxGridBlockCoords& block)
+{
+    const int top = block.GetTopRow();
+    const int bottom = block.GetBottomRow();
+
+    // Ensure that the block rows are covered by whole bands.
+    const size_t first = SplitBands(top);
+    size_t last = SplitBands(bottom + 1);
+
+    // Add the bands for the rows of the block which are not covered by any
+    // of them yet if we're setting the attribute for them.
+    if ( attr )
+    {
+        int row = top;
+        for ( size_t n = first; ; n++ )
+        {
+            const int next = n < last ? m_bands[n].first : bottom + 1;
+            if ( next > row )
+            {
+                m_bands.insert(m_bands.begin() + n, Band{row, next - 1, {}});
+                n++;
+                last++;
+            }
+
+            if ( n == last )
+                break;
+
+            row = m_bands[n].last + 1;
+        }
+    }
+
+    for ( size_t n = first; n < last; n++ )
+    {
+        if ( attr )
+            attr->IncRef();
+
+        SetIntervalsAttr(m_bands[n].intervals,
+                         block.GetLeftCol(), block.GetRightCol(),
+                         attr);
+    }
+
+    wxSafeDecRef(attr);
+
+    // The bands just before and after the block may be identical to the
+    // changed ones now, so normalize them too.
+    NormalizeBands(first, last + 1);
+}
+
+size_t wxGridCellAttrRangeData::SplitBands(int row)
+{
+    // Find the first band ending at or after this row.
+    size_t n = std::lower_bound(m_bands.begin(), m_bands.end(), row,
+                                [](const Band& band, int r)
+                                {
+                                    return band.last < r;
+                                }) - m_bands.begin();
+
+    if ( n < m_bands.size() && m_bands[n].first < row )
+    {
+        // This band contains the row, split it.
+        Band after = m_bands[n];
+        after.first = row;
+        for ( const auto& interval : after.intervals )
+            interval.attr->IncRef();
+
+        m_bands[n].last = row - 1;
+        m_bands.insert(m_bands.begin() + n + 1, std::move(after));
+        n++;
+    }
+
+    return n;
+}
+
+void wxGridCellAttrRangeData::NormalizeBands(size_t from, size_t to)
+{
+    for ( size_t n = from; n < to && n < m_bands.size(); )
+    {
+        Band& band = m_bands[n];
+        if ( band.intervals.empty() )
+        {
+            m_bands.erase(m_bands.begin() + n);
+            to--;
+            continue;
+        }
+
+        if ( n > 0 )
+        {
+            Band& prev = m_bands[n - 1];
+            if ( prev.last + 1 == band.first &&
+                    std::equal(prev.intervals.begin(), prev.intervals.end(),
+                               band.intervals.begin(), band.intervals.end(),
+                               [](const Interval& i1, const Interval& i2)
+                               {
+                                   return i1.first == i2.first &&
+                                          i1.last == i2.last &&
+                                          i1.attr == i2.attr;
+                               }) )
+            {
+                prev.last = band.last;
+                DecRefIntervals(band.intervals);
+                m_bands.erase(m_bands.begin() + n);
+                to--;
+                continue;
+            }
+        }
+
+        n++;
+    }
+}
+
+/* static */
+void wxGridCellAttrRangeData::SetIntervalsAttr(Intervals& intervals,
+                                               int first, int last,
+                                               wxGridCellAttr *attr)
+{
+    // Find the range [from, to) of the intervals overlapping the columns.
+    const size_t from = std::lower_bound(intervals.begin(), intervals.end(),
+                                         first,
+                                         [](const Interval& interval, int col)
+                                         {
+                                             return interval.last < col;
+                                         }) - intervals.begin();
+    size_t to = from;
+    while ( to < intervals.size() && intervals[to].first <= last )
+        to++;
+
+    // Replace them with the parts of them outside of the columns and the new
+    // interval, if any.
+    Intervals replacement;
+    if ( from < to && intervals[from].first < first )
+    {
+        Interval before = intervals[from];
+        before.last = first - 1;
+        before.attr->IncRef();
+        replacement.push_back(before);
+    }
+
+    if ( attr )
+        replacement.push_back({first, last, attr});
+
+    if ( from < to && intervals[to - 1].last > last )
+    {
+        Interval after = intervals[to - 1];
+        after.first = last + 1;
+        after.attr->IncRef();
+        replacement.push_back(after);
+    }
+
+    for ( size_t n = from; n < to; n++ )
+        intervals[n].attr->DecRef();
+
+    intervals.erase(intervals.begin() + from, intervals.begin() + to);
+    intervals.insert(intervals.begin() + from,
+                     replacement.begin(), replacement.end());
+
+    NormalizeIntervals(intervals, from, from + replacement.size() + 1);
+}
+
+/* static */
+void wxGridCellAttrRangeData::NormalizeIntervals(Intervals& intervals,
+                                                 size_t from, size_t to)
+{
+    for ( size_t n = wxMax(from, 1); n < to && n < intervals.size(); )
+    {
+        Interval& prev = intervals[n - 1];
+        const Interval& interval = intervals[n];
+        if ( prev.last + 1 == interval.first && prev.attr == interval.attr )
+        {
+            prev.last = interval.last;
+            interval.attr->DecRef();
+            intervals.erase(intervals.begin() + n);
+            to--;
+            continue;
+        }
+
+        n++;
+    }
+}
+
+wxGridCellAttr *wxGridCellAttrRangeData::GetAttr(int row, int col) const
+{
+    const auto band = FindSpan(m_bands, row);
+    if ( band == m_bands.end() )
+        return nullptr;
+
+    const auto interval = FindSpan(band->intervals, col);
+    if ( interval == band->intervals.end() )
+        return nullptr;
+
+    wxGridCellAttr* const attr = interval->attr;
+    attr->IncRef();
+
+    return attr;
+}
+
+void wxGridCellAttrRangeData::UpdateAttrRows( size_t pos, int numRows )
+{
+    if ( !numRows )
+        return;
+
+    UpdateSpansRowsOrCols
+    (
+        m_bands, static_cast<int>(pos), numRows,
+        [](const Band& band)
+        {
+            for ( const auto& interval : band.intervals )
+                interval.attr->IncRef();
+            return band;
+        },
+        [](const Band& band)
+        {
+            DecRefIntervals(band.intervals);
+        }
+    );
+
+    // Deleting rows may have made some bands adjacent.
+    if ( numRows < 0 )
+        NormalizeBands(0, m_bands.size());
+}
+
+void wxGridCellAttrRangeData::UpdateAttrCols( size_t pos, int numCols )
+{
+    if ( !numCols )
+        return;
+
+    for ( auto& band : m_bands )
+    {
+        UpdateSpansRowsOrCols
+        (
+            band.intervals, static_cast<int>(pos), numCols,
+            [](const Interval& interval)
+            {
+                interval.attr->IncRef();
+                return interval;
+            },
+            [](const Interval& interval)
+            {
+                interval.attr->DecRef();
+            }
+        );
+
+        if ( numCols < 0 )
+            NormalizeIntervals(band.intervals, 0, band.intervals.size());
+    }
+
+    // Bands may have become empty or identical to their neighbours.
+    NormalizeBands(0, m_bands.size());
+}
+
 // ----------------------------------------------------------------------------
 // wxGridRowOrColAttrData
 // ----------------------------------------------------------------------------
@@ -1224,14 +1627,30 @@ wxGridRowOrColAttrData::~wxGridRowOrColAttrData()
     }
 }
 
+size_t wxGridRowOrColAttrData::LowerBound(int rowOrCol) const
+{
+    size_t lo = 0,
+           hi = m_rowsOrCols.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_rowsOrCols[mid] < rowOrCol )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
 wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 {
     wxGridCellAttr *attr = nullptr;
 
-    int n = m_rowsOrCols.Index(rowOrCol);
-    if ( n != wxNOT_FOUND )
+    const size_t n = LowerBound(rowOrCol);
+    if ( n < m_rowsOrCols.size() && m_rowsOrCols[n] == rowOrCol )
     {
-        attr = m_attrs[(size_t)n];
+        attr = m_attrs[n];
         attr->IncRef();
     }
 
@@ -1240,20 +1659,19 @@ wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 
 void wxGridRowOrColAttrData::SetAttr(wxGridCellAttr *attr, int rowOrCol)
 {
-    int i = m_rowsOrCols.Index(rowOrCol);
-    if ( i == wxNOT_FOUND )
+    const size_t n = LowerBound(rowOrCol);
+    if ( n == m_rowsOrCols.size() || m_rowsOrCols[n] != rowOrCol )
     {
         if ( attr )
         {
             // store the new attribute, taking its ownership
-            m_rowsOrCols.Add(rowOrCol);
-            m_attrs.Add(attr);
+            m_rowsOrCols.Insert(rowOrCol, n);
+            m_attrs.Insert(attr, n);
         }
         // nothing to remove
     }
     else // we have an attribute for this row or column
     {
-        size_t n = (size_t)i;
 
         // notice that this code works correctly even when the old attribute is
         // the same as the new one: as we own of it, we must call DecRef() on
@@ -1341,7 +1759,7 @@ wxGridCellAttr *wxGridCellAttrProvider::GetAttr(int row, int col,
                 {
                     // Basically implement old version.
                     // Also check merge cache, so we don't have to re-merge every time..
-                    wxGridCellAttr *attrcell = m_data->m_cellAttrs.GetAttr(row, col);
+                    wxGridCellAttr *attrcell = m_data->GetCellAttr(row, col);
                     wxGridCellAttr *attrrow = m_data->m_rowAttrs.GetAttr(row);
                     wxGridCellAttr *attrcol = m_data->m_colAttrs.GetAttr(col);
 
@@ -1394,7 +1812,7 @@ wxGridCellAttr *wxGridCellAttrProvider::GetAttr(int row, int col,
                 break;
 
             case (wxGridCellAttr::Cell):
-                attr = m_data->m_cellAttrs.GetAttr(row, col);
+                attr = m_data->GetCellAttr(row, col);
                 break;
 
             case (wxGridCellAttr::Col):
@@ -1422,9 +1840,65 @@ void wxGridCellAttrProvider::SetAttr(wxGridCellAttr *attr,
     if ( !m_data )
         InitData();
 
+    // The attribute of the cell takes precedence over the attribute of the
+    // block containing it, if any, but removing it must remove the latter
+    // for this cell too.
+    if ( !attr && !m_data->m_cellRangeAttrs.IsEmpty() )
+    {
+        m_data->m_cellRangeAttrs.SetAttr(nullptr,
+                                         wxGridBlockCoords(row, col, row, col));
+    }
+
     m_data->m_cellAttrs.SetAttr(attr, row, col);
 }
 
+bool wxGridCellAttrProvider::UsesAttrRange(int row, int col) const
+{
+    if ( !m_data || m_data->m_cellRangeAttrs.IsEmpty() )
+        return false;
+
+    wxGridCellAttr *attr = m_data->m_cellAttrs.GetAttr(row, col);
+    if ( attr )
+    {
+        attr->DecRef();
+        return false;
+    }
+
+    attr = m_data->m_cellRangeAttrs.GetAttr(row, col);
+    if ( !attr )
+        return false;
+
+    attr->DecRef();
+    return true;
+}
+
+void wxGridCellAttrProvider::SetAttrRange(wxGridCellAttr *attr,
+                                          const wxGridBlockCoords& block)
+{
+    wxCHECK_RET( block.GetTopRow() >= 0 && block.GetLeftCol() >= 0 &&
+                 block.GetTopRow() <= block.GetBottomRow() &&
+                 block.GetLeftCol() <= block.GetRightCol(),
+                 "invalid block" );
+
+    if ( attr )
+    {
+        int numRows, numCols;
+        attr->GetSize(&numRows, &numCols);
+        if ( numRows != 1 || numCols != 1 )
+        {
+            attr->DecRef();
+            wxFAIL_MSG( "multicell attributes can't be used for a range" );
+            return;
+        }
+    }
+
+    if ( !m_data )
+        InitData();
+
+    m_data->m_cellAttrs.RemoveAttrs(block);
+    m_data->m_cellRangeAttrs.SetAttr(attr, block);
+}
+
 void wxGridCellAttrProvider::SetRowAttr(wxGridCellAttr *attr, int row)
 {
     if ( !m_data )
@@ -1446,6 +1920,7 @@ void wxGridCellAttrProvider::UpdateAttrRows( size_t pos, int numRows )
     if ( m_data )
     {
         m_data->m_cellAttrs.UpdateAttrRows( pos, numRows );
+        m_data->m_cellRangeAttrs.UpdateAttrRows( pos, numRows );
 
         m_data->m_rowAttrs.UpdateAttrRowsOrCols( pos, numRows );
     }
@@ -1456,6 +1931,7 @@ void wxGridCellAttrProvider::UpdateAttrCols( size_t pos, int numCols )
     if ( m_data )
     {
         m_data->m_cellAttrs.UpdateAttrCols( pos, numCols );
+        m_data->m_cellRangeAttrs.UpdateAttrCols( pos, numCols );
 
         m_data->m_colAttrs.UpdateAttrRowsOrCols( pos, numCols );
     }
@@ -1735,6 +2211,23 @@ void wxGridTableBase::SetAttr(wxGridCellAttr* attr, int row, int col)
     }
 }
 
+void wxGridTableBase::SetAttrRange(wxGridCellAttr* attr,
+                                   const wxGridBlockCoords& block)
+{
+    if ( m_attrProvider )
+    {
+        if ( attr )
+            attr->SetKind(wxGridCellAttr::Cell);
+        m_attrProvider->SetAttrRange(attr, block);
+    }
+    else
+    {
+        // as we take ownership of the pointer and don't store it, we must
+        // free it now
+        wxSafeDecRef(attr);
+    }
+}
+
 void wxGridTableBase::SetRowAttr(wxGridCellAttr *attr, int row)
 {
     if ( m_attrProvider )
@@ -2402,7 +2895,7 @@ void wxGridWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
     wxRegion reg = GetUpdateRegion();
 
     wxGridCellCoordsVector dirtyCells = m_owner->CalcCellsExposed( reg , this );
-    m_owner->DrawGridCellArea( dc, dirtyCells );
+    m_owner->DrawCachedGridCellArea( dc, dirtyCells );
 
     m_owner->DrawGridSpace( dc, this );
 
@@ -2757,8 +3250,26 @@ void wxGridWindow::ScrollWindow( int dx, int dy, const wxRect *rect )
     m_owner->ScrollWindow(dx, dy, rect);
 }
 
+void wxGridWindow::Refresh( bool eraseBackground, const wxRect *rect )
+{
+    // The cells shown in the refreshed area may have changed, so their cached
+    // bitmaps can't be used any longer.
+    if ( rect )
+        m_owner->InvalidateTiles(*rect, this);
+    else
+        m_owner->InvalidateTiles();
+
+    wxGridSubwindow::Refresh(eraseBackground, rect);
+}
+
 void wxGrid::ScrollWindow( int dx, int dy, const wxRect *rect )
 {
+    // Scrolling doesn't change the cells, so don't forget their cached bitmaps
+    // if the newly exposed parts of the windows are refreshed while doing it.
+    wxGridTileCache* const tileCache = m_tileCache;
+    m_tileCache = nullptr;
+    wxON_BLOCK_EXIT_SET(m_tileCache, tileCache);
+
     // We must explicitly call wxWindow version to avoid infinite recursion as
     // wxGridWindow::ScrollWindow() calls this method back.
     m_gridWin->wxWindow::ScrollWindow( dx, dy, rect );
@@ -2901,6 +3412,7 @@ wxGrid::~wxGrid()
 
     delete m_typeRegistry;
     delete m_selection;
+    delete m_tileCache;
 
     delete m_setFixedRows;
     delete m_setFixedCols;
@@ -3091,6 +3603,7 @@ wxGrid::SetTable(wxGridTableBase *table,
 
             // Don't hold on to attributes cached from the old table
             ClearAttrCache();
+            InvalidateTiles();
 
             m_table->SetView(nullptr);
             if( m_ownTable )
@@ -3166,6 +3679,7 @@ void wxGrid::Init()
     m_ownTable = false;
 
     m_selection = nullptr;
+    m_tileCache = nullptr;
     m_defaultCellAttr = nullptr;
     m_typeRegistry = nullptr;
 
@@ -3484,6 +3998,9 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
     // cell than stored in the cache after adding/removing rows/columns.
     ClearAttrCache();
 
+    // And the cells in the cached tiles may have changed for the same reason.
+    InvalidateTiles();
+
     // By the same reasoning, the editor should be dismissed if columns are
     // added or removed. And for consistency, it should IMHO always be
     // removed, not only if the cell "underneath" it actually changes.
@@ -5836,6 +6353,7 @@ void wxGrid::ClearGrid()
         DisableCellEditControl();
 
         m_table->Clear();
+        InvalidateTiles();
         if ( ShouldRefresh() )
             RefreshArea(wxGA_Cells);
     }
@@ -5974,6 +6492,41 @@ wxGrid::SendEvent(wxEventType type, int row, int col, const wxString& s)
 
 void wxGrid::Refresh(bool eraseb, const wxRect* rect)
 {
+    // Forget the cached cells even if we don't refresh right now, as they
+    // must be drawn anew when the grid is redrawn later.
+    if ( m_tileCache )
+    {
+        if ( rect )
+        {
+            wxGridWindow* const gridWindows[] =
+            {
+                m_gridWin,
+                m_frozenColGridWin,
+                m_frozenRowGridWin,
+                m_frozenCornerGridWin
+            };
+
+            for ( wxGridWindow* gridWindow : gridWindows )
+            {
+                if ( !gridWindow )
+                    continue;
+
+                const wxRect rectWin = gridWindow->GetRect();
+                wxRect r = *rect;
+                r.Intersect(rectWin);
+                if ( r.IsEmpty() )
+                    continue;
+
+                r.Offset(-rectWin.GetPosition());
+                InvalidateTiles(r, gridWindow);
+            }
+        }
+        else
+        {
+            InvalidateTiles();
+        }
+    }
+
     // Don't do anything if between Begin/EndBatch...
     // EndBatch() will do all this on the last nested one anyway.
     if ( ShouldRefresh() )
@@ -6029,6 +6582,7 @@ void wxGrid::RefreshBlock(int topRow, int leftCol,
         rightCol = leftCol;
     }
 
+    InvalidateRowsTiles(topRow, bottomRow);
 
     int row = topRow;
     int col = leftCol;
@@ -6083,6 +6637,9 @@ void wxGrid::RefreshBlock(int topRow, int leftCol,
 
 void wxGrid::RefreshBlock(const wxGridCellCoords& coords)
 {
+    if ( coords != wxGridNoCellCoords )
+        InvalidateTiles(coords);
+
     if ( !ShouldRefresh() )
         return;
 
@@ -6182,6 +6739,61 @@ void wxGrid::RefreshArea(int areas)
     }
 }
 
+void wxGrid::InvalidateTiles()
+{
+    if ( m_tileCache )
+        m_tileCache->Invalidate();
+}
+
+void wxGrid::InvalidateTiles(const wxGridCellCoords& coords)
+{
+    if ( !m_tileCache )
+        return;
+
+    // Use the rectangle of the entire cell if it spans several rows.
+    const wxRect rect = CellToRect(coords);
+    if ( rect.height > 0 )
+        m_tileCache->InvalidateBand(rect.GetTop(), rect.GetBottom());
+}
+
+void wxGrid::InvalidateRowsTiles(int topRow, int bottomRow)
+{
+    if ( !m_tileCache )
+        return;
+
+    int top = GetRowTop(topRow),
+        bottom = GetRowBottom(bottomRow);
+
+    // The rows between the given ones are not necessarily shown between
+    // them if the rows were reordered.
+    if ( !m_rowAt.empty() )
+    {
+        for ( int row = topRow; row <= bottomRow; row++ )
+        {
+            top = wxMin(top, GetRowTop(row));
+            bottom = wxMax(bottom, GetRowBottom(row));
+        }
+    }
+
+    m_tileCache->InvalidateBand(top, bottom - 1);
+}
+
+void wxGrid::InvalidateTiles(const wxRect& rect, const wxGridWindow *gridWindow)
+{
+    if ( !m_tileCache )
+        return;
+
+    const wxPoint offset = GetGridWindowOffset(gridWindow);
+
+    int top, bottom;
+    CalcGridWindowUnscrolledPosition(0, rect.GetTop() + offset.y,
+                                     nullptr, &top, gridWindow);
+    CalcGridWindowUnscrolledPosition(0, rect.GetBottom() + offset.y,
+                                     nullptr, &bottom, gridWindow);
+
+    m_tileCache->InvalidateBand(top, bottom);
+}
+
 void wxGrid::OnSize(wxSizeEvent& event)
 {
     if (m_targetWindow != this) // check whether initialisation has been done
@@ -6695,6 +7307,76 @@ bool wxGrid::SetCurrentCell( const wxGridCellCoords& coords )
     return true;
 }
 
+namespace
+{
+
+struct wxGridCellCoordsHash
+{
+    size_t operator()(const wxGridCellCoords& coords) const
+    {
+        return std::hash<wxUint64>()((wxUint64(wxUint32(coords.GetRow())) << 32)
+                                        | wxUint32(coords.GetCol()));
+    }
+};
+
+using wxGridCellCoordsSet = std::unordered_set<wxGridCellCoords,
+                                               wxGridCellCoordsHash>;
+
+// Cells to redraw in addition to the exposed ones in DrawGridCellArea().
+class wxGridRedrawCells
+{
+public:
+    explicit wxGridRedrawCells(const wxGridCellCoordsVector& cells)
+        : m_exposed(cells.begin(), cells.end())
+    {
+    }
+
+    // Add the cell unless it's already going to be drawn.
+    void Add(const wxGridCellCoords& cell)
+    {
+        if ( m_exposed.count(cell) || !m_added.insert(cell).second )
+            return;
+
+        m_cells.push_back(cell);
+
+        const auto it = m_minCols.find(cell.GetRow());
+        if ( it == m_minCols.end() )
+            m_minCols[cell.GetRow()] = cell.GetCol();
+        else if ( cell.GetCol() < it->second )
+            it->second = cell.GetCol();
+    }
+
+    // Return the leftmost column of the cells to redraw in the given row if
+    // it's less than the given one or 0 otherwise.
+    int GetLeftLimit(int row, int col) const
+    {
+        const auto it = m_minCols.find(row);
+        return it != m_minCols.end() && it->second < col ? it->second : 0;
+    }
+
+    const wxGridCellCoordsVector& GetCells() const { return m_cells; }
+
+private:
+    const wxGridCellCoordsSet m_exposed;
+    wxGridCellCoordsSet m_added;
+    wxGridCellCoordsVector m_cells;
+
+    // Minimal column of the cells in m_cells for each row.
+    std::unordered_map<int, int> m_minCols;
+};
+
+// Result of searching for a non-empty cell to the left of an empty one in
+// DrawGridCellArea(): all columns in [from, to) range were checked and, if
+// found is true, "from" is the first non-empty cell found.
+struct wxGridOverflowSearch
+{
+    int from;
+    int to;
+    bool found;
+};
+
+} // anonymous namespace
+
 // Note - this function only draws cells that are in the list of
 // exposed cells (usually set from the update region by
 // CalcExposedCells)
@@ -6705,7 +7387,12 @@ void wxGrid::DrawGridCellArea( wxDC& dc, const wxGridCellCoordsVector& cells )
         return;
 
     int i, numCells = cells.size();
-    wxGridCellCoordsVector redrawCells;
+    wxGridRedrawCells redrawCells(cells);
+
+    // Searches for the cells overflowing into the empty ones already done in
+    // each row: as many empty cells in the same row typically find the same
+    // non-empty cell, remembering them avoids doing the same search again.
+    std::unordered_map<int, wxGridOverflowSearch> overflowSearches;
 
     for ( i = numCells - 1; i >= 0; i-- )
     {
@@ -6716,32 +7403,7 @@ void wxGrid::DrawGridCellArea( wxDC& dc, const wxGridCellCoordsVector& cells )
         // If this cell is part of a multicell block, find owner for repaint
         if ( GetCellSize( row, col, &cell_rows, &cell_cols ) == CellSpan_Inside )
         {
-            wxGridCellCoords cell( row + cell_rows, col + cell_cols );
-            bool marked = false;
-            for ( int j = 0; j < numCells; j++ )
-            {
-                if ( cell == cells[j] )
-                {
-                    marked = true;
-                    break;
-                }
-            }
-
-            if (!marked)
-            {
-                int count = redrawCells.size();
-                for (int j = 0; j < count; j++)
-                {
-                    if ( cell == redrawCells[j] )
-                    {
-                        marked = true;
-                        break;
-                    }
-                }
-
-                if (!marked)
-                    redrawCells.push_back( cell );
-            }
+            redrawCells.Add(wxGridCellCoords(row + cell_rows, col + cell_cols));
 
             // don't bother drawing this cell
             continue;
@@ -6752,59 +7414,62 @@ void wxGrid::DrawGridCellArea( wxDC& dc, const wxGridCellCoordsVector& cells )
         {
             for ( int l = 0; l < cell_rows; l++ )
             {
+                const int r = row + l;
+
                 // find a cell in this row to leave already marked for repaint
-                int left = col;
-                for ( const auto& cell: redrawCells )
+                const int left = redrawCells.GetLeftLimit(r, col);
+
+                int j = col - 1;
+
+                auto it = overflowSearches.find(r);
+                if ( it != overflowSearches.end() )
                 {
-                    if ((cell.GetCol() < left) && (cell.GetRow() == row))
+                    wxGridOverflowSearch& search = it->second;
+                    if ( search.from < col && col <= search.to )
+                    {
+                        // All cells between the non-empty one found by the
+                        // previous search and this one are empty, so we'd
+                        // find the same cell, which was already handled.
+                        if ( search.found )
+                            continue;
+
+                        // Otherwise continue the search where it stopped.
+                        j = search.from - 1;
+                    }
+                    else
                     {
-                        left = cell.GetCol();
+                        search = {col, col, false};
                     }
                 }
+                else
+                {
+                    it = overflowSearches.insert({r, {col, col, false}}).first;
+                }
 
-                if (left == col)
-                    left = 0; // oh well
+                wxGridOverflowSearch& search = it->second;
+                search.found = false;
 
-                for (int j = col - 1; j >= left; j--)
+                for ( ; j >= left; j-- )
                 {
-                    if (!m_table->IsEmptyCell(row + l, j))
+                    search.from = j;
+
+                    if (!m_table->IsEmptyCell(r, j))
                     {
-                        wxGridCellAttrPtr attr = GetCellAttrPtr(row + l, j);
+                        search.found = true;
+
+                        wxGridCellAttrPtr attr = GetCellAttrPtr(r, j);
                         int numRows, numCols;
                         attr->GetSize(&numRows, &numCols);
                         if ( GetCellSpan(numRows, numCols)
                                  == wxGrid::CellSpan_Inside )
+                        {
                             // As above: don't bother drawing inside cells.
+                            search.found = false;
                             continue;
+                        }
 
                         if ( attr->CanOverflow() )
-                        {
-                            wxGridCellCoords cellOver(row + l, j);
-                            bool marked = false;
-
-                            for ( const auto& cell: cells )
-                            {
-                                if ( cellOver == cell )
-                                {
-                                    marked = true;
-                                    break;
-                                }
-                            }
-
-                            if (!marked)
-                            {
-                                for ( const auto& cell: redrawCells )
-                                {
-                                    if ( cellOver == cell )
-                                    {
-                                        marked = true;
-                                        break;
-                                    }
-                                }
-                                if (!marked)
-                                    redrawCells.push_back( cellOver );
-                            }
-                        }
+                            redrawCells.Add(wxGridCellCoords(r, j));
                         break;
                     }
                 }
@@ -6814,11 +7479,214 @@ void wxGrid::DrawGridCellArea( wxDC& dc, const wxGridCellCoordsVector& cells )
         DrawCell( dc, cells[i] );
     }
 
-    numCells = redrawCells.size();
+    const wxGridCellCoordsVector& extraCells = redrawCells.GetCells();
+    numCells = extraCells.size();
 
     for ( i = numCells - 1; i >= 0; i-- )
     {
-        DrawCell( dc, redrawCells[i] );
+        DrawCell( dc, extraCells[i] );
+    }
+}
+
+void wxGrid::DrawCachedGridCellArea( wxDC& dc, const wxGridCellCoordsVector& cells )
+{
+    // The bitmaps would be mirrored when drawing them in RTL layout, so just
+    // don't use them in this case.
+    if ( m_tileCache && dc.GetLayoutDirection() != wxLayout_RightToLeft )
+        m_tileCache->Draw(dc, cells);
+    else
+        DrawGridCellArea(dc, cells);
+}
+
+// ----------------------------------------------------------------------------
+// wxGridTileCache
+// ----------------------------------------------------------------------------
+
+std::vector<int> wxGridTileCache::GetLayout(wxUint64 key, wxRect& rect) const
+{
+    const int rowFirst = static_cast<int>(key >> 32) * TILE_ROWS;
+    const int colFirst = static_cast<int>(key & 0xffffffff) * TILE_COLS;
+    const int rowEnd = wxMin(rowFirst + TILE_ROWS, m_grid->GetNumberRows());
+    const int colEnd = wxMin(colFirst + TILE_COLS, m_grid->GetNumberCols());
+
+    std::vector<int> layout;
+    if ( rowFirst >= rowEnd || colFirst >= colEnd )
+    {
+        rect = wxRect();
+        return layout;
+    }
+
+    layout.reserve(2*(rowEnd - rowFirst + colEnd - colFirst + 1));
+
+    const int top = m_grid->GetRowTop(m_grid->GetRowAt(rowFirst));
+    const int left = m_grid->GetColLeft(m_grid->GetColAt(colFirst));
+    layout.push_back(top);
+    layout.push_back(left);
+
+    int bottom = top;
+    for ( int pos = rowFirst; pos < rowEnd; pos++ )
+    {
+        const int row = m_grid->GetRowAt(pos);
+        bottom = m_grid->GetRowBottom(row);
+
+        layout.push_back(row);
+        layout.push_back(bottom);
+    }
+
+    int right = left;
+    for ( int pos = colFirst; pos < colEnd; pos++ )
+    {
+        const int col = m_grid->GetColAt(pos);
+        right = m_grid->GetColRight(col);
+
+        layout.push_back(col);
+        layout.push_back(right);
+    }
+
+    rect = wxRect(left, top, right - left, bottom - top);
+
+    return layout;
+}
+
+void wxGridTileCache::DrawTile(Tile& tile, wxUint64 key, double scale) const
+{
+    const int rowFirst = static_cast<int>(key >> 32) * TILE_ROWS;
+    const int colFirst = static_cast<int>(key & 0xffffffff) * TILE_COLS;
+    const int rowEnd = wxMin(rowFirst + TILE_ROWS, m_grid->GetNumberRows());
+    const int colEnd = wxMin(colFirst + TILE_COLS, m_grid->GetNumberCols());
+
+    wxGridCellCoordsVector cells;
+    cells.reserve((rowEnd - rowFirst)*(colEnd - colFirst));
+    for ( int rowPos = rowFirst; rowPos < rowEnd; rowPos++ )
+    {
+        const int row = m_grid->GetRowAt(rowPos);
+        for ( int colPos = colFirst; colPos < colEnd; colPos++ )
+            cells.push_back(wxGridCellCoords(row, m_grid->GetColAt(colPos)));
+    }
+
+    tile.bitmap.CreateWithLogicalSize(tile.rect.GetSize(), scale);
+
+    wxMemoryDC dc(tile.bitmap);
+    dc.SetLogicalOrigin(tile.rect.x, tile.rect.y);
+    dc.SetBackground(m_grid->GetDefaultCellBackgroundColour());
+    dc.Clear();
+
+    // The cells overflowing into this tile or spanning it may extend beyond
+    // it, but only the part inside the tile must be drawn.
+    wxDCClipper clip(dc, tile.rect);
+
+    m_grid->DrawGridCellArea(dc, cells);
+}
+
+void wxGridTileCache::Draw(wxDC& dc, const wxGridCellCoordsVector& cells)
+{
+    m_drawCount++;
+
+    std::vector<wxUint64> keys;
+    keys.reserve(cells.size());
+    for ( const auto& cell : cells )
+    {
+        keys.push_back(MakeKey(m_grid->GetRowPos(cell.GetRow()) / TILE_ROWS,
+                               m_grid->GetColPos(cell.GetCol()) / TILE_COLS));
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    const double scale = dc.GetContentScaleFactor();
+
+    for ( const auto key : keys )
+    {
+        wxRect rect;
+        std::vector<int> layout = GetLayout(key, rect);
+
+        // All rows or columns of the tile may be hidden.
+        if ( rect.IsEmpty() )
+            continue;
+
+        auto it = m_tiles.find(key);
+        if ( it == m_tiles.end() ||
+                it->second.bitmap.GetScaleFactor() != scale ||
+                    it->second.layout != layout )
+        {
+            // Don't keep any references into m_tiles while drawing the cells,
+            // they could be invalidated if the grid is changed during it.
+            Tile tile;
+            tile.layout = std::move(layout);
+            tile.rect = rect;
+
+            DrawTile(tile, key, scale);
+
+            m_tiles[key] = std::move(tile);
+            it = m_tiles.find(key);
+        }
+
+        Tile& tile = it->second;
+        tile.lastDrawn = m_drawCount;
+
+        dc.DrawBitmap(tile.bitmap, tile.rect.GetPosition());
+    }
+
+    Shrink();
+}
+
+void wxGridTileCache::InvalidateBand(int top, int bottom)
+{
+    for ( auto it = m_tiles.begin(); it != m_tiles.end(); )
+    {
+        const Tile& tile = it->second;
+
+        // Forget the tiles which would have to be drawn again anyhow because
+        // their layout changed too: otherwise they could be used again if this
+        // change were undone, even though their cells could have changed.
+        wxRect rect;
+        if ( (tile.rect.GetTop() <= bottom && top <= tile.rect.GetBottom()) ||
+                GetLayout(it->first, rect) != tile.layout )
+        {
+            it = m_tiles.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void wxGridTileCache::Shrink()
+{
+    const wxSize size = m_grid->GetClientSize();
+    const wxUint64 maxArea = wxUint64(MAX_WINDOW_AREAS)
+                                * wxMax(size.x, 0) * wxMax(size.y, 0);
+
+    wxUint64 area = 0;
+    std::vector<Tiles::iterator> unused;
+    for ( auto it = m_tiles.begin(); it != m_tiles.end(); ++it )
+    {
+        const wxRect& rect = it->second.rect;
+        area += wxUint64(rect.width) * rect.height;
+
+        if ( it->second.lastDrawn != m_drawCount )
+            unused.push_back(it);
+    }
+
+    if ( area <= maxArea )
+        return;
+
+    std::sort(unused.begin(), unused.end(),
+              [](const Tiles::iterator& it1, const Tiles::iterator& it2)
+              {
+                  return it1->second.lastDrawn < it2->second.lastDrawn;
+              });
+
+    for ( const auto& it : unused )
+    {
+        if ( area <= maxArea )
+            break;
+
+        const wxRect& rect = it->second.rect;
+        area -= wxUint64(rect.width) * rect.height;
+
+        m_tiles.erase(it);
     }
 }
 
@@ -7883,6 +8751,17 @@ void wxGrid::ForceRefresh()
     EndBatch();
 }
 
+void wxGrid::EnableTileCache(bool enable)
+{
+    if ( enable == IsTileCacheEnabled() )
+        return;
+
+    if ( enable )
+        m_tileCache = new wxGridTileCache(this);
+    else
+        wxDELETE(m_tileCache);
+}
+
 void wxGrid::DoEnable(bool enable)
 {
     wxScrolledCanvas::DoEnable(enable);
@@ -8172,6 +9051,9 @@ bool wxGrid::DoShowCellEditControl(const wxGridActivationSource& actSource)
         editor->GetWindow()->Move(rect.x, rect.y);
     }
 
+    // The editor draws the background of the cell while it's shown.
+    InvalidateTiles(m_currentCellCoords);
+
     editor->Show( true, attr.get() );
 
     // recalc dimensions in case we need to
@@ -9722,6 +10604,7 @@ int wxGrid::GetColSize( int col ) const
 void wxGrid::SetDefaultCellBackgroundColour( const wxColour& col )
 {
     m_defaultCellAttr->SetBackgroundColour(col);
+    InvalidateTiles();
 #if defined(__WXGTK__) || defined(__WXQT__)
     m_gridWin->SetBackgroundColour(col);
 #endif
@@ -9730,21 +10613,25 @@ void wxGrid::SetDefaultCellBackgroundColour( const wxColour& col )
 void wxGrid::SetDefaultCellTextColour( const wxColour& col )
 {
     m_defaultCellAttr->SetTextColour(col);
+    InvalidateTiles();
 }
 
 void wxGrid::SetDefaultCellAlignment( int horiz, int vert )
 {
     m_defaultCellAttr->SetAlignment(horiz, vert);
+    InvalidateTiles();
 }
 
 void wxGrid::SetDefaultCellFitMode(wxGridFitMode fitMode)
 {
     m_defaultCellAttr->SetFitMode(fitMode);
+    InvalidateTiles();
 }
 
 void wxGrid::SetDefaultCellFont( const wxFont& font )
 {
     m_defaultCellAttr->SetFont(font);
+    InvalidateTiles();
 }
 
 // For editors and renderers the type registry takes precedence over the
@@ -10011,6 +10898,32 @@ wxGridCellAttr *wxGrid::GetOrCreateCellAttr(int row, int col) const
         attr->IncRef();
         m_table->SetAttr(attr, row, col);
     }
+    else
+    {
+        // The attribute set for a block of cells is shared by all of them, so
+        // make a copy of it for this cell only, as the caller is going to
+        // modify it.
+        const wxGridCellAttrProvider* const
+            provider = m_table->GetAttrProvider();
+        if ( provider && provider->UsesAttrRange(row, col) )
+        {
+            wxGridCellAttr* const attrCell = attr->Clone();
+            attr->DecRef();
+
+            attr = attrCell;
+            attr->SetDefAttr(m_defaultCellAttr);
+            attr->SetKind(wxGridCellAttr::Cell);
+
+            attr->IncRef();
+            m_table->SetAttr(attr, row, col);
+
+            // The shared attribute may have been cached for this cell.
+            const_cast<wxGrid*>(this)->RefreshAttr(row, col);
+        }
+    }
+
+    // The caller is going to modify the attribute, so the cell will change.
+    const_cast<wxGrid*>(this)->InvalidateTiles(wxGridCellCoords(row, col));
 
     return attr;
 }
@@ -10074,6 +10987,23 @@ void wxGrid::SetAttr(int row, int col, wxGridCellAttr *attr)
     {
         m_table->SetAttr(attr, row, col);
         ClearAttrCache();
+        InvalidateTiles(wxGridCellCoords(row, col));
+    }
+    else
+    {
+        wxSafeDecRef(attr);
+    }
+}
+
+void wxGrid::SetAttrRange(const wxGridBlockCoords& block, wxGridCellAttr *attr)
+{
+    if ( CanHaveAttributes() )
+    {
+        const wxGridBlockCoords canonical = block.Canonicalize();
+
+        m_table->SetAttrRange(attr, canonical);
+        ClearAttrCache();
+        InvalidateRowsTiles(canonical.GetTopRow(), canonical.GetBottomRow());
     }
     else
     {
@@ -10087,6 +11017,7 @@ void wxGrid::SetRowAttr(int row, wxGridCellAttr *attr)
     {
         m_table->SetRowAttr(attr, row);
         ClearAttrCache();
+        InvalidateRowsTiles(row, row);
     }
     else
     {
@@ -10100,6 +11031,7 @@ void wxGrid::SetColAttr(int col, wxGridCellAttr *attr)
     {
         m_table->SetColAttr(attr, col);
         ClearAttrCache();
+        InvalidateTiles();
     }
     else
     {
@@ -10234,6 +11166,7 @@ void wxGrid::RegisterDataType(const wxString& typeName,
                               wxGridCellEditor* editor)
 {
     m_typeRegistry->RegisterDataType(typeName, renderer, editor);
+    InvalidateTiles();
 }
 
 
@@ -11145,6 +12078,7 @@ void wxGrid::SetCellValue( int row, int col, const wxString& s )
     if ( m_table )
     {
         m_table->SetValue( row, col, s );
+        InvalidateTiles(wxGridCellCoords(row, col));
         if ( ShouldRefresh() )
         {
             wxRect rect( CellToRect( row, col ) );
@@ -28,284 +28,205 @@
 // ============================================================================
 
 // ----------------------------------------------------------------------------
-// RowRanges
+// HeightCache
 // ----------------------------------------------------------------------------
 
-void RowRanges::Add(unsigned int row)
+namespace
 {
-    size_t count = m_ranges.size();
-    size_t rngIdx = 0;
-    for (rngIdx = 0; rngIdx < count; ++rngIdx)
-    {
-        RowRange &rng = m_ranges[rngIdx];
-
-        if (row >= rng.from && rng.to > row)
-        {
-            // index already in range
-            return;
-        }
-
-        if (row == rng.from - 1)
-        {
-            // extend range at the beginning (to the left)
-            rng.from = row;
-            // no cleanup necessary
-            return;
-        }
-        if (row == rng.to)
-        {
-            // extend range at the end (set to row+1 because 'to' is not
-            // including)
-            rng.to = row + 1;
-            CleanUp(rngIdx);
-            return;
-        }
 
-        if (rng.from > row + 1)
-        {
-            // this range is already behind row index, so break here and insert
-            // a new range before
-            break;
-        }
-    }
+// Maximal number of rows with unknown heights added to the vector to store the
+// height of a row after its end: the rows further away are kept in the map.
+const unsigned int MAX_ROWS_GAP = 1024;
 
-    RowRange newRange;
-    newRange.from = row;
-    newRange.to = row + 1;
-    m_ranges.insert(m_ranges.begin() + rngIdx, newRange);
-}
-
-void RowRanges::Remove(unsigned int row)
+// Return the value of the least significant bit set in the given index.
+inline unsigned int LowestBit(unsigned int i)
 {
-    size_t count = m_ranges.size();
-    size_t rngIdx = 0;
-    while (rngIdx < count)
-    {
-        RowRange &rng = m_ranges[rngIdx];
-        if (rng.from >= row)
-        {
-            // this range starts behind row index, so remove it
-            m_ranges.erase(m_ranges.begin() + rngIdx);
-            count--;
-            continue;
-        }
-        if (rng.to > row)
-        {
-            // this ranges includes row, so cut off at row index to exclude row
-            rng.to = row;
-        }
-
-        rngIdx += 1;
-    }
+    return i & (~i + 1);
 }
 
+} // anonymous namespace
 
-void RowRanges::CleanUp(unsigned int idx)
+int HeightCache::GetSumOfFirst(unsigned int count) const
 {
-    size_t count = m_ranges.size();
-
-    wxCHECK_RET( idx < count, "Wrong index" );
+    int sum = 0;
+    for ( unsigned int i = count; i > 0; i -= LowestBit(i) )
+        sum += m_tree[i];
 
-    size_t rngIdx = 0;
-    if (idx > 0)
-    {
-        // start one RowRange before
-        rngIdx = idx - 1;
-    }
-
-    RowRange *prevRng = &m_ranges[rngIdx];
-    rngIdx++;
-    while (rngIdx <= idx + 1 && rngIdx < count)
-    {
-        RowRange &rng = m_ranges[rngIdx];
-
-        if (prevRng->to == rng.from)
-        {
-            // this range starts where the previous range began, so remove this
-            // and set the to-value of the previous range to the to-value of
-            // this range
-            prevRng->to = rng.to;
-            m_ranges.erase(m_ranges.begin() + rngIdx);
-            count--;
-            continue;
-        }
-
-        prevRng = &rng;
-        rngIdx += 1;
-    }
+    return sum;
 }
 
-bool RowRanges::Has(unsigned int row) const
+void HeightCache::Append(int height)
 {
-    size_t count = m_ranges.size();
-    for (size_t rngIdx = 0; rngIdx < count; rngIdx++)
-    {
-        const RowRange &rng = m_ranges[rngIdx];
-        if (rng.from <= row && row < rng.to)
-        {
-            return true;
-        }
-    }
-    return false;
+    m_heights.push_back(height);
+
+    // The new element covers the rows in [n - LowestBit(n), n) range, with
+    // the last of them being the new one.
+    const unsigned int n = m_heights.size();
+    m_tree.push_back((height < 0 ? 0 : height) +
+                        GetSumOfFirst(n - 1) - GetSumOfFirst(n - LowestBit(n)));
 }
 
-unsigned int RowRanges::CountAll() const
+void HeightCache::AppendFarRows()
 {
-    unsigned int ctr = 0;
-    size_t count = m_ranges.size();
-    for (size_t rngIdx = 0; rngIdx < count; rngIdx++)
+    std::map<unsigned int, int>::iterator it;
+    while ( (it = m_farHeights.begin()) != m_farHeights.end() &&
+                it->first == m_heights.size() )
     {
-        const RowRange &rng = m_ranges[rngIdx];
-        ctr += rng.to - rng.from;
+        Append(it->second);
+        m_farHeights.erase(it);
     }
-    return ctr;
 }
 
-unsigned int RowRanges::CountTo(unsigned int row) const
+unsigned int HeightCache::GetKnownRows(int& height) const
 {
-    unsigned int ctr = 0;
-    size_t count = m_ranges.size();
-    for (size_t rngIdx = 0; rngIdx < count; rngIdx++)
-    {
-        const RowRange &rng = m_ranges[rngIdx];
-        if (rng.from > row)
-        {
-            break;
-        }
-        else if (rng.to < row)
-        {
-            ctr += rng.to - rng.from;
-        }
-        else
-        {
-            ctr += row - rng.from;
-            break;
-        }
-    }
-    return ctr;
+    height = GetSumOfFirst(m_knownRows);
+    return m_knownRows;
 }
 
-// ----------------------------------------------------------------------------
-// HeightCache
-// ----------------------------------------------------------------------------
-
 bool HeightCache::GetLineInfo(unsigned int row, int &start, int &height)
 {
-    int y = 0;
-    bool found = false;
+    if ( row >= m_knownRows )
+        return false;
 
-    for ( const auto& kv : m_heightToRowRange )
-    {
-        int rowHeight = kv.first;
-        const RowRanges& rowRanges = kv.second;
-        if (rowRanges.Has(row))
-        {
-            height = rowHeight;
-            found = true;
-        }
-        y += rowHeight * (rowRanges.CountTo(row));
-    }
-    if (found)
-    {
-        start = y;
-    }
-    return found;
+    start = GetSumOfFirst(row);
+    height = m_heights[row];
+    return true;
 }
 
 bool HeightCache::GetLineStart(unsigned int row, int &start)
 {
-    int height = 0;
-    return GetLineInfo(row, start, height);
+    // We don't need to know the height of this row itself.
+    if ( row > m_knownRows )
+        return false;
+
+    start = GetSumOfFirst(row);
+    return true;
 }
 
 bool HeightCache::GetLineHeight(unsigned int row, int &height)
 {
-    for ( const auto& kv : m_heightToRowRange )
+    if ( row >= m_heights.size() )
     {
-        int rowHeight = kv.first;
-        const RowRanges& rowRanges = kv.second;
-        if (rowRanges.Has(row))
-        {
-            height = rowHeight;
-            return true;
-        }
+        const std::map<unsigned int, int>::const_iterator
+            it = m_farHeights.find(row);
+        if ( it == m_farHeights.end() )
+            return false;
+
+        height = it->second;
+        return true;
     }
-    return false;
+
+    if ( m_heights[row] < 0 )
+        return false;
+
+    height = m_heights[row];
+    return true;
 }
 
 bool HeightCache::GetLineAt(int y, unsigned int &row)
 {
-    unsigned int total = 0;
+    if ( y < 0 || !m_knownRows )
+        return false;
 
-    for ( const auto& kv : m_heightToRowRange )
+    // Find the number of the rows whose total height doesn't exceed y: the
+    // row containing y is the next one.
+    const unsigned int count = m_heights.size();
+    unsigned int step = 1;
+    while ( step <= count / 2 )
+        step *= 2;
+
+    unsigned int pos = 0;
+    int remaining = y;
+    for ( ; step; step /= 2 )
     {
-        const RowRanges& rowRanges = kv.second;
-        total += rowRanges.CountAll();
+        if ( pos + step <= count && m_tree[pos + step] <= remaining )
+        {
+            pos += step;
+            remaining -= m_tree[pos];
+        }
     }
 
-    if (total == 0)
+    if ( pos >= m_knownRows )
     {
+        // given y point is after the last known row
         return false;
     }
 
-    int lo = 0;
-    int hi = total;
-    int start, height;
-    while (lo < hi)
+    row = pos;
+    return true;
+}
+
+void HeightCache::Put(unsigned int row, int height)
+{
+    wxCHECK_RET( height >= 0, "invalid row height" );
+
+    if ( row >= m_heights.size() )
     {
-        int mid = (lo + hi) / 2;
-        if (GetLineInfo(mid, start, height))
+        m_farHeights[row] = height;
+        if ( row - m_heights.size() > MAX_ROWS_GAP )
+            return;
+
+        // Add all the rows up to this one to the vector, taking the heights
+        // of the rows already stored in the map, if any, from it.
+        while ( m_heights.size() <= row )
         {
-            if (start + height <= y)
+            const std::map<unsigned int, int>::iterator
+                it = m_farHeights.begin();
+            if ( it->first == m_heights.size() )
             {
-                lo = mid + 1;
+                Append(it->second);
+                m_farHeights.erase(it);
             }
             else
             {
-                hi = mid;
+                Append(-1);
             }
         }
-        else
-        {
-            // should never happen, except the HeightCache has gaps which is an
-            // invalid state
-            return false;
-        }
-    }
-    if (GetLineInfo(lo, start, height))
-    {
-        if (y < start)
-        {
-            // given y point is before the first row
-            return false;
-        }
-        row = lo;
-        return true;
+
+        AppendFarRows();
     }
     else
     {
-        // given y point is after the last row
-        return false;
+        const int old = m_heights[row];
+        if ( old == height )
+            return;
+
+        const int delta = height - (old < 0 ? 0 : old);
+        for ( unsigned int i = row + 1; i < m_tree.size(); i += LowestBit(i) )
+            m_tree[i] += delta;
+
+        m_heights[row] = height;
     }
-}
 
-void HeightCache::Put(unsigned int row, int height)
-{
-    m_heightToRowRange[height].Add(row);
+    if ( row == m_knownRows )
+    {
+        while ( m_knownRows < m_heights.size() && m_heights[m_knownRows] >= 0 )
+            m_knownRows++;
+    }
 }
 
 void HeightCache::Remove(unsigned int row)
 {
-    for ( auto& kv : m_heightToRowRange )
+    // Notice that truncating the tree doesn't affect any of the remaining
+    // elements as they only depend on the rows preceding them.
+    if ( row < m_heights.size() )
     {
-        RowRanges& rowRanges = kv.second;
-        rowRanges.Remove(row);
+        m_heights.resize(row);
+        m_tree.resize(row + 1);
     }
+
+    m_farHeights.erase(m_farHeights.lower_bound(row), m_farHeights.end());
+
+    if ( m_knownRows > row )
+        m_knownRows = row;
 }
 
 void HeightCache::Clear()
 {
-    m_heightToRowRange.clear();
+    m_heights.clear();
+    m_tree.resize(1);
+    m_farHeights.clear();
+    m_knownRows = 0;
 }
 
 HeightCache::~HeightCache()
@@ -22,6 +22,7 @@
 #include "wx/math.h"
 #include "wx/rawbmp.h"
 
+#include "wx/private/image.h"
 #include "wx/gtk/private/object.h"
 #include "wx/gtk/private.h"
 
@@ -586,7 +587,14 @@ static void CopyImageData(
 
 #if wxUSE_IMAGE
 #ifdef __WXGTK3__
-void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale)
+// Destroy the image owning the data used by a pixbuf.
+static void DestroyPixbufImage(guchar* WXUNUSED(pixels), gpointer data)
+{
+    delete static_cast<wxImage*>(data);
+}
+
+void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale,
+                             bool canShareData)
 {
     wxCHECK_RET(image.IsOk(), "invalid image");
 
@@ -600,21 +608,44 @@ void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale)
     wxBitmapRefData* bmpData = new wxBitmapRefData(w, h, depth);
     bmpData->m_scaleFactor = scale;
     m_refData = bmpData;
-    GdkPixbuf* pixbuf_dst = gdk_pixbuf_new(GDK_COLORSPACE_RGB, depth == 32, 8, w, h);
-    bmpData->m_pixbufNoMask = pixbuf_dst;
-    wxASSERT(bmpData->m_bpp == 32 || !gdk_pixbuf_get_has_alpha(bmpData->m_pixbufNoMask));
     const guchar* src = image.GetData();
-
-    guchar* dst = gdk_pixbuf_get_pixels(pixbuf_dst);
-    const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
-    CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
-
-    if (depth == 32 && alpha)
+    if (canShareData && depth != 32)
     {
-        for (int j = 0; j < h; j++, dst += dstStride)
-            for (int i = 0; i < w; i++)
-                dst[i * 4 + 3] = *alpha++;
+        // Pixbuf without alpha uses exactly the same layout as wxImage, so
+        // just use the image data directly, keeping a reference to the image
+        // for as long as the pixbuf exists.
+        bmpData->m_pixbufNoMask = gdk_pixbuf_new_from_data(
+            image.GetData(), GDK_COLORSPACE_RGB, false, 8, w, h, 3 * w,
+            DestroyPixbufImage, new wxImage(image));
+    }
+    else
+    {
+        GdkPixbuf* pixbuf_dst = gdk_pixbuf_new(GDK_COLORSPACE_RGB, depth == 32, 8, w, h);
+        bmpData->m_pixbufNoMask = pixbuf_dst;
+
+        guchar* dst = gdk_pixbuf_get_pixels(pixbuf_dst);
+        const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
+        if (depth == 32 && alpha)
+        {
+            // Interleave the colour and alpha data in a single pass.
+            const guchar* s = src;
+            for (int j = 0; j < h; j++, dst += dstStride)
+            {
+                guchar* d = dst;
+                for (int i = 0; i < w; i++, d += 4, s += 3)
+                {
+                    d[0] = s[0];
+                    d[1] = s[1];
+                    d[2] = s[2];
+                    d[3] = *alpha++;
+                }
+            }
+        }
+        else
+            CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
     }
+    wxASSERT(bmpData->m_bpp == 32 || !gdk_pixbuf_get_has_alpha(bmpData->m_pixbufNoMask));
+
     if (image.HasMask())
     {
         const guchar r = image.GetMaskRed();
@@ -622,7 +653,7 @@ void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale)
         const guchar b = image.GetMaskBlue();
         cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, w, h);
         const int stride = cairo_image_surface_get_stride(surface);
-        dst = cairo_image_surface_get_data(surface);
+        guchar* dst = cairo_image_surface_get_data(surface);
         memset(dst, 0xff, stride * h);
         for (int j = 0; j < h; j++, dst += stride)
             for (int i = 0; i < w; i++, src += 3)
@@ -738,19 +769,33 @@ bool wxBitmap::CreateFromImageAsPixbuf(const wxImage& image)
     // Copy the data:
     const unsigned char* in = image.GetData();
     unsigned char *out = gdk_pixbuf_get_pixels(pixbuf);
-    unsigned char *alpha = image.GetAlpha();
+    const unsigned char* alpha = image.GetAlpha();
 
     int rowpad = gdk_pixbuf_get_rowstride(pixbuf) - 4 * width;
 
-    for (int y = 0; y < height; y++, out += rowpad)
+    if (alpha)
     {
-        for (int x = 0; x < width; x++, out += 4, in += 3)
+        for (int y = 0; y < height; y++, out += rowpad)
         {
-            out[0] = in[0];
-            out[1] = in[1];
-            out[2] = in[2];
-            if (alpha)
+            for (int x = 0; x < width; x++, out += 4, in += 3)
+            {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
                 out[3] = *alpha++;
+            }
+        }
+    }
+    else
+    {
+        for (int y = 0; y < height; y++, out += rowpad)
+        {
+            for (int x = 0; x < width; x++, out += 4, in += 3)
+            {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+            }
         }
     }
 
@@ -784,6 +829,19 @@ wxBitmap::wxBitmap(const wxImage& image, int depth, double scale)
     InitFromImage(image, depth, scale);
 }
 
+wxBitmap::wxBitmap(wxImage&& image, int depth, double scale)
+{
+#ifdef __WXGTK3__
+    // We can reuse the image data only if nobody else can modify it.
+    const bool canShareData = wxImageHasExclusiveData(image);
+    InitFromImage(image, depth, scale, canShareData);
+    if (canShareData)
+        image.Destroy();
+#else
+    InitFromImage(image, depth, scale);
+#endif
+}
+
 wxBitmap::wxBitmap(const wxImage& image, const wxDC& dc)
 {
     InitFromImage(image, -1, dc.GetContentScaleFactor());
@@ -400,6 +400,7 @@ wxHtmlImageCell::wxHtmlImageCell(const wxHtmlTag& tag,
                       input->GetLocation().Matches(wxT("*.GIF"))) )
                 {
                     m_gifDecoder = new wxGIFDecoder();
+                    m_gifDecoder->SetDecodeOnDemand(true);
                     if ( m_gifDecoder->LoadGIF(*s) == wxGIF_OK )
                     {
                         wxImage img;
@@ -538,7 +538,7 @@ protected:
     void SendEvent(wxFileSystemWatcherEvent& evt)
     {
         wxLogTrace(wxTRACE_FSWATCHER, evt.ToString());
-        m_watcher->GetOwner()->ProcessEvent(evt);
+        m_watcher->SendEvent(evt);
     }
 
     int ReadEventsToBuf(char* buf, int size)
@@ -381,7 +381,7 @@ protected:
 
     void SendEvent(wxFileSystemWatcherEvent& evt)
     {
-        m_watcher->GetOwner()->ProcessEvent(evt);
+        m_watcher->SendEvent(evt);
     }
 
     static int Watcher2NativeFlags(int WXUNUSED(flags))
@@ -48,45 +48,99 @@ wxTimerScheduler *wxTimerScheduler::ms_instance = nullptr;
 
 void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
 {
-    DoAddTimer(wxTimerSchedule(timer, expiration));
+    DoAddTimer(timer, expiration);
 }
 
-void wxTimerScheduler::DoAddTimer(const wxTimerSchedule& s)
+void wxTimerScheduler::PlaceAt(size_t index, const wxTimerSchedule& s)
 {
-    // do an insertion sort to keep the list sorted in expiration order
-    wxTimerList::iterator node;
-    for ( node = m_timers.begin(); node != m_timers.end(); ++node )
+    m_timers[index] = s;
+    s.m_timer->m_heapIndex = index;
+}
+
+void wxTimerScheduler::SiftUp(size_t index)
+{
+    const wxTimerSchedule s = m_timers[index];
+    while ( index > 0 )
     {
-        wxASSERT_MSG( node->m_timer != s.m_timer,
-                      wxT("adding the same timer twice?") );
+        const size_t parent = (index - 1) / 2;
+        if ( !s.IsBefore(m_timers[parent]) )
+            break;
+
+        PlaceAt(index, m_timers[parent]);
+        index = parent;
+    }
+
+    PlaceAt(index, s);
+}
+
+void wxTimerScheduler::SiftDown(size_t index)
+{
+    const size_t count = m_timers.size();
+    const wxTimerSchedule s = m_timers[index];
+    for ( ;; )
+    {
+        size_t child = 2*index + 1;
+        if ( child >= count )
+            break;
+
+        if ( child + 1 < count && m_timers[child + 1].IsBefore(m_timers[child]) )
+            child++;
 
-        if ( node->m_expiration > s.m_expiration )
+        if ( !m_timers[child].IsBefore(s) )
             break;
+
+        PlaceAt(index, m_timers[child]);
+        index = child;
     }
 
-    m_timers.insert(node, s);
+    PlaceAt(index, s);
+}
+
+void wxTimerScheduler::DoAddTimer(wxUnixTimerImpl *timer,
+                                  wxUsecClock_t expiration)
+{
+    wxASSERT_MSG( timer->m_heapIndex >= m_timers.size() ||
+                    m_timers[timer->m_heapIndex].m_timer != timer,
+                  wxT("adding the same timer twice?") );
+
+    m_timers.push_back(wxTimerSchedule(timer, expiration, ++m_lastSeq));
+    SiftUp(m_timers.size() - 1);
 
     wxLogTrace(wxTrace_Timer, wxT("Inserted timer %d expiring at %s"),
-               s.m_timer->GetId(),
-               s.m_expiration.ToString());
+               timer->GetId(),
+               expiration.ToString());
+}
+
+void wxTimerScheduler::DoRemoveTimer(size_t index)
+{
+    const size_t last = m_timers.size() - 1;
+    if ( index != last )
+    {
+        // replace the removed element with the last one and move it to its
+        // correct place, which may be either above or below this one
+        PlaceAt(index, m_timers[last]);
+        m_timers.pop_back();
+
+        if ( index > 0 && m_timers[index].IsBefore(m_timers[(index - 1) / 2]) )
+            SiftUp(index);
+        else
+            SiftDown(index);
+    }
+    else
+    {
+        m_timers.pop_back();
+    }
 }
 
 void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
 {
     wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
 
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
-    {
-        if ( node->m_timer == timer )
-        {
-            m_timers.erase(node);
-            return;
-        }
-    }
+    const size_t index = timer->m_heapIndex;
+    wxCHECK_RET( index < m_timers.size() && m_timers[index].m_timer == timer,
+                 wxT("removing inexistent timer?") );
 
-    wxFAIL_MSG( wxT("removing inexistent timer?") );
+    DoRemoveTimer(index);
 }
 
 bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
@@ -96,7 +150,7 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
     wxCHECK_MSG( remaining, false, wxT("null pointer") );
 
-    *remaining = m_timers.begin()->m_expiration - wxGetUTCTimeUSec();
+    *remaining = m_timers.front().m_expiration - wxGetUTCTimeUSec();
     if ( *remaining < 0 )
     {
         // timer already expired, don't wait at all before notifying it
@@ -115,51 +169,54 @@ bool wxTimerScheduler::NotifyExpired()
 
     typedef wxVector<wxUnixTimerImpl *> TimerImpls;
     TimerImpls toNotify;
-    for ( wxTimerList::iterator next,
-            cur = m_timers.begin(); cur != m_timers.end(); cur = next )
+    while ( !m_timers.empty() )
     {
-        wxTimerSchedule s = *cur;
+        const wxTimerSchedule s = m_timers.front();
         if ( s.m_expiration > now )
         {
-            // as the list is sorted by expiration time, we can skip the rest
+            // as the heap top is the first timer to expire, we're done
             break;
         }
 
-        // remember next as we will delete the node pointed to by cur
-        next = cur;
-        ++next;
-
-        m_timers.erase(cur);
+        DoRemoveTimer(0);
 
         // check whether we need to keep this timer
         wxUnixTimerImpl * const timer = s.m_timer;
         if ( timer->IsOneShot() )
         {
             // the timer needs to be stopped but don't call its Stop() from
-            // here as it would attempt to remove the timer from our list and
+            // here as it would attempt to remove the timer from our heap and
             // we had already done it, so we just need to reset its state
             timer->MarkStopped();
         }
-        else // reschedule the next timer expiration
-        {
-            // always keep the expiration time in the future, i.e. base it on
-            // the current time instead of just offsetting it from the current
-            // expiration time because it could happen that we're late and the
-            // current expiration time is (far) in the past
-            s.m_expiration = now + timer->GetInterval()*1000;
-            DoAddTimer(s);
-        }
 
         // we can't notify the timer from this loop as the timer event handler
         // could modify m_timers (for example, but not only, by stopping this
-        // timer) which would render our iterators invalid, so do it after the
-        // loop end
+        // timer), so do it after the loop end
         toNotify.push_back(timer);
     }
 
     if ( toNotify.empty() )
         return false;
 
+    // reschedule the next expiration of the periodic timers only now, so that
+    // the timers with very short intervals are not notified more than once
+    for ( TimerImpls::const_iterator i = toNotify.begin(),
+                                     end = toNotify.end();
+          i != end;
+          ++i )
+    {
+        wxUnixTimerImpl * const timer = *i;
+        if ( !timer->IsOneShot() )
+        {
+            // always keep the expiration time in the future, i.e. base it on
+            // the current time instead of just offsetting it from the current
+            // expiration time because it could happen that we're late and the
+            // current expiration time is (far) in the past
+            DoAddTimer(timer, now + timer->GetInterval()*1000);
+        }
+    }
+
     for ( TimerImpls::const_iterator i = toNotify.begin(),
                                      end = toNotify.end();
           i != end;
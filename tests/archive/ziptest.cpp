@@ -15,8 +15,10 @@
 #if wxUSE_STREAMS && wxUSE_ZIPSTREAM
 
 #include "archivetest.h"
+#include "wx/mstream.h"
 #include "wx/zipstrm.h"
 
+#include <algorithm>
 #include <memory>
 
 using std::string;
@@ -250,4 +252,118 @@ CppUnit::Test *ziptest::makeTest(
 CPPUNIT_TEST_SUITE_REGISTRATION(ziptest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ziptest, "archive/zip");
 
+TEST_CASE("wxZipIndex", "[archive][zip]")
+{
+    const int NUM_ENTRIES = 100;
+
+    // Check that the offsets are adjusted correctly when there is something
+    // before the zip data, as in self-extracting archives, too.
+    const size_t prefixLen = GENERATE(0, 1000);
+
+    wxMemoryOutputStream memOut;
+    for ( size_t n = 0; n < prefixLen; n++ )
+        memOut.PutC('x');
+
+    {
+        wxZipOutputStream zip(memOut);
+        for ( int n = 0; n < NUM_ENTRIES; n++ )
+        {
+            REQUIRE( zip.PutNextEntry(wxString::Format("dir/file%d.txt", n)) );
+            const std::string text = wxString::Format("This is file %d", n).utf8_string();
+            zip.Write(text.data(), text.size());
+        }
+
+        zip.SetComment("Test comment");
+    }
+
+    wxStreamBuffer* const buf = memOut.GetOutputStreamBuffer();
+    const void* const data = buf->GetBufferStart();
+    const size_t size = buf->GetBufferSize();
+
+    wxZipIndex index;
+    {
+        wxMemoryInputStream memIn(data, size);
+        REQUIRE( index.Load(memIn) );
+    }
+
+    CHECK( index.GetCount() == NUM_ENTRIES );
+    CHECK( index.GetComment() == "Test comment" );
+    CHECK( index.GetEntry(1).GetName(wxPATH_UNIX) == "dir/file1.txt" );
+    CHECK( index.Find("dir/nonexistent.txt", wxPATH_UNIX) == nullptr );
+    CHECK( index.OpenEntry(new wxMemoryInputStream(data, size),
+                           "nonexistent.txt") == nullptr );
+
+    for ( int n = NUM_ENTRIES - 1; n >= 0; n-- )
+    {
+        const wxString name = wxString::Format("dir/file%d.txt", n);
+        INFO("Entry " << name);
+
+        const wxZipEntry* const entry = index.Find(name, wxPATH_UNIX);
+        REQUIRE( entry );
+        CHECK( entry->GetName(wxPATH_UNIX) == name );
+
+        std::unique_ptr<wxZipInputStream>
+            zip(index.OpenEntry(new wxMemoryInputStream(data, size), *entry));
+        REQUIRE( zip );
+
+        char text[64] = { 0 };
+        zip->Read(text, sizeof(text) - 1);
+        CHECK( zip->Eof() );
+        CHECK( wxString::FromUTF8(text) == wxString::Format("This is file %d", n) );
+    }
+}
+
+TEST_CASE("wxZipInputStream::PeekSpan", "[archive][zip]")
+{
+    const std::string text(1000, 'x');
+
+    wxMemoryOutputStream memOut;
+    {
+        wxZipOutputStream zip(memOut);
+        wxZipEntry* const entry = new wxZipEntry("file.txt");
+        entry->SetMethod(wxZIP_METHOD_STORE);
+        REQUIRE( zip.PutNextEntry(entry) );
+        zip.Write(text.data(), text.size());
+    }
+
+    wxStreamBuffer* const buf = memOut.GetOutputStreamBuffer();
+    char* const data = static_cast<char*>(buf->GetBufferStart());
+    const size_t size = buf->GetBufferSize();
+
+    // Read all the entry data directly, without calling Read().
+    const auto readEntry = [data, size]()
+    {
+        wxMemoryInputStream memIn(data, size);
+        wxZipInputStream zip(memIn);
+        std::unique_ptr<wxZipEntry> entry(zip.GetNextEntry());
+        REQUIRE( entry );
+
+        size_t total = 0;
+        for ( ;; )
+        {
+            size_t len;
+            if ( !zip.PeekSpan(&len) )
+                break;
+
+            zip.SkipSpan(len);
+            total += len;
+        }
+
+        CHECK( static_cast<wxFileOffset>(total) == entry->GetSize() );
+
+        return zip.GetLastError();
+    };
+
+    CHECK( readEntry() == wxSTREAM_EOF );
+
+    // Corrupt the data of the entry: this must be detected even if it's
+    // only accessed directly.
+    char* const p = std::search(data, data + size, text.begin(), text.end());
+    REQUIRE( p != data + size );
+    p[text.size() / 2] = 'y';
+
+    wxLogNull noLog;
+    CHECK( readEntry() == wxSTREAM_READ_ERROR );
+}
+
 #endif // wxUSE_STREAMS && wxUSE_ZIPSTREAM
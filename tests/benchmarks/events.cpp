@@ -0,0 +1,164 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Event queuing and processing benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/app.h"
+#include "wx/event.h"
+#include "wx/thread.h"
+
+#include <vector>
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Number of events queued by each thread during a single benchmark run.
+const int NUM_EVENTS_PER_THREAD = 10000;
+
+// Handler simply counting the events it receives.
+class CountingHandler : public wxEvtHandler
+{
+public:
+    CountingHandler()
+    {
+        Bind(wxEVT_THREAD, [this](wxThreadEvent&) { m_count++; });
+    }
+
+    int m_count = 0;
+};
+
+// Thread posting the given number of events to the handler.
+class PostingThread : public wxThread
+{
+public:
+    PostingThread(wxEvtHandler* handler, int count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_count(count)
+    {
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        for ( int n = 0; n < m_count; n++ )
+        {
+            wxThreadEvent* const event = new wxThreadEvent();
+            event->SetInt(n);
+            wxQueueEvent(m_handler, event);
+        }
+
+        return nullptr;
+    }
+
+private:
+    wxEvtHandler* const m_handler;
+    const int m_count;
+};
+
+} // anonymous namespace
+
+// Post events from N (given by the numeric parameter, 4 by default) threads
+// to the same handler while processing them in the main thread.
+BENCHMARK_FUNC(QueueEventFromThreads)
+{
+    const int numThreads = Bench::GetNumericParameter(4);
+    const int numEvents = numThreads*NUM_EVENTS_PER_THREAD;
+
+    CountingHandler handler;
+
+    std::vector<PostingThread*> threads;
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        PostingThread* const thread = new PostingThread(&handler,
+                                                        NUM_EVENTS_PER_THREAD);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    const int numExpected = static_cast<int>(threads.size())*NUM_EVENTS_PER_THREAD;
+    while ( handler.m_count < numExpected )
+        wxTheApp->ProcessPendingEvents();
+
+    for ( auto thread : threads )
+    {
+        thread->Wait();
+        delete thread;
+    }
+
+    return handler.m_count == numEvents;
+}
+
+#endif // wxUSE_THREADS
+
+// Queue events from the main thread only and process them.
+BENCHMARK_FUNC(QueueEventSingleThread)
+{
+    wxEvtHandler handler;
+
+    int count = 0;
+    handler.Bind(wxEVT_THREAD, [&count](wxThreadEvent&) { count++; });
+
+    for ( int n = 0; n < 10000; n++ )
+        wxQueueEvent(&handler, new wxThreadEvent());
+
+    wxTheApp->ProcessPendingEvents();
+
+    return count == 10000;
+}
+
+// Process an event by a handler with many (given by the numeric parameter,
+// 200 by default) dynamically bound handlers for different event types.
+BENCHMARK_FUNC(ProcessEventManyHandlers)
+{
+    static wxEvtHandler s_handler;
+    static int s_count = 0;
+
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+
+        const int numHandlers = Bench::GetNumericParameter(200);
+        for ( int n = 0; n < numHandlers; n++ )
+            s_handler.Bind(wxEventTypeTag<wxEvent>(wxNewEventType()),
+                           [](wxEvent&) { });
+
+        s_handler.Bind(wxEVT_THREAD, [](wxThreadEvent&) { s_count++; });
+    }
+
+    wxThreadEvent event;
+    for ( int n = 0; n < 1000; n++ )
+        s_handler.ProcessEvent(event);
+
+    return s_count != 0;
+}
+
+// Queue many events replacing each other and process them.
+BENCHMARK_FUNC(QueueEventCoalesced)
+{
+    wxEvtHandler handler;
+
+    int count = 0;
+    handler.Bind(wxEVT_THREAD, [&count](wxThreadEvent&) { count++; });
+
+    for ( int n = 0; n < 10000; n++ )
+        handler.QueueEventCoalesced(new wxThreadEvent(), n % 4);
+
+    wxTheApp->ProcessPendingEvents();
+
+    return count == 4;
+}
@@ -0,0 +1,252 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/grid.cpp
+// Purpose:     wxGrid attributes and drawing benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/dcmemory.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+#if wxUSE_GRID
+
+namespace
+{
+
+// Size of the square block of attributed cells: 1000*1000 = 1M cells.
+const int NUM_ATTR_ROWS_COLS = 1000;
+
+// Number of randomly placed ranges used by the benchmarks below.
+const int NUM_SCATTERED_RANGES = 5000;
+
+// Maximal size of each of these ranges.
+const int MAX_SCATTERED_RANGE_SIZE = 50;
+
+// Size of the part of the grid looked up by each benchmark run, which
+// corresponds to the number of cells shown in a typical grid window.
+const int NUM_VISIBLE_ROWS = 50;
+const int NUM_VISIBLE_COLS = 20;
+
+// Look up the attributes of all cells shown when the window is scrolled to
+// the given position, as is done when painting it, and return the number of
+// cells having an attribute.
+int LookupVisibleAttrs(const wxGridCellAttrProvider& provider, int pos)
+{
+    const int top = pos % (NUM_ATTR_ROWS_COLS - NUM_VISIBLE_ROWS);
+    const int left = pos % (NUM_ATTR_ROWS_COLS - NUM_VISIBLE_COLS);
+
+    int numFound = 0;
+    for ( int row = top; row < top + NUM_VISIBLE_ROWS; row++ )
+    {
+        for ( int col = left; col < left + NUM_VISIBLE_COLS; col++ )
+        {
+            wxGridCellAttrPtr
+                attr = provider.GetAttrPtr(row, col, wxGridCellAttr::Any);
+            if ( attr )
+                numFound++;
+        }
+    }
+
+    return numFound;
+}
+
+// Call the given function with many randomly placed, and overlapping, ranges
+// of different sizes and the attributes using a few different colours.
+template <typename F>
+void SetScatteredRanges(F setAttrRange)
+{
+    // Use our own trivial generator to always get the same ranges.
+    unsigned seed = 17;
+    const auto nextRandom = [&seed](int max)
+    {
+        seed = seed*1103515245 + 12345;
+        return static_cast<int>((seed >> 16) % max);
+    };
+
+    const wxColour colours[] = { *wxRED, *wxGREEN, *wxBLUE, *wxYELLOW };
+
+    for ( int n = 0; n < NUM_SCATTERED_RANGES; n++ )
+    {
+        const int top = nextRandom(NUM_ATTR_ROWS_COLS);
+        const int left = nextRandom(NUM_ATTR_ROWS_COLS);
+        const int bottom = wxMin(top + nextRandom(MAX_SCATTERED_RANGE_SIZE),
+                                 NUM_ATTR_ROWS_COLS - 1);
+        const int right = wxMin(left + nextRandom(MAX_SCATTERED_RANGE_SIZE),
+                                NUM_ATTR_ROWS_COLS - 1);
+
+        setAttrRange(wxGridBlockCoords(top, left, bottom, right),
+                     new wxGridCellAttr(*wxBLACK, colours[n % WXSIZEOF(colours)],
+                                        wxNullFont, 0, 0));
+    }
+}
+
+} // anonymous namespace
+
+// Look up attributes of the cells when each of 1M cells has its own
+// attribute, sharing the same few colours.
+BENCHMARK_FUNC(GridAttrLookupCells)
+{
+    static wxGridCellAttrProvider s_provider;
+    static int s_pos = 0;
+
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+
+        wxGridCellAttr* attrs[2];
+        attrs[0] = new wxGridCellAttr(*wxRED, *wxWHITE, wxNullFont, 0, 0);
+        attrs[1] = new wxGridCellAttr(*wxBLUE, *wxWHITE, wxNullFont, 0, 0);
+
+        for ( int row = 0; row < NUM_ATTR_ROWS_COLS; row++ )
+        {
+            for ( int col = 0; col < NUM_ATTR_ROWS_COLS; col++ )
+            {
+                wxGridCellAttr* const attr = attrs[(col / 100) % 2];
+                attr->IncRef();
+                s_provider.SetAttr(attr, row, col);
+            }
+        }
+
+        attrs[0]->DecRef();
+        attrs[1]->DecRef();
+    }
+
+    return LookupVisibleAttrs(s_provider, s_pos++) ==
+                NUM_VISIBLE_ROWS*NUM_VISIBLE_COLS;
+}
+
+// Look up attributes of the cells covered by many scattered ranges.
+BENCHMARK_FUNC(GridAttrLookupRange)
+{
+    static wxGridCellAttrProvider s_provider;
+    static int s_pos = 0;
+
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+
+        SetScatteredRanges([](const wxGridBlockCoords& block,
+                              wxGridCellAttr* attr)
+        {
+            s_provider.SetAttrRange(attr, block);
+        });
+    }
+
+    return LookupVisibleAttrs(s_provider, s_pos++) >= 0;
+}
+
+// Look up attributes of cells in many attributed rows.
+BENCHMARK_FUNC(GridAttrLookupRows)
+{
+    static wxGridCellAttrProvider s_provider;
+    static int s_pos = 0;
+
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+
+        for ( int row = 0; row < NUM_ATTR_ROWS_COLS; row++ )
+        {
+            const wxColour& colour = row % 2 ? *wxLIGHT_GREY : *wxWHITE;
+            s_provider.SetRowAttr
+                       (
+                        new wxGridCellAttr(*wxBLACK, colour, wxNullFont, 0, 0),
+                        row
+                       );
+        }
+    }
+
+    return LookupVisibleAttrs(s_provider, s_pos++) ==
+                NUM_VISIBLE_ROWS*NUM_VISIBLE_COLS;
+}
+
+// Paint all 1M cells of the grid using the attributes of many scattered
+// ranges. Pass a non-zero numeric parameter to paint it without them, for
+// comparison.
+BENCHMARK_FUNC(GridPaintRange)
+{
+    static wxGrid* s_grid = nullptr;
+    if ( !s_grid )
+    {
+        // The grid is destroyed together with its parent window on exit.
+        s_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+        s_grid->CreateGrid(NUM_ATTR_ROWS_COLS, NUM_ATTR_ROWS_COLS);
+
+        if ( !Bench::GetNumericParameter(0) )
+        {
+            SetScatteredRanges([](const wxGridBlockCoords& block,
+                                  wxGridCellAttr* attr)
+            {
+                s_grid->SetAttrRange(block, attr);
+            });
+        }
+    }
+
+    static wxBitmap s_bitmap(NUM_ATTR_ROWS_COLS, NUM_ATTR_ROWS_COLS);
+
+    wxMemoryDC dc(s_bitmap);
+    s_grid->Render(dc, wxPoint(0, 0), s_bitmap.GetSize(),
+                   wxGridCellCoords(0, 0),
+                   wxGridCellCoords(NUM_ATTR_ROWS_COLS - 1,
+                                    NUM_ATTR_ROWS_COLS - 1),
+                   wxGRID_DRAW_CELL_LINES);
+
+    return true;
+}
+
+// Benchmark redrawing the cells shown when scrolling horizontally back and
+// forth over a grid with numbers, using the tile cache unless the numeric
+// parameter is 0.
+BENCHMARK_FUNC(GridPaintScroll)
+{
+    static wxGrid* s_grid = nullptr;
+    if ( !s_grid )
+    {
+        s_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+        s_grid->CreateGrid(NUM_VISIBLE_ROWS, 10*NUM_VISIBLE_COLS);
+
+        for ( int col = 0; col < s_grid->GetNumberCols(); col++ )
+        {
+            s_grid->SetColFormatFloat(col, -1, 2);
+
+            for ( int row = 0; row < NUM_VISIBLE_ROWS; row++ )
+                s_grid->SetCellValue(row, col, wxString::Format("%d.%d", row, col));
+        }
+
+        // Make the grid big enough to show all visible cells at once.
+        const wxRect rect = s_grid->CellToRect(NUM_VISIBLE_ROWS - 1,
+                                               NUM_VISIBLE_COLS - 1);
+        s_grid->SetSize(rect.GetRight() + 1, rect.GetBottom() + 1);
+
+        s_grid->EnableTileCache(Bench::GetNumericParameter(1) != 0);
+    }
+
+    static int s_run = 0;
+    const int left = s_run++ % (2*NUM_VISIBLE_COLS);
+
+    wxGridCellCoordsVector cells;
+    for ( int row = 0; row < NUM_VISIBLE_ROWS; row++ )
+    {
+        for ( int col = left; col < left + NUM_VISIBLE_COLS; col++ )
+            cells.push_back(wxGridCellCoords(row, col));
+    }
+
+    static wxBitmap s_bitmap(s_grid->GetSize());
+
+    // Draw the cells as they would be drawn in the scrolled window.
+    wxMemoryDC dc(s_bitmap);
+    dc.SetLogicalOrigin(s_grid->CellToRect(0, left).GetLeft(), 0);
+    s_grid->DrawCachedGridCellArea(dc, cells);
+
+    return true;
+}
+
+#endif // wxUSE_GRID
@@ -7,7 +7,9 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+#include "wx/bitmap.h"
 #include "wx/image.h"
+#include "wx/quantize.h"
 
 #include "bench.h"
 
@@ -43,6 +45,34 @@ BENCHMARK_FUNC(LoadPNG)
     return image.LoadFile("horse.png");
 }
 
+// Load a thumbnail with the size given by the numeric parameter (50 by
+// default) or just a part of the JPEG image.
+BENCHMARK_FUNC(LoadJPEGThumbnail)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+
+    const int size = Bench::GetNumericParameter(50);
+
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, size);
+    image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, size);
+    return image.LoadFile("horse.jpg");
+}
+
+BENCHMARK_FUNC(LoadJPEGRegion)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_REGION_X, 50);
+    image.SetOption(wxIMAGE_OPTION_REGION_Y, 50);
+    image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, 64);
+    image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, 64);
+    return image.LoadFile("horse.jpg");
+}
+
 #if wxUSE_LIBTIFF
 BENCHMARK_FUNC(LoadTIFF)
 {
@@ -118,3 +148,179 @@ BENCHMARK_FUNC(ShrinkHighQuality)
     return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
                        wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+BENCHMARK_FUNC(ResampleBox)
+{
+    const wxImage& image = GetTestImage();
+    const double factor = Bench::GetNumericParameter(50) / 100.;
+    return image.ResampleBox(factor*image.GetWidth(),
+                             factor*image.GetHeight()).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBilinear)
+{
+    const wxImage& image = GetTestImage();
+    const double factor = Bench::GetNumericParameter(50) / 100.;
+    return image.ResampleBilinear(factor*image.GetWidth(),
+                                  factor*image.GetHeight()).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBicubic)
+{
+    const wxImage& image = GetTestImage();
+    const double factor = Bench::GetNumericParameter(50) / 100.;
+    return image.ResampleBicubic(factor*image.GetWidth(),
+                                 factor*image.GetHeight()).IsOk();
+}
+
+BENCHMARK_FUNC(BlurHorizontal)
+{
+    const wxImage& image = GetTestImage();
+    return image.BlurHorizontal(Bench::GetNumericParameter(5)).IsOk();
+}
+
+BENCHMARK_FUNC(BlurVertical)
+{
+    const wxImage& image = GetTestImage();
+    return image.BlurVertical(Bench::GetNumericParameter(5)).IsOk();
+}
+
+BENCHMARK_FUNC(Blur)
+{
+    const wxImage& image = GetTestImage();
+    return image.Blur(Bench::GetNumericParameter(5)).IsOk();
+}
+
+// Big image used for the benchmarks below.
+static const wxImage& GetBigImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        s_image.Create(3000, 2000, false);
+
+        unsigned char* data = s_image.GetData();
+        for ( int n = 0; n < 3000*2000*3; n++ )
+            data[n] = static_cast<unsigned char>(n*7 + n/9000);
+    }
+
+    return s_image;
+}
+
+// These benchmarks use the number of threads given by the numeric parameter,
+// 1 by default, to allow checking how they scale with the number of threads.
+BENCHMARK_FUNC(ChangeHSVParallel)
+{
+    wxImage::SetParallelism(Bench::GetNumericParameter(1));
+
+    wxImage image = GetBigImage().Copy();
+    image.ChangeHSV(0.5, -0.4, -0.2);
+
+    wxImage::SetParallelism(1);
+
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(RotateParallel)
+{
+    wxImage::SetParallelism(Bench::GetNumericParameter(1));
+
+    const wxImage& image = GetBigImage();
+    const bool ok = image.Rotate(0.3, wxPoint(image.GetWidth() / 2,
+                                              image.GetHeight() / 2)).IsOk();
+
+    wxImage::SetParallelism(1);
+
+    return ok;
+}
+
+// Compare the default quantization using Floyd-Steinberg dithering with the
+// faster one without it, which can also use several threads.
+BENCHMARK_FUNC(QuantizeDither)
+{
+    wxImage::SetParallelism(Bench::GetNumericParameter(1));
+
+    wxImage image;
+    const bool ok = wxQuantize::Quantize(GetBigImage(), image, 236, nullptr,
+                                         wxQUANTIZE_FILL_DESTINATION_IMAGE);
+
+    wxImage::SetParallelism(1);
+
+    return ok;
+}
+
+BENCHMARK_FUNC(QuantizeNoDither)
+{
+    wxImage::SetParallelism(Bench::GetNumericParameter(1));
+
+    wxImage image;
+    const bool ok = wxQuantize::Quantize(GetBigImage(), image, 236, nullptr,
+                                         wxQUANTIZE_FILL_DESTINATION_IMAGE |
+                                         wxQUANTIZE_NO_DITHERING);
+
+    wxImage::SetParallelism(1);
+
+    return ok;
+}
+
+// Compare applying a typical sequence of operations to an image directly and
+// using wxImagePipeline.
+BENCHMARK_FUNC(OperationsSequence)
+{
+    const wxImage& image = GetBigImage();
+    const wxImage result = image.GetSubImage(wxRect(100, 100, 2400, 1800))
+                                .Mirror()
+                                .ConvertToGreyscale()
+                                .Rotate90();
+    return result.IsOk();
+}
+
+BENCHMARK_FUNC(OperationsPipeline)
+{
+    const wxImage& image = GetBigImage();
+    const wxImage result = wxImagePipeline(image)
+                                .GetSubImage(wxRect(100, 100, 2400, 1800))
+                                .Mirror()
+                                .ConvertToGreyscale()
+                                .Rotate90()
+                                .Execute();
+    return result.IsOk();
+}
+
+// Measure the speed of conversions between wxImage and wxBitmap.
+BENCHMARK_FUNC(ImageToBitmap)
+{
+    const wxBitmap bitmap(GetBigImage());
+    return bitmap.IsOk();
+}
+
+BENCHMARK_FUNC(ImageToBitmapAlpha)
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        s_image = GetBigImage().Copy();
+        s_image.InitAlpha();
+    }
+
+    const wxBitmap bitmap(s_image);
+    return bitmap.IsOk();
+}
+
+// Note that this benchmark includes the time needed to copy the image, as the
+// bitmap takes ownership of the image data.
+BENCHMARK_FUNC(ImageToBitmapMove)
+{
+    wxImage image = GetBigImage().Copy();
+    const wxBitmap bitmap(std::move(image));
+    return bitmap.IsOk();
+}
+
+// Subtract the time taken by ImageToBitmap from this one to get the time of
+// the conversion in the other direction: we don't use a static bitmap here to
+// avoid destroying it after the GUI is shut down.
+BENCHMARK_FUNC(ImageToBitmapToImage)
+{
+    const wxBitmap bitmap(GetBigImage());
+    return bitmap.ConvertToImage().IsOk();
+}
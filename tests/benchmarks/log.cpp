@@ -106,3 +106,40 @@ BENCHMARK_FUNC(LogTraceInactive)
 
     return true;
 }
+
+// Log many messages to the given log target and destroy it.
+static bool LogMessagesToFile(wxLog* log)
+{
+    delete log->SetFormatter(new wxLogFormatterNone);
+
+    wxLog* const logOld = wxLog::SetActiveTarget(log);
+
+    for ( int n = 0; n < 10000; n++ )
+        wxLogMessage("Message number %d", n);
+
+    wxLog::SetActiveTarget(logOld);
+    delete log;
+
+    return true;
+}
+
+// Return the file to use for the benchmarks writing the messages to a file.
+static FILE* GetLogFile()
+{
+    static FILE* const s_fp = tmpfile();
+    return s_fp;
+}
+
+BENCHMARK_FUNC(LogMessageFile)
+{
+    return LogMessagesToFile(new wxLogStderr(GetLogFile()));
+}
+
+#if wxUSE_THREADS
+
+BENCHMARK_FUNC(LogMessageAsyncFile)
+{
+    return LogMessagesToFile(new wxLogAsyncFile(GetLogFile()));
+}
+
+#endif // wxUSE_THREADS
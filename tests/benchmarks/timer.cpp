@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/timer.cpp
+// Purpose:     wxTimer benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/timer.h"
+
+#include <memory>
+#include <vector>
+
+#if wxUSE_TIMER
+
+namespace
+{
+
+// Return the given number of (not running) timers.
+std::vector<std::unique_ptr<wxTimer>>& GetTimers(int count)
+{
+    static std::vector<std::unique_ptr<wxTimer>> s_timers;
+    if ( static_cast<int>(s_timers.size()) != count )
+    {
+        s_timers.clear();
+        for ( int n = 0; n < count; n++ )
+            s_timers.emplace_back(new wxTimer());
+    }
+
+    return s_timers;
+}
+
+} // anonymous namespace
+
+// Start N (given by the numeric parameter, 100000 by default) timers with
+// different intervals and then stop all of them, in a different order.
+BENCHMARK_FUNC(TimerStartStop)
+{
+    const int numTimers = Bench::GetNumericParameter(100000);
+    auto& timers = GetTimers(numTimers);
+
+    for ( int n = 0; n < numTimers; n++ )
+        timers[n]->StartOnce(1000000 + (n*7919) % numTimers);
+
+    for ( int n = numTimers - 1; n >= 0; n-- )
+        timers[n]->Stop();
+
+    return true;
+}
+
+// Restart each of N already running timers, as done when using timers for
+// timeouts which are postponed by activity.
+BENCHMARK_FUNC(TimerRestart)
+{
+    const int numTimers = Bench::GetNumericParameter(100000);
+    auto& timers = GetTimers(numTimers);
+
+    for ( int n = 0; n < numTimers; n++ )
+        timers[n]->StartOnce(1000000 + n);
+
+    for ( int n = 0; n < numTimers; n++ )
+        timers[n]->StartOnce(1000000 + numTimers + n);
+
+    for ( auto& timer : timers )
+        timer->Stop();
+
+    return true;
+}
+
+#endif // wxUSE_TIMER
@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/zlib.cpp
+// Purpose:     Compression streams benchmarks
+// Author:      wxWidgets team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/mstream.h"
+#include "wx/zstream.h"
+
+#include <vector>
+
+namespace
+{
+
+// Return 16MiB of moderately compressible data.
+const std::vector<char>& GetData()
+{
+    static std::vector<char> s_data;
+    if ( s_data.empty() )
+    {
+        const size_t size = 16*1024*1024;
+        s_data.reserve(size);
+
+        wxUint32 seed = 1;
+        while ( s_data.size() < size )
+        {
+            seed = seed*1103515245 + 12345;
+            s_data.push_back(static_cast<char>('a' + (seed >> 16) % 16));
+        }
+    }
+
+    return s_data;
+}
+
+} // anonymous namespace
+
+// Compress the data using the number of threads given by the numeric
+// parameter, 1 by default, i.e. without using any worker threads.
+BENCHMARK_FUNC(ZlibCompress)
+{
+    const std::vector<char>& data = GetData();
+
+    wxMemoryOutputStream memOut;
+    wxZlibOutputStream zOut(memOut);
+    if ( !zOut.SetParallelism(Bench::GetNumericParameter(1)) )
+        return false;
+
+    if ( zOut.Write(data.data(), data.size()).LastWrite() != data.size() )
+        return false;
+
+    return zOut.Close();
+}
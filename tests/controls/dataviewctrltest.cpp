@@ -861,6 +861,209 @@ TEST_CASE_METHOD(MultiColumnsDataViewCtrlTestCase,
     CHECK( m_lastColumn->GetWidth() >= lastColumnMinWidth );
 }
 
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+
+namespace
+{
+
+// Renderer using the text of wxDataViewTreeStore items as their height.
+class RowHeightRenderer : public wxDataViewCustomRenderer
+{
+public:
+    RowHeightRenderer()
+        : wxDataViewCustomRenderer("wxDataViewIconText")
+    {
+    }
+
+    virtual bool SetValue(const wxVariant& value) override
+    {
+        wxDataViewIconText iconText;
+        iconText << value;
+        m_text = iconText.GetText();
+        return true;
+    }
+
+    virtual bool GetValue(wxVariant& WXUNUSED(value)) const override
+    {
+        return true;
+    }
+
+    virtual wxSize GetSize() const override
+    {
+        return wxSize(100, wxAtoi(m_text));
+    }
+
+    virtual bool Render(wxRect rect, wxDC* dc, int state) override
+    {
+        RenderText(m_text, 0, rect, dc, state);
+        return true;
+    }
+
+private:
+    wxString m_text;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxDVC::VariableHeightRows", "[wxDataViewCtrl][item]")
+{
+    std::unique_ptr<wxDataViewCtrl> dvc(new wxDataViewCtrl
+                                            (
+                                                wxTheApp->GetTopWindow(),
+                                                wxID_ANY,
+                                                wxDefaultPosition,
+                                                wxSize(400, 400),
+                                                wxDV_VARIABLE_LINE_HEIGHT
+                                            ));
+
+    // The heights are chosen to be bigger than the default line height, so
+    // that they're really used for the rows.
+    wxObjectDataPtr<wxDataViewTreeStore> store(new wxDataViewTreeStore);
+    const wxDataViewItem root = store->AppendContainer(wxDataViewItem(), "40");
+    const wxDataViewItem parent = store->AppendContainer(root, "60");
+    const wxDataViewItem leaf1 = store->AppendItem(parent, "50");
+    const wxDataViewItem leaf2 = store->AppendItem(parent, "70");
+    const wxDataViewItem child = store->AppendItem(root, "45");
+    const wxDataViewItem last = store->AppendItem(root, "55");
+
+    dvc->AssociateModel(store.get());
+    dvc->AppendColumn(new wxDataViewColumn("Height", new RowHeightRenderer, 0));
+
+    dvc->Expand(root);
+    dvc->Expand(parent);
+
+    // Check that the given items are shown one after another with the given
+    // heights and that hit testing finds them inside their rectangles.
+    const auto checkRows = [&dvc](const std::vector<wxDataViewItem>& items,
+                                  const std::vector<int>& heights)
+    {
+        int y = dvc->GetItemRect(items[0]).y;
+        for ( size_t n = 0; n < items.size(); ++n )
+        {
+            INFO("Row " << n);
+
+            const wxRect rect = dvc->GetItemRect(items[n]);
+            CHECK( rect.y == y );
+            CHECK( rect.height == heights[n] );
+
+            wxDataViewItem item;
+            wxDataViewColumn* column = nullptr;
+            dvc->HitTest(wxPoint(rect.x + rect.width / 2,
+                                 rect.y + rect.height / 2),
+                         item, column);
+            CHECK( item == items[n] );
+
+            y += heights[n];
+        }
+    };
+
+    checkRows({root, parent, leaf1, leaf2, child, last},
+              {40, 60, 50, 70, 45, 55});
+
+    const wxRect rectLastExpanded = dvc->GetItemRect(last);
+
+    // Collapsing an item must move the rows after it up.
+    dvc->Collapse(parent);
+    CHECK( dvc->GetItemRect(leaf1) == wxRect() );
+    CHECK( dvc->GetItemRect(leaf2) == wxRect() );
+    checkRows({root, parent, child, last}, {40, 60, 45, 55});
+    CHECK( dvc->GetItemRect(last).y == rectLastExpanded.y - 50 - 70 );
+
+    // And expanding it again must restore their positions.
+    dvc->Expand(parent);
+    checkRows({root, parent, leaf1, leaf2, child, last},
+              {40, 60, 50, 70, 45, 55});
+    CHECK( dvc->GetItemRect(last) == rectLastExpanded );
+
+    // Changing the height of a row must move all the following rows too.
+    store->SetItemText(leaf1, "80");
+    store->ItemChanged(leaf1);
+    checkRows({root, parent, leaf1, leaf2, child, last},
+              {40, 60, 80, 70, 45, 55});
+    CHECK( dvc->GetItemRect(last).y == rectLastExpanded.y + 30 );
+
+    // Collapsing the root hides everything but it.
+    dvc->Collapse(root);
+    CHECK( dvc->GetItemRect(parent) == wxRect() );
+    CHECK( dvc->GetItemRect(last) == wxRect() );
+
+    dvc->Expand(root);
+    checkRows({root, parent, leaf1, leaf2, child, last},
+              {40, 60, 80, 70, 45, 55});
+
+    // Deleting an item must move the rows after it up as well.
+    store->DeleteItem(leaf2);
+    store->ItemDeleted(parent, leaf2);
+    checkRows({root, parent, leaf1, child, last},
+              {40, 60, 80, 45, 55});
+}
+
+TEST_CASE("wxDVC::BestColumnWidth", "[wxDataViewCtrl][column]")
+{
+    std::unique_ptr<wxDataViewListCtrl> dvc(new wxDataViewListCtrl
+                                                (
+                                                    wxTheApp->GetTopWindow(),
+                                                    wxID_ANY,
+                                                    wxDefaultPosition,
+                                                    wxSize(400, 200)
+                                                ));
+
+    wxDataViewColumn* const
+        column = dvc->AppendTextColumn("", wxDATAVIEW_CELL_INERT,
+                                       wxCOL_WIDTH_AUTOSIZE);
+
+    const wxString shortText("x");
+    const wxString longText(wxString('W', 40));
+
+    wxVector<wxVariant> values;
+    values.push_back(shortText);
+    for ( int i = 0; i < 10; ++i )
+        dvc->AppendItem(values);
+
+    const int widthShort = column->GetWidth();
+    CHECK( widthShort > 0 );
+
+    // Making an item wider must make the column wider too.
+    dvc->SetTextValue(longText, 5, 0);
+    const int widthLong = column->GetWidth();
+    CHECK( widthLong > widthShort );
+
+    // Changing another item must not affect it.
+    dvc->SetTextValue("xx", 3, 0);
+    CHECK( column->GetWidth() == widthLong );
+
+    // But making the widest item narrower must shrink the column.
+    dvc->SetTextValue(shortText, 5, 0);
+    dvc->SetTextValue(shortText, 3, 0);
+    CHECK( column->GetWidth() == widthShort );
+
+    // Changing a far away item must be taken into account too.
+    for ( int i = 0; i < 5000; ++i )
+        dvc->AppendItem(values);
+    CHECK( column->GetWidth() == widthShort );
+
+    dvc->SetTextValue(longText, 4321, 0);
+    CHECK( column->GetWidth() == widthLong );
+
+    dvc->SetTextValue(shortText, 4321, 0);
+    CHECK( column->GetWidth() == widthShort );
+
+    // Add many more rows than can be measured at once, with a wide one far
+    // from the visible ones: even if it is skipped when computing the width
+    // from scratch, it must be taken into account after refining the width
+    // in idle time.
+    dvc->DeleteAllItems();
+    for ( int i = 0; i < 5000; ++i )
+        dvc->AppendItem(i == 4321 ? wxVector<wxVariant>(1, longText) : values);
+
+    CHECK( column->GetWidth() <= widthLong );
+    for ( int n = 0; n < 10000 && column->GetWidth() != widthLong; ++n )
+        dvc->OnInternalIdle();
+    CHECK( column->GetWidth() == widthLong );
+}
+
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
+
 #if wxUSE_UIACTIONSIMULATOR
 
 TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
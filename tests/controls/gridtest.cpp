@@ -14,10 +14,12 @@
 #ifndef WX_PRECOMP
     #include "wx/app.h"
     #include "wx/dcclient.h"
+    #include "wx/dcmemory.h"
 #endif // WX_PRECOMP
 
 #include "wx/grid.h"
 #include "wx/headerctrl.h"
+#include "wx/generic/private/grid.h"
 #include "testableframe.h"
 #include "asserthelper.h"
 #include "wx/uiaction.h"
@@ -1862,6 +1864,183 @@ TEST_CASE_METHOD(GridTestCase, "Grid::DrawInvalidCell", "[grid][multicell]")
     wxYield();
 }
 
+namespace
+{
+
+// Renderer remembering the cells it has drawn.
+class RecordingRenderer : public wxGridCellStringRenderer
+{
+public:
+    explicit RecordingRenderer(wxGridCellCoordsVector& drawn)
+        : m_drawn(drawn)
+    {
+    }
+
+    virtual void Draw(wxGrid& grid,
+                      wxGridCellAttr& attr,
+                      wxDC& dc,
+                      const wxRect& rect,
+                      int row, int col,
+                      bool isSelected) override
+    {
+        m_drawn.push_back(wxGridCellCoords(row, col));
+
+        wxGridCellStringRenderer::Draw(grid, attr, dc, rect, row, col,
+                                       isSelected);
+    }
+
+    virtual wxGridCellRenderer *Clone() const override
+    {
+        return new RecordingRenderer(m_drawn);
+    }
+
+private:
+    wxGridCellCoordsVector& m_drawn;
+};
+
+} // anonymous namespace
+
+TEST_CASE_METHOD(GridTestCase, "Grid::DrawOverflowingCells", "[grid]")
+{
+    wxGridCellCoordsVector drawn;
+    m_grid->SetDefaultRenderer(new RecordingRenderer(drawn));
+    m_grid->AppendCols(4);
+
+    wxBitmap bmp(m_grid->GetGridWindow()->GetSize());
+    wxMemoryDC dc(bmp);
+
+    // Draw just the given cells and return true if the specified one was
+    // drawn too.
+    const auto drawCells = [&](const wxGridCellCoordsVector& cells,
+                               const wxGridCellCoords& cell)
+    {
+        drawn.clear();
+        m_grid->DrawGridCellArea(dc, cells);
+
+        return std::find(drawn.begin(), drawn.end(), cell) != drawn.end();
+    };
+
+    const wxGridCellCoordsVector exposed{{0, 4}, {0, 5}, {1, 4}, {1, 5}};
+
+    // Drawing the empty cells must redraw the cell overflowing into them.
+    m_grid->SetCellValue(0, 0, wxString('W', 100));
+    CHECK( drawCells(exposed, {0, 0}) );
+    CHECK( !drawCells(exposed, {1, 0}) );
+
+    // The results of the search for the overflowing cell are not kept
+    // between redraws, so changing the values of cells is taken into account.
+    m_grid->SetCellValue(0, 2, "W");
+    CHECK( !drawCells(exposed, {0, 0}) );
+    CHECK( drawCells(exposed, {0, 2}) );
+
+    m_grid->SetCellValue(0, 2, "");
+    CHECK( drawCells(exposed, {0, 0}) );
+
+    m_grid->SetCellValue(1, 1, wxString('W', 100));
+    CHECK( drawCells(exposed, {1, 1}) );
+
+    // And so are the changes to the attributes.
+    m_grid->SetCellOverflow(0, 0, false);
+    CHECK( !drawCells(exposed, {0, 0}) );
+    CHECK( drawCells(exposed, {1, 1}) );
+
+    m_grid->SetCellOverflow(0, 0, true);
+    CHECK( drawCells(exposed, {0, 0}) );
+
+    // Inside cells of a multicell must redraw its owner.
+    m_grid->SetCellSize(0, 3, 1, 2);
+    CHECK( drawCells(exposed, {0, 3}) );
+
+    m_grid->SetCellSize(0, 3, 1, 1);
+    CHECK( !drawCells(exposed, {0, 3}) );
+}
+
+TEST_CASE_METHOD(GridTestCase, "Grid::TileCache", "[grid]")
+{
+    wxGridCellCoordsVector drawn;
+    m_grid->SetDefaultRenderer(new RecordingRenderer(drawn));
+    m_grid->AppendRows(30);
+
+    m_grid->EnableTileCache();
+    CHECK( m_grid->IsTileCacheEnabled() );
+
+    wxBitmap bmp(m_grid->GetGridWindow()->GetSize());
+    wxMemoryDC dc(bmp);
+
+    const auto wasDrawn = [&](const wxGridCellCoords& cell)
+    {
+        return std::find(drawn.begin(), drawn.end(), cell) != drawn.end();
+    };
+
+    // Draw the given cells using the cache and return true if the specified
+    // one was drawn by the renderer, i.e. wasn't taken from the cache.
+    const auto drawCells = [&](const wxGridCellCoordsVector& cells,
+                               const wxGridCellCoords& cell)
+    {
+        drawn.clear();
+        m_grid->DrawCachedGridCellArea(dc, cells);
+
+        return wasDrawn(cell);
+    };
+
+    // These cells are in different tiles, as each of them has 16 rows.
+    const wxGridCellCoordsVector exposed{{0, 0}, {20, 0}};
+
+    // All cells of the tiles are drawn, even if they're not exposed...
+    CHECK( drawCells(exposed, {0, 0}) );
+    CHECK( wasDrawn({1, 1}) );
+    CHECK( wasDrawn({21, 1}) );
+
+    // ... and then they're not drawn again.
+    CHECK( !drawCells(exposed, {0, 0}) );
+    CHECK( drawn.empty() );
+
+    // Changing the value of a cell only draws its tile again.
+    m_grid->SetCellValue(20, 1, "Changed");
+    CHECK( drawCells(exposed, {20, 0}) );
+    CHECK( !wasDrawn({0, 0}) );
+
+    // And so does changing its attributes.
+    m_grid->SetCellBackgroundColour(0, 1, *wxRED);
+    CHECK( drawCells(exposed, {0, 0}) );
+    CHECK( !wasDrawn({20, 0}) );
+
+    // Check that the bitmap of the tile drawn again uses the new colour.
+    dc.SelectObject(wxNullBitmap);
+    const wxImage image = bmp.ConvertToImage();
+    dc.SelectObject(bmp);
+
+    const wxRect rect = m_grid->CellToRect(0, 1);
+    const int x = rect.GetLeft() + rect.width / 2,
+              y = rect.GetTop() + rect.height / 2;
+    CHECK( image.GetRed(x, y) == 0xff );
+    CHECK( image.GetGreen(x, y) == 0 );
+    CHECK( image.GetBlue(x, y) == 0 );
+
+    m_grid->RefreshBlock(20, 0, 20, 0);
+    CHECK( drawCells(exposed, {20, 0}) );
+    CHECK( !wasDrawn({0, 0}) );
+
+    // Resizing a row changes the positions of all cells below it.
+    m_grid->SetRowSize(5, 2*m_grid->GetRowSize(5));
+    CHECK( drawCells(exposed, {0, 0}) );
+    CHECK( wasDrawn({20, 0}) );
+
+    // Refreshing the entire grid forgets all tiles.
+    CHECK( !drawCells(exposed, {0, 0}) );
+    m_grid->Refresh();
+    CHECK( drawCells(exposed, {0, 0}) );
+    CHECK( wasDrawn({20, 0}) );
+
+    m_grid->EnableTileCache(false);
+    CHECK( !m_grid->IsTileCacheEnabled() );
+
+    // Without the cache, only the given cells are drawn, and every time.
+    CHECK( drawCells(exposed, {0, 0}) );
+    CHECK( !wasDrawn({1, 1}) );
+    CHECK( drawCells(exposed, {0, 0}) );
+}
+
 #define CHECK_ATTR_COUNT(n) CHECK( m_grid->GetCellAttrCount() == n )
 
 TEST_CASE_METHOD(GridTestCase, "Grid::CellAttribute", "[attr][cell][grid]")
@@ -1955,6 +2134,194 @@ TEST_CASE_METHOD(GridTestCase, "Grid::CellAttribute", "[attr][cell][grid]")
     }
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::CellAttributeRange", "[attr][cell][grid]")
+{
+    CHECK_ATTR_COUNT( 0 );
+
+    wxGridCellAttr* const attr = new wxGridCellAttr;
+    attr->SetBackgroundColour(*wxRED);
+    m_grid->SetAttrRange(wxGridBlockCoords(1, 0, 3, 1), attr);
+    CHECK_ATTR_COUNT( 6 );
+    CHECK( !HasCellAttr(0, 0) );
+    CHECK( HasCellAttr(1, 0) );
+    CHECK( HasCellAttr(3, 1) );
+    CHECK( m_grid->GetCellBackgroundColour(2, 1) == *wxRED );
+
+    SECTION("Overwrite")
+    {
+        // Setting the attribute of a single cell overrides the range one.
+        SetCellAttr(2, 0);
+        CHECK_ATTR_COUNT( 6 );
+        CHECK( m_grid->GetCellBackgroundColour(2, 0) != *wxRED );
+
+        m_grid->SetAttr(2, 1, nullptr);
+        CHECK_ATTR_COUNT( 5 );
+
+        // And setting the range attribute overrides the individual ones.
+        m_grid->SetAttrRange(wxGridBlockCoords(2, 0, 2, 1), nullptr);
+        CHECK_ATTR_COUNT( 4 );
+        CHECK( !HasCellAttr(2, 0) );
+        CHECK( HasCellAttr(3, 0) );
+    }
+
+    SECTION("Copy on write")
+    {
+        // Changing the attribute of a single cell makes a copy of the range
+        // attribute for it, without affecting the other cells.
+        m_grid->SetCellTextColour(2, 0, *wxGREEN);
+        CHECK_ATTR_COUNT( 6 );
+        CHECK( m_grid->GetCellTextColour(2, 0) == *wxGREEN );
+        CHECK( m_grid->GetCellBackgroundColour(2, 0) == *wxRED );
+        CHECK( m_grid->GetCellTextColour(1, 0) != *wxGREEN );
+        CHECK( m_grid->GetCellTextColour(3, 0) != *wxGREEN );
+        CHECK( m_grid->GetCellTextColour(2, 1) != *wxGREEN );
+        CHECK( !attr->HasTextColour() );
+
+        m_grid->SetCellBackgroundColour(2, 1, *wxBLUE);
+        CHECK( m_grid->GetCellBackgroundColour(2, 1) == *wxBLUE );
+        CHECK( m_grid->GetCellBackgroundColour(2, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(1, 1) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(3, 1) == *wxRED );
+        CHECK( attr->GetBackgroundColour() == *wxRED );
+
+        // The same is true for the cell size.
+        m_grid->SetCellSize(1, 0, 1, 2);
+
+        int rows, cols;
+        CHECK( m_grid->GetCellSize(1, 0, &rows, &cols) == wxGrid::CellSpan_Main );
+        CHECK( m_grid->GetCellSize(1, 1, &rows, &cols) == wxGrid::CellSpan_Inside );
+        CHECK( m_grid->GetCellSize(2, 0, &rows, &cols) == wxGrid::CellSpan_None );
+        CHECK( m_grid->GetCellSize(3, 1, &rows, &cols) == wxGrid::CellSpan_None );
+        CHECK( m_grid->GetCellBackgroundColour(1, 1) == *wxRED );
+        CHECK_ATTR_COUNT( 6 );
+    }
+
+    SECTION("Expanding")
+    {
+        m_grid->InsertCols(1);
+        CHECK_ATTR_COUNT( 6 );
+        CHECK( HasCellAttr(1, 0) );
+        CHECK( !HasCellAttr(1, 1) );
+        CHECK( HasCellAttr(1, 2) );
+
+        m_grid->InsertRows(0);
+        CHECK_ATTR_COUNT( 6 );
+        CHECK( !HasCellAttr(1, 0) );
+        CHECK( HasCellAttr(4, 2) );
+    }
+
+    SECTION("Shrinking")
+    {
+        m_grid->DeleteCols(0);
+        CHECK_ATTR_COUNT( 3 );
+        CHECK( HasCellAttr(1, 0) );
+        CHECK( !HasCellAttr(1, 1) );
+
+        m_grid->DeleteRows(1, 2);
+        CHECK_ATTR_COUNT( 1 );
+        CHECK( HasCellAttr(1, 0) );
+    }
+}
+
+TEST_CASE("Grid::CellAttributeRangeData", "[attr][cell][grid]")
+{
+    wxGridCellAttrRangeData data;
+
+    wxGridCellAttr* const attr = new wxGridCellAttr;
+    wxGridCellAttr* const attrOther = new wxGridCellAttr;
+
+    const auto setAttr = [&data](wxGridCellAttr* a, int top, int left,
+                                 int bottom, int right)
+    {
+        if ( a )
+            a->IncRef();
+        data.SetAttr(a, wxGridBlockCoords(top, left, bottom, right));
+    };
+
+    const auto getAttr = [&data](int row, int col)
+    {
+        wxGridCellAttr* const a = data.GetAttr(row, col);
+        if ( a )
+            a->DecRef();
+        return a;
+    };
+
+    setAttr(attr, 10, 10, 19, 19);
+    CHECK( data.GetCount() == 1 );
+    CHECK( getAttr(10, 10) == attr );
+    CHECK( getAttr(19, 19) == attr );
+    CHECK( getAttr(9, 10) == nullptr );
+    CHECK( getAttr(10, 20) == nullptr );
+
+    SECTION("Overlapping")
+    {
+        // The new range overrides the old one in the overlapping part only.
+        setAttr(attrOther, 15, 5, 25, 14);
+        CHECK( getAttr(15, 5) == attrOther );
+        CHECK( getAttr(15, 10) == attrOther );
+        CHECK( getAttr(15, 15) == attr );
+        CHECK( getAttr(14, 10) == attr );
+        CHECK( getAttr(25, 14) == attrOther );
+
+        // Resetting it all removes everything.
+        setAttr(nullptr, 0, 0, 30, 30);
+        CHECK( data.IsEmpty() );
+    }
+
+    SECTION("Set and clear cycles")
+    {
+        // Repeatedly changing the attributes of the individual cells and
+        // restoring them must not accumulate anything.
+        for ( int n = 0; n < 100; n++ )
+        {
+            const int row = 5 + n % 20;
+            const int col = 5 + (n * 7) % 20;
+            const bool inside = row >= 10 && row < 20 && col >= 10 && col < 20;
+
+            setAttr(attrOther, row, col, row, col);
+            CHECK( getAttr(row, col) == attrOther );
+
+            setAttr(inside ? attr : nullptr, row, col, row, col);
+            CHECK( getAttr(row, col) == (inside ? attr : nullptr) );
+
+            CHECK( data.GetCount() == 1 );
+        }
+
+        // The same is true for removing the attribute from a cell.
+        setAttr(nullptr, 15, 15, 15, 15);
+        CHECK( getAttr(15, 15) == nullptr );
+        setAttr(attr, 15, 15, 15, 15);
+        CHECK( data.GetCount() == 1 );
+    }
+
+    SECTION("Inserting and deleting")
+    {
+        data.UpdateAttrRows(15, 3);
+        CHECK( data.GetCount() == 2 );
+        CHECK( getAttr(16, 10) == nullptr );
+        CHECK( getAttr(22, 19) == attr );
+
+        data.UpdateAttrRows(15, -3);
+        CHECK( data.GetCount() == 1 );
+
+        data.UpdateAttrCols(15, 3);
+        CHECK( data.GetCount() == 2 );
+        CHECK( getAttr(10, 16) == nullptr );
+        CHECK( getAttr(19, 22) == attr );
+
+        data.UpdateAttrCols(15, -3);
+        CHECK( data.GetCount() == 1 );
+
+        data.UpdateAttrRows(5, -10);
+        CHECK( getAttr(5, 10) == attr );
+        CHECK( getAttr(9, 10) == attr );
+        CHECK( getAttr(10, 10) == nullptr );
+    }
+
+    attrOther->DecRef();
+    attr->DecRef();
+}
+
 namespace SetTable_ClearAttrCache
 {
 
@@ -13,8 +13,12 @@
 #include "testprec.h"
 
 
+#include "wx/app.h"
 #include "wx/event.h"
 
+#include <memory>
+#include <vector>
+
 // ----------------------------------------------------------------------------
 // test events and their handlers
 // ----------------------------------------------------------------------------
@@ -534,3 +538,291 @@ void TestEventCreation()
 }
 
 #endif // TEST_INVALID_EVENT_CREATION
+
+namespace
+{
+
+// Handler recording the order in which it was called.
+class OrderRecorder : public wxEvtHandler
+{
+public:
+    OrderRecorder(std::vector<int>& called, int n)
+        : m_called(called),
+          m_n(n)
+    {
+    }
+
+    void OnEvent(wxEvent& event)
+    {
+        m_called.push_back(m_n);
+        event.Skip();
+    }
+
+private:
+    std::vector<int>& m_called;
+    const int m_n;
+
+    wxDECLARE_NO_COPY_CLASS(OrderRecorder);
+};
+
+} // anonymous namespace
+
+TEST_CASE("Event::BindMany", "[event][bind][unbind]")
+{
+    // Bind enough handlers to use the index by event type internally.
+    const int NUM_HANDLERS = 100;
+
+    wxEvtHandler handler;
+    std::vector<int> called;
+
+    std::vector<std::unique_ptr<OrderRecorder>> recorders;
+    for ( int n = 0; n < NUM_HANDLERS; n++ )
+    {
+        recorders.emplace_back(new OrderRecorder(called, n));
+
+        OrderRecorder* const recorder = recorders.back().get();
+        if ( n % 2 )
+            handler.Bind(MyEventType, &OrderRecorder::OnEvent, recorder);
+        else
+            handler.Bind(wxEVT_IDLE, &OrderRecorder::OnEvent, recorder);
+    }
+
+    MyEvent e;
+    handler.ProcessEvent(e);
+
+    // Only the handlers for this event type should have been called and in
+    // the reverse order of binding.
+    REQUIRE( called.size() == NUM_HANDLERS / 2 );
+    CHECK( called.front() == NUM_HANDLERS - 1 );
+    CHECK( called.back() == 1 );
+
+    SECTION("Unbind")
+    {
+        CHECK( handler.Unbind(MyEventType, &OrderRecorder::OnEvent,
+                              recorders[NUM_HANDLERS - 1].get()) );
+        CHECK( handler.Unbind(MyEventType, &OrderRecorder::OnEvent,
+                              recorders[1].get()) );
+        CHECK( !handler.Unbind(MyEventType, &OrderRecorder::OnEvent,
+                               recorders[2].get()) );
+
+        called.clear();
+        handler.ProcessEvent(e);
+        REQUIRE( called.size() == NUM_HANDLERS / 2 - 2 );
+        CHECK( called.front() == NUM_HANDLERS - 3 );
+        CHECK( called.back() == 3 );
+
+        // Check that destroying the handler object unbinds it too.
+        recorders[3].reset();
+
+        called.clear();
+        handler.ProcessEvent(e);
+        CHECK( called.size() == NUM_HANDLERS / 2 - 3 );
+    }
+
+    SECTION("Bind inside handler")
+    {
+        // Binding new handlers from inside a handler must not call them for
+        // the event being currently processed.
+        bool boundNew = false;
+        handler.Bind(MyEventType, [&](MyEvent& event)
+            {
+                if ( !boundNew )
+                {
+                    boundNew = true;
+                    for ( int n = 0; n < NUM_HANDLERS; n++ )
+                        handler.Bind(wxEVT_THREAD, [](wxThreadEvent&) { });
+                    handler.Bind(MyEventType, [&](MyEvent&) { called.push_back(-1); });
+                }
+
+                event.Skip();
+            });
+
+        called.clear();
+        handler.ProcessEvent(e);
+        CHECK( called.size() == NUM_HANDLERS / 2 );
+
+        called.clear();
+        handler.ProcessEvent(e);
+        REQUIRE( called.size() == 1 );
+        CHECK( called[0] == -1 );
+    }
+}
+
+TEST_CASE("Event::QueueEventCoalesced", "[event][queue]")
+{
+    wxEvtHandler handler;
+
+    std::vector<int> values;
+    handler.Bind(wxEVT_THREAD, [&values](wxThreadEvent& event)
+        {
+            values.push_back(event.GetInt());
+        });
+
+    const auto queue = [&handler](int value, int id = wxID_ANY, wxIntPtr key = 0)
+        {
+            wxThreadEvent* const event = new wxThreadEvent(wxEVT_THREAD, id);
+            event->SetInt(value);
+            handler.QueueEventCoalesced(event, key);
+        };
+
+    queue(1);
+    queue(2);
+    queue(10, 1);
+    queue(100, wxID_ANY, 1);
+    queue(3);
+    queue(20, 1);
+
+    // This one is queued normally, so it's never coalesced.
+    wxThreadEvent* const event = new wxThreadEvent();
+    event->SetInt(4);
+    wxQueueEvent(&handler, event);
+
+    queue(5);
+
+    wxTheApp->ProcessPendingEvents();
+
+    REQUIRE( values.size() == 4 );
+    CHECK( values[0] == 5 );
+    CHECK( values[1] == 20 );
+    CHECK( values[2] == 100 );
+    CHECK( values[3] == 4 );
+
+    // Once the event is processed, a new one is queued normally.
+    values.clear();
+    queue(6);
+    wxTheApp->ProcessPendingEvents();
+
+    REQUIRE( values.size() == 1 );
+    CHECK( values[0] == 6 );
+}
+
+TEST_CASE("Event::PendingEventsBatch", "[event][queue]")
+{
+    std::vector<int> values;
+
+    const auto queue = [](wxEvtHandler& handler, int value)
+        {
+            wxThreadEvent* const event = new wxThreadEvent();
+            event->SetInt(value);
+            wxQueueEvent(&handler, event);
+        };
+
+    SECTION("Handler destroyed")
+    {
+        wxEvtHandler* const handler = new wxEvtHandler;
+        handler->Bind(wxEVT_THREAD, [&values, handler](wxThreadEvent& event)
+            {
+                values.push_back(event.GetInt());
+
+                // The remaining events of the batch must be discarded.
+                if ( event.GetInt() == 2 )
+                    delete handler;
+            });
+
+        wxEvtHandler other;
+        other.Bind(wxEVT_THREAD, [&values](wxThreadEvent& event)
+            {
+                values.push_back(-event.GetInt());
+            });
+
+        for ( int n = 1; n <= 4; n++ )
+            queue(*handler, n);
+        queue(other, 1);
+
+        wxTheApp->ProcessPendingEvents();
+
+        REQUIRE( values.size() == 3 );
+        CHECK( values[0] == 1 );
+        CHECK( values[1] == 2 );
+        CHECK( values[2] == -1 );
+    }
+
+    SECTION("Budget")
+    {
+        wxEvtHandler handler;
+        handler.Bind(wxEVT_THREAD, [&values](wxThreadEvent& event)
+            {
+                values.push_back(event.GetInt());
+            });
+
+        for ( int n = 0; n < 5; n++ )
+            queue(handler, n);
+
+        // Don't leave the budget set for the other tests.
+        struct BudgetResetter
+        {
+            ~BudgetResetter() { wxTheApp->SetPendingEventsBudget(0); }
+        } resetBudget;
+
+        wxTheApp->SetPendingEventsBudget(2);
+
+        wxTheApp->ProcessPendingEvents();
+        CHECK( values.size() == 2 );
+
+        // The processing must resume where it stopped.
+        wxTheApp->ProcessPendingEvents();
+        CHECK( values.size() == 4 );
+
+        wxTheApp->ProcessPendingEvents();
+        REQUIRE( values.size() == 5 );
+        for ( int n = 0; n < 5; n++ )
+            CHECK( values[n] == n );
+
+        // Check the time limit too: at least one event is always processed,
+        // but not more than fit into the budget.
+        values.clear();
+        handler.Bind(wxEVT_THREAD, [](wxThreadEvent& event)
+            {
+                wxMilliSleep(20);
+                event.Skip();
+            });
+
+        for ( int n = 0; n < 5; n++ )
+            queue(handler, n);
+
+        wxTheApp->SetPendingEventsBudget(0, 10);
+
+        wxTheApp->ProcessPendingEvents();
+        CHECK( values.size() == 1 );
+
+        for ( int n = 0; n < 10 && values.size() < 5; n++ )
+            wxTheApp->ProcessPendingEvents();
+
+        REQUIRE( values.size() == 5 );
+        for ( int n = 0; n < 5; n++ )
+            CHECK( values[n] == n );
+    }
+
+    SECTION("Queue from handler")
+    {
+        wxEvtHandler handler;
+        handler.Bind(wxEVT_THREAD, [&](wxThreadEvent& event)
+            {
+                const int value = event.GetInt();
+                values.push_back(value);
+
+                if ( value == 1 )
+                {
+                    queue(handler, 3);
+
+                    // Process the events from a nested call, as a modal
+                    // dialog shown from this handler would do: they must
+                    // still be processed in the order they were queued in.
+                    wxTheApp->ProcessPendingEvents();
+
+                    values.push_back(-1);
+                }
+            });
+
+        queue(handler, 1);
+        queue(handler, 2);
+
+        wxTheApp->ProcessPendingEvents();
+
+        REQUIRE( values.size() == 4 );
+        CHECK( values[0] == 1 );
+        CHECK( values[1] == 2 );
+        CHECK( values[2] == 3 );
+        CHECK( values[3] == -1 );
+    }
+}
@@ -18,6 +18,10 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "wx/evtloop.h"
 #include "wx/timer.h"
 
@@ -65,10 +69,12 @@ private:
     CPPUNIT_TEST_SUITE( TimerEventTestCase );
         CPPUNIT_TEST( OneShot );
         CPPUNIT_TEST( Multiple );
+        CPPUNIT_TEST( Order );
     CPPUNIT_TEST_SUITE_END();
 
     void OneShot();
     void Multiple();
+    void Order();
 
     wxDECLARE_NO_COPY_CLASS(TimerEventTestCase);
 };
@@ -137,3 +143,56 @@ void TimerEventTestCase::Multiple()
     // more than one
     CPPUNIT_ASSERT( numTicks > 1 );
 }
+
+void TimerEventTestCase::Order()
+{
+    wxEventLoop loop;
+
+    // ids of the timers in the order in which they expired
+    std::vector<int> expired;
+
+    wxEvtHandler handler;
+    handler.Bind(wxEVT_TIMER, [&](wxTimerEvent& event)
+    {
+        expired.push_back(event.GetId());
+    });
+
+    // start the timers in some order different from their expiration order
+    // and stop some of them before they expire
+    const int NUM_TIMERS = 30;
+    std::vector<std::unique_ptr<wxTimer>> timers;
+    for ( int n = 0; n < NUM_TIMERS; n++ )
+    {
+        const int id = (n*7) % NUM_TIMERS + 1;
+        timers.emplace_back(new wxTimer(&handler, id));
+        timers.back()->StartOnce(id*10);
+    }
+
+    int numExpected = NUM_TIMERS;
+    for ( int n = 0; n < NUM_TIMERS; n += 3 )
+    {
+        timers[n]->Stop();
+        numExpected--;
+    }
+
+    time_t t;
+    time(&t);
+    const time_t tEnd = t + 5;
+    while ( static_cast<int>(expired.size()) < numExpected && time(&t) < tEnd )
+    {
+        loop.Dispatch();
+    }
+
+    CPPUNIT_ASSERT_EQUAL( numExpected, static_cast<int>(expired.size()) );
+
+    for ( size_t n = 1; n < expired.size(); n++ )
+    {
+        CPPUNIT_ASSERT( expired[n - 1] < expired[n] );
+    }
+
+    for ( int n = 0; n < NUM_TIMERS; n += 3 )
+    {
+        CPPUNIT_ASSERT( std::find(expired.begin(), expired.end(),
+                                  timers[n]->GetId()) == expired.end() );
+    }
+}
@@ -14,6 +14,7 @@
 
 
 #ifndef WX_PRECOMP
+    #include "wx/app.h"
     #include "wx/timer.h"
 #endif
 
@@ -25,11 +26,13 @@
 #include "wx/fswatcher.h"
 #include "wx/log.h"
 #include "wx/stdpaths.h"
+#include "wx/stopwatch.h"
 #include "wx/vector.h"
 
 #include "testfile.h"
 
 #include <memory>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 // local functions
@@ -873,6 +876,225 @@ TEST_CASE_METHOD(FileSystemWatcherTestCase,
 }
 
 
+// When AddTree() doesn't add a watch for each subdirectory, AddTreeAsync() is
+// the same as it, so only test it under the other platforms.
+#if !defined(__WINDOWS__) && !defined(wxHAVE_FSEVENTS_FILE_NOTIFICATIONS)
+
+// ----------------------------------------------------------------------------
+// TestAddTreeAsync
+// ----------------------------------------------------------------------------
+
+TEST_CASE_METHOD(FileSystemWatcherTestCase,
+                 "wxFileSystemWatcher::AddTreeAsync", "[fsw]")
+{
+    class AsyncTreeTester : public FSWTesterBase
+    {
+    public:
+        AsyncTreeTester()
+        {
+            Bind(wxEVT_FSWATCHER_TREE_ADDED,
+                 [this](wxFileSystemWatcherEvent& event)
+                 {
+                    m_treesAdded.push_back(event.GetPath());
+                 });
+        }
+
+        // Create the tree with the given number of subdirectories at each of
+        // the 2 levels and return the total number of directories in it.
+        int GrowTree(wxFileName dir, int count)
+        {
+            REQUIRE(dir.Mkdir());
+
+            int total = 1;
+            for ( int i = 0; i < count; ++i )
+            {
+                wxFileName subdir(dir);
+                subdir.AppendDir(wxString::Format("dir%d", i));
+                REQUIRE(subdir.Mkdir());
+                total++;
+
+                for ( int j = 0; j < count; ++j )
+                {
+                    wxFileName subsubdir(subdir);
+                    subsubdir.AppendDir(wxString::Format("sub%d", j));
+                    REQUIRE(subsubdir.Mkdir());
+                    total++;
+                }
+            }
+
+            return total;
+        }
+
+        void WaitForTree()
+        {
+            wxStopWatch sw;
+            while ( m_treesAdded.empty() )
+            {
+                if ( sw.Time() > 10000 )
+                {
+                    FAIL("Timed out waiting for the tree to be added");
+                }
+
+                wxTheApp->ProcessPendingEvents();
+                wxMilliSleep(1);
+            }
+        }
+
+        virtual void GenerateEvent() override
+        {
+            wxFileName treedir = EventGenerator::GetWatchDir();
+            treedir.AppendDir("asynctree");
+
+            // Use enough directories to need several batches.
+            const int total = GrowTree(treedir, 20);
+
+            const int initial = m_watcher->GetWatchedPathsCount();
+
+            REQUIRE( m_watcher->AddTreeAsync(treedir) );
+
+            // The root directory is added immediately.
+            CHECK( m_watcher->GetWatchedPathsCount() == initial + 1 );
+
+            WaitForTree();
+
+            REQUIRE( m_treesAdded.size() == 1 );
+            CHECK( m_treesAdded[0].GetFullPath() == treedir.GetFullPath() );
+            CHECK( m_watcher->GetWatchedPathsCount() == initial + total );
+
+            CHECK( m_watcher->RemoveTree(treedir) );
+            CHECK( m_watcher->GetWatchedPathsCount() == initial );
+
+            // Removing the tree while it's being added should work too.
+            m_treesAdded.clear();
+            REQUIRE( m_watcher->AddTreeAsync(treedir) );
+            CHECK( m_watcher->RemoveTree(treedir) );
+            CHECK( m_watcher->GetWatchedPathsCount() == initial );
+
+            wxTheApp->ProcessPendingEvents();
+            CHECK( m_treesAdded.empty() );
+            CHECK( m_watcher->GetWatchedPathsCount() == initial );
+
+            // And so should destroying the watcher.
+            REQUIRE( m_watcher->AddTreeAsync(treedir) );
+            m_watcher.reset();
+
+            CHECK( treedir.Rmdir(wxPATH_RMDIR_RECURSIVE) );
+
+            Exit();
+        }
+
+        virtual wxFileSystemWatcherEvent ExpectedEvent() override
+        {
+            FAIL("Shouldn't be called");
+
+            return wxFileSystemWatcherEvent(wxFSW_EVENT_ERROR);
+        }
+
+        virtual void CheckResult() override
+        {
+        }
+
+    private:
+        wxVector<wxFileName> m_treesAdded;
+    };
+
+    AsyncTreeTester tester;
+
+    tester.Run();
+}
+
+#endif // !__WINDOWS__ && !wxHAVE_FSEVENTS_FILE_NOTIFICATIONS
+
+#ifdef wxHAS_INOTIFY
+
+// ----------------------------------------------------------------------------
+// TestCoalescing
+// ----------------------------------------------------------------------------
+
+TEST_CASE_METHOD(FileSystemWatcherTestCase,
+                 "wxFileSystemWatcher::Coalescing", "[fsw]")
+{
+    class EventTester : public FSWTesterBase
+    {
+    public:
+        EventTester()
+        {
+            Bind(wxEVT_FSWATCHER_BATCH,
+                 [this](wxFileSystemWatcherBatchEvent& event)
+                 {
+                    m_batches.push_back(event.GetEvents());
+                    SendIdle();
+                 });
+        }
+
+        virtual bool Init() override
+        {
+            // Create a file which exists before we start watching.
+            m_existing = eg.RandomName();
+            CHECK(wxFile().Create(m_existing.GetFullPath()));
+
+            if ( !FSWTesterBase::Init() )
+                return false;
+
+            m_watcher->SetCoalescingInterval(500);
+            CHECK( m_watcher->GetCoalescingInterval() == 500 );
+
+            return true;
+        }
+
+        virtual void GenerateEvent() override
+        {
+            // Create and modify a file a few times, and also create and
+            // delete another one: all this should result in a single event
+            // for the first file and none at all for the second one.
+            CHECK(eg.CreateFile());
+            CHECK(eg.ModifyFile());
+            CHECK(eg.ModifyFile());
+
+            const wxFileName temp = eg.RandomName();
+            CHECK(wxFile().Create(temp.GetFullPath()));
+            CHECK(wxRemoveFile(temp.GetFullPath()));
+
+            // But deleting, recreating and deleting an existing file again
+            // should still result in its deletion being reported.
+            CHECK(wxRemoveFile(m_existing.GetFullPath()));
+            CHECK(wxFile().Create(m_existing.GetFullPath()));
+            CHECK(wxRemoveFile(m_existing.GetFullPath()));
+        }
+
+        virtual void CheckResult() override
+        {
+            // Individual events are not sent when they're coalesced.
+            CHECK( m_events.empty() );
+
+            REQUIRE( m_batches.size() == 1 );
+
+            const std::vector<wxFileSystemWatcherEvent>& events = m_batches[0];
+            REQUIRE( events.size() == 2 );
+            CHECK( events[0].GetChangeType() == wxFSW_EVENT_CREATE );
+            CHECK( events[0].GetPath() == eg.m_file );
+            CHECK( events[1].GetChangeType() == wxFSW_EVENT_DELETE );
+            CHECK( events[1].GetPath() == m_existing );
+        }
+
+        virtual wxFileSystemWatcherEvent ExpectedEvent() override
+        {
+            FAIL("Shouldn't be called");
+
+            return wxFileSystemWatcherEvent(wxFSW_EVENT_ERROR);
+        }
+
+    private:
+        std::vector<std::vector<wxFileSystemWatcherEvent>> m_batches;
+        wxFileName m_existing;
+    };
+
+    EventTester tester;
+    tester.Run();
+}
+
+#endif // wxHAS_INOTIFY
+
 namespace
 {
 
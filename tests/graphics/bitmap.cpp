@@ -631,6 +631,61 @@ TEST_CASE("BitmapTestCase::FromImage", "[bitmap][image][convertfrom]")
         }
     }
 
+    SECTION("RGB image moved into bitmap")
+    {
+        wxImage img(3, 2);
+        img.SetRGB(0, 0, maskCol.Red(), maskCol.Green(), maskCol.Blue());
+        img.SetRGB(1, 1, fillCol.Red(), fillCol.Green(), fillCol.Blue());
+        img.SetRGB(2, 1, fillCol.Red(), fillCol.Green(), fillCol.Blue());
+
+        const wxImage imgOrig = img.Copy();
+
+        wxBitmap bmp(std::move(img));
+        REQUIRE_FALSE(bmp.HasAlpha());
+        REQUIRE(bmp.GetWidth() == imgOrig.GetWidth());
+        REQUIRE(bmp.GetHeight() == imgOrig.GetHeight());
+
+        const wxImage imgBmp = bmp.ConvertToImage();
+        for ( int y = 0; y < imgOrig.GetHeight(); ++y )
+        {
+            for ( int x = 0; x < imgOrig.GetWidth(); ++x )
+            {
+                wxColour bmpc(imgBmp.GetRed(x, y), imgBmp.GetGreen(x, y), imgBmp.GetBlue(x, y));
+                wxColour imgc(imgOrig.GetRed(x, y), imgOrig.GetGreen(x, y), imgOrig.GetBlue(x, y));
+                CHECK_EQUAL_COLOUR_RGB(bmpc, imgc);
+            }
+        }
+
+#ifdef __WXGTK3__
+        // The image was the sole owner of its data, so the bitmap must have
+        // taken it over and the image must have been reset.
+        CHECK_FALSE( img.IsOk() );
+#endif
+
+        // Modifying the bitmap must change the bitmap itself, but not the
+        // images created from it before.
+        {
+            wxMemoryDC dc(bmp);
+            dc.SetBackground(*wxBLUE_BRUSH);
+            dc.Clear();
+        }
+        const wxImage imgModified = bmp.ConvertToImage();
+        CHECK( imgModified.GetRed(0, 0) == 0 );
+        CHECK( imgModified.GetBlue(0, 0) == 0xff );
+        CHECK( imgBmp.GetRed(0, 0) == maskCol.Red() );
+
+        // If the image data is shared, it must be copied and not taken over.
+        wxImage imgShared(2, 2);
+        const wxImage imgCopy = imgShared;
+        wxBitmap bmpShared(std::move(imgShared));
+        CHECK( imgShared.IsOk() );
+        CHECK( imgShared.IsSameAs(imgCopy) );
+
+        // And modifying the image must not affect the bitmap.
+        imgCopy.GetData()[0] = 0x80;
+        CHECK( bmpShared.ConvertToImage().GetRed(0, 0) == 0 );
+    }
+
     SECTION("RGB image with mask")
     {
         wxImage img(2, 2);
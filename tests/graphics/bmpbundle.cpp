@@ -485,6 +485,40 @@ TEST_CASE("BitmapBundle::FromSVG-alpha", "[bmpbundle][svg][alpha]")
     CHECK( (int)img.GetBlue(0, 1) == 0xff );
 }
 
+TEST_CASE("BitmapBundle::FromSVG-cache", "[bmpbundle][svg][cache]")
+{
+    static const char svg_data[] =
+        "<svg viewBox=\"0 0 100 100\">"
+        "<circle cx=\"50\" cy=\"50\" r=\"25\" fill=\"red\"/>"
+        "</svg>"
+        ;
+
+    wxBitmapBundle b = wxBitmapBundle::FromSVG(svg_data, wxSize(16, 16));
+    REQUIRE( b.IsOk() );
+
+    // Bitmaps of different sizes should all be cached.
+    const wxBitmap bmp32 = b.GetBitmap(wxSize(32, 32));
+    const wxBitmap bmp16 = b.GetBitmap(wxSize(16, 16));
+    CHECK( b.GetBitmap(wxSize(32, 32)).IsSameAs(bmp32) );
+    CHECK( b.GetBitmap(wxSize(16, 16)).IsSameAs(bmp16) );
+
+    // But only the last one should be kept if caching is disabled.
+    wxBitmapBundle::SetSVGCacheLimit(0);
+    CHECK( b.GetBitmap(wxSize(16, 16)).IsSameAs(bmp16) );
+    CHECK( !b.GetBitmap(wxSize(32, 32)).IsSameAs(bmp32) );
+
+    wxBitmapBundle::SetSVGCacheLimit(16*1024*1024);
+
+    // Pre-rasterizing doesn't do anything visible, but check that it doesn't
+    // break anything neither.
+    wxVector<wxBitmapBundle> bundles;
+    bundles.push_back(b);
+    bundles.push_back(wxBitmapBundle());
+    wxBitmapBundle::PrerasterizeSVG(bundles);
+
+    CHECK( b.GetBitmap(wxSize(24, 24)).GetSize() == wxSize(24, 24) );
+}
+
 TEST_CASE("BitmapBundle::FromSVGFile", "[bmpbundle][svg][file]")
 {
     const wxSize size(20, 20); // completely arbitrary
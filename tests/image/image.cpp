@@ -20,10 +20,12 @@
 #endif // WX_PRECOMP
 
 #include "wx/anidecod.h" // wxImageArray
+#include "wx/gifdecod.h"
 #include "wx/bitmap.h"
 #include "wx/cursor.h"
 #include "wx/icon.h"
 #include "wx/palette.h"
+#include "wx/quantize.h"
 #include "wx/url.h"
 #include "wx/log.h"
 #include "wx/mstream.h"
@@ -41,8 +43,11 @@
     #include "wx/msw/dib.h"
 #endif
 
+#include "wx/private/image.h"
+
 #include "testimage.h"
 
+#include <atomic>
 #include <memory>
 
 #define CHECK_EQUAL_COLOUR_RGB(c1, c2) \
@@ -1282,6 +1287,44 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::BadGIF", "[image][gif][error]")
     CHECK( image.GetSize() == wxSize(1200, 800) );
 }
 
+TEST_CASE_METHOD(ImageHandlersInit, "wxGIFDecoder::DecodeOnDemand", "[image][gif]")
+{
+#if wxUSE_PALETTE
+    wxImage image("horse.gif");
+    REQUIRE( image.IsOk() );
+
+    wxImageArray images;
+    images.push_back(image);
+    for (int i = 0; i < 4-1; ++i)
+    {
+        images.push_back( images[i].Rotate90() );
+
+        images[i+1].SetPalette(images[0].GetPalette());
+    }
+
+    wxMemoryOutputStream memOut;
+    REQUIRE( wxGIFHandler().SaveAnimation(images, &memOut) );
+
+    wxMemoryInputStream memIn(memOut);
+    wxGIFDecoder decoder;
+    decoder.SetDecodeOnDemand(true);
+    REQUIRE( decoder.LoadGIF(memIn) == wxGIF_OK );
+    REQUIRE( decoder.GetFrameCount() == 4 );
+
+    // Check that going back to the previously decoded frames works too.
+    for ( int i = 3; i >= 0; --i )
+    {
+        REQUIRE( decoder.ConvertToImage(i, &image) );
+
+        wxINFO_FMT("Compare test for GIF frame number %d failed", i);
+        CHECK_THAT(image, RGBSameAs(images[i]));
+    }
+
+    REQUIRE( decoder.ConvertToImage(3, &image) );
+    CHECK_THAT(image, RGBSameAs(images[3]));
+#endif // #if wxUSE_PALETTE
+}
+
 #endif // wxUSE_GIF
 
 TEST_CASE_METHOD(ImageHandlersInit, "wxImage::DibPadding", "[image]")
@@ -2435,6 +2478,155 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::ChangeColours", "[image]")
     CHECK_THAT(test, RGBSimilarToFile("image/toucan_mono_255_255_255.png"));
 }
 
+TEST_CASE("wxImage::Parallelism", "[image]")
+{
+    // Use an image big enough to be split into several bands of rows.
+    wxImage original(600, 500);
+    unsigned char* data = original.GetData();
+    for ( int n = 0; n < original.GetWidth()*original.GetHeight()*3; n++ )
+        data[n] = static_cast<unsigned char>(n*7 + n/1800);
+
+    const auto process = [&original]()
+    {
+        wxImage hsv = original.Copy();
+        hsv.ChangeHSV(0.538, -0.41, -0.259);
+
+        wxImage dithered, quantized;
+        wxQuantize::Quantize(original, dithered, nullptr, 200, nullptr,
+                             wxQUANTIZE_FILL_DESTINATION_IMAGE);
+        wxQuantize::Quantize(original, quantized, nullptr, 200, nullptr,
+                             wxQUANTIZE_FILL_DESTINATION_IMAGE |
+                             wxQUANTIZE_NO_DITHERING);
+
+        return std::vector<wxImage>
+        {
+            hsv,
+            original.Rotate(0.3, wxPoint(300, 250)),
+            original.Rotate(0.3, wxPoint(300, 250), false),
+            original.ConvertToGreyscale(),
+            dithered,
+            quantized,
+        };
+    };
+
+    const std::vector<wxImage> sequential = process();
+
+    const int oldParallelism = wxImage::GetParallelism();
+    wxImage::SetParallelism(4);
+    CHECK( wxImage::GetParallelism() == 4 );
+
+    const std::vector<wxImage> parallel = process();
+
+    wxImage::SetParallelism(oldParallelism);
+
+    for ( size_t n = 0; n < sequential.size(); n++ )
+    {
+        INFO("Image #" << n);
+        CHECK_THAT( parallel[n], RGBSameAs(sequential[n]) );
+    }
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE("wxImage::ProcessRowsNested", "[image]")
+{
+    const int oldParallelism = wxImage::GetParallelism();
+    wxImage::SetParallelism(4);
+
+    // Use the size big enough for the rows to be split between the threads.
+    const int width = 1000;
+    const int height = 1000;
+
+    std::atomic<int> outerCalls{0},
+                     outerRows{0},
+                     innerRows{0};
+    wxImageProcessRows(width, height, [&](int from, int to)
+    {
+        outerCalls++;
+        outerRows += to - from;
+
+        // This must not deadlock, whether it's called from this thread or
+        // from one of the other ones.
+        wxImageProcessRows(width, height, [&](int innerFrom, int innerTo)
+        {
+            innerRows += innerTo - innerFrom;
+        });
+    });
+
+    wxImage::SetParallelism(oldParallelism);
+
+    CHECK( outerCalls > 1 );
+    CHECK( outerRows == height );
+    CHECK( innerRows == outerCalls*height );
+}
+
+#endif // wxUSE_THREADS
+
+TEST_CASE("wxImage::Pipeline", "[image]")
+{
+    wxImage original(60, 40);
+    unsigned char* data = original.GetData();
+    for ( int n = 0; n < original.GetWidth()*original.GetHeight()*3; n++ )
+        data[n] = static_cast<unsigned char>(n*7 + n/180);
+
+    SECTION("Geometry")
+    {
+        wxImage expected = original.GetSubImage(wxRect(5, 3, 40, 30))
+                                   .Mirror()
+                                   .Rotate90()
+                                   .Mirror(false)
+                                   .Rotate180()
+                                   .Rotate90(false);
+
+        wxImagePipeline pipeline(original);
+        pipeline.GetSubImage(wxRect(5, 3, 40, 30))
+                .Mirror()
+                .Rotate90()
+                .Mirror(false)
+                .Rotate180()
+                .Rotate90(false);
+        CHECK( pipeline.GetSize() == wxSize(40, 30) );
+        CHECK_THAT( pipeline.Execute(), RGBSameAs(expected) );
+    }
+
+    SECTION("Colours")
+    {
+        original.SetMaskColour(data[0], data[1], data[2]);
+
+        wxImage expected = original.ConvertToGreyscale().Rotate90();
+        expected.ChangeHSV(0.5, -0.2, 0.1);
+
+        wxImage actual = wxImagePipeline(original)
+                            .ConvertToGreyscale()
+                            .Rotate90()
+                            .ChangeHSV(0.5, -0.2, 0.1)
+                            .Execute();
+        CHECK_THAT( actual, RGBSameAs(expected) );
+        CHECK( actual.HasMask() );
+    }
+
+    SECTION("Scale")
+    {
+        original.InitAlpha();
+        unsigned char* alpha = original.GetAlpha();
+        for ( int n = 0; n < original.GetWidth()*original.GetHeight(); n++ )
+            alpha[n] = static_cast<unsigned char>(n);
+
+        wxImage expected = original.GetSubImage(wxRect(10, 0, 40, 40))
+                                   .Scale(20, 20)
+                                   .ConvertToDisabled()
+                                   .Mirror();
+
+        wxImage actual = wxImagePipeline(original)
+                            .GetSubImage(wxRect(10, 0, 40, 40))
+                            .Scale(20, 20)
+                            .ConvertToDisabled()
+                            .Mirror()
+                            .Execute();
+        CHECK_THAT( actual, RGBASameAs(expected) );
+    }
+}
+
 TEST_CASE("wxImage::Clear", "[image]")
 {
     wxImage image(2, 2);
@@ -2475,6 +2667,111 @@ TEST_CASE("wxImage::SizeLimits", "[image]")
 #endif // SIZEOF_VOID_P == 8
 }
 
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadRegion", "[image]")
+{
+    const wxRect region(10, 20, 50, 40);
+
+    const auto loadRegion = [](const wxString& file, const wxRect& rect)
+    {
+        wxImage image;
+        image.SetOption(wxIMAGE_OPTION_REGION_X, rect.x);
+        image.SetOption(wxIMAGE_OPTION_REGION_Y, rect.y);
+        image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, rect.width);
+        image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, rect.height);
+        image.LoadFile(file);
+        return image;
+    };
+
+    // Loading the region must give exactly the same result as cropping the
+    // full image, whether the handler supports loading it natively or not.
+    const char* const files[] =
+    {
+        "horse.png",                            // interlaced PNG
+        "image/horse_bicubic_300x300.png",      // non-interlaced PNG
+        "image/paste_input_overlay_transparent_border_semitransparent_circle.png",
+        "horse.bmp",
+    };
+
+    for ( const char* file : files )
+    {
+        INFO("File: " << file);
+
+        wxImage full(file);
+        REQUIRE( full.IsOk() );
+
+        wxImage image = loadRegion(file, region);
+        REQUIRE( image.IsOk() );
+        CHECK_THAT( image, RGBASameAs(full.GetSubImage(region)) );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == full.GetWidth() );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == full.GetHeight() );
+
+        // The region is clipped to the image.
+        const wxRect regionBig(full.GetWidth() - 30, full.GetHeight() - 20, 100, 100);
+        image = loadRegion(file, regionBig);
+        REQUIRE( image.IsOk() );
+        CHECK( image.GetSize() == wxSize(30, 20) );
+
+        // And loading fails if it doesn't intersect it at all.
+        wxLogNull noLog;
+        CHECK( !loadRegion(file, wxRect(full.GetWidth(), full.GetHeight(), 10, 10)).IsOk() );
+    }
+
+    // JPEG decoding may produce slightly different results for the pixels
+    // near the region boundary, so check only its size.
+    wxImage image = loadRegion("horse.jpg", region);
+    REQUIRE( image.IsOk() );
+    CHECK( image.GetSize() == region.GetSize() );
+    CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 200 );
+
+    // Check that the region and the maximal size can be combined.
+    for ( const char* file : { "horse.jpg", "image/horse_bicubic_300x300.png" } )
+    {
+        INFO("File: " << file);
+
+        image = wxImage();
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 30);
+        image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, 120);
+        image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, 80);
+        REQUIRE( image.LoadFile(file) );
+        CHECK( image.GetSize() == wxSize(30, 20) );
+
+        // Loading must still fail if the region is outside of the image.
+        image = wxImage();
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 30);
+        image.SetOption(wxIMAGE_OPTION_REGION_X, 1000);
+        image.SetOption(wxIMAGE_OPTION_REGION_Y, 1000);
+        image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, 10);
+        image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, 10);
+
+        wxLogNull noLog;
+        CHECK( !image.LoadFile(file) );
+        CHECK( !image.IsOk() );
+    }
+
+    // And that scaling a PNG while loading it works too.
+    image = wxImage();
+    image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 100);
+    REQUIRE( image.LoadFile("image/horse_bicubic_300x300.png") );
+    CHECK( image.GetSize() == wxSize(75, 75) );
+    CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 300 );
+
+    // Scaling must never result in an empty image, even if the image aspect
+    // ratio is very different from that of the maximal size.
+    for ( const auto type : { wxBITMAP_TYPE_PNG, wxBITMAP_TYPE_BMP } )
+    {
+        INFO("Type: " << type);
+
+        wxMemoryOutputStream mos;
+        REQUIRE( wxImage(4000, 10).SaveFile(mos, type) );
+
+        wxMemoryInputStream mis(mos);
+        image = wxImage();
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 100);
+        REQUIRE( image.LoadFile(mis, type) );
+        CHECK( image.GetSize() == wxSize(500, 1) );
+    }
+}
+
 // This can be used to test loading an arbitrary image file by setting the
 // environment variable WX_TEST_IMAGE_PATH to point to it.
 TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadPath", "[.]")
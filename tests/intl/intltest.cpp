@@ -359,6 +359,48 @@ TEST_CASE("wxTranslations::GetBestTranslation", "[translations]")
     }
 }
 
+TEST_CASE("wxTranslations::LazyLoading", "[translations]")
+{
+    wxFileTranslationsLoader::AddCatalogLookupPathPrefix("./intl");
+
+    const wxString domain("internat");
+
+    wxTranslations trans;
+    trans.SetLanguage(wxLANGUAGE_FRENCH);
+
+    SECTION("Enabled")
+    {
+        trans.EnableLazyLoading();
+        CHECK( trans.IsLazyLoadingEnabled() );
+    }
+
+    SECTION("Disabled")
+    {
+        CHECK_FALSE( trans.IsLazyLoadingEnabled() );
+    }
+
+    REQUIRE( trans.AddAvailableCatalog(domain) );
+
+    // Check that the results are the same in both cases, even when looking up
+    // the same string more than once.
+    for ( int n = 0; n < 2; n++ )
+    {
+        const wxString* s = trans.GetTranslatedString("&Open bogus file", domain);
+        REQUIRE( s );
+        CHECK( *s == "&Ouvrir un fichier" );
+
+        s = trans.GetTranslatedString("&File");
+        REQUIRE( s );
+        CHECK( *s == "&Fichier" );
+
+        CHECK_FALSE( trans.GetTranslatedString("No such string", domain) );
+        CHECK_FALSE( trans.GetTranslatedString("&File", domain, "context") );
+    }
+
+    CHECK( trans.GetHeaderValue("Project-Id-Version", domain) ==
+            "wxWindows 2.0 i18n sample" );
+}
+
 // This test can be used to check how GetBestTranslation() and
 // GetAvailableTranslations() work with the given preferred languages: set
 // WXLANGUAGE environment variable to the colon-separated list of preferred
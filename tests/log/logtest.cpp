@@ -18,8 +18,16 @@
     #include "wx/filefn.h"
 #endif // WX_PRECOMP
 
+#include "wx/crt.h"
+#include "wx/ffile.h"
 #include "wx/scopeguard.h"
 
+#include "testfile.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
 #if wxUSE_LOG
 
 #ifdef __WINDOWS__
@@ -336,6 +344,69 @@ void macroCompilabilityTest()
         wxLogDebug("hello debug %d", 42);
 }
 
+#if wxUSE_THREADS
+
+TEST_CASE("wxLogAsyncFile", "[log]")
+{
+    TempFile tf("logasync.txt");
+    if ( wxFileExists(tf.GetName()) )
+        wxRemoveFile(tf.GetName());
+
+    static const int NUM_THREADS = 4;
+    static const int NUM_MESSAGES = 3000;
+
+    {
+        wxLogAsyncFile* const log = new wxLogAsyncFile(tf.GetName());
+        std::unique_ptr<wxLog> logDeleter(log);
+        REQUIRE( log->IsOk() );
+
+        delete log->SetFormatter(new wxLogFormatterNone);
+
+        wxLog* const logOld = wxLog::SetActiveTarget(log);
+        wxON_BLOCK_EXIT1( wxLog::SetActiveTarget, logOld );
+
+        wxLogMessage("Main thread message");
+
+        // Log more messages than fit into the per-thread buffer from several
+        // threads at once.
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < NUM_THREADS; t++ )
+        {
+            threads.emplace_back([t]()
+            {
+                for ( int n = 0; n < NUM_MESSAGES; n++ )
+                    wxLogMessage("Thread %d message %d", t, n);
+            });
+        }
+
+        for ( auto& thread : threads )
+            thread.join();
+
+        log->Sync();
+
+        wxFFile f(tf.GetName());
+        wxString contents;
+        REQUIRE( f.ReadAll(&contents) );
+
+        wxArrayString lines = wxSplit(contents.BeforeLast('\n'), '\n', '\0');
+        REQUIRE( lines.size() == 1 + NUM_THREADS*NUM_MESSAGES );
+        CHECK( lines[0] == "Main thread message" );
+
+        // Messages from the same thread must be in order.
+        int next[NUM_THREADS] = { 0 };
+        for ( size_t n = 1; n < lines.size(); n++ )
+        {
+            int t, m;
+            REQUIRE( wxSscanf(lines[n], "Thread %d message %d", &t, &m) == 2 );
+            REQUIRE( t >= 0 );
+            REQUIRE( t < NUM_THREADS );
+            CHECK( m == next[t]++ );
+        }
+    }
+}
+
+#endif // wxUSE_THREADS
+
 // This allows to check wxLogTrace() interactively by running this test with
 // WXTRACE=logtest.
 TEST_CASE("wxLog::WXTRACE", "[log][.]")
@@ -803,6 +803,92 @@ TEST_CASE_METHOD(RequestFixture, "WebRequest::LifeTime", "[net][webrequest]")
     CHECK( request.GetResponse().GetStatus() == 200 );
 }
 
+// Fixture using its own session, as the tests using it change its options.
+class BatchRequestFixture : public RequestFixture
+{
+public:
+    BatchRequestFixture()
+        : session(wxWebSession::New())
+    {
+    }
+
+    wxWebSessionBase& GetSession() override
+    {
+        return session;
+    }
+
+    wxWebSession session;
+};
+
+TEST_CASE_METHOD(BatchRequestFixture,
+                 "WebRequest::Batch", "[net][webrequest][batch]")
+{
+    if ( !InitBaseURL() )
+        return;
+
+    // These options are not supported by all backends, so just check that
+    // using them doesn't break anything.
+    session.SetMaxConnectionsPerHost(2);
+    session.SetConnectionCacheSize(4);
+    session.EnableMultiplexing();
+
+    const int BATCH_ID = 17;
+    wxWebRequestBatch batch(this, BATCH_ID);
+
+    // Use a separate handler for the requests events, as the fixture one
+    // would exit the loop as soon as the first request terminates, while we
+    // want to wait for the batch event.
+    wxEvtHandler requestsHandler;
+    int numStateEvents = 0;
+    requestsHandler.Bind(wxEVT_WEBREQUEST_STATE, [&](wxWebRequestEvent& evt)
+    {
+        if ( evt.GetState() != wxWebRequest::State_Active )
+            numStateEvents++;
+    });
+
+    const int NUM_REQUESTS = 10;
+    for ( int n = 0; n < NUM_REQUESTS; n++ )
+    {
+        batch.Add(session.CreateRequest(&requestsHandler,
+                                        wxString::Format("bytes/%d", 100 + n)));
+    }
+
+    batch.Add(session.CreateRequest(&requestsHandler, "status/404"));
+    REQUIRE( batch.GetCount() == NUM_REQUESTS + 1 );
+
+    int numBatchEvents = 0;
+    wxWebRequest::State batchState = wxWebRequest::State_Idle;
+    Bind(wxEVT_WEBREQUEST_BATCH, [&](wxWebRequestEvent& evt)
+    {
+        numBatchEvents++;
+        CHECK( evt.GetId() == BATCH_ID );
+        batchState = evt.GetState();
+        loop.Exit();
+    });
+
+    CHECK( !batch.IsFinished() );
+    batch.Start();
+    RunLoopWithTimeout();
+
+    CHECK( numBatchEvents == 1 );
+    CHECK( numStateEvents == NUM_REQUESTS + 1 );
+    CHECK( batchState == wxWebRequest::State_Failed );
+    CHECK( batch.IsFinished() );
+    CHECK( batch.GetFinishedCount() == NUM_REQUESTS + 1 );
+    CHECK( batch.GetFailedCount() == 1 );
+
+    for ( int n = 0; n < NUM_REQUESTS; n++ )
+    {
+        const wxWebRequest request = batch.GetRequest(n);
+        CHECK( request.GetState() == wxWebRequest::State_Completed );
+        CHECK( request.GetBytesReceived() == 100 + n );
+    }
+
+    const wxWebRequest request404 = batch.GetRequest(NUM_REQUESTS);
+    CHECK( request404.GetState() == wxWebRequest::State_Failed );
+    CHECK( request404.GetResponse().GetStatus() == 404 );
+}
+
 class SyncRequestFixture : public BaseRequestFixture
 {
 public:
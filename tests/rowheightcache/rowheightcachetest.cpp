@@ -19,172 +19,6 @@
 
 #include "wx/generic/private/rowheightcache.h"
 
-// ----------------------------------------------------------------------------
-// TestRowRangesAdd
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesSimple", "[dataview][heightcache]")
-{
-    RowRanges rr;
-
-    CHECK(rr.CountAll() == 0);
-
-    for (unsigned int i = 0; i <= 10; i++)
-    {
-        CHECK(rr.Has(i) == false);
-
-        rr.Add(i);
-
-        CHECK(rr.CountAll() == i+1);
-        CHECK(rr.CountTo(i) == i);
-        CHECK(rr.Has(i) == true);
-    }
-
-    CHECK(rr.GetSize() == 1); // every row is sorted in the same range, so count == 1
-    CHECK(rr.CountAll() == 11); // 11 rows collected
-    CHECK(rr.CountTo(10) == 10);
-
-    rr.Add(5); // row 5 already contained -> does nothing
-
-    CHECK(rr.GetSize() == 1); // every row is sorted in the same range, so count == 1
-    CHECK(rr.CountAll() == 11); // 11 rows collected
-    CHECK(rr.CountTo(10) == 10);
-
-    for (int i = 10; i >= 0; i--)
-    {
-        CHECK(rr.CountAll() == (unsigned)i+1);
-        CHECK(rr.CountTo((unsigned)i) == (unsigned)i);
-
-        rr.Remove(i);
-
-        CHECK(rr.CountAll() == (unsigned)i);
-        CHECK(rr.CountTo((unsigned)i) == (unsigned)i);
-    }
-
-    CHECK(rr.CountAll() == 0); // everything removed, no row range is left behind
-    for (int i = 10; i > 0; i--)
-    {
-        CHECK(rr.CountTo(i) == 0);
-    }
-    CHECK(rr.GetSize() == 0);
-}
-
-// ----------------------------------------------------------------------------
-// TestRowRangesRemove
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesGapsMod2", "[dataview][heightcache]")
-{
-    RowRanges rr;
-    for (int i = 0; i < 100; i++)
-    {
-        CHECK(rr.Has(i) == false);
-
-        if (i % 2 == 0)
-        {
-            rr.Add(i);
-        }
-    }
-    CHECK(rr.CountAll() == 50);
-    CHECK(rr.CountTo(100) == 50);
-
-    for (unsigned int i = 99; i > 0; i--)
-    {
-        if (i % 2 == 0)
-        {
-            CHECK(rr.Has(i) == true);
-            rr.Remove(i);
-            CHECK(rr.Has(i) == false);
-        }
-        else
-        {
-            CHECK(rr.Has(i) == false);
-        }
-    }
-
-    // only row 0 is in the RowRanges, so remove 1 does nothing
-    rr.Remove(1);
-
-    CHECK(rr.CountAll() == 1);
-    CHECK(rr.CountTo(0) == 0);
-    CHECK(rr.CountTo(1) == 1);
-    CHECK(rr.CountTo(100) == 1);
-    CHECK(rr.GetSize() == 1);
-
-    rr.Remove(0); // last row is beeing removed
-
-    CHECK(rr.CountAll() == 0);
-    CHECK(rr.CountTo(0) == 0);
-    CHECK(rr.CountTo(1) == 0);
-    CHECK(rr.CountTo(100) == 0);
-    CHECK(rr.GetSize() == 0);
-
-    rr.Add(10);
-    CHECK(rr.GetSize() == 1);
-    CHECK(rr.CountTo(1) == 0); // tests CountTo first break
-    rr.Add(5); // inserts a range at the beginning
-    CHECK(rr.GetSize() == 2);
-    rr.Remove(10);
-    rr.Remove(5);
-    CHECK(rr.GetSize() == 0);
-}
-
-// ----------------------------------------------------------------------------
-// TestRowRangesCleanUp1
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesCleanUp1", "[dataview][heightcache]")
-{
-    RowRanges rr;
-    for (unsigned int i = 0; i < 100; i++)
-    {
-        CHECK(rr.Has(i) == false);
-
-        if (i % 2 == 0)
-        {
-            rr.Add(i);
-        }
-    }
-    CHECK(rr.GetSize() == 50); // adding 50 rows (only even) results in 50 range objects
-    CHECK(rr.CountAll() == 50);
-    CHECK(rr.CountTo(100) == 50);
-
-    for (unsigned int i = 0; i < 100; i++)
-    {
-        if (i % 2 == 1)
-        {
-            rr.Add(i);
-        }
-    }
-
-    CHECK(rr.GetSize() == 1); // adding 50 rows (only odd) should combined to 1 range object
-    CHECK(rr.CountAll() == 100);
-    CHECK(rr.CountTo(100) == 100);
-}
-
-// ----------------------------------------------------------------------------
-// TestRowRangesCleanUp2
-// ----------------------------------------------------------------------------
-TEST_CASE("RowHeightCacheTestCase::TestRowRangesCleanUp2", "[dataview][heightcache]")
-{
-    RowRanges rr;
-    for (unsigned int i = 0; i < 10; i++)
-    {
-        rr.Add(i);
-    }
-    CHECK(rr.GetSize() == 1); // adding 10 sequent rows results in 1 range objects
-    CHECK(rr.CountAll() == 10);
-    CHECK(rr.CountTo(100) == 10);
-
-    for (unsigned int i = 12; i < 20; i++)
-    {
-        rr.Add(i);
-    }
-
-    CHECK(rr.GetSize() == 2);
-    rr.Add(11); // tests extending a range at the beginning (to the left)
-    CHECK(rr.GetSize() == 2);
-    rr.Add(10); // extends a range and reduces them
-    CHECK(rr.GetSize() == 1);
-}
-
 // ----------------------------------------------------------------------------
 // TestHeightCache
 // ----------------------------------------------------------------------------
@@ -270,3 +104,117 @@ TEST_CASE("RowHeightCacheTestCase::TestHeightCache", "[dataview][heightcache]")
     CHECK(hc.GetLineAt(22180, row) == false);
     CHECK(row == 666);
 }
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheVariable
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheVariable", "[dataview][heightcache]")
+{
+    HeightCache hc;
+
+    // Fill the cache out of order and with different heights.
+    const unsigned int count = 1000;
+    std::vector<int> heights(count);
+    for ( unsigned int i = 0; i < count; i++ )
+        heights[i] = 10 + i % 7;
+
+    for ( unsigned int i = 0; i < count; i += 2 )
+        hc.Put(i, heights[i]);
+
+    int start = 0;
+    int height = 0;
+    unsigned int row = 666;
+
+    // Only the first row is known so far.
+    CHECK(hc.GetLineStart(1, start) == true);
+    CHECK(start == heights[0]);
+    CHECK(hc.GetLineStart(2, start) == false);
+    CHECK(hc.GetLineInfo(1, start, height) == false);
+    CHECK(hc.GetLineHeight(998, height) == true);
+    CHECK(height == heights[998]);
+
+    for ( unsigned int i = 1; i < count; i += 2 )
+        hc.Put(i, heights[i]);
+
+    CHECK(hc.GetKnownRows(height) == count);
+
+    // Change the height of an existing row.
+    heights[500] = 50;
+    hc.Put(500, heights[500]);
+
+    int y = 0;
+    for ( unsigned int i = 0; i < count; i++ )
+    {
+        CHECK(hc.GetLineInfo(i, start, height) == true);
+        CHECK(start == y);
+        CHECK(height == heights[i]);
+
+        CHECK(hc.GetLineAt(y, row) == true);
+        CHECK(row == i);
+        CHECK(hc.GetLineAt(y + heights[i] - 1, row) == true);
+        CHECK(row == i);
+
+        y += heights[i];
+    }
+
+    CHECK(hc.GetLineAt(y, row) == false);
+    CHECK(hc.GetKnownRows(height) == count);
+    CHECK(height == y);
+
+    // Removing a row invalidates all the subsequent ones.
+    hc.Remove(600);
+    CHECK(hc.GetKnownRows(height) == 600);
+    CHECK(hc.GetLineHeight(700, height) == false);
+
+    hc.Put(600, heights[600]);
+    CHECK(hc.GetKnownRows(height) == 601);
+    CHECK(hc.GetLineInfo(600, start, height) == true);
+    CHECK(height == heights[600]);
+}
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheFarRows
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheFarRows", "[dataview][heightcache]")
+{
+    HeightCache hc;
+
+    int start = 0;
+    int height = 0;
+
+    // Storing the height of a row far away must work without storing all the
+    // rows before it.
+    hc.Put(1000000, 30);
+    hc.Put(1000002, 32);
+    CHECK(hc.GetLineHeight(1000000, height) == true);
+    CHECK(height == 30);
+    CHECK(hc.GetLineHeight(1000001, height) == false);
+    CHECK(hc.GetKnownRows(height) == 0);
+
+    for ( unsigned int i = 0; i < 1000000; i++ )
+        hc.Put(i, 10);
+
+    // The rows from the map must have been taken into account when reaching
+    // them.
+    CHECK(hc.GetKnownRows(height) == 1000001);
+    CHECK(height == 10000030);
+    CHECK(hc.GetLineHeight(1000002, height) == true);
+    CHECK(height == 32);
+
+    hc.Put(1000001, 31);
+    CHECK(hc.GetKnownRows(height) == 1000003);
+    CHECK(hc.GetLineInfo(1000002, start, height) == true);
+    CHECK(start == 10000061);
+    CHECK(height == 32);
+
+    // Removing rows must remove the far rows after them too.
+    hc.Put(2000000, 20);
+    hc.Remove(1500000);
+    CHECK(hc.GetLineHeight(2000000, height) == false);
+    CHECK(hc.GetLineHeight(1000002, height) == true);
+
+    hc.Clear();
+    hc.Put(3000000, 20);
+    hc.Clear();
+    CHECK(hc.GetLineHeight(3000000, height) == false);
+}
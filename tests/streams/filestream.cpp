@@ -17,8 +17,11 @@
 #endif
 
 #include "wx/wfstream.h"
+#include "wx/mstream.h"
+#include "wx/zstream.h"
 
 #include "bstream.h"
+#include "testfile.h"
 
 #define DATABUFFER_SIZE     1024
 
@@ -144,3 +147,78 @@ wxString fileStream::GetInFileName() const
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(fileStream)
+
+TEST_CASE("wxMappedFileInputStream", "[stream][file]")
+{
+    // Create a file containing some uncompressed data followed by the same
+    // data compressed using zlib.
+    wxMemoryBuffer data;
+    for ( int i = 0; i < 100000; i++ )
+        data.AppendByte(static_cast<char>(i % 251));
+
+    wxMemoryOutputStream memOut;
+    memOut.Write(data.GetData(), data.GetDataLen());
+    {
+        wxZlibOutputStream zOut(memOut);
+        zOut.Write(data.GetData(), data.GetDataLen());
+    }
+
+    TempFile tmp("mappedstream.test");
+    {
+        wxFileOutputStream out(tmp.GetName());
+        REQUIRE( out.IsOk() );
+
+        wxMemoryInputStream memIn(memOut);
+        out.Write(memIn);
+    }
+
+    const size_t sizeFile = memOut.GetLength();
+
+    wxMappedFileInputStream in(tmp.GetName());
+    REQUIRE( in.IsOk() );
+    CHECK( in.GetLength() == static_cast<wxFileOffset>(sizeFile) );
+    CHECK( in.GetSize() == sizeFile );
+
+    char buf[10];
+    CHECK( in.Read(buf, sizeof(buf)).LastRead() == sizeof(buf) );
+    CHECK( memcmp(buf, data.GetData(), sizeof(buf)) == 0 );
+    CHECK( in.TellI() == 10 );
+
+    size_t size;
+    const char* p = static_cast<const char*>(in.PeekSpan(&size));
+    REQUIRE( p );
+    CHECK( size == sizeFile - 10 );
+    CHECK( p == static_cast<const char*>(in.GetData()) + 10 );
+
+    in.SkipSpan(data.GetDataLen() - 10);
+    CHECK( in.TellI() == static_cast<wxFileOffset>(data.GetDataLen()) );
+
+    // No direct access to the data put back into the stream.
+    in.Ungetch('x');
+    CHECK( !in.PeekSpan(&size) );
+    CHECK( size == 0 );
+    CHECK( in.GetC() == 'x' );
+
+    // Decompressing the data uses direct access to it.
+    {
+        wxZlibInputStream zIn(in);
+        wxMemoryOutputStream unpacked;
+        zIn.Read(unpacked);
+
+        REQUIRE( static_cast<size_t>(unpacked.GetLength()) == data.GetDataLen() );
+
+        wxMemoryBuffer result(data.GetDataLen());
+        unpacked.CopyTo(result.GetWriteBuf(data.GetDataLen()),
+                        data.GetDataLen());
+        CHECK( memcmp(result.GetData(), data.GetData(),
+                      data.GetDataLen()) == 0 );
+    }
+
+    CHECK( in.SeekI(5) == 5 );
+    CHECK( in.GetC() == 5 );
+    CHECK( in.SeekI(-1, wxFromEnd) == static_cast<wxFileOffset>(sizeFile - 1) );
+    CHECK( in.CanRead() );
+    in.GetC();
+    CHECK( !in.CanRead() );
+    CHECK( !in.PeekSpan(&size) );
+}
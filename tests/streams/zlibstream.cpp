@@ -548,3 +548,72 @@ void zlibStream::genExtTestData(wxTextOutputStream &out, const char *buf, int fl
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(zlibStream)
 
+
+#if wxUSE_THREADS
+
+TEST_CASE("wxZlibOutputStream::Parallel", "[zlib][stream]")
+{
+    // Use enough data for several blocks and make it compressible, but not
+    // trivially so, in order to check that the dictionary is used correctly.
+    wxMemoryBuffer data;
+    {
+        wxUint32 seed = 17;
+        for ( int n = 0; n < 1000000; n++ )
+        {
+            seed = seed*1103515245 + 12345;
+            const char ch = static_cast<char>('a' + (seed >> 16) % 16);
+            data.AppendByte(ch);
+        }
+    }
+
+    const int flags[] = { wxZLIB_NO_HEADER, wxZLIB_ZLIB, wxZLIB_GZIP };
+    for ( const int flag : flags )
+    {
+        const int levels[] = { -1, 0, 1, 9 };
+        for ( const int level : levels )
+        {
+            INFO("Flag " << flag << ", level " << level);
+
+            wxMemoryOutputStream memOut;
+            {
+                wxZlibOutputStream zOut(memOut, level, flag);
+                REQUIRE( zOut.SetParallelism(4) );
+
+                // Write the data in chunks of varying size and sync once in
+                // the middle to test both kinds of flushes.
+                const size_t chunks[] = { 1, 1000, 70000, 300000, 5 };
+                const char* p = static_cast<const char*>(data.GetData());
+                const size_t size = data.GetDataLen();
+                for ( size_t pos = 0, n = 0; pos < size; n++ )
+                {
+                    const size_t len = wxMin(chunks[n % WXSIZEOF(chunks)],
+                                             size - pos);
+                    CHECK( zOut.Write(p + pos, len).LastWrite() == len );
+                    pos += len;
+
+                    if ( pos > size / 2 && pos - len <= size / 2 )
+                        zOut.Sync();
+                }
+
+                CHECK( zOut.Close() );
+            }
+
+            wxMemoryInputStream memIn(memOut);
+            wxZlibInputStream zIn(memIn, flag == wxZLIB_NO_HEADER
+                                            ? wxZLIB_NO_HEADER
+                                            : wxZLIB_AUTO);
+
+            wxMemoryOutputStream unpacked;
+            zIn.Read(unpacked);
+
+            const size_t len = unpacked.GetLength();
+            REQUIRE( len == data.GetDataLen() );
+
+            wxMemoryBuffer result(len);
+            unpacked.CopyTo(result.GetWriteBuf(len), len);
+            CHECK( memcmp(result.GetData(), data.GetData(), len) == 0 );
+        }
+    }
+}
+
+#endif // wxUSE_THREADS